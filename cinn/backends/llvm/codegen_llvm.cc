@@ -14,6 +14,7 @@
 
 #include "cinn/backends/llvm/codegen_llvm.h"
 
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <glog/stl_logging.h>
 #include <llvm/ADT/SmallVector.h>
@@ -26,12 +27,15 @@
 #include <llvm/Support/raw_ostream.h>
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "cinn/backends/extern_func_emitter.h"
 #include "cinn/backends/extern_func_emitter_builtin.h"
@@ -51,6 +55,8 @@
 #include "llvm/IR/Verifier.h"
 #include "llvm/Support/Alignment.h"
 
+DECLARE_int32(cinn_approx_math_level);
+
 namespace cinn {
 namespace backends {
 
@@ -69,6 +75,16 @@ auto NodeToExpr(const T *node) {
 
 bool is_integral_type(common::Type t) { return t.is_int() || t.is_uint(); }
 
+//! Evaluate the polynomial of \p coeffs, from the highest order, at \p x by Horner's method.
+llvm::Value *EmitPolynomial(llvm::IRBuilder<> *b, llvm::Value *x, const std::vector<float> &coeffs) {
+  CHECK(!coeffs.empty());
+  llvm::Value *result = llvm::ConstantFP::get(x->getType(), coeffs[0]);
+  for (size_t i = 1; i < coeffs.size(); i++) {
+    result = b->CreateFAdd(b->CreateFMul(result, x), llvm::ConstantFP::get(x->getType(), coeffs[i]));
+  }
+  return result;
+}
+
 bool is_floating_type(common::Type t) { return t.is_float(); }
 
 llvm::Value *EmitComparison(llvm::CmpInst::Predicate predicate,
@@ -371,6 +387,24 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Cast *op) {
     return Call(callee, std::vector<llvm::Value *>({value}), "pod_value_cast");
   }
 
+  // bfloat16 is stored as raw bits, so the conversions go through float32 by bit operations.
+  if (from.is_bfloat16() && !to.is_cpp_handle() && !to.is_cpp_handle2()) {
+    value  = EmitBFloat16ToFloat32(value, from.lanes());
+    from   = Float(32, from.lanes());
+    source = CinnTypeToLLVMType(from, m_);
+  }
+  if (to.is_bfloat16() && !to.is_cpp_handle() && !to.is_cpp_handle2()) {
+    auto *f32_type = CinnTypeToLLVMType(Float(32, to.lanes()), m_, true);
+    if (from.is_float()) {
+      value = FPCast(value, f32_type);
+    } else if (from.is_int()) {
+      value = SIToFP(value, f32_type);
+    } else {
+      value = UIToFP(value, f32_type);
+    }
+    return EmitFloat32ToBFloat16(value, to.lanes());
+  }
+
   do {
     if (value->getType() == target) break;
 
@@ -425,6 +459,126 @@ llvm::Value *CodeGenLLVM::Visit(const ir::Cast *op) {
   return value;
 }
 
+llvm::Value *CodeGenLLVM::EmitBFloat16ToFloat32(llvm::Value *value, int lanes) {
+  auto *i32_type = CinnTypeToLLVMType(Int(32, lanes), m_, true);
+  auto *f32_type = CinnTypeToLLVMType(Float(32, lanes), m_, true);
+  auto *bits     = b_->CreateZExt(value, i32_type);
+  bits           = b_->CreateShl(bits, llvm::ConstantInt::get(i32_type, 16));
+  return b_->CreateBitCast(bits, f32_type);
+}
+
+llvm::Value *CodeGenLLVM::EmitFloat32ToBFloat16(llvm::Value *value, int lanes) {
+  auto *i16_type = CinnTypeToLLVMType(BFloat(16, lanes), m_, true);
+  auto *i32_type = CinnTypeToLLVMType(Int(32, lanes), m_, true);
+  auto *bits     = b_->CreateBitCast(value, i32_type);
+  auto *high     = b_->CreateLShr(bits, llvm::ConstantInt::get(i32_type, 16));
+  // round to nearest even: bits + 0x7FFF + ((bits >> 16) & 1).
+  auto *lsb      = b_->CreateAnd(high, llvm::ConstantInt::get(i32_type, 1));
+  auto *rounding = b_->CreateAdd(lsb, llvm::ConstantInt::get(i32_type, 0x7FFF));
+  auto *rounded  = b_->CreateLShr(b_->CreateAdd(bits, rounding), llvm::ConstantInt::get(i32_type, 16));
+  // the rounding may carry a NaN into the infinity or the sign bit, so a NaN keeps its high bits and is made quiet.
+  auto *quiet_nan = b_->CreateOr(high, llvm::ConstantInt::get(i32_type, 0x40));
+  bits            = b_->CreateSelect(b_->CreateFCmpUNO(value, value), quiet_nan, rounded);
+  return b_->CreateTrunc(bits, i16_type);
+}
+
+llvm::Value *CodeGenLLVM::EmitApproxExp(llvm::Value *x, int lanes, int level) {
+  auto *i32_type = CinnTypeToLLVMType(Int(32, lanes), m_, true);
+  auto *f32_type = CinnTypeToLLVMType(Float(32, lanes), m_, true);
+  auto constant  = [&](float v) { return llvm::ConstantFP::get(f32_type, v); };
+  // exp overflows above ln(FLT_MAX) and underflows below the log of the smallest denormal, ln(2^-150).
+  const float max_log = 88.72283935546875f;
+  const float min_log = -103.97207708f;
+
+  llvm::Value *v = b_->CreateSelect(b_->CreateFCmpOGT(x, constant(max_log)), constant(max_log), x);
+  v              = b_->CreateSelect(b_->CreateFCmpOLT(v, constant(min_log)), constant(min_log), v);
+  // x = n * ln2 + r with |r| <= ln2 / 2, ln2 is split into two parts so that r is exact.
+  llvm::Value *n = b_->CreateFAdd(b_->CreateFMul(v, constant(M_LOG2E)), constant(0.5f));
+  n              = b_->CreateUnaryIntrinsic(llvm::Intrinsic::floor, n);
+  llvm::Value *r = b_->CreateFSub(v, b_->CreateFMul(n, constant(0.693359375f)));
+  r              = b_->CreateFSub(r, b_->CreateFMul(n, constant(-2.12194440e-4f)));
+
+  llvm::Value *p;
+  if (level >= 2) {
+    // The Taylor series to r^4, the relative error is about 4e-5 (5.6e-5 at most, at r = -ln2 / 2).
+    p = EmitPolynomial(b_, r, {1.f / 24, 1.f / 6, 0.5f, 1.f, 1.f});
+  } else {
+    // The minimax polynomial of cephes, the relative error is about 2e-7.
+    p = EmitPolynomial(b_,
+                       r,
+                       {1.9875691500E-4f,
+                        1.3981999507E-3f,
+                        8.3334519073E-3f,
+                        4.1665795894E-2f,
+                        1.6666665459E-1f,
+                        5.0000001201E-1f});
+    p = b_->CreateFAdd(b_->CreateFAdd(b_->CreateFMul(p, b_->CreateFMul(r, r)), r), constant(1.f));
+  }
+
+  // Scale by 2^n, which is built from the exponent bits in two halves, as n may be out of the normal range.
+  auto pow2 = [&](llvm::Value *e) {
+    e = b_->CreateAdd(e, llvm::ConstantInt::get(i32_type, 127));
+    return b_->CreateBitCast(b_->CreateShl(e, llvm::ConstantInt::get(i32_type, 23)), f32_type);
+  };
+
+  llvm::Value *n0     = b_->CreateFPToSI(n, i32_type);
+  llvm::Value *n1     = b_->CreateAShr(n0, llvm::ConstantInt::get(i32_type, 1));
+  llvm::Value *n2     = b_->CreateSub(n0, n1);
+  llvm::Value *result = b_->CreateFMul(b_->CreateFMul(p, pow2(n1)), pow2(n2));
+
+  const float inf = std::numeric_limits<float>::infinity();
+  result          = b_->CreateSelect(b_->CreateFCmpOGT(x, constant(max_log)), constant(inf), result);
+  result          = b_->CreateSelect(b_->CreateFCmpOLT(x, constant(min_log)), constant(0.f), result);
+  return b_->CreateSelect(b_->CreateFCmpUNO(x, x), x, result);
+}
+
+llvm::Value *CodeGenLLVM::EmitApproxLog(llvm::Value *x, int lanes) {
+  auto *i32_type = CinnTypeToLLVMType(Int(32, lanes), m_, true);
+  auto *f32_type = CinnTypeToLLVMType(Float(32, lanes), m_, true);
+  auto constant  = [&](float v) { return llvm::ConstantFP::get(f32_type, v); };
+  auto int_const = [&](int v) { return llvm::ConstantInt::get(i32_type, v); };
+
+  // Scale the denormals up to normal numbers to read their exponents.
+  llvm::Value *is_denormal = b_->CreateFCmpOLT(x, constant(std::numeric_limits<float>::min()));
+  llvm::Value *v           = b_->CreateSelect(is_denormal, b_->CreateFMul(x, constant(8388608.f)), x);
+  llvm::Value *bias        = b_->CreateSelect(is_denormal, int_const(126 + 23), int_const(126));
+
+  // x = m * 2^e with m in [sqrt(0.5), sqrt(2)), log(x) = log(m) + e * ln2.
+  llvm::Value *bits     = b_->CreateBitCast(v, i32_type);
+  llvm::Value *e        = b_->CreateSIToFP(b_->CreateSub(b_->CreateLShr(bits, int_const(23)), bias), f32_type);
+  llvm::Value *mantissa = b_->CreateOr(b_->CreateAnd(bits, int_const(0x007fffff)), int_const(0x3f000000));
+  llvm::Value *m        = b_->CreateBitCast(mantissa, f32_type);
+  llvm::Value *is_small = b_->CreateFCmpOLT(m, constant(M_SQRT1_2));
+  e                     = b_->CreateSelect(is_small, b_->CreateFSub(e, constant(1.f)), e);
+  m                     = b_->CreateFSub(b_->CreateSelect(is_small, b_->CreateFAdd(m, m), m), constant(1.f));
+
+  // The minimax polynomial of cephes for log(1 + m), the relative error is about 2e-7.
+  llvm::Value *z = b_->CreateFMul(m, m);
+  llvm::Value *y = EmitPolynomial(b_,
+                                  m,
+                                  {7.0376836292E-2f,
+                                   -1.1514610310E-1f,
+                                   1.1676998740E-1f,
+                                   -1.2420140846E-1f,
+                                   1.4249322787E-1f,
+                                   -1.6668057665E-1f,
+                                   2.0000714765E-1f,
+                                   -2.4999993993E-1f,
+                                   3.3333331174E-1f});
+
+  y                   = b_->CreateFMul(b_->CreateFMul(y, m), z);
+  y                   = b_->CreateFAdd(y, b_->CreateFMul(e, constant(-2.12194440e-4f)));
+  y                   = b_->CreateFSub(y, b_->CreateFMul(z, constant(0.5f)));
+  llvm::Value *result = b_->CreateFAdd(b_->CreateFAdd(m, y), b_->CreateFMul(e, constant(0.693359375f)));
+
+  // log(+inf) = +inf, log(0) = -inf, the log of a negative number or NaN is NaN.
+  const float inf = std::numeric_limits<float>::infinity();
+  result          = b_->CreateSelect(b_->CreateFCmpOEQ(x, constant(inf)), constant(inf), result);
+  result          = b_->CreateSelect(b_->CreateFCmpOEQ(x, constant(0.f)), constant(-inf), result);
+  return b_->CreateSelect(
+      b_->CreateFCmpULT(x, constant(0.f)), constant(std::numeric_limits<float>::quiet_NaN()), result);
+}
+
 llvm::Value *CodeGenLLVM::CreateSerialFor(const ir::For *op, int stride) {
   SymbolTableGuard symbol_table_guard(*symbol_table_);
 
@@ -1442,7 +1596,16 @@ llvm::Value *CodeGenLLVM::Visit(const ir::intrinsics::BuiltinIntrin *op) {
   }
 
   llvm::Intrinsic::ID id = op->id;
-  int64_t num_signature  = op->arg_nums;
+  // The libm calls that exp and log expand to do not vectorize, inline the polynomial approximations instead.
+  if (FLAGS_cinn_approx_math_level > 0 && op->type().is_float(32) &&
+      (id == llvm::Intrinsic::exp || id == llvm::Intrinsic::log)) {
+    CHECK_EQ(op->args.size(), 1U);
+    llvm::Value *x = Visit(&op->args[0]);
+    int lanes      = op->type().lanes();
+    return id == llvm::Intrinsic::exp ? EmitApproxExp(x, lanes, FLAGS_cinn_approx_math_level)
+                                      : EmitApproxLog(x, lanes);
+  }
+  int64_t num_signature = op->arg_nums;
   std::vector<llvm::Value *> arg_value;
   std::vector<llvm::Type *> arg_type;
   for (size_t i = 0; i < op->args.size(); ++i) {
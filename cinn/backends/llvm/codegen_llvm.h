@@ -199,6 +199,22 @@ class CodeGenLLVM : public LLVMIRVisitor, public IrBuilderMixin<CodeGenLLVM> {
   llvm::Value *CreateVecSlice(llvm::Value *vec, int begin, int lanes);
 
   llvm::Value *DenseVectorLoad(const ir::Load *load);
+
+  //! Convert between bfloat16 raw bits (i16) and float32, the float32 -> bfloat16 rounds to nearest even.
+  // @{
+  llvm::Value *EmitBFloat16ToFloat32(llvm::Value *value, int lanes);
+  llvm::Value *EmitFloat32ToBFloat16(llvm::Value *value, int lanes);
+  // @}
+
+  /**
+   * Inline polynomial approximations of exp and log of float32, which are plain arithmetic and vectorize with the
+   * loops. The \p level 1 of exp and log are accurate to about 2e-7 relatively, the level 2 of exp trades the accuracy
+   * (about 4e-5) for a shorter polynomial. The special values like inf and NaN are kept.
+   */
+  // @{
+  llvm::Value *EmitApproxExp(llvm::Value *x, int lanes, int level);
+  llvm::Value *EmitApproxLog(llvm::Value *x, int lanes);
+  // @}
   llvm::Value *CreateSerialFor(const ir::For *op, int stride = 1);
 
   /**
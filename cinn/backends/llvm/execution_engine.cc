@@ -63,6 +63,7 @@
 #include "cinn/backends/llvm/runtime_symbol_registry.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/runtime/intrinsic.h"
+#include "cinn/utils/string.h"
 
 namespace cinn::backends {
 namespace {
@@ -85,6 +86,26 @@ void InitializeLLVMPasses() {
   // llvm::initializeTarget(registry);
   // llvm::initializeCodeGenPreparePass(registry);
 }
+
+llvm::orc::JITTargetMachineBuilder CreateTargetMachineBuilder(const ExecutionOptions &options) {
+  auto builder = llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost());
+  if (!options.cpu.empty()) builder.setCPU(options.cpu);
+  if (!options.features.empty()) builder.addFeatures(utils::Split(options.features, ","));
+  switch (options.opt_level) {
+    case 0:
+      builder.setCodeGenOptLevel(llvm::CodeGenOpt::None);
+      break;
+    case 1:
+      builder.setCodeGenOptLevel(llvm::CodeGenOpt::Less);
+      break;
+    case 2:
+      builder.setCodeGenOptLevel(llvm::CodeGenOpt::Default);
+      break;
+    default:
+      builder.setCodeGenOptLevel(llvm::CodeGenOpt::Aggressive);
+  }
+  return builder;
+}
 }  // namespace
 void NaiveObjectCache::notifyObjectCompiled(const llvm::Module *m, llvm::MemoryBufferRef obj_buffer) {
   cached_objects_[m->getModuleIdentifier()] =
@@ -107,11 +128,17 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
   VLOG(1) << "initialize llvm config";
   VLOG(1) << "llvm version: " << LLVM_VERSION_STRING;
   VLOG(1) << "llvm default target triple: " << LLVM_DEFAULT_TARGET_TRIPLE;
-  llvm::InitializeNativeTarget();
-  llvm::InitializeNativeTargetAsmPrinter();
+  // the engines may be created by several threads at once, e.g. the pipelined compilation, but the native target
+  // initialization is not thread-safe.
+  static std::once_flag init_native_target;
+  std::call_once(init_native_target, []() {
+    llvm::InitializeNativeTarget();
+    llvm::InitializeNativeTargetAsmPrinter();
+  });
   InitializeLLVMPasses();
 
-  auto engine = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true);
+  auto engine      = std::make_unique<ExecutionEngine>(/*enable_object_cache=*/true);
+  engine->options_ = config;
 
   auto compile_layer_creator = [&engine](llvm::orc::JITTargetMachineBuilder jtmb)
       -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
@@ -134,6 +161,7 @@ std::unique_ptr<llvm::MemoryBuffer> NaiveObjectCache::getObject(const llvm::Modu
 
   VLOG(2) << "create jit execution engine";
   engine->jit_ = llvm::cantFail(llvm::orc::LLJITBuilder()
+                                    .setJITTargetMachineBuilder(CreateTargetMachineBuilder(config))
                                     .setCompileFunctionCreator(compile_layer_creator)
                                     .setObjectLinkingLayerCreator(object_layer_creator)
                                     .create());
@@ -160,9 +188,8 @@ void ExecutionEngine::Link(const ir::Module &module) {
   VLOG(3) << "ir_emitter->Compile(module) Succeed!";
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid module found";
 
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  LLVMModuleOptimizer optimize(machine.get(), 3, {}, true);
+  auto machine = llvm::cantFail(CreateTargetMachineBuilder(options_).createTargetMachine());
+  LLVMModuleOptimizer optimize(machine.get(), options_.opt_level, options_.optimize_options, true);
   optimize(m.get());
   CHECK(!llvm::verifyModule(*m, &llvm::errs())) << "Invalid optimized module detected";
   for (auto &f : *m) {
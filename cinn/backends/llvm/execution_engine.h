@@ -44,6 +44,7 @@
 #include <vector>
 
 #include "cinn/backends/llvm/codegen_x86.h"
+#include "cinn/backends/llvm/llvm_optimizer.h"
 #include "cinn/backends/llvm/llvm_util.h"
 #include "cinn/ir/module.h"
 
@@ -61,9 +62,13 @@ class NaiveObjectCache : public llvm::ObjectCache {
 struct ExecutionOptions {
   int opt_level{3};
   bool enable_debug_info{false};
+  //! The options of the LLVM optimization pipeline of the opt_level above.
+  OptimizeOptions optimize_options;
+  //! The target CPU and the features to add like "+avx2,+fma", the host CPU is used if it is empty.
+  std::string cpu;
+  std::string features;
   // TODO(fc500110)
   // int num_compile_threads{1};
-  // bool enable_fast_math;
 };
 
 class ExecutionEngine {
@@ -90,6 +95,7 @@ class ExecutionEngine {
 
  private:
   mutable std::mutex mu_;
+  ExecutionOptions options_;
   llvm::SmallString<0> buffer_;
   std::unique_ptr<llvm::orc::LLJIT> jit_;
   std::unique_ptr<NaiveObjectCache> cache_;
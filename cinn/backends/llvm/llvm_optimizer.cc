@@ -17,7 +17,9 @@
 #include <glog/logging.h>
 #include <llvm/ADT/Triple.h>
 #include <llvm/Analysis/CGSCCPassManager.h>
+#include <llvm/Analysis/LoopInfo.h>
 #include <llvm/AsmParser/Parser.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/JITSymbol.h>
 #include <llvm/ExecutionEngine/Orc/CompileUtils.h>
@@ -28,9 +30,12 @@
 #include <llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h>
 #include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
 #include <llvm/ExecutionEngine/SectionMemoryManager.h>
+#include <llvm/IR/Dominators.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/InstIterator.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
 #include <llvm/IR/PassManager.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Passes/PassBuilder.h>
@@ -51,6 +56,7 @@
 #include <llvm/Transforms/Scalar/NewGVN.h>
 #include <llvm/Transforms/Scalar/Reassociate.h>
 #include <llvm/Transforms/Scalar/SimplifyCFG.h>
+#include <llvm/Transforms/Utils/LoopUtils.h>
 #include <llvm/Transforms/Vectorize.h>
 
 #include <algorithm>
@@ -113,45 +119,90 @@ class CustomPassManager : public PassManagerT {
 
 using CustomFunctionPassManager = CustomPassManager<llvm::legacy::FunctionPassManager>;
 using CustomModulePassManager   = CustomPassManager<llvm::legacy::PassManager>;
+
+void SetFastMathFlags(llvm::Function *fn, llvm::FastMathFlags flags) {
+  for (auto &inst : llvm::instructions(fn)) {
+    if (llvm::isa<llvm::FPMathOperator>(&inst)) inst.setFastMathFlags(flags);
+  }
+  // The backend reads the function attributes instead of the instruction flags.
+  auto to_attr = [](bool x) { return x ? "true" : "false"; };
+  fn->addFnAttr("unsafe-fp-math", to_attr(flags.isFast()));
+  fn->addFnAttr("no-nans-fp-math", to_attr(flags.noNaNs()));
+  fn->addFnAttr("no-infs-fp-math", to_attr(flags.noInfs()));
+  fn->addFnAttr("no-signed-zeros-fp-math", to_attr(flags.noSignedZeros()));
+}
 }  // namespace
 
 LLVMModuleOptimizer::LLVMModuleOptimizer(llvm::TargetMachine *machine,
                                          int opt_level,
-                                         llvm::FastMathFlags fast_math_flags,
+                                         const OptimizeOptions &options,
                                          bool print_passes)
-    : opt_level_(opt_level), print_passes_(print_passes), machine_(machine) {}
+    : machine_(machine), opt_level_(opt_level), options_(options), print_passes_(print_passes) {}
 
 void LLVMModuleOptimizer::operator()(llvm::Module *m) {
-  auto machine =
-      std::move(llvm::cantFail(llvm::cantFail(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine()));
-  auto fpm = std::make_unique<CustomFunctionPassManager>(print_passes_, m);
-  // fpm->add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
-  // fpm->add(llvm::createInstructionCombiningPass());
-  // fpm->add(llvm::createReassociatePass());
-  // fpm->add(llvm::createGVNPass());
-  // fpm->add(llvm::createCFGSimplificationPass());
-  // fpm->add(llvm::createSROAPass());
-  // fpm->add(llvm::createEarlyCSEPass());
-  // fpm->add(llvm::createLowerExpectIntrinsicPass());
-  // fpm->add(llvm::createCallSiteSplittingPass());
-  // fpm->add(llvm::createLoopVectorizePass());
-  // fpm->add(llvm::createSLPVectorizerPass());
-  // fpm->add(llvm::createLoadStoreVectorizerPass());
-  // fpm->add(llvm::createLoopUnrollPass());
+  for (auto &fn : *m) {
+    if (fn.isDeclaration()) continue;
+    if (options_.fast_math_flags.any()) SetFastMathFlags(&fn, options_.fast_math_flags);
+    if (options_.tune_per_function) TuneFunction(&fn);
+  }
+
+  if (options_.use_new_pass_manager) {
+    RunNewPipeline(m);
+  } else {
+    RunLegacyPipeline(m);
+  }
+}
+
+void LLVMModuleOptimizer::TuneFunction(llvm::Function *fn) {
+  llvm::DominatorTree dom_tree(*fn);
+  llvm::LoopInfo loop_info(dom_tree);
+  if (loop_info.empty()) return;
+
+  auto loops         = loop_info.getLoopsInPreorder();
+  unsigned max_depth = 0;
+  for (auto *loop : loops) max_depth = std::max(max_depth, loop->getLoopDepth());
+  bool is_tiny = fn->getInstructionCount() < options_.tiny_function_size;
+  if (!is_tiny && max_depth < 3) return;
+
+  for (auto *loop : loops) {
+    if (is_tiny) {
+      llvm::addStringMetadataToLoop(loop, "llvm.loop.unroll.disable");
+      llvm::addStringMetadataToLoop(loop, "llvm.loop.interleave.count", 1);
+    } else if (loop->getSubLoops().empty()) {
+      llvm::addStringMetadataToLoop(loop, "llvm.loop.vectorize.enable", 1);
+    }
+  }
+  VLOG(3) << "Tune function " << fn->getName().str() << " as " << (is_tiny ? "a tiny kernel" : "a loop nest")
+          << ", loop depth: " << max_depth;
+}
 
+void LLVMModuleOptimizer::RunLegacyPipeline(llvm::Module *m) {
+  auto fpm = std::make_unique<CustomFunctionPassManager>(print_passes_, m);
   auto mpm = std::make_unique<CustomModulePassManager>(print_passes_);
-  // mpm->add(llvm::createTargetTransformInfoWrapperPass(llvm::TargetIRAnalysis()));
-  // LOG(INFO) << "llvm run pass: target machine: name[" << machine_->getTarget().getName() << "]";
-  // LOG(INFO) << "llvm run pass: target machine: cpu[" << machine_->getTargetCPU().str() << "]";
-  fpm->add(llvm::createTargetTransformInfoWrapperPass(machine->getTargetIRAnalysis()));
-  mpm->add(llvm::createTargetTransformInfoWrapperPass(machine->getTargetIRAnalysis()));
+  fpm->add(llvm::createTargetTransformInfoWrapperPass(machine_->getTargetIRAnalysis()));
+  mpm->add(llvm::createTargetTransformInfoWrapperPass(machine_->getTargetIRAnalysis()));
   auto builder           = std::make_unique<llvm::PassManagerBuilder>();
   builder->OptLevel      = opt_level_;
-  builder->Inliner       = llvm::createFunctionInliningPass();
-  builder->LoopVectorize = true;
-  builder->SLPVectorize  = true;
+  builder->Inliner       = options_.inline_threshold >= 0 ? llvm::createFunctionInliningPass(options_.inline_threshold)
+                                                          : llvm::createFunctionInliningPass();
+  builder->LoopVectorize = options_.loop_vectorize;
+  builder->SLPVectorize  = options_.slp_vectorize;
+  // The default unrolling is replaced by the one with the given threshold, which the builder has no option for. It is
+  // added at EP_OptimizerLast, after the vectorizers as the default partial unrolling, but the full unrolling of the
+  // loop simplification before them is skipped too.
+  builder->DisableUnrollLoops = !options_.unroll_loops || options_.unroll_threshold >= 0;
+  if (options_.unroll_loops && options_.unroll_threshold >= 0) {
+    int opt_level = opt_level_;
+    int threshold = options_.unroll_threshold;
+    builder->addExtension(
+        llvm::PassManagerBuilder::EP_OptimizerLast,
+        [opt_level, threshold](const llvm::PassManagerBuilder &, llvm::legacy::PassManagerBase &pm) {
+          pm.add(llvm::createLoopUnrollPass(opt_level, /*OnlyWhenForced=*/false, /*ForgetAllSCEV=*/false, threshold));
+          pm.add(llvm::createInstructionCombiningPass());
+        });
+  }
 #if LLVM_VERSION_MAJOR >= 11
-  machine->adjustPassManager(*builder);
+  machine_->adjustPassManager(*builder);
 #endif
   builder->populateFunctionPassManager(*fpm);
   builder->populateModulePassManager(*mpm);
@@ -163,4 +214,44 @@ void LLVMModuleOptimizer::operator()(llvm::Module *m) {
   mpm->run(*m);
 }
 
+void LLVMModuleOptimizer::RunNewPipeline(llvm::Module *m) {
+  // The O0 pipeline does nothing more than the always-inliner, which the lowered functions do not need.
+  if (opt_level_ <= 0) return;
+
+  llvm::PipelineTuningOptions tuning;
+  tuning.LoopVectorization = options_.loop_vectorize;
+  tuning.SLPVectorization  = options_.slp_vectorize;
+  tuning.LoopUnrolling     = options_.unroll_loops;
+  tuning.LoopInterleaving  = options_.unroll_loops;
+#if LLVM_VERSION_MAJOR == 12
+  llvm::PassBuilder builder(print_passes_, machine_, tuning);
+#else
+  llvm::PassBuilder builder(machine_, tuning);
+#endif
+
+  llvm::LoopAnalysisManager lam;
+  llvm::FunctionAnalysisManager fam;
+  llvm::CGSCCAnalysisManager cgam;
+  llvm::ModuleAnalysisManager mam;
+  builder.registerModuleAnalyses(mam);
+  builder.registerCGSCCAnalyses(cgam);
+  builder.registerFunctionAnalyses(fam);
+  builder.registerLoopAnalyses(lam);
+  builder.crossRegisterProxies(lam, fam, cgam, mam);
+
+#if LLVM_VERSION_MAJOR >= 14
+  using OptimizationLevel = llvm::OptimizationLevel;
+#else
+  using OptimizationLevel = llvm::PassBuilder::OptimizationLevel;
+#endif
+  OptimizationLevel level = OptimizationLevel::O3;
+  if (opt_level_ == 1) {
+    level = OptimizationLevel::O1;
+  } else if (opt_level_ == 2) {
+    level = OptimizationLevel::O2;
+  }
+  llvm::ModulePassManager mpm = builder.buildPerModuleDefaultPipeline(level);
+  mpm.run(*m, mam);
+}
+
 }  // namespace cinn::backends
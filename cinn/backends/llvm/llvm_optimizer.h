@@ -24,20 +24,49 @@
 
 namespace cinn::backends {
 
-// TODO(fc500110): define class OptimizeOptions
+struct OptimizeOptions {
+  //! Build the pipeline with the new pass manager instead of the legacy PassManagerBuilder.
+  bool use_new_pass_manager{false};
+  bool loop_vectorize{true};
+  bool slp_vectorize{true};
+  bool unroll_loops{true};
+  //! The cost threshold of the unrolled loops, -1 for the default one of the optimization level. Only the legacy
+  //! pipeline supports it, where the loops are then unrolled at the end of the pipeline only.
+  int unroll_threshold{-1};
+  //! The cost threshold of inlining a call, -1 for the default one of the optimization level.
+  int inline_threshold{-1};
+  //! The fast-math flags set to all the floating-point operations and the functions.
+  llvm::FastMathFlags fast_math_flags;
+  //! Tune the loops of each function by its size, see LLVMModuleOptimizer::TuneFunction.
+  bool tune_per_function{false};
+  //! A function with fewer instructions than this is regarded as a tiny kernel.
+  int tiny_function_size{128};
+};
 
 // llvm module optimizer
 class LLVMModuleOptimizer final {
  public:
+  //! \p opt_level is the level of the optimization pipeline, from 0 to 3.
   explicit LLVMModuleOptimizer(llvm::TargetMachine *machine,
                                int opt_level,
-                               llvm::FastMathFlags fast_math_flags,
+                               const OptimizeOptions &options,
                                bool print_passes = false);
   void operator()(llvm::Module *m);
 
  private:
+  /**
+   * Tune the optimization of a single function with attributes and loop metadata, as the pipeline is shared by the
+   * whole module. The loops of a tiny kernel (like an elementwise op) are not unrolled or interleaved, which saves the
+   * compile time and the code size while keeping them vectorized, the innermost loops of a loop nest of depth 3 or more
+   * (like a matmul) are forced to be vectorized.
+   */
+  void TuneFunction(llvm::Function *fn);
+  void RunLegacyPipeline(llvm::Module *m);
+  void RunNewPipeline(llvm::Module *m);
+
   llvm::TargetMachine *machine_;
   int opt_level_{};
+  OptimizeOptions options_;
   bool print_passes_{};
 };
 }  // namespace cinn::backends
@@ -0,0 +1,108 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/backends/pipelined_compiler.h"
+
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace backends {
+
+PipelinedCompiler::PipelinedCompiler(const Target& target, int num_threads) : target_(target) {
+  CHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(&PipelinedCompiler::WorkerLoop, this);
+  }
+}
+
+PipelinedCompiler::~PipelinedCompiler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void PipelinedCompiler::Submit(const ir::Module& module) {
+  std::unique_ptr<Task> task(new Task);
+  task->module = module;
+  task->done   = task->promise.get_future().share();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& fn : module.functions()) {
+      fn2task_[fn->name] = task.get();
+    }
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+lower_func_ptr_t PipelinedCompiler::Lookup(absl::string_view fn_name) {
+  Task* task = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = fn2task_.find(fn_name);
+    if (it == fn2task_.end()) {
+      return nullptr;
+    }
+    task = it->second;
+  }
+  task->done.wait();
+  auto it = task->functions.find(fn_name);
+  return it == task->functions.end() ? nullptr : it->second;
+}
+
+void PipelinedCompiler::Wait() {
+  std::vector<std::shared_future<void>> futures;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& task : tasks_) {
+      futures.push_back(task->done);
+    }
+  }
+  for (auto& future : futures) {
+    future.wait();
+  }
+}
+
+void PipelinedCompiler::WorkerLoop() {
+  while (true) {
+    Task* task = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || next_task_ < tasks_.size(); });
+      if (stop_) {
+        return;
+      }
+      task = tasks_[next_task_++].get();
+    }
+    utils::Timer timer;
+    timer.Start();
+    task->compiler = Compiler::Create(target_);
+    task->compiler->Build(task->module);
+    // the functions are materialized by the JIT when looked up first, so they are looked up here in the background.
+    for (auto& fn : task->module.functions()) {
+      task->functions[fn->name] = task->compiler->Lookup(fn->name);
+    }
+    VLOG(3) << "Compile the module " << task->module.name() << " of " << task->functions.size() << " functions in "
+            << timer.Stop() << " ms";
+    task->promise.set_value();
+  }
+}
+
+}  // namespace backends
+}  // namespace cinn
@@ -0,0 +1,85 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/string_view.h>
+
+#include <condition_variable>  // NOLINT
+#include <future>              // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "cinn/backends/compiler.h"
+
+namespace cinn {
+namespace backends {
+
+/**
+ * PipelinedCompiler compiles the modules by the background threads in the order they are submitted, each module by
+ * a Compiler of its own, so the functions of the modules submitted first can be used while the later ones are still
+ * being lowered or compiled.
+ */
+class PipelinedCompiler final {
+ public:
+  PipelinedCompiler(const Target& target, int num_threads);
+
+  //! The modules not started compiling yet are dropped.
+  ~PipelinedCompiler();
+
+  /**
+   * Compile \p module in the background, the functions in it are ready to look up once it is compiled.
+   */
+  void Submit(const ir::Module& module);
+
+  /**
+   * Retrieve a function by \p fn_name, waiting until the module containing it is compiled.
+   * @return function address or null if not exists.
+   */
+  lower_func_ptr_t Lookup(absl::string_view fn_name);
+
+  //! Wait until all the submitted modules are compiled.
+  void Wait();
+
+ private:
+  struct Task {
+    ir::Module module;
+    std::unique_ptr<Compiler> compiler;
+    absl::flat_hash_map<std::string, lower_func_ptr_t> functions;
+    std::promise<void> promise;
+    std::shared_future<void> done;
+  };
+
+  void WorkerLoop();
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(PipelinedCompiler);
+
+  Target target_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  // the tasks in the submitted order, and the next one to compile.
+  std::vector<std::unique_ptr<Task>> tasks_;
+  size_t next_task_{0};
+  // mapping a function's name to the task of the module containing it
+  absl::flat_hash_map<std::string, Task*> fn2task_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace backends
+}  // namespace cinn
@@ -0,0 +1,105 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/common/csr_graph.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace cinn {
+namespace common {
+
+namespace {
+
+// Fill the CSR arrays of the edges got by \p get_edges, the other end of an edge is got by \p get_end.
+template <typename GetEdges, typename GetEnd>
+void BuildCsr(const std::vector<GraphNode*>& nodes,
+              const absl::flat_hash_map<const GraphNode*, int>& ids,
+              GetEdges get_edges,
+              GetEnd get_end,
+              std::vector<int>* offsets,
+              std::vector<int>* end_ids,
+              std::vector<GraphEdge*>* edges) {
+  offsets->reserve(nodes.size() + 1);
+  offsets->push_back(0);
+  for (auto* node : nodes) {
+    size_t begin = edges->size();
+    for (auto& edge : get_edges(node)) {
+      edges->push_back(edge.get());
+    }
+    std::sort(edges->begin() + begin, edges->end(), [](GraphEdge* a, GraphEdge* b) { return a->index() < b->index(); });
+    for (size_t i = begin; i < edges->size(); i++) {
+      auto it = ids.find(get_end((*edges)[i]));
+      CHECK(it != ids.end()) << "The node linked with " << node->id() << " is not in the graph";
+      end_ids->push_back(it->second);
+    }
+    offsets->push_back(edges->size());
+  }
+}
+
+}  // namespace
+
+CsrGraph::CsrGraph(const Graph& graph) {
+  // The same Kahn's algorithm as Graph::topological_order, with the indegrees kept in an array.
+  auto graph_nodes = graph.nodes();
+  absl::flat_hash_map<const GraphNode*, int> indegree;
+  indegree.reserve(graph_nodes.size());
+  nodes_.reserve(graph_nodes.size());
+  for (auto* node : graph_nodes) {
+    indegree[node] = node->inlinks().size();
+    if (node->inlinks().empty()) {
+      nodes_.push_back(const_cast<GraphNode*>(node));
+    }
+  }
+  for (size_t i = 0; i < nodes_.size(); i++) {
+    for (auto& edge : nodes_[i]->outlinks()) {
+      auto* sink = edge->sink();
+      if (--indegree[sink] == 0) {
+        nodes_.push_back(sink);
+      }
+    }
+  }
+  CHECK_EQ(nodes_.size(), graph_nodes.size()) << "circle detected in the graph:\n\n" << graph.Visualize();
+
+  ids_.reserve(nodes_.size());
+  for (int i = 0; i < nodes_.size(); i++) {
+    ids_[nodes_[i]] = i;
+  }
+  BuildCsr(
+      nodes_,
+      ids_,
+      [](GraphNode* node) -> decltype(auto) { return node->inlinks(); },
+      [](GraphEdge* edge) { return edge->source(); },
+      &in_offsets_,
+      &in_ids_,
+      &in_edges_);
+  BuildCsr(
+      nodes_,
+      ids_,
+      [](GraphNode* node) -> decltype(auto) { return node->outlinks(); },
+      [](GraphEdge* edge) { return edge->sink(); },
+      &out_offsets_,
+      &out_ids_,
+      &out_edges_);
+  VLOG(4) << "Built the CSR graph of " << num_nodes() << " nodes and " << num_edges() << " edges";
+}
+
+int CsrGraph::id(const GraphNode* node) const {
+  auto it = ids_.find(node);
+  return it == ids_.end() ? -1 : it->second;
+}
+
+}  // namespace common
+}  // namespace cinn
@@ -0,0 +1,83 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+//! \file This file contains an immutable index-based snapshot of a graph.
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/types/span.h>
+
+#include <vector>
+
+#include "cinn/common/graph_utils.h"
+
+namespace cinn {
+namespace common {
+
+/**
+ * \brief An immutable snapshot of the topology of a Graph in the compressed sparse row format.
+ *
+ * The nodes are numbered from 0 in the topological order of the graph, which is the same order as
+ * Graph::topological_order gives, so a node's id is also its position in the order. The edges of all the nodes are
+ * kept in contiguous arrays sorted by the edge indices, so the inputs and outputs of an op are in order.
+ *
+ * The snapshot is built once in O(V + E) and queried without touching the ordered sets of the nodes, passes should
+ * build a new one after they change the graph.
+ */
+class CsrGraph {
+ public:
+  explicit CsrGraph(const Graph& graph);
+
+  int num_nodes() const { return nodes_.size(); }
+  int num_edges() const { return in_edges_.size(); }
+
+  GraphNode* node(int id) const { return nodes_[id]; }
+  //! Get the id of \p node, -1 if it is not in the graph.
+  int id(const GraphNode* node) const;
+
+  //! The nodes in topological order, that is node(0), node(1), ...
+  const std::vector<GraphNode*>& topological_order() const { return nodes_; }
+
+  //! The ids of the source nodes of the input edges of a node, in the order of the edge indices.
+  absl::Span<const int> producers(int id) const { return Slice(in_offsets_, in_ids_, id); }
+  //! The ids of the sink nodes of the output edges of a node, in the order of the edge indices.
+  absl::Span<const int> consumers(int id) const { return Slice(out_offsets_, out_ids_, id); }
+
+  //! The input edges of a node, in the order of the edge indices.
+  absl::Span<GraphEdge* const> in_edges(int id) const { return Slice(in_offsets_, in_edges_, id); }
+  //! The output edges of a node, in the order of the edge indices.
+  absl::Span<GraphEdge* const> out_edges(int id) const { return Slice(out_offsets_, out_edges_, id); }
+
+ private:
+  template <typename T>
+  static absl::Span<const T> Slice(const std::vector<int>& offsets, const std::vector<T>& values, int id) {
+    return absl::Span<const T>(values.data() + offsets[id], offsets[id + 1] - offsets[id]);
+  }
+
+  std::vector<GraphNode*> nodes_;
+  absl::flat_hash_map<const GraphNode*, int> ids_;
+
+  //! The edges of node i are in [offsets[i], offsets[i + 1]) of the arrays.
+  //! @{
+  std::vector<int> in_offsets_;
+  std::vector<int> in_ids_;
+  std::vector<GraphEdge*> in_edges_;
+  std::vector<int> out_offsets_;
+  std::vector<int> out_ids_;
+  std::vector<GraphEdge*> out_edges_;
+  //! @}
+};
+
+}  // namespace common
+}  // namespace cinn
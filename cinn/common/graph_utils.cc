@@ -75,9 +75,10 @@ std::tuple<std::vector<GraphNode *>, std::vector<GraphEdge *>> Graph::topologica
   std::deque<GraphNode *> queue;
 
   // collect indegreee.
-  std::map<std::string, int> indegree;
+  absl::flat_hash_map<const GraphNode *, int> indegree;
+  indegree.reserve(nodes_.size());
   for (auto *n : nodes()) {
-    indegree[n->id()] = n->inlinks().size();
+    indegree[n] = n->inlinks().size();
   }
 
   // insert start points first.
@@ -99,7 +100,7 @@ std::tuple<std::vector<GraphNode *>, std::vector<GraphEdge *>> Graph::topologica
       CHECK_EQ(edge->source(), top_node);
       edge_order.push_back(edge.get());
       auto *sink = edge->sink();
-      if ((--indegree[sink->id()]) == 0) {
+      if ((--indegree[sink]) == 0) {
         queue.push_back(sink);
       }
     }
@@ -131,6 +132,8 @@ std::vector<GraphNode *> Graph::start_points() {
 GraphNode *Graph::RegisterNode(size_t key, GraphNode *node) {
   registry_.emplace(key, node);
   nodes_.emplace_back(node);
+  node->graph_ = this;
+  UpdateTopologyVersion();
   return node;
 }
 
@@ -173,7 +176,11 @@ void Graph::ClearUnlinkedNodes(absl::flat_hash_map<std::string, std::vector<int>
     auto node = *it;
     if (node->inlinks().empty() && node->outlinks().empty()) {
       VLOG(2) << "delete unlinked node: " << node->id();
+      if (node->graph_ == this) {
+        node->graph_ = nullptr;
+      }
       nodes_.erase(it);
+      UpdateTopologyVersion();
       if (shape_dict->count(node->id())) {
         shape_dict->erase(node->id());
       }
@@ -190,6 +197,24 @@ void Graph::ClearUnlinkedNodes(absl::flat_hash_map<std::string, std::vector<int>
 
 const char *GraphNode::__type_info__ = "GraphNode";
 
+void GraphNode::UpdateTopologyVersion(GraphNode *other) {
+  if (graph_) {
+    graph_->UpdateTopologyVersion();
+  }
+  if (other->graph_ && other->graph_ != graph_) {
+    other->graph_->UpdateTopologyVersion();
+  }
+}
+
+Graph::~Graph() {
+  // the nodes may be kept alive by others, so they should not update the versions of the graph any more.
+  for (auto &node : nodes_) {
+    if (node->graph_ == this) {
+      node->graph_ = nullptr;
+    }
+  }
+}
+
 bool GraphEdgeCompare::operator()(const Shared<GraphEdge> &a, const Shared<GraphEdge> &b) const {
   if (a->source()->id() == b->source()->id()) {
     if (a->sink()->id() == b->sink()->id()) {
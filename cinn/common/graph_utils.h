@@ -39,6 +39,7 @@ namespace common {
 #undef As
 #endif
 
+class Graph;
 class GraphNode;
 
 /**
@@ -91,6 +92,7 @@ class GraphNode : public Object {
     other->index_inlinks++;
     outlinks_.insert(outlink_edge);
     other->inlinks_.insert(inlink_edge);
+    UpdateTopologyVersion(other);
 
     for (auto& item : outlinks_) {
       if (item->index() == index_outlinks - 1) {
@@ -133,6 +135,7 @@ class GraphNode : public Object {
 
   void UnLinkAllTo(GraphNode* other) {
     if (other == this) return;
+    UpdateTopologyVersion(other);
     // remove all this node's outlink
     {
       auto it = std::find_if(outlinks_.begin(), outlinks_.end(), [&](const Shared<GraphEdge>& x) {
@@ -161,6 +164,7 @@ class GraphNode : public Object {
 
   void UnLinkSingleTo(GraphNode* other) {
     if (other == this) return;
+    UpdateTopologyVersion(other);
     // remove single outlink
     {
       auto it = std::find_if(outlinks_.begin(), outlinks_.end(), [&](const Shared<GraphEdge>& x) {
@@ -189,6 +193,9 @@ class GraphNode : public Object {
   //! Get the output links of the node.
   virtual const std::set<Shared<GraphEdge>, GraphEdgeCompare>& outlinks() const { return outlinks_; }
 
+  //! The graph the node is registered to last, nullptr if it is not registered or dropped from the graph.
+  Graph* graph() const { return graph_; }
+
   //! Reset graph traversal meta info.
   void ResetVisitMeta() { visited_time_ = 0; }
   void VisitOnce() const { visited_time_++; }
@@ -213,6 +220,14 @@ class GraphNode : public Object {
   int index_inlinks{0};
   int index_outlinks{0};
   int index{0};
+
+ private:
+  friend class Graph;
+
+  //! Update the topology versions of the graphs of this node and \p other, as a link between them is changed.
+  void UpdateTopologyVersion(GraphNode* other);
+
+  Graph* graph_{};
 };
 
 /**
@@ -223,6 +238,8 @@ class Graph {
   using node_order_t = std::vector<GraphNode*>;
   using edge_order_t = std::vector<GraphEdge*>;
 
+  ~Graph();
+
   //! Add a node to the graph.
   //! @{
   GraphNode* RegisterNode(size_t key, GraphNode* node);
@@ -257,7 +274,11 @@ class Graph {
   void DropNode(GraphNode* n) {
     auto it = std::find_if(nodes_.begin(), nodes_.end(), [&](auto& x) { return x.get() == n; });
     if (it != nodes_.end()) {
+      if (n->graph_ == this) {
+        n->graph_ = nullptr;
+      }
       nodes_.erase(it);
+      UpdateTopologyVersion();
     }
   }
 
@@ -270,11 +291,19 @@ class Graph {
 
   size_t num_nodes() const { return nodes_.size(); }
 
+  //! The version of the topology of the graph, which changes whenever a link of its nodes is added or removed, or a
+  //! node is registered to or dropped from it, so the analyses cached on the graph can tell whether they are stale.
+  //! @{
+  uint64_t topology_version() const { return topology_version_; }
+  void UpdateTopologyVersion() { ++topology_version_; }
+  //! @}
+
  protected:
   //! A lookup table that map from hash key to graph node, note that it doesn't own the graph node.
-  std::map<size_t, GraphNode*> registry_;
+  absl::flat_hash_map<size_t, GraphNode*> registry_;
   //! A list owns the graph nodes.
   std::vector<Shared<GraphNode>> nodes_;
+  uint64_t topology_version_{0};
 };
 
 }  // namespace common
@@ -64,6 +64,9 @@ std::ostream &operator<<(std::ostream &os, Type::type_t t) {
     case Type::type_t::Float:
       os << "Float";
       break;
+    case Type::type_t::BFloat:
+      os << "BFloat";
+      break;
     case Type::type_t::Unk:
       os << "Unk";
       break;
@@ -211,6 +214,8 @@ bool Type::is_void() const { return type() == type_t::Void; }
 bool Type::is_vector() const { return lanes() > 1; }
 bool Type::is_scalar() const { return lanes() == 1; }
 bool Type::is_float(int bits) const { return type() == type_t::Float && (bits < 0 || bits == this->bits()); }
+bool Type::is_float16() const { return type() == type_t::Float && bits() == 16; }
+bool Type::is_bfloat16() const { return type() == type_t::BFloat && bits() == 16; }
 bool Type::is_uint(int bits) const { return type() == type_t::UInt && (bits < 0 || bits == this->bits()); }
 bool Type::is_int(int bits) const { return type() == type_t::Int && (bits < 0 || bits == this->bits()); }
 bool Type::is_integer(int bits) const {
@@ -253,6 +258,10 @@ const Type &F16() {
   static auto t = Float(16);
   return t;
 }
+const Type &BF16() {
+  static auto t = BFloat(16);
+  return t;
+}
 const Type &F32() {
   static auto t = Float(32);
   return t;
@@ -352,6 +361,8 @@ Type Str2Type(const std::string &type) {
       {"float16", F16()},
       {"half", F16()},
 
+      {"bfloat16", BF16()},
+
       {"float", F32()},
       {"float32", F32()},
 
@@ -387,6 +398,9 @@ std::string Type2Str(const Type &type) {
     case Type::type_t::Float:
       return "float" + std::to_string(type.bits());
 
+    case Type::type_t::BFloat:
+      return "bfloat" + std::to_string(type.bits());
+
     case Type::type_t::Void:
       return "void";
 
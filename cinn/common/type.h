@@ -37,6 +37,7 @@ struct Type {
     Int,
     UInt,
     Float,
+    BFloat,  // brain floating point, 16 bits with the same exponent range as float32
     String,
     Void,
     // stupid idea to mix the Customized with other primitive types, large refactor needs here.
@@ -68,7 +69,10 @@ struct Type {
   CINN_NODISCARD bool is_bool() const;
   CINN_NODISCARD bool is_vector() const;
   CINN_NODISCARD bool is_scalar() const;
+  //! NOTE: bfloat16 is a type of its own and does not satisfy is_float(), check is_bfloat16() where it is accepted.
   CINN_NODISCARD bool is_float(int bits = -1) const;
+  CINN_NODISCARD bool is_float16() const;
+  CINN_NODISCARD bool is_bfloat16() const;
   CINN_NODISCARD bool is_int(int bits = -1) const;
   CINN_NODISCARD bool is_integer(int bits = -1) const;
   CINN_NODISCARD bool is_uint(int bits = -1) const;
@@ -141,12 +145,14 @@ inline Type Void() { return Type(Type::type_t ::Void, 1, 0); }
 inline Type Int(int bits, int lanes = 1) { return Type(Type::type_t ::Int, bits, lanes); }
 inline Type UInt(int bits, int lanes = 1) { return Type(Type::type_t ::UInt, bits, lanes); }
 inline Type Float(int bits, int lanes = 1) { return Type(Type::type_t ::Float, bits, lanes); }
+inline Type BFloat(int bits, int lanes = 1) { return Type(Type::type_t ::BFloat, bits, lanes); }
 inline Type Bool(int lanes = 1) { return Type(Type::type_t ::UInt, 1, lanes); }
 inline Type String() { return Type(Type::type_t::String, 1, 1); }
 
 //! Builtin native types as global singletons.
 // @{
 const Type& F16();
+const Type& BF16();
 const Type& F32();
 const Type& F64();
 const Type& I8();
@@ -28,4 +28,17 @@ TEST(Type, basic) {
   LOG(INFO) << type_of<float>();
 }
 
+TEST(Type, low_precision_float) {
+  ASSERT_TRUE(F16().is_float16());
+  ASSERT_FALSE(F16().is_bfloat16());
+  ASSERT_TRUE(BF16().is_bfloat16());
+  ASSERT_FALSE(BF16().is_float(16));
+  ASSERT_NE(F16(), BF16());
+
+  ASSERT_EQ(Str2Type("float16"), F16());
+  ASSERT_EQ(Str2Type("bfloat16"), BF16());
+  ASSERT_EQ(Type2Str(F16()), "float16");
+  ASSERT_EQ(Type2Str(BF16()), "bfloat16");
+}
+
 }  // namespace cinn::common
@@ -76,7 +76,7 @@ class BaseBuilder {
    * @param keep_dim If it is set true, the axes which are reduced are left in the result as dimensions with size one.
    * With this option, the result will broadcast correctly against the input array.
    *
-   * @return The result variable.
+   * @return The result variable. For float16 and bfloat16 inputs, the result is accumulated and returned in float32.
    */
   Variable Reduce(const Variable& operand, ReduceKind kind, const std::vector<int>& dim, bool keep_dim = false);
 
@@ -14,6 +14,10 @@
 
 #include "cinn/frontend/computation.h"
 
+#include <absl/container/flat_hash_map.h>
+
+#include <algorithm>
+
 #include "cinn/frontend/program_pass.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/graph_compiler.h"
@@ -35,6 +39,7 @@ struct ComputationContext {
 
   std::vector<hlir::framework::Tensor> inputs;
   std::vector<hlir::framework::Tensor> outputs;
+  std::vector<std::string> input_names;
   std::unordered_map<std::string, Variable> varmap;
   std::unordered_map<std::string, std::string> varmap_paddle2program;
 };
@@ -85,6 +90,7 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
   for (auto &in_v : program.GetInputs()) {
     hlir::framework::Tensor t = ctx->scope->GetTensor(in_v->id);
     ctx->inputs.push_back(t);
+    ctx->input_names.push_back(in_v->id);
   }
   for (auto &out_v : outputs) {
     hlir::framework::Tensor t = ctx->scope->GetTensor(out_v->id);
@@ -93,6 +99,90 @@ std::shared_ptr<ComputationContext> CompileProgram(const Target &target,
   return ctx;
 }
 
+namespace {
+
+void CopyToTensor(hlir::framework::Tensor &t, const Target &target, const void *data, size_t size) {
+  void *tdata = t->mutable_data(target, t->type());
+  CHECK_EQ(size, (t->shape().numel() * t->type().bits() + 7) / 8);
+  if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    CUDA_CALL(cudaMemcpy(tdata, data, size, cudaMemcpyHostToDevice));
+#else
+    CINN_NOT_IMPLEMENTED
+#endif
+  } else if (target.arch == Target::Arch::X86) {
+    memcpy(tdata, data, size);
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+}
+
+void CopyFromTensor(hlir::framework::Tensor &t, const Target &target, void *data, size_t size) {
+  void *tdata = t->mutable_data(target, t->type());
+  CHECK_EQ(size, (t->shape().numel() * t->type().bits() + 7) / 8);
+  if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    CUDA_CALL(cudaMemcpy(data, tdata, size, cudaMemcpyDeviceToHost));
+#else
+    CINN_NOT_IMPLEMENTED
+#endif
+  } else if (target.arch == Target::Arch::X86) {
+    memcpy(data, tdata, size);
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+}
+
+// Copy \p src into a new buffer with its contents, the tensors sharing a buffer share the copy too.
+hlir::framework::Tensor CopyTensor(
+    hlir::framework::Tensor &src,
+    const Target &target,
+    absl::flat_hash_map<hlir::framework::Buffer *, std::shared_ptr<hlir::framework::Buffer>> *copied_buffers) {
+  auto &buffer = (*copied_buffers)[src->get_buffer().get()];
+  if (!buffer) {
+    auto *src_data = src->buffer();
+    size_t size    = std::max<size_t>(src_data->memory_size, (src->shape().numel() * src->type().bits() + 7) / 8);
+    buffer         = std::make_shared<hlir::framework::Buffer>(target);
+    if (target == common::DefaultHostTarget()) {
+      buffer->ResizeLazy(1024, size);
+    } else {
+      buffer->ResizeLazy(size);
+    }
+    if (src_data->memory) {
+      if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+        CUDA_CALL(
+            cudaMemcpy(buffer->data()->memory, src_data->memory, src_data->memory_size, cudaMemcpyDeviceToDevice));
+#else
+        CINN_NOT_IMPLEMENTED
+#endif
+      } else {
+        memcpy(buffer->data()->memory, src_data->memory, src_data->memory_size);
+      }
+    }
+  }
+  hlir::framework::Tensor dst;
+  dst->set_buffer(buffer);
+  dst->Resize(src->shape());
+  dst->set_type(src->type());
+  return dst;
+}
+
+// Get the name of the variable in the scope, which is \p tname or the one of the paddle variable called \p tname.
+std::string GetVarName(const ComputationContext &ctx, const std::string &tname) {
+  if (ctx.scope->FindVar(tname)) {
+    return tname;
+  }
+  auto it = ctx.varmap_paddle2program.find(tname);
+  if (it == ctx.varmap_paddle2program.end()) {
+    LOG(FATAL) << "No variable called [" << tname
+               << "] found in computation\nThe existing vars: " << utils::Join(ctx.scope->var_names(), ", ");
+  }
+  return it->second;
+}
+
+}  // namespace
+
 std::vector<std::string> CinnComputation::GetAllTensorNames() {
   std::vector<std::string> res;
   for (auto &v : context_->scope->var_names()) {
@@ -180,34 +270,10 @@ void CinnComputation::SetTensorData(const std::string &tname, void *data, size_t
 }
 
 void CinnComputation::SetTensorData(hlir::framework::Tensor &t, void *data, size_t size) {
-  void *tdata = t->mutable_data(context_->target, t->type());
-  CHECK_EQ(size, (t->shape().numel() * t->type().bits() + 7) / 8);
-  if (context_->target.arch == Target::Arch::NVGPU) {
-#ifdef CINN_WITH_CUDA
-    CUDA_CALL(cudaMemcpy(tdata, data, size, cudaMemcpyHostToDevice));
-#else
-    CINN_NOT_IMPLEMENTED
-#endif
-  } else if (context_->target.arch == Target::Arch::X86) {
-    memcpy(tdata, data, size);
-  } else {
-    CINN_NOT_IMPLEMENTED
-  }
+  CopyToTensor(t, context_->target, data, size);
 }
 void CinnComputation::GetTensorData(hlir::framework::Tensor &t, void *data, size_t size) {
-  void *tdata = t->mutable_data(context_->target, t->type());
-  CHECK_EQ(size, (t->shape().numel() * t->type().bits() + 7) / 8);
-  if (context_->target.arch == Target::Arch::NVGPU) {
-#ifdef CINN_WITH_CUDA
-    CUDA_CALL(cudaMemcpy(data, tdata, size, cudaMemcpyDeviceToHost));
-#else
-    CINN_NOT_IMPLEMENTED
-#endif
-  } else if (context_->target.arch == Target::Arch::X86) {
-    memcpy(data, tdata, size);
-  } else {
-    CINN_NOT_IMPLEMENTED
-  }
+  CopyFromTensor(t, context_->target, data, size);
 }
 
 void CinnComputation::GetTensorData(const std::string &tname, void *data, size_t size) {
@@ -215,25 +281,100 @@ void CinnComputation::GetTensorData(const std::string &tname, void *data, size_t
   GetTensorData(t, data, size);
 }
 
+void CinnComputation::BindTensorData(hlir::framework::Tensor &t,
+                                     void *data,
+                                     size_t size,
+                                     std::shared_ptr<void> holder) {
+  CHECK_EQ(size, (t->shape().numel() * t->type().bits() + 7) / 8);
+  t->ShareExternalData(data, context_->target, t->type(), std::move(holder));
+}
+
+void CinnComputation::BindTensorData(const std::string &tname,
+                                     void *data,
+                                     size_t size,
+                                     std::shared_ptr<void> holder) {
+  hlir::framework::Tensor t = GetTensor(tname);
+  BindTensorData(t, data, size, std::move(holder));
+}
+
+const Target &CinnComputation::GetTarget() const { return context_->target; }
+
+std::shared_ptr<hlir::framework::Graph> CinnComputation::GetGraph() const { return context_->graph; }
+
 std::vector<hlir::framework::Tensor> CinnComputation::GetInputTensors() { return context_->inputs; }
 
 std::vector<hlir::framework::Tensor> CinnComputation::GetOutputTensors() { return context_->outputs; }
 
 hlir::framework::Tensor CinnComputation::GetTensor(const std::string &tname) {
-  if (context_->scope->FindVar(tname)) {
-    return context_->scope->GetTensor(tname);
-  }
-  auto it = context_->varmap_paddle2program.find(tname);
-  if (it == context_->varmap_paddle2program.end()) {
-    LOG(FATAL) << "No variable called [" << tname
-               << "] found in computation\nThe existing vars: " << utils::Join(context_->scope->var_names(), ", ");
-  }
-  return context_->scope->GetTensor(it->second);
+  return context_->scope->GetTensor(GetVarName(*context_, tname));
 }
 
 void CinnComputation::Execute(const std::map<std::string, cinn_pod_value_t> *name2podargs) {
   context_->program->Execute(name2podargs, context_->stream);
 }
 
+std::shared_ptr<CinnExecutionContext> CinnComputation::CreateExecutionContext(
+    const std::vector<std::string> &input_names, void *stream) {
+  std::unordered_set<std::string> copied_vars;
+  for (auto &name : input_names.empty() ? context_->input_names : input_names) {
+    copied_vars.insert(GetVarName(*context_, name));
+  }
+  for (auto &ins : context_->program->GetRunInstructions()) {
+    for (auto &out_args : ins->GetOutArgs()) {
+      copied_vars.insert(out_args.begin(), out_args.end());
+    }
+  }
+
+  auto scope = std::make_shared<hlir::framework::Scope>();
+  absl::flat_hash_map<hlir::framework::Buffer *, std::shared_ptr<hlir::framework::Buffer>> copied_buffers;
+  for (auto &name : context_->scope->var_names()) {
+    std::string var_name(name);
+    auto src = context_->scope->GetTensor(var_name);
+    auto dst = copied_vars.count(var_name) ? CopyTensor(src, context_->target, &copied_buffers) : src;
+    absl::get<hlir::framework::Tensor>(*scope->Var<hlir::framework::Tensor>(var_name)) = dst;
+  }
+  VLOG(3) << "Create an execution context with " << copied_vars.size() << " of " << context_->scope->var_names().size()
+          << " tensors copied";
+  auto program = context_->program->Clone(scope);
+  return std::make_shared<CinnExecutionContext>(
+      context_, std::move(scope), std::move(program), stream ? stream : context_->stream);
+}
+
+CinnExecutionContext::CinnExecutionContext(std::shared_ptr<ComputationContext> computation,
+                                           std::shared_ptr<hlir::framework::Scope> scope,
+                                           std::unique_ptr<hlir::framework::Program> program,
+                                           void *stream)
+    : computation_(std::move(computation)), scope_(std::move(scope)), program_(std::move(program)), stream_(stream) {}
+
+hlir::framework::Tensor CinnExecutionContext::GetTensor(const std::string &name) {
+  return scope_->GetTensor(GetVarName(*computation_, name));
+}
+
+hlir::framework::Tensor CinnExecutionContext::GetWritableTensor(const std::string &tname) {
+  auto var_name = GetVarName(*computation_, tname);
+  auto t        = scope_->GetTensor(var_name);
+  CHECK(t->get_buffer() != computation_->scope->GetTensor(var_name)->get_buffer())
+      << "The tensor [" << tname << "] is shared with the computation, add it to the input names of the context";
+  return t;
+}
+
+void CinnExecutionContext::SetTensorData(const std::string &tname, void *data, size_t size) {
+  auto t = GetWritableTensor(tname);
+  CopyToTensor(t, computation_->target, data, size);
+}
+
+void CinnExecutionContext::GetTensorData(const std::string &tname, void *data, size_t size) {
+  auto t = GetTensor(tname);
+  CopyFromTensor(t, computation_->target, data, size);
+}
+
+void CinnExecutionContext::BindTensorData(const std::string &tname, void *data, size_t size) {
+  auto t = GetWritableTensor(tname);
+  CHECK_EQ(size, (t->shape().numel() * t->type().bits() + 7) / 8);
+  t->ShareExternalData(data, computation_->target, t->type());
+}
+
+void CinnExecutionContext::Execute() { program_->Execute(nullptr, stream_); }
+
 }  // namespace frontend
 }  // namespace cinn
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "cinn/frontend/base_builder.h"
 #include "cinn/frontend/syntax.h"
@@ -23,6 +26,7 @@ namespace cinn {
 namespace frontend {
 
 struct ComputationContext;
+class CinnExecutionContext;
 
 class CinnComputation {
  public:
@@ -148,14 +152,115 @@ class CinnComputation {
    */
   void GetTensorData(const std::string &tname, void *data, size_t size);
 
+  /**
+   * bind a user specified buffer as the memory of a tensor, no copy is made.
+   * the buffer should be in the memory of the target, i.e. the device memory if the target is NVGPU,
+   * and outlive the executions using the tensor, or be kept alive by the holder.
+   * @param t the tensor
+   * @param data address of the memory buffer holding tensor's data
+   * @param size size of the memory buffer
+   * @param holder optional owner of the memory buffer, released when the tensor is rebound or destroyed
+   */
+  void BindTensorData(hlir::framework::Tensor &t, void *data, size_t size, std::shared_ptr<void> holder = nullptr);
+
+  /**
+   * bind a user specified buffer as the memory of a tensor (specified by it's name), no copy is made.
+   * @param tname name of the tensor
+   * @param data address of the memory buffer holding tensor's data
+   * @param size size of the memory buffer
+   * @param holder optional owner of the memory buffer, released when the tensor is rebound or destroyed
+   */
+  void BindTensorData(const std::string &tname, void *data, size_t size, std::shared_ptr<void> holder = nullptr);
+
+  /**
+   * get the target the program runs on
+   */
+  const Target &GetTarget() const;
+
+  /**
+   * get the graph the program is compiled from
+   */
+  std::shared_ptr<hlir::framework::Graph> GetGraph() const;
+
   /**
    * run the compiled program
    */
   void Execute(const std::map<std::string, cinn_pod_value_t> *name2podargs = nullptr);
 
+  /**
+   * create an execution context to serve a request, which runs the compiled kernels on its own tensors.
+   * the tensors written by the program and the request inputs are copied into the context, the other ones, such as
+   * the parameters, are shared read-only with the computation. different contexts can be executed concurrently.
+   * @param input_names names of the tensors fed per request, all the inputs of the program if it is empty
+   * @param stream CUDA stream to run the context, the stream of the computation is used if it is null
+   * @return shared_ptr pointing to CinnExecutionContext instance
+   */
+  std::shared_ptr<CinnExecutionContext> CreateExecutionContext(const std::vector<std::string> &input_names = {},
+                                                               void *stream = nullptr);
+
  private:
   std::shared_ptr<ComputationContext> context_;
 };
 
+/**
+ * CinnExecutionContext holds the tensors of a request and a copy of the runtime program bound to them, the compiled
+ * kernels and the read-only tensors are shared with the CinnComputation creating it. A context is used by one thread
+ * at a time.
+ */
+class CinnExecutionContext {
+ public:
+  CinnExecutionContext(std::shared_ptr<ComputationContext> computation,
+                       std::shared_ptr<hlir::framework::Scope> scope,
+                       std::unique_ptr<hlir::framework::Program> program,
+                       void *stream);
+
+  /**
+   * get tensor by name, the tensors shared with the computation should not be written
+   * @param name tensor name
+   */
+  hlir::framework::Tensor GetTensor(const std::string &name);
+
+  /**
+   * set the data of a tensor (specified by it's name) from user specified buffer.
+   * if tensor is in NVGPU device memory, cudaMemcpy is used.
+   * @param tname name of the tensor
+   * @param data address of the memory buffer to store tensor's data
+   * @param size size of the memory buffer
+   */
+  void SetTensorData(const std::string &tname, void *data, size_t size);
+
+  /**
+   * copy the data of a tensor (specified by it's name) to user specified buffer.
+   * if tensor is in NVGPU device memory, cudaMemcpy is used.
+   * @param tname name of the tensor
+   * @param data address of the memory buffer to store tensor's data
+   * @param size size of the memory buffer
+   */
+  void GetTensorData(const std::string &tname, void *data, size_t size);
+
+  /**
+   * bind a user specified buffer as the memory of a tensor (specified by it's name), no copy is made.
+   * the buffer should be in the memory of the target and outlive the executions using the tensor.
+   * @param tname name of the tensor
+   * @param data address of the memory buffer holding tensor's data
+   * @param size size of the memory buffer
+   */
+  void BindTensorData(const std::string &tname, void *data, size_t size);
+
+  /**
+   * run the compiled program on the tensors of this context
+   */
+  void Execute();
+
+ private:
+  //! Check the tensor is owned by this context before writing it.
+  hlir::framework::Tensor GetWritableTensor(const std::string &tname);
+
+  std::shared_ptr<ComputationContext> computation_;
+  std::shared_ptr<hlir::framework::Scope> scope_;
+  std::unique_ptr<hlir::framework::Program> program_;
+  void *stream_;
+};
+
 }  // namespace frontend
 }  // namespace cinn
@@ -24,7 +24,9 @@ namespace cinn::frontend {
 
 struct Interpreter::Impl {
   Impl(const std::vector<std::string>& input_names, const std::vector<hlir::framework::shape_t>& input_shapes)
-      : scope_(std::make_shared<hlir::framework::Scope>()), input_names_(input_names), input_shapes_(input_shapes) {}
+      : scope_(std::make_shared<hlir::framework::Scope>()), input_names_(input_names), input_shapes_(input_shapes) {
+    param_scope_ = scope_;
+  }
 
   /**
    * Build the model.
@@ -36,13 +38,36 @@ struct Interpreter::Impl {
              const Target& target,
              const std::string& model_name = "");
 
+  //! Whether the leading dimension of some input is dynamic.
+  bool HasDynamicBatch() const;
+
+  //! Get the bucket batch size to compile for \p batch_size.
+  int GetBucket(int batch_size) const;
+
+  //! Compile the specialization for \p batch and make it the current one.
+  void BuildSpecialization(int batch);
+
  private:
   friend class Interpreter;
 
+  //! A model compiled for a fixed batch size.
+  struct Specialization {
+    std::shared_ptr<hlir::framework::Scope> scope;
+    std::unique_ptr<hlir::framework::GraphCompiler> graph_compiler;
+    std::unique_ptr<hlir::framework::Program> runtime_program;
+  };
+
   std::vector<std::string> input_names_;
   absl::flat_hash_set<std::string> fetch_names_;
   std::vector<hlir::framework::shape_t> input_shapes_;
 
+  Target target_;
+  std::string model_name_;
+  std::vector<int> batch_buckets_;
+  absl::flat_hash_map<int, Specialization> specializations_;
+
+  // The scope holding the loaded parameters, which are shared by all the specializations.
+  std::shared_ptr<hlir::framework::Scope> param_scope_;
   std::shared_ptr<hlir::framework::Scope> scope_;
   std::unique_ptr<frontend::Program> program_;
   std::unique_ptr<hlir::framework::GraphCompiler> graph_compiler_;
@@ -53,13 +78,15 @@ struct Interpreter::Impl {
 
   std::unique_ptr<hlir::framework::Program> runtime_program_;
   std::unique_ptr<hlir::framework::Program> prerun_program_;
+  // The runtime program of the current specialization.
+  hlir::framework::Program* current_program_{nullptr};
 };
 
 void Interpreter::LoadPaddleModel(const std::string& model_dir,
                                   const Target& target,
                                   bool params_combined,
                                   const std::string& model_name) {
-  auto programTuple               = LoadPaddleProgram(model_dir, impl_->scope_.get(), params_combined, target);
+  auto programTuple               = LoadPaddleProgram(model_dir, impl_->param_scope_.get(), params_combined, target);
   auto& program                   = std::get<0>(programTuple);
   auto& var_map                   = std::get<1>(programTuple);
   auto& var_map_paddle_to_program = std::get<2>(programTuple);
@@ -68,11 +95,46 @@ void Interpreter::LoadPaddleModel(const std::string& model_dir,
   impl_->var_map_                = var_map;
   impl_->var_map_paddle_to_cinn_ = var_map_paddle_to_program;
   impl_->fetch_names_            = fetch_names;
-
+  impl_->target_                 = target;
+  impl_->model_name_             = model_name;
+
+  if (impl_->HasDynamicBatch()) {
+    // the specializations are compiled lazily in SetBatchSize
+    impl_->specializations_.clear();
+    impl_->current_program_ = nullptr;
+    return;
+  }
   impl_->Build(impl_->input_names_, impl_->input_shapes_, target, model_name);
+  impl_->current_program_ = impl_->runtime_program_.get();
 }
 
-void Interpreter::Run() { impl_->runtime_program_->Execute(); }
+void Interpreter::SetBatchBuckets(const std::vector<int>& buckets) {
+  for (int bucket : buckets) {
+    CHECK_GT(bucket, 0) << "The batch bucket should be positive, but get " << bucket;
+  }
+  impl_->batch_buckets_ = buckets;
+  std::sort(impl_->batch_buckets_.begin(), impl_->batch_buckets_.end());
+}
+
+int Interpreter::SetBatchSize(int batch_size) {
+  CHECK(impl_->HasDynamicBatch()) << "The model has no dynamic batch dimension, its input shapes are fixed.";
+  CHECK(impl_->program_) << "The model should be loaded before setting the batch size.";
+  CHECK_GT(batch_size, 0) << "The batch size should be positive, but get " << batch_size;
+  int batch = impl_->GetBucket(batch_size);
+  auto it   = impl_->specializations_.find(batch);
+  if (it == impl_->specializations_.end()) {
+    impl_->BuildSpecialization(batch);
+  } else {
+    impl_->scope_           = it->second.scope;
+    impl_->current_program_ = it->second.runtime_program.get();
+  }
+  return batch;
+}
+
+void Interpreter::Run() {
+  CHECK(impl_->current_program_) << "No program is compiled, call SetBatchSize first for a model with dynamic batch.";
+  impl_->current_program_->Execute();
+}
 
 hlir::framework::Tensor Interpreter::GetTensor(const std::string& name) {
   if (impl_->scope_->FindVar(name)) return impl_->scope_->GetTensor(name);
@@ -85,6 +147,50 @@ hlir::framework::Tensor Interpreter::GetTensor(const std::string& name) {
   return impl_->scope_->GetTensor(it->second);
 }
 
+void Interpreter::BindTensorData(const std::string& name, void* data) {
+  auto tensor = GetTensor(name);
+  CHECK(tensor->type().valid()) << "The type of variable [" << name << "] is not inferred yet";
+  tensor->ShareExternalData(data, impl_->target_, tensor->type());
+}
+
+bool Interpreter::Impl::HasDynamicBatch() const {
+  return std::any_of(input_shapes_.begin(), input_shapes_.end(), [](const hlir::framework::shape_t& shape) {
+    return !shape.empty() && shape[0] == -1;
+  });
+}
+
+int Interpreter::Impl::GetBucket(int batch_size) const {
+  auto it = std::lower_bound(batch_buckets_.begin(), batch_buckets_.end(), batch_size);
+  if (it != batch_buckets_.end()) return *it;
+  if (!batch_buckets_.empty()) {
+    LOG(WARNING) << "The batch size " << batch_size << " exceeds the largest bucket " << batch_buckets_.back()
+                 << ", compile a specialization for it.";
+  }
+  return batch_size;
+}
+
+void Interpreter::Impl::BuildSpecialization(int batch) {
+  VLOG(3) << "Compile the specialization of batch size " << batch;
+  auto input_shapes = input_shapes_;
+  for (auto& shape : input_shapes) {
+    if (!shape.empty() && shape[0] == -1) shape[0] = batch;
+  }
+
+  // Each specialization has its own scope for the activations, and shares the parameter tensors.
+  scope_ = std::make_shared<hlir::framework::Scope>();
+  for (auto& name : param_scope_->var_names()) {
+    std::string var_name(name);
+    *scope_->Var<hlir::framework::Tensor>(var_name) = *param_scope_->FindVar(var_name);
+  }
+  Build(input_names_, input_shapes, target_, model_name_);
+
+  auto& specialization           = specializations_[batch];
+  specialization.scope           = scope_;
+  specialization.graph_compiler  = std::move(graph_compiler_);
+  specialization.runtime_program = std::move(runtime_program_);
+  current_program_               = specialization.runtime_program.get();
+}
+
 void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
                               const std::vector<hlir::framework::shape_t>& input_shapes,
                               const Target& target,
@@ -100,7 +206,10 @@ void Interpreter::Impl::Build(const std::vector<std::string>& input_names,
 
   for (int i = 0; i < input_vars.size(); i++) input_vars[i]->shape = input_shapes[i];
 
-  program_->SetInputs({input_vars});
+  // the input variables are shared with the program, a rebuild only updates their shapes
+  if (program_->GetInputs().empty()) {
+    program_->SetInputs({input_vars});
+  }
   program_->Validate();
 
   VLOG(3) << "Program:\n" << *program_;
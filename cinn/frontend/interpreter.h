@@ -29,11 +29,30 @@ namespace frontend {
 
 /**
  * The executor for a model.
+ *
+ * A leading dimension of -1 in `input_shapes` marks a dynamic batch dimension. Such a model is compiled lazily into
+ * one specialization per batch bucket, and `SetBatchSize` selects the specialization used by the following
+ * `GetTensor` and `Run` calls.
  */
 class Interpreter final {
  public:
   Interpreter(const std::vector<std::string>& input_names, const std::vector<hlir::framework::shape_t>& input_shapes);
 
+  /**
+   * Set the batch sizes to compile for a model with a dynamic batch dimension, a batch size is rounded up to the
+   * smallest bucket not less than it. With no buckets (the default), every distinct batch size gets its own
+   * specialization.
+   */
+  void SetBatchBuckets(const std::vector<int>& buckets);
+
+  /**
+   * Select the specialization for \p batch_size, compile it if it is not cached yet.
+   * The input tensors of the selected specialization have the bucket batch size, only the first \p batch_size rows
+   * of the outputs are meaningful.
+   * @return The batch size of the selected specialization.
+   */
+  int SetBatchSize(int batch_size);
+
   /**
    * Load a Paddle model.
    * @param model_dir The directory path to the model.
@@ -51,6 +70,14 @@ class Interpreter final {
 
   hlir::framework::Tensor GetTensor(const std::string& name);
 
+  /**
+   * Bind the caller-owned \p data as the memory of the input or output variable \p name, no copy is made.
+   * The data should hold the whole tensor, be aligned to its element size, locate in the target of the model (a
+   * device pointer on GPU builds) and outlive the following runs. The binding is kept across runs of the current
+   * specialization.
+   */
+  void BindTensorData(const std::string& name, void* data);
+
   std::shared_ptr<hlir::framework::Scope> scope();
 
   ~Interpreter();
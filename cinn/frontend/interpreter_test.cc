@@ -16,6 +16,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "cinn/runtime/use_extern_funcs.h"
 
 DEFINE_string(model_dir, "", "");
@@ -31,4 +34,42 @@ TEST(Interpreter, basic) {
   executor.GetTensor("fc_0.tmp_2");
 }
 
+TEST(Interpreter, bind_tensor_data) {
+  Interpreter executor({"A"}, {{1, 30}});
+  executor.LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+
+  auto out = executor.GetTensor("fc_0.tmp_2");
+  std::vector<float> input(30, 1.f);
+  std::vector<float> output(out->shape().numel(), 0.f);
+  executor.BindTensorData("A", input.data());
+  executor.BindTensorData("fc_0.tmp_2", output.data());
+  executor.Run();
+  ASSERT_EQ(out->data<float>(), output.data());
+
+  // the bound memory is reused by the later runs
+  std::fill(input.begin(), input.end(), 2.f);
+  executor.Run();
+  ASSERT_EQ(executor.GetTensor("A")->data<float>(), input.data());
+}
+
+TEST(Interpreter, dynamic_batch) {
+  Interpreter executor({"A"}, {{-1, 30}});
+  executor.SetBatchBuckets({4, 1});
+  executor.LoadPaddleModel(FLAGS_model_dir, common::DefaultHostTarget());
+
+  ASSERT_EQ(executor.SetBatchSize(3), 4);
+  ASSERT_EQ(executor.GetTensor("A")->shape().data()[0], 4);
+  executor.Run();
+  ASSERT_EQ(executor.GetTensor("fc_0.tmp_2")->shape().data()[0], 4);
+
+  ASSERT_EQ(executor.SetBatchSize(1), 1);
+  ASSERT_EQ(executor.GetTensor("A")->shape().data()[0], 1);
+  executor.Run();
+
+  // a batch size larger than all the buckets gets its own specialization
+  ASSERT_EQ(executor.SetBatchSize(6), 6);
+  executor.Run();
+  ASSERT_EQ(executor.GetTensor("fc_0.tmp_2")->shape().data()[0], 6);
+}
+
 }  // namespace cinn::frontend
@@ -0,0 +1,218 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/micro_batcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "cinn/hlir/framework/graph.h"
+
+namespace cinn {
+namespace frontend {
+
+namespace {
+
+//! Find an op mixing the samples along the first dimension, return its id or an empty string if there is none.
+std::string FindCrossBatchOp(hlir::framework::Graph* graph) {
+  using hlir::framework::shape_t;
+  auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    if (!node) {
+      continue;
+    }
+    auto& op_name = node->op()->name;
+    bool cross    = op_name == "batch_norm_train" || op_name == "batch_norm_grad";
+    if (op_name == "reduce_sum" || op_name == "reduce_prod" || op_name == "reduce_max" || op_name == "reduce_min") {
+      auto& attr_store = node->attrs.attr_store;
+      auto in_id       = node->inlinks_in_order().front()->source()->id();
+      int ndim         = shape_dict.count(in_id) ? shape_dict.at(in_id).size() : 0;
+      // no dim reduces all the axes.
+      auto dim = attr_store.count("dim") ? absl::get<std::vector<int>>(attr_store.at("dim")) : std::vector<int>{};
+      cross    = dim.empty() ||
+              std::any_of(dim.begin(), dim.end(), [ndim](int axis) { return axis == 0 || axis == -ndim; });
+    }
+    if (cross) {
+      return node->id();
+    }
+  }
+  return "";
+}
+
+}  // namespace
+
+MicroBatcher::MicroBatcher(std::shared_ptr<CinnComputation> computation, const Options& options)
+    : options_(options), computation_(std::move(computation)) {
+  CHECK(!options_.input_names.empty()) << "The batched inputs should be given";
+  CHECK(!options_.output_names.empty()) << "The batched outputs should be given";
+  CHECK_GT(options_.num_workers, 0);
+  if (!options_.allow_cross_batch_ops) {
+    auto op_id = FindCrossBatchOp(computation_->GetGraph().get());
+    CHECK(op_id.empty()) << "The op [" << op_id << "] mixes the samples along the batch dimension, set "
+                         << "allow_cross_batch_ops if it only applies to the tensors without the batch dimension";
+  }
+  auto get_sample_bytes = [this](const std::string& name) {
+    auto t      = computation_->GetTensor(name);
+    auto& shape = t->shape().data();
+    CHECK(!shape.empty()) << "The tensor [" << name << "] should have the batch dimension";
+    if (!max_batch_size_) {
+      max_batch_size_ = shape[0];
+    }
+    CHECK_EQ(shape[0], max_batch_size_) << "The batch dimension of the tensor [" << name << "] is different";
+    return (t->shape().numel() / shape[0] * t->type().bits() + 7) / 8;
+  };
+  for (auto& name : options_.input_names) {
+    input_sample_bytes_.push_back(get_sample_bytes(name));
+  }
+  for (auto& name : options_.output_names) {
+    output_sample_bytes_.push_back(get_sample_bytes(name));
+  }
+  on_host_ = computation_->GetTarget().arch == common::Target::Arch::X86;
+
+  for (int i = 0; i < options_.num_workers; ++i) {
+    workers_.emplace_back(&MicroBatcher::WorkerLoop, this, computation_->CreateExecutionContext(options_.input_names));
+  }
+}
+
+MicroBatcher::~MicroBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+std::future<void> MicroBatcher::Submit(int batch_size,
+                                       const std::vector<const void*>& inputs,
+                                       const std::vector<void*>& outputs) {
+  CHECK_GT(batch_size, 0);
+  CHECK_LE(batch_size, max_batch_size_) << "The request is larger than the batch the computation is compiled for";
+  CHECK_EQ(inputs.size(), options_.input_names.size());
+  CHECK_EQ(outputs.size(), options_.output_names.size());
+  Request request;
+  request.batch_size = batch_size;
+  request.inputs     = inputs;
+  request.outputs    = outputs;
+  request.arrival    = std::chrono::steady_clock::now();
+  auto future        = request.done.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK(!stop_) << "The micro batcher is stopped";
+    queue_.push_back(std::move(request));
+  }
+  cv_.notify_one();
+  return future;
+}
+
+std::vector<MicroBatcher::Request> MicroBatcher::PopBatch() {
+  std::vector<Request> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+  if (queue_.empty()) {
+    return batch;
+  }
+  auto deadline = queue_.front().arrival + std::chrono::microseconds(options_.max_wait_us);
+  int total     = 0;
+  while (true) {
+    while (!queue_.empty() && total + queue_.front().batch_size <= max_batch_size_) {
+      total += queue_.front().batch_size;
+      batch.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    // the batch is full, or the next request does not fit.
+    if (total == max_batch_size_ || !queue_.empty() || stop_) {
+      break;
+    }
+    if (cv_.wait_until(lock, deadline) == std::cv_status::timeout && queue_.empty()) {
+      break;
+    }
+  }
+  // wake another worker for the requests left.
+  if (!queue_.empty()) {
+    cv_.notify_one();
+  }
+  return batch;
+}
+
+void MicroBatcher::WorkerLoop(std::shared_ptr<CinnExecutionContext> context) {
+  // the batched inputs are staged in the host buffers, which are bound to the tensors directly on host, and the
+  // outputs on device are copied back to host buffers.
+  std::vector<std::vector<char>> input_buffers, output_buffers;
+  for (size_t i = 0; i < options_.input_names.size(); ++i) {
+    input_buffers.emplace_back(input_sample_bytes_[i] * max_batch_size_);
+    if (on_host_) {
+      context->BindTensorData(options_.input_names[i], input_buffers[i].data(), input_buffers[i].size());
+    }
+  }
+  for (size_t i = 0; i < options_.output_names.size() && !on_host_; ++i) {
+    output_buffers.emplace_back(output_sample_bytes_[i] * max_batch_size_);
+  }
+
+  while (true) {
+    auto batch = PopBatch();
+    if (batch.empty()) {
+      return;
+    }
+    int total = 0;
+    for (auto& request : batch) {
+      total += request.batch_size;
+    }
+    VLOG(4) << "Execute " << batch.size() << " requests of " << total << " samples";
+    num_batches_++;
+    if (batch.size() > 1) {
+      num_coalesced_batches_++;
+    }
+
+    for (size_t i = 0; i < input_buffers.size(); ++i) {
+      char* dst = input_buffers[i].data();
+      for (auto& request : batch) {
+        size_t bytes = input_sample_bytes_[i] * request.batch_size;
+        std::memcpy(dst, request.inputs[i], bytes);
+        dst += bytes;
+      }
+      std::memset(dst, 0, input_buffers[i].data() + input_buffers[i].size() - dst);
+      if (!on_host_) {
+        context->SetTensorData(options_.input_names[i], input_buffers[i].data(), input_buffers[i].size());
+      }
+    }
+
+    context->Execute();
+
+    for (size_t i = 0; i < options_.output_names.size(); ++i) {
+      const char* src = nullptr;
+      if (on_host_) {
+        src = context->GetTensor(options_.output_names[i])->data<char>();
+      } else {
+        context->GetTensorData(options_.output_names[i], output_buffers[i].data(), output_buffers[i].size());
+        src = output_buffers[i].data();
+      }
+      for (auto& request : batch) {
+        size_t bytes = output_sample_bytes_[i] * request.batch_size;
+        std::memcpy(request.outputs[i], src, bytes);
+        src += bytes;
+      }
+    }
+    for (auto& request : batch) {
+      request.done.set_value();
+    }
+  }
+}
+
+}  // namespace frontend
+}  // namespace cinn
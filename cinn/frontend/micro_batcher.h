@@ -0,0 +1,114 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cinn/frontend/computation.h"
+
+namespace cinn {
+namespace frontend {
+
+/**
+ * MicroBatcher serves the requests of a computation from several threads. Each worker thread runs its own
+ * CinnExecutionContext, and coalesces the requests queued in a short window into one execution.
+ *
+ * The computation is compiled for the largest batch, which is the first dimension of the batched inputs and outputs.
+ * The samples of the coalesced requests are packed along it and the rows left are filled with zeros, so it is valid
+ * only when the samples are computed independently. The programs reducing over the first dimension or computing the
+ * batch_norm statistics across it are rejected, unless allow_cross_batch_ops is set.
+ */
+class MicroBatcher {
+ public:
+  struct Options {
+    // names of the inputs fed per request, whose first dimension is the batch dimension.
+    std::vector<std::string> input_names;
+    // names of the outputs fetched per request, whose first dimension is the batch dimension.
+    std::vector<std::string> output_names;
+    // number of the execution contexts run concurrently.
+    int num_workers = 1;
+    // the time to wait for more requests to fill a batch, in us.
+    int max_wait_us = 100;
+    // whether serve the programs with ops mixing the samples along the first dimension, e.g. the reduction over it
+    // only applied to the parameters.
+    bool allow_cross_batch_ops = false;
+  };
+
+  MicroBatcher(std::shared_ptr<CinnComputation> computation, const Options& options);
+
+  //! Serve the requests queued and stop the workers.
+  ~MicroBatcher();
+
+  /**
+   * Submit a request of \p batch_size samples, it is thread-safe.
+   * @param batch_size The number of samples, which is at most the batch the computation is compiled for.
+   * @param inputs The host buffers of the inputs in the order of input_names, each holding batch_size samples.
+   * @param outputs The host buffers of the outputs in the order of output_names, filled when the future is ready.
+   * @return The future ready when the outputs are filled.
+   */
+  std::future<void> Submit(int batch_size, const std::vector<const void*>& inputs, const std::vector<void*>& outputs);
+
+  //! The batch the computation is compiled for.
+  int max_batch_size() const { return max_batch_size_; }
+
+  //! The number of the executions.
+  int64_t num_batches() const { return num_batches_; }
+
+  //! The number of the executions serving more than one request.
+  int64_t num_coalesced_batches() const { return num_coalesced_batches_; }
+
+ private:
+  struct Request {
+    int batch_size;
+    std::vector<const void*> inputs;
+    std::vector<void*> outputs;
+    std::promise<void> done;
+    std::chrono::steady_clock::time_point arrival;
+  };
+
+  void WorkerLoop(std::shared_ptr<CinnExecutionContext> context);
+
+  //! Pop the requests executed together, wait for at most max_wait_us after the first one arrives to fill the batch.
+  std::vector<Request> PopBatch();
+
+  Options options_;
+  std::shared_ptr<CinnComputation> computation_;
+  int max_batch_size_{0};
+  bool on_host_{false};
+  // bytes of a sample of each input and output.
+  std::vector<size_t> input_sample_bytes_;
+  std::vector<size_t> output_sample_bytes_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request> queue_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+
+  std::atomic<int64_t> num_batches_{0};
+  std::atomic<int64_t> num_coalesced_batches_{0};
+};
+
+}  // namespace frontend
+}  // namespace cinn
@@ -0,0 +1,199 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/micro_batcher.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <utility>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/utils/timer.h"
+
+namespace cinn {
+namespace frontend {
+
+namespace {
+
+constexpr int kBatch = 16;
+constexpr int kM     = 32;
+constexpr int kN     = 24;
+
+// out = relu(x * w + b), where w and b are the parameters shared by the requests.
+std::shared_ptr<CinnComputation> CreateComputation(std::vector<float>* w, std::vector<float>* b, Variable* out) {
+  NetBuilder builder("micro_batcher");
+  auto x  = builder.CreateInput(Float(32), {kBatch, kM}, "X");
+  auto wv = builder.CreateInput(Float(32), {kM, kN}, "W");
+  auto bv = builder.CreateInput(Float(32), {kN}, "Bias");
+  *out    = builder.Relu(builder.ElementwiseAdd(builder.Matmul(x, wv), bv, 1));
+
+  auto computation = CinnComputation::BuildAndCompile(
+      common::DefaultHostTarget(), builder, CinnComputation::DefaultCompileOptions(), {*out});
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  w->resize(kM * kN);
+  b->resize(kN);
+  for (auto& v : *w) v = dist(engine);
+  for (auto& v : *b) v = dist(engine);
+  computation->SetTensorData("W", w->data(), w->size() * sizeof(float));
+  computation->SetTensorData("Bias", b->data(), b->size() * sizeof(float));
+  return computation;
+}
+
+std::vector<float> Reference(const std::vector<float>& x,
+                             const std::vector<float>& w,
+                             const std::vector<float>& b,
+                             int batch) {
+  std::vector<float> out(batch * kN);
+  for (int i = 0; i < batch; ++i) {
+    for (int j = 0; j < kN; ++j) {
+      float sum = b[j];
+      for (int k = 0; k < kM; ++k) {
+        sum += x[i * kM + k] * w[k * kN + j];
+      }
+      out[i * kN + j] = std::max(sum, 0.f);
+    }
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST(CinnExecutionContext, concurrent_execute) {
+  std::vector<float> w, b;
+  Variable out;
+  auto computation = CreateComputation(&w, &b, &out);
+
+  constexpr int kThreads = 4;
+  std::vector<std::thread> threads;
+  std::vector<int> passed(kThreads, false);
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      auto context = computation->CreateExecutionContext({"X"});
+      std::vector<float> x(kBatch * kM, static_cast<float>(t + 1) / kThreads), result(kBatch * kN);
+      bool ok = true;
+      for (int step = 0; step < 20; ++step) {
+        x[0] = step;
+        context->SetTensorData("X", x.data(), x.size() * sizeof(float));
+        context->Execute();
+        context->GetTensorData(out->id, result.data(), result.size() * sizeof(float));
+        auto expected = Reference(x, w, b, kBatch);
+        for (int i = 0; i < expected.size(); ++i) {
+          ok &= std::abs(result[i] - expected[i]) < 1e-4;
+        }
+      }
+      passed[t] = ok;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < kThreads; ++t) {
+    ASSERT_TRUE(passed[t]) << "The context of thread " << t << " got wrong results";
+  }
+}
+
+TEST(MicroBatcher, coalesce_requests) {
+  std::vector<float> w, b;
+  Variable out;
+  auto computation = CreateComputation(&w, &b, &out);
+
+  // the clients submit requests of 1 to 4 samples concurrently, the throughput and the latency are reported for each
+  // concurrency level.
+  for (int concurrency : {1, 4, 16}) {
+    MicroBatcher::Options options;
+    options.input_names  = {"X"};
+    options.output_names = {out->id};
+    options.num_workers  = 2;
+    options.max_wait_us  = 200;
+    MicroBatcher batcher(computation, options);
+
+    constexpr int kRequests = 50;
+    std::vector<std::thread> clients;
+    std::vector<double> latency_ms(concurrency, 0);
+    std::vector<int> passed(concurrency, true);
+    utils::Timer timer;
+    timer.Start();
+    for (int c = 0; c < concurrency; ++c) {
+      clients.emplace_back([&, c] {
+        std::default_random_engine engine(c);
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        for (int r = 0; r < kRequests; ++r) {
+          int batch_size = r % 4 + 1;
+          std::vector<float> x(batch_size * kM), result(batch_size * kN);
+          for (auto& v : x) v = dist(engine);
+
+          utils::Timer request_timer;
+          request_timer.Start();
+          batcher.Submit(batch_size, {x.data()}, {result.data()}).wait();
+          latency_ms[c] += request_timer.Stop();
+
+          auto expected = Reference(x, w, b, batch_size);
+          for (int i = 0; i < expected.size(); ++i) {
+            passed[c] = passed[c] && std::abs(result[i] - expected[i]) < 1e-4;
+          }
+        }
+      });
+    }
+    for (auto& client : clients) {
+      client.join();
+    }
+    double total_ms = timer.Stop();
+    double latency  = 0;
+    for (int c = 0; c < concurrency; ++c) {
+      ASSERT_TRUE(passed[c]) << "The requests of client " << c << " got wrong results";
+      latency += latency_ms[c];
+    }
+    LOG(INFO) << "concurrency " << concurrency << ": throughput " << concurrency * kRequests / total_ms * 1000
+              << " requests/s, average latency " << latency / (concurrency * kRequests) << " ms, "
+              << batcher.num_coalesced_batches() << " of " << batcher.num_batches() << " batches coalesced";
+    // 16 clients keep more requests queued than the 2 workers serve one by one.
+    if (concurrency == 16) {
+      EXPECT_GT(batcher.num_coalesced_batches(), 0);
+    }
+  }
+}
+
+TEST(MicroBatcher, reject_cross_batch_ops) {
+  auto compile = [](bool across_batch) {
+    NetBuilder builder("cross_batch");
+    auto x = builder.CreateInput(Float(32), {kBatch, kM}, "X");
+    // the samples are summed up together or separately.
+    auto out = across_batch ? builder.ElementwiseAdd(x, builder.ReduceSum(x, {0}), 1) : builder.ReduceSum(x, {1}, true);
+    return std::make_pair(CinnComputation::BuildAndCompile(
+                              common::DefaultHostTarget(), builder, CinnComputation::DefaultCompileOptions(), {out}),
+                          out->id);
+  };
+
+  MicroBatcher::Options options;
+  options.input_names  = {"X"};
+  auto per_sample      = compile(false);
+  options.output_names = {per_sample.second};
+  MicroBatcher batcher(per_sample.first, options);
+
+  // the batch mixing the samples is served only when it is allowed explicitly.
+  auto across_batch    = compile(true);
+  options.output_names = {across_batch.second};
+  ASSERT_DEATH(MicroBatcher(across_batch.first, options), "");
+  options.allow_cross_batch_ops = true;
+  MicroBatcher allowed_batcher(across_batch.first, options);
+}
+
+}  // namespace frontend
+}  // namespace cinn
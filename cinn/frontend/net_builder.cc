@@ -218,6 +218,14 @@ Variable NetBuilder::Softmax(const Variable& a, int axis, const std::string& dat
   return instr.GetOutput(0);
 }
 
+Variable NetBuilder::FusedAttention(const Variable& q, const Variable& k, const Variable& v, float scale) {
+  Instruction instr("fused_attention", {q, k, v});
+  instr.SetAttr("scale", scale);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
 Variable NetBuilder::DropoutInfer(const Variable& a, float dropout_prob, const std::string& dropout_implementation) {
   Instruction instr("dropout_infer", {a});
   instr.SetAttr("dropout_prob", dropout_prob);
@@ -257,6 +265,63 @@ std::vector<Variable> NetBuilder::Conv2dGrad(const Variable& dy,
   return instr.GetOutputs();
 }
 
+Variable NetBuilder::Quantize(const Variable& x, const Variable& scale, int axis, int zero_point) {
+  Instruction instr("quantize", {x, scale});
+  instr.SetAttr("axis", axis);
+  instr.SetAttr("zero_point", zero_point);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::Dequantize(const Variable& x, const Variable& scale, int axis, int zero_point) {
+  Instruction instr("dequantize", {x, scale});
+  instr.SetAttr("axis", axis);
+  instr.SetAttr("zero_point", zero_point);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::Requantize(
+    const Variable& x, const Variable& in_scale, const Variable& out_scale, int axis, int zero_point) {
+  Instruction instr("requantize", {x, in_scale, out_scale});
+  instr.SetAttr("axis", axis);
+  instr.SetAttr("zero_point", zero_point);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::QuantizedMatmul(const Variable& x, const Variable& y) {
+  Instruction instr("quantized_matmul", {x, y});
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::QuantizedConv2d(const Variable& x,
+                                     const Variable& w,
+                                     const std::vector<int>& strides,
+                                     const std::vector<int>& paddings,
+                                     const std::vector<int>& dilations) {
+  Instruction instr("quantized_conv2d", {x, w});
+  instr.SetAttr("stride", strides);
+  instr.SetAttr("padding", paddings);
+  instr.SetAttr("dilation", dilations);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
+Variable NetBuilder::Cast(const Variable& x, const std::string& dtype) {
+  Instruction instr("cast", {x});
+  instr.SetAttr("dtype", dtype);
+  InferShape(instr);
+  AppendInstruction(instr);
+  return instr.GetOutput(0);
+}
+
 Variable NetBuilder::ElementwiseOp(const std::string& op_type, const Variable& lhs, const Variable& rhs, int axis) {
   Instruction instr(op_type, {lhs, rhs});
   instr.SetAttr("axis", axis);
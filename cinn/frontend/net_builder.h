@@ -151,6 +151,12 @@ class NetBuilder : public BaseBuilder {
 
   Variable Softmax(const Variable& a, int axis = -1, const std::string& data_format = "AnyLayout");
 
+  /**
+   * The fused multi-head attention softmax(q * k^T * scale) * v, the leading dimensions of q, k and v are the batch
+   * and the heads. It is only supported on X86.
+   */
+  Variable FusedAttention(const Variable& q, const Variable& k, const Variable& v, float scale = 1.0f);
+
   Variable DropoutInfer(const Variable& a,
                         float dropout_prob                        = 0.5f,
                         const std::string& dropout_implementation = "downgrade_in_infer");
@@ -168,6 +174,42 @@ class NetBuilder : public BaseBuilder {
                                    const std::string& data_format       = "NCHW",
                                    const std::string& padding_algorithm = "EXPLICIT");
 
+  /**
+   * Quantize the float Variable x to int8: clip(round(x / scale) + zero_point, -128, 127).
+   * The scale is a 1-D Variable of shape [1] (per-tensor) or [x.shape[axis]] (per-channel, axis >= 0).
+   */
+  Variable Quantize(const Variable& x, const Variable& scale, int axis = -1, int zero_point = 0);
+
+  /**
+   * Dequantize the int8 or int32 Variable x to float32: (x - zero_point) * scale.
+   */
+  Variable Dequantize(const Variable& x, const Variable& scale, int axis = -1, int zero_point = 0);
+
+  /**
+   * Requantize the int32 accumulator x of scale in_scale to int8 of per-tensor scale out_scale.
+   */
+  Variable Requantize(
+      const Variable& x, const Variable& in_scale, const Variable& out_scale, int axis = -1, int zero_point = 0);
+
+  /**
+   * Multiply the int8 matrices x [M, K] and y [K, N] with int32 accumulation, the result is of type int32.
+   */
+  Variable QuantizedMatmul(const Variable& x, const Variable& y);
+
+  /**
+   * The 2-D convolution of the int8 input x (NCHW) and weights w (OIHW) with int32 accumulation.
+   */
+  Variable QuantizedConv2d(const Variable& x,
+                           const Variable& w,
+                           const std::vector<int>& strides   = {1, 1},
+                           const std::vector<int>& paddings  = {0, 0},
+                           const std::vector<int>& dilations = {1, 1});
+
+  /**
+   * Cast the Variable x to dtype, e.g. "float16", "bfloat16" or "float32".
+   */
+  Variable Cast(const Variable& x, const std::string& dtype);
+
  protected:
   Variable ElementwiseOp(const std::string& op_type, const Variable& lhs, const Variable& rhs, int axis = -1);
 };
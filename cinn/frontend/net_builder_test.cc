@@ -14,9 +14,12 @@
 
 #include "cinn/frontend/net_builder.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <memory>
 #include <random>
 #include <vector>
@@ -31,6 +34,8 @@
 #include <cuda_runtime.h>
 #endif
 
+DECLARE_bool(cinn_cpu_two_step_reduce);
+
 namespace cinn {
 namespace frontend {
 
@@ -69,6 +74,20 @@ void SetRandData(hlir::framework::Tensor tensor, Target target) {
 #endif
 }
 
+// The bits of v in the float16 or bfloat16 type, v should be zero or a normal value exactly representable in it.
+uint16_t LowPrecisionBits(float v, const Type& type) {
+  uint32_t bits;
+  std::memcpy(&bits, &v, sizeof(v));
+  if (type.is_bfloat16() || (bits & 0x7FFFFFFF) == 0) {
+    return bits >> 16;
+  }
+  // float16 rebiases the exponent from 127 to 15 and keeps the 10 high bits of the mantissa.
+  uint32_t sign = (bits >> 16) & 0x8000;
+  int exponent  = static_cast<int>((bits >> 23) & 0xFF) - 127 + 15;
+  CHECK(exponent > 0 && exponent < 31) << v << " is out of the normal range of float16";
+  return sign | (exponent << 10) | ((bits >> 13) & 0x3FF);
+}
+
 template <typename T, typename Alloc = std::allocator<T>>
 std::ostream& operator<<(std::ostream& os, const std::vector<T, Alloc>& vec) {
   os << "{ ";
@@ -189,5 +208,295 @@ TEST(net_build, program_execute_reverse) {
   runtime_program->Execute();
 }
 
+TEST(net_build, program_execute_cpu_two_step_reduce) {
+  const int M = 16;
+  const int N = 256;
+
+  NetBuilder builder("net_builder");
+  Placeholder input   = builder.CreateInput(Float(32), {M, N}, "X");
+  Placeholder small   = builder.CreateInput(Float(32), {M, 10}, "Y");
+  Variable softmax    = builder.Softmax(input);
+  Variable reduce_sum = builder.ReduceSum(small, {-1});
+  auto program        = builder.Build();
+
+  Target target                  = common::DefaultHostTarget();
+  FLAGS_cinn_cpu_two_step_reduce = true;
+  auto graph                     = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope                     = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program           = gc.Build();
+  FLAGS_cinn_cpu_two_step_reduce = false;
+
+  auto input_tensor = scope->GetTensor(std::string(input.id()));
+  auto small_tensor = scope->GetTensor(std::string(small.id()));
+  SetRandData(input_tensor, target);
+  SetRandData(small_tensor, target);
+  runtime_program->Execute();
+
+  const float* input_data   = input_tensor->data<float>();
+  const float* softmax_data = scope->GetTensor(std::string(softmax->id))->data<float>();
+  for (int i = 0; i < M; ++i) {
+    float sum = 0.f;
+    for (int j = 0; j < N; ++j) {
+      sum += std::exp(input_data[i * N + j]);
+    }
+    for (int j = 0; j < N; ++j) {
+      EXPECT_NEAR(softmax_data[i * N + j], std::exp(input_data[i * N + j]) / sum, 1e-6);
+    }
+  }
+  // the negative reduce axis counts from the last one.
+  const float* small_data = small_tensor->data<float>();
+  const float* sum_data   = scope->GetTensor(std::string(reduce_sum->id))->data<float>();
+  for (int i = 0; i < M; ++i) {
+    float sum = 0.f;
+    for (int j = 0; j < 10; ++j) {
+      sum += small_data[i * 10 + j];
+    }
+    EXPECT_NEAR(sum_data[i], sum, 1e-5);
+  }
+}
+
+TEST(net_build, program_execute_quantize_dequantize) {
+  const int M = 4;
+  const int N = 16;
+
+  NetBuilder builder("net_builder");
+  Placeholder input    = builder.CreateInput(Float(32), {M, N}, "X");
+  Placeholder scale    = builder.CreateInput(Float(32), {N}, "Scale");
+  Variable quant_out   = builder.Quantize(input, scale, 1);
+  Variable dequant_out = builder.Dequantize(quant_out, scale, 1);
+  auto program         = builder.Build();
+
+  Target target = common::DefaultHostTarget();
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  scope->Var<hlir::framework::Tensor>(std::string(input.id()));
+  scope->Var<hlir::framework::Tensor>(std::string(scale.id()));
+  scope->Var<hlir::framework::Tensor>(std::string(dequant_out->id));
+
+  auto input_tensor = scope->GetTensor(std::string(input.id()));
+  auto scale_tensor = scope->GetTensor(std::string(scale.id()));
+  SetRandData(input_tensor, target);
+  float* scale_data = scale_tensor->mutable_data<float>(target);
+  for (int j = 0; j < N; ++j) {
+    scale_data[j] = (j + 1) / 127.f;
+  }
+  runtime_program->Execute();
+
+  auto output_tensor      = scope->GetTensor(std::string(dequant_out->id));
+  const float* input_data = input_tensor->data<float>();
+  const float* out_data   = output_tensor->data<float>();
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      float s = scale_data[j];
+      float q = std::min(std::max(std::round(input_data[i * N + j] / s), -128.f), 127.f);
+      EXPECT_NEAR(out_data[i * N + j], q * s, 1e-5);
+    }
+  }
+}
+
+TEST(net_build, program_execute_quantized_matmul) {
+  const int M = 4;
+  const int K = 32;
+  const int N = 16;
+
+  NetBuilder builder("net_builder");
+  Placeholder x        = builder.CreateInput(Int(8), {M, K}, "X");
+  Placeholder y        = builder.CreateInput(Int(8), {K, N}, "Y");
+  Placeholder scale    = builder.CreateInput(Float(32), {N}, "Scale");
+  Variable acc         = builder.QuantizedMatmul(x, y);
+  Variable dequant_out = builder.Dequantize(acc, scale, 1);
+  auto program         = builder.Build();
+
+  Target target = common::DefaultHostTarget();
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  std::default_random_engine engine(0);
+  std::uniform_int_distribution<int> dist(-128, 127);
+  int8_t* x_data = scope->GetTensor(std::string(x.id()))->mutable_data<int8_t>(target);
+  int8_t* y_data = scope->GetTensor(std::string(y.id()))->mutable_data<int8_t>(target);
+  for (int i = 0; i < M * K; ++i) {
+    x_data[i] = dist(engine);
+  }
+  for (int i = 0; i < K * N; ++i) {
+    y_data[i] = dist(engine);
+  }
+  float* scale_data = scope->GetTensor(std::string(scale.id()))->mutable_data<float>(target);
+  for (int j = 0; j < N; ++j) {
+    scale_data[j] = (j + 1) / 127.f;
+  }
+  runtime_program->Execute();
+
+  const float* out_data = scope->GetTensor(std::string(dequant_out->id))->data<float>();
+  for (int i = 0; i < M; ++i) {
+    for (int j = 0; j < N; ++j) {
+      int32_t expected = 0;
+      for (int k = 0; k < K; ++k) {
+        expected += static_cast<int32_t>(x_data[i * K + k]) * y_data[k * N + j];
+      }
+      EXPECT_NEAR(out_data[i * N + j], expected * scale_data[j], 1e-5 * std::abs(expected * scale_data[j]) + 1e-5);
+    }
+  }
+}
+
+TEST(net_build, program_execute_quantized_conv2d) {
+  const int C_in  = 8;
+  const int C_out = 4;
+  const int H     = 6;
+  const int W     = 6;
+
+  NetBuilder builder("net_builder");
+  Placeholder x         = builder.CreateInput(Int(8), {1, C_in, H, W}, "X");
+  Placeholder w         = builder.CreateInput(Int(8), {C_out, C_in, 3, 3}, "W");
+  Placeholder in_scale  = builder.CreateInput(Float(32), {C_out}, "InScale");
+  Placeholder out_scale = builder.CreateInput(Float(32), {1}, "OutScale");
+  Variable acc          = builder.QuantizedConv2d(x, w, {1, 1}, {1, 1});
+  Variable requant_out  = builder.Requantize(acc, in_scale, out_scale, 1);
+  auto program          = builder.Build();
+
+  Target target = common::DefaultHostTarget();
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  std::default_random_engine engine(0);
+  std::uniform_int_distribution<int> dist(-128, 127);
+  int8_t* x_data = scope->GetTensor(std::string(x.id()))->mutable_data<int8_t>(target);
+  int8_t* w_data = scope->GetTensor(std::string(w.id()))->mutable_data<int8_t>(target);
+  for (int i = 0; i < C_in * H * W; ++i) {
+    x_data[i] = dist(engine);
+  }
+  for (int i = 0; i < C_out * C_in * 9; ++i) {
+    w_data[i] = dist(engine);
+  }
+  float* in_scale_data  = scope->GetTensor(std::string(in_scale.id()))->mutable_data<float>(target);
+  float* out_scale_data = scope->GetTensor(std::string(out_scale.id()))->mutable_data<float>(target);
+  for (int o = 0; o < C_out; ++o) {
+    in_scale_data[o] = (o + 1) * 1e-4f;
+  }
+  out_scale_data[0] = 0.5f;
+  runtime_program->Execute();
+
+  // the padded border reads zero, the zero point of the symmetric quantization.
+  const int8_t* out_data = scope->GetTensor(std::string(requant_out->id))->data<int8_t>();
+  for (int o = 0; o < C_out; ++o) {
+    for (int h = 0; h < H; ++h) {
+      for (int v = 0; v < W; ++v) {
+        int32_t acc_value = 0;
+        for (int c = 0; c < C_in; ++c) {
+          for (int r = 0; r < 3; ++r) {
+            for (int s = 0; s < 3; ++s) {
+              int ih = h + r - 1, iw = v + s - 1;
+              if (ih >= 0 && ih < H && iw >= 0 && iw < W) {
+                int32_t a = x_data[(c * H + ih) * W + iw];
+                int32_t b = w_data[((o * C_in + c) * 3 + r) * 3 + s];
+                acc_value += a * b;
+              }
+            }
+          }
+        }
+        float ratio = in_scale_data[o] / out_scale_data[0];
+        float q     = std::min(std::max(std::round(acc_value * ratio), -128.f), 127.f);
+        EXPECT_NEAR(out_data[(o * H + h) * W + v], q, 1);
+      }
+    }
+  }
+}
+
+TEST(net_build, program_execute_low_precision) {
+  const int M = 8;
+  const int K = 16;
+  const int N = 4;
+  // the inputs are multiples of 1/32 in [-2, 2], so they and their sums are exact in float16 and bfloat16, and the
+  // results only differ from float32 by the order of the accumulation.
+  std::default_random_engine engine(0);
+  std::uniform_int_distribution<int> dist(-64, 64);
+  std::vector<float> a_data(M * K), b_data(M * K), w_data(K * N);
+  for (auto* data : {&a_data, &b_data, &w_data}) {
+    for (auto& v : *data) {
+      v = dist(engine) / 32.f;
+    }
+  }
+
+  Target target = common::DefaultHostTarget();
+  // the elementwise ops run in the input type, the matmul in float32.
+  auto run = [&](const Type& type) {
+    NetBuilder builder("net_builder");
+    Placeholder a = builder.CreateInput(type, {M, K}, "A");
+    Placeholder b = builder.CreateInput(type, {M, K}, "B");
+    Placeholder w = builder.CreateInput(Float(32), {K, N}, "W");
+    Variable out  = builder.Relu(builder.Add(a, b));
+    if (type != Float(32)) {
+      out = builder.Cast(out, "float32");
+    }
+    out          = builder.Matmul(out, w);
+    auto program = builder.Build();
+
+    auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+    auto scope = BuildScope(target, graph);
+    hlir::framework::GraphCompiler gc(target, scope, graph);
+    auto runtime_program = gc.Build();
+
+    for (auto& item : {std::make_pair(a, &a_data), std::make_pair(b, &b_data)}) {
+      auto tensor = scope->GetTensor(std::string(item.first.id()));
+      if (type == Float(32)) {
+        std::copy(item.second->begin(), item.second->end(), tensor->mutable_data<float>(target));
+        continue;
+      }
+      auto* data = reinterpret_cast<uint16_t*>(tensor->mutable_data(target, type));
+      for (int i = 0; i < item.second->size(); ++i) {
+        data[i] = LowPrecisionBits(item.second->at(i), type);
+      }
+    }
+    std::copy(w_data.begin(), w_data.end(), scope->GetTensor(std::string(w.id()))->mutable_data<float>(target));
+    runtime_program->Execute();
+
+    auto out_tensor = scope->GetTensor(std::string(out->id));
+    return std::vector<float>(out_tensor->data<float>(), out_tensor->data<float>() + M * N);
+  };
+
+  auto expected = run(Float(32));
+  for (auto& type : {common::BF16(), common::F16()}) {
+    auto result = run(type);
+    for (int i = 0; i < M * N; ++i) {
+      EXPECT_NEAR(result[i], expected[i], 1e-5 * std::abs(expected[i]) + 1e-5) << "type " << type << ", index " << i;
+    }
+  }
+}
+
+TEST(net_build, program_execute_bfloat16_nan) {
+  NetBuilder builder("net_builder");
+  Placeholder x = builder.CreateInput(Float(32), {4}, "X");
+  Variable out  = builder.Cast(builder.Cast(x, "bfloat16"), "float32");
+  auto program  = builder.Build();
+
+  Target target = common::DefaultHostTarget();
+  auto graph    = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope    = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+
+  // the NaNs with all the low bits set would be rounded to -0 and infinity without the special handling.
+  std::vector<uint32_t> x_bits = {0x7FFFFFFF, 0xFFFFFFFF, 0x7F800001, 0x3F800000};
+  std::memcpy(scope->GetTensor(std::string(x.id()))->mutable_data<float>(target), x_bits.data(), 4 * sizeof(float));
+  runtime_program->Execute();
+
+  const float* out_data = scope->GetTensor(std::string(out->id))->data<float>();
+  EXPECT_TRUE(std::isnan(out_data[0]));
+  EXPECT_TRUE(std::isnan(out_data[1]));
+  EXPECT_TRUE(std::isnan(out_data[2]));
+  EXPECT_EQ(out_data[3], 1.f);
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -0,0 +1,85 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/frontend/op_mapper_registry.h"
+#include "cinn/frontend/op_mappers/common_utils.h"
+
+namespace cinn {
+namespace frontend {
+namespace paddle_mappers {
+
+namespace {
+// Paddle stores the abs-max of the quantized range as Scale, so that x_q = round(x / Scale * bnt), where
+// bnt = 2^(bit_length - 1) - 1. CINN's quantize ops take the real step size, that is Scale / bnt.
+Variable GetQuantStepSize(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("Scale").size(), 1UL);
+  auto scale_name = op_desc.Input("Scale").front();
+  auto scale      = ctx.GetVar(scale_name);
+
+  auto bit_length = utils::GetAttrOrDefault<int>(op_desc, "bit_length", 8);
+  CHECK_EQ(bit_length, 8) << "Only 8-bit quantization is supported now, but the bit_length of " << op_desc.Type()
+                          << " is " << bit_length;
+  float bnt = static_cast<float>((1 << (bit_length - 1)) - 1);
+  return ctx.Builder()->Scale(scale, 1.0f / bnt);
+}
+}  // namespace
+
+void QuantizeLinearOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("X").size(), 1UL);
+  auto x_name = op_desc.Input("X").front();
+  CHECK_EQ(op_desc.Output("Y").size(), 1UL);
+  auto out_name = op_desc.Output("Y").front();
+
+  // The zero point of paddle's quantized model is always 0, so the ZeroPoint input is ignored.
+  auto quant_axis = utils::GetAttrOrDefault<int>(op_desc, "quant_axis", -1);
+
+  auto x     = ctx.GetVar(x_name);
+  auto scale = GetQuantStepSize(op_desc, ctx);
+  auto out   = ctx.Builder()->Quantize(x, scale, quant_axis);
+
+  ctx.AddVar(out_name, out);
+  ctx.AddVarModelToProgram(out_name, out->id);
+}
+
+void DequantizeLinearOpMapper(const paddle::cpp::OpDesc& op_desc, const OpMapperContext& ctx) {
+  CHECK_EQ(op_desc.Input("X").size(), 1UL);
+  auto x_name = op_desc.Input("X").front();
+  CHECK_EQ(op_desc.Output("Y").size(), 1UL);
+  auto out_name = op_desc.Output("Y").front();
+
+  auto quant_axis = utils::GetAttrOrDefault<int>(op_desc, "quant_axis", -1);
+
+  auto x     = ctx.GetVar(x_name);
+  auto scale = GetQuantStepSize(op_desc, ctx);
+  Variable out;
+  if (x->type.is_float()) {
+    // the quantized weights of paddle's model are saved as float values
+    out = ctx.Builder()->ElementwiseMul(x, scale, quant_axis);
+  } else {
+    out = ctx.Builder()->Dequantize(x, scale, quant_axis);
+  }
+
+  ctx.AddVar(out_name, out);
+  ctx.AddVarModelToProgram(out_name, out->id);
+}
+
+}  // namespace paddle_mappers
+}  // namespace frontend
+}  // namespace cinn
+
+CINN_REGISTER_HELPER(paddle_quantize) {
+  CINN_REGISTER_OP_MAPPER(quantize_linear, cinn::frontend::paddle_mappers::QuantizeLinearOpMapper)
+  CINN_REGISTER_OP_MAPPER(dequantize_linear, cinn::frontend::paddle_mappers::DequantizeLinearOpMapper)
+  return true;
+}
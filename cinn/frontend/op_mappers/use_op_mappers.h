@@ -30,6 +30,7 @@ CINN_USE_REGISTER(paddle_pool2d)
 CINN_USE_REGISTER(paddle_conv2d)
 CINN_USE_REGISTER(paddle_transpose)
 CINN_USE_REGISTER(paddle_reshape)
+CINN_USE_REGISTER(paddle_quantize)
 
 CINN_USE_REGISTER(science_broadcast)
 CINN_USE_REGISTER(science_transform)
@@ -28,13 +28,20 @@
 #include "cinn/hlir/pass/use_pass.h"
 
 DECLARE_bool(cinn_use_new_fusion_pass);
+DECLARE_bool(cinn_pass_profile);
 
 namespace cinn {
 namespace frontend {
 
 OptimizeOptions DefaultTrainingOptimizeOptions() {
   OptimizeOptions options;
-  options.program_passes = {"Decomposer", "TransposeFolding", "GemmRewriter", "RemoveIdentity"};
+  options.program_passes = {"Decomposer",
+                            "CommonSubexpressionElimination",
+                            "TransposeFolding",
+                            "AttentionFusion",
+                            "GemmRewriter",
+                            "RemoveIdentity",
+                            "DeadCodeElimination"};
   if (FLAGS_cinn_use_new_fusion_pass) {
     options.graph_passes = {"OpFusionPass", "FusionMergePass"};
   } else {
@@ -52,6 +59,9 @@ std::shared_ptr<hlir::framework::Graph> Optimize(frontend::Program* program,
   // Apply graph passes
   auto graph = std::make_shared<hlir::framework::Graph>(*program, target);
   hlir::framework::ApplyPasses(graph.get(), options.graph_passes);
+  if (FLAGS_cinn_pass_profile) {
+    LOG(INFO) << "The passes applied so far:\n" << hlir::framework::PassProfiler::Global()->Summary();
+  }
   return graph;
 }
 }  // namespace frontend
@@ -14,7 +14,17 @@
 
 #include "cinn/frontend/paddle/model_parser.h"
 
+#include <fcntl.h>
+#include <gflags/gflags.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
 #include <fstream>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "cinn/backends/codegen_cuda_dev.h"
@@ -24,8 +34,71 @@
 #include "cinn/common/common.h"
 #include "cinn/frontend/paddle/compatible_pb.h"
 
+DECLARE_bool(cinn_mmap_params);
+
 namespace cinn::frontend::paddle {
 
+namespace {
+
+// A parameter file mapped into memory. The pages are private and copy-on-write, so a pass writing the weights in
+// place never touches the file. It is unmapped when the last tensor aliasing it is released.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    CHECK_NE(fd, -1) << "failed to open file " << path;
+    struct stat st;
+    CHECK_EQ(fstat(fd, &st), 0) << "failed to stat file " << path;
+    size_ = st.st_size;
+    if (size_ > 0) {
+      data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      CHECK(data_ != MAP_FAILED) << "failed to map file " << path;
+    }
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (data_) munmap(data_, size_);
+  }
+
+  char *data() const { return static_cast<char *>(data_); }
+  size_t size() const { return size_; }
+
+ private:
+  void *data_{nullptr};
+  size_t size_{0};
+
+  CINN_DISALLOW_COPY_AND_ASSIGN(MappedFile);
+};
+
+// Read the serialized parameters in place from a block of memory.
+class MemoryReader {
+ public:
+  MemoryReader(const char *begin, const char *end) : cur_(begin), end_(end) {}
+
+  template <typename T>
+  T Read() {
+    T value;
+    std::memcpy(&value, Skip(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  const char *Skip(size_t size) {
+    CHECK_LE(size, static_cast<size_t>(end_ - cur_)) << "There is a problem with loading model parameters";
+    const char *data = cur_;
+    cur_ += size;
+    return data;
+  }
+
+  bool eof() const { return cur_ == end_; }
+
+ private:
+  const char *cur_;
+  const char *end_;
+};
+
+}  // namespace
+
 int SizeOfType(framework_proto::VarType::Type type) {
   using Type = framework_proto::VarType::Type;
   switch (static_cast<int>(type)) {
@@ -108,6 +181,83 @@ void TensorFromStream(std::istream &is, hlir::framework::_Tensor_ *tensor, const
   }
 }
 
+common::Type ParamType(framework_proto::VarType::Type type) {
+  using Type = framework_proto::VarType::Type;
+  switch (static_cast<int>(type)) {
+    case Type::VarType_Type_FP32:
+      return Float(32);
+    case Type::VarType_Type_INT8:
+      return Int(8);
+    case Type::VarType_Type_INT16:
+      return Int(16);
+    case Type::VarType_Type_INT32:
+      return Int(32);
+    case Type::VarType_Type_INT64:
+      return Int(64);
+    default:
+      LOG(FATAL) << "unknown type " << type;
+  }
+  return common::Type();
+}
+
+// Read a tensor in place, the host tensor aliases the mapped \p file if it is given and the data is aligned.
+void TensorFromMemory(MemoryReader *reader,
+                      hlir::framework::_Tensor_ *tensor,
+                      const common::Target &target,
+                      const std::shared_ptr<MappedFile> &file) {
+  uint32_t version = reader->Read<uint32_t>();
+  CHECK_EQ(version, 0U) << "Only version 0 is supported";
+  framework_proto::VarType::TensorDesc desc;
+  int32_t desc_size = reader->Read<int32_t>();
+  CHECK(desc.ParseFromArray(reader->Skip(desc_size), desc_size)) << "Cannot parse tensor desc";
+
+  std::vector<int32_t> dims_vec;
+  std::copy(desc.dims().begin(), desc.dims().end(), std::back_inserter(dims_vec));
+  tensor->Resize(hlir::framework::Shape(dims_vec));
+  size_t type_size = SizeOfType(desc.data_type());
+  size_t size      = tensor->shape().numel() * type_size;
+  const char *data = reader->Skip(size);
+
+  if (target.arch == Target::Arch::X86) {
+    auto type = ParamType(desc.data_type());
+    if (file && reinterpret_cast<uintptr_t>(data) % type_size == 0) {
+      // the mapped pages are writable copy-on-write, so casting away const is safe
+      tensor->ShareExternalData(const_cast<char *>(data), target, type, file);
+    } else {
+      std::memcpy(tensor->mutable_data(target, type), data, size);
+    }
+  } else if (target.arch == Target::Arch::NVGPU) {
+#ifdef CINN_WITH_CUDA
+    if (desc.data_type() != framework_proto::VarType::Type::VarType_Type_FP32)
+      LOG(FATAL) << "[CUDA] The type is not fp32!!";
+    auto *dst = tensor->mutable_data<float>(target);
+    CUDA_CALL(cudaMemcpy(reinterpret_cast<void *>(dst), data, size, cudaMemcpyHostToDevice));
+#else
+    LOG(FATAL) << "To use CUDA backends, you need to set WITH_CUDA ON!";
+#endif
+  } else {
+    CINN_NOT_IMPLEMENTED
+  }
+}
+
+void LoDTensorFromMemory(MemoryReader *reader,
+                         hlir::framework::Variable *var,
+                         const common::Target &target,
+                         const std::shared_ptr<MappedFile> &file) {
+  auto &tensor     = absl::get<hlir::framework::Tensor>(*var);
+  uint32_t version = reader->Read<uint32_t>();
+  VLOG(3) << "model version " << version;
+
+  // Skip LoD information
+  uint64_t lod_level = reader->Read<uint64_t>();
+  for (uint64_t i = 0; i < lod_level; ++i) {
+    uint64_t size = reader->Read<uint64_t>();
+    reader->Skip(size);
+  }
+
+  TensorFromMemory(reader, tensor.operator->(), target, file);
+}
+
 void LoadLoDTensor(std::istream &is, hlir::framework::Variable *var, const common::Target &target) {
   auto &tensor = absl::get<hlir::framework::Tensor>(*var);
   uint32_t version{};
@@ -157,11 +307,39 @@ void LoadParams(const std::string &path) {}
 
 // Load directly to CPU, and latter transfer to other devices.
 void LoadParam(const std::string &path, hlir::framework::Variable *out, const common::Target &target) {
+  if (FLAGS_cinn_mmap_params) {
+    auto file = std::make_shared<MappedFile>(path);
+    MemoryReader reader(file->data(), file->data() + file->size());
+    LoDTensorFromMemory(&reader, out, target, file);
+    return;
+  }
   std::ifstream fin(path, std::ios::binary);
   CHECK(fin.is_open()) << "failed to open file " << path;
   LoadLoDTensor(fin, out, target);
 }
 
+// Load the parameters stored in separate files in parallel, the variables should be created in the scope already
+// since the scope is not thread-safe.
+void LoadSeparateParams(const std::vector<std::pair<std::string, hlir::framework::Variable *>> &params,
+                        const common::Target &target) {
+  size_t num_threads = std::min<size_t>(params.size(), std::max(std::thread::hardware_concurrency(), 1U));
+  std::atomic<size_t> next{0};
+  auto load_func = [&]() {
+    for (size_t i = next++; i < params.size(); i = next++) {
+      VLOG(4) << "reading weight " << params[i].first;
+      LoadParam(params[i].first, params[i].second, target);
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(load_func);
+  }
+  load_func();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
 bool IsPersistable(const cpp::VarDesc &var) {
   if (var.Persistable() && var.GetType() != cpp::VarDescAPI::Type::FEED_MINIBATCH &&
       var.GetType() != cpp::VarDescAPI::Type::FETCH_LIST && var.GetType() != cpp::VarDescAPI::Type::RAW) {
@@ -201,9 +379,19 @@ void LoadCombinedParamsPb(const std::string &path,
                     << " LoadCombinedParamsPb, use LoadParam instead.";
   };
 
-  if (params_from_memory) {
-    std::stringstream fin(path, std::ios::in | std::ios::binary);
-    load_var_func(fin);
+  if (params_from_memory || FLAGS_cinn_mmap_params) {
+    // the path holds the content of the parameters if they are from memory, which is copied into the tensors
+    std::shared_ptr<MappedFile> file;
+    if (!params_from_memory) file = std::make_shared<MappedFile>(path);
+    const char *begin = params_from_memory ? path.data() : file->data();
+    const char *end   = begin + (params_from_memory ? path.size() : file->size());
+    MemoryReader reader(begin, end);
+    for (size_t i = 0; i < paramlist.size(); ++i) {
+      auto *var = scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(paramlist[i]));
+      LoDTensorFromMemory(&reader, var, target, file);
+    }
+    CHECK(reader.eof()) << "You are not allowed to load partial data via"
+                        << " LoadCombinedParamsPb, use LoadParam instead.";
   } else {
     std::ifstream fin(path, std::ios::binary);
     CHECK(fin.is_open());
@@ -248,21 +436,20 @@ void LoadModelPb(const std::string &model_dir,
     LoadCombinedParamsPb(param_file_temp, scope, *cpp_prog, model_from_memory, target);
   } else {
     auto main_block = pb_proto_prog.blocks(0);
+    std::vector<std::pair<std::string, hlir::framework::Variable *>> params;
     for (auto &var : main_block.vars()) {
       if (var.name() == "feed" || var.name() == "fetch" || !var.persistable()) continue;
 
       std::string file_path = model_dir + "/" + var.name();
-      VLOG(4) << "reading weight " << var.name();
-
-      std::ifstream file(file_path, std::ios::binary);
       switch (var.type().type()) {
         case framework_proto::VarType_Type_LOD_TENSOR:
-          LoadLoDTensor(file, scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(var.name())), target);
+          params.emplace_back(file_path, scope->Var<hlir::framework::Tensor>(utils::TransValidVarName(var.name())));
           break;
         default:
           LOG(FATAL) << "unknown weight type";
       }
     }
+    LoadSeparateParams(params, target);
   }
 
   VLOG(4) << "Load protobuf model in [" << model_dir << "] successfully";
@@ -17,10 +17,83 @@
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
 DEFINE_string(model_dir, "<NOTEXIST>", "model directory path");
+DECLARE_bool(cinn_mmap_params);
 
 namespace cinn::frontend::paddle {
 
+namespace {
+
+// Write a float32 parameter in the format of paddle's save op: the LoD header followed by the tensor. Return the offset
+// of the data in the file, which depends on the size of the serialized dims.
+size_t SaveParam(const std::string& path, const std::vector<int64_t>& dims, const std::vector<float>& values) {
+  std::ofstream fout(path, std::ios::binary);
+  CHECK(fout.is_open()) << "failed to open file " << path;
+  uint32_t version   = 0;
+  uint64_t lod_level = 0;
+  fout.write(reinterpret_cast<const char*>(&version), sizeof(version));
+  fout.write(reinterpret_cast<const char*>(&lod_level), sizeof(lod_level));
+  fout.write(reinterpret_cast<const char*>(&version), sizeof(version));
+
+  framework_proto::VarType::TensorDesc desc;
+  desc.set_data_type(framework_proto::VarType::FP32);
+  for (auto dim : dims) {
+    desc.add_dims(dim);
+  }
+  std::string desc_str = desc.SerializeAsString();
+  int32_t size         = desc_str.size();
+  fout.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  fout.write(desc_str.data(), size);
+  size_t data_offset = fout.tellp();
+  fout.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+  return data_offset;
+}
+
+// Load a parameter of \p dims with and without mmap, and check both get the same tensor. The mapped data is aliased
+// only if it is aligned to the float size in the file.
+void CheckLoadParam(const std::vector<int64_t>& dims, bool aligned) {
+  const std::string path = "load_param_test.bin";
+  std::vector<int> shape(dims.begin(), dims.end());
+  std::vector<float> values(hlir::framework::Shape(shape).numel());
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = i * 0.5f - 7.f;
+  }
+  size_t data_offset = SaveParam(path, dims, values);
+  ASSERT_EQ(data_offset % sizeof(float) == 0, aligned) << "The data is at offset " << data_offset;
+
+  bool mmap_params = FLAGS_cinn_mmap_params;
+  hlir::framework::Scope scope;
+  auto* copied           = scope.Var<hlir::framework::Tensor>("copied");
+  auto* mapped           = scope.Var<hlir::framework::Tensor>("mapped");
+  FLAGS_cinn_mmap_params = false;
+  LoadParam(path, copied, common::DefaultHostTarget());
+  FLAGS_cinn_mmap_params = true;
+  LoadParam(path, mapped, common::DefaultHostTarget());
+  FLAGS_cinn_mmap_params = mmap_params;
+  // the mapping is kept alive by the aliasing tensor after the file is removed.
+  std::remove(path.c_str());
+
+  auto copied_tensor = scope.GetTensor("copied");
+  auto mapped_tensor = scope.GetTensor("mapped");
+  ASSERT_EQ(copied_tensor->shape().data(), shape);
+  ASSERT_EQ(mapped_tensor->shape().data(), copied_tensor->shape().data());
+  ASSERT_EQ(mapped_tensor->type(), copied_tensor->type());
+  ASSERT_FALSE(copied_tensor->get_buffer()->is_external());
+  // the misaligned data falls back to a copy.
+  ASSERT_EQ(mapped_tensor->get_buffer()->is_external(), aligned);
+  ASSERT_NE(mapped_tensor->data<float>(), copied_tensor->data<float>());
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(copied_tensor->data<float>()[i], values[i]);
+    ASSERT_EQ(mapped_tensor->data<float>()[i], values[i]);
+  }
+}
+
+}  // namespace
+
 TEST(LoadModelPb, naive_model) {
   hlir::framework::Scope scope;
   cpp::ProgramDesc program_desc;
@@ -42,4 +115,10 @@ TEST(LoadModelPb, naive_model) {
   // fetch
 }
 
+// The header takes 20 bytes before the serialized desc, which takes 2 bytes for the dtype and 2 bytes for each small
+// dim, so 3 dims leave the data aligned and 2 dims don't.
+TEST(LoadParam, mmap_same_as_copy) { CheckLoadParam({3, 10, 10}, true); }
+
+TEST(LoadParam, mmap_misaligned_copy) { CheckLoadParam({3, 100}, false); }
+
 }  // namespace cinn::frontend::paddle
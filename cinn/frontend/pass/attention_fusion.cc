@@ -0,0 +1,209 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/cinn_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+#include "glog/logging.h"
+
+namespace cinn::frontend::pass {
+
+// Pass `AttentionFusion` rewrites the attention of transformers
+//   scores = matmul(q, k, trans_b=true, alpha) -> [scale] -> softmax(axis=-1) -> matmul(scores, v)
+// into a single fused_attention, which computes the scores block by block with the online softmax and never
+// materializes the seq_q x seq_k score matrix. It runs after TransposeFolding, which folds the transpose of k into
+// the matmul. The intermediate results should be used only once and not be fetched.
+class AttentionFusionPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) const override {
+    if (target.arch != Target::Arch::X86 || !program->size()) {
+      return;
+    }
+
+    absl::flat_hash_map<_Variable_*, Instruction*> out2instr;
+    absl::flat_hash_map<_Variable_*, int> var_used_count;
+    for (size_t i = 0; i < program->size(); i++) {
+      auto& instr = (*program)[i];
+      for (auto& var : instr->outputs) {
+        out2instr[var.get()] = &instr;
+      }
+      for (auto& var : instr->inputs) {
+        var_used_count[var.get()]++;
+      }
+    }
+
+    // `remove_instrs` are the instructions fused into the attention, and `attentions` maps the last matmul of each
+    // matched attention to the fused one.
+    absl::flat_hash_set<_Instruction_*> remove_instrs;
+    absl::flat_hash_map<_Instruction_*, Attention> attentions;
+    for (size_t i = 0; i < program->size(); i++) {
+      auto& instr = (*program)[i];
+      Attention attention;
+      if (MatchAttention(instr, out2instr, var_used_count, fetch_ids, &attention)) {
+        for (auto* fused : attention.fused_instrs) {
+          remove_instrs.insert(fused);
+        }
+        attentions.emplace(instr.get(), attention);
+      }
+    }
+    if (attentions.empty()) {
+      return;
+    }
+    VLOG(4) << "-- Before fusing " << attentions.size() << " attentions: " << *program;
+
+    CinnBuilder builder("attention_fusion_builder");
+    for (auto& var : program->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    absl::flat_hash_map<_Variable_*, Variable> origin2new;
+    for (size_t i = 0; i < program->size(); i++) {
+      auto& instr = (*program)[i];
+      if (remove_instrs.count(instr.get())) {
+        continue;
+      }
+      auto it = attentions.find(instr.get());
+      if (it == attentions.end()) {
+        builder.AppendInstruction(instr);
+        continue;
+      }
+      const auto& attention = it->second;
+      const auto& new_outs =
+          builder.CustomInstr("fused_attention", {attention.q, attention.k, attention.v}, {{"scale", attention.scale}});
+      auto new_out = new_outs[0];
+      auto old_out = instr.GetOutput(0);
+      new_out.set_id(old_out->id);
+      origin2new.emplace(old_out.get(), new_out);
+    }
+    *program = builder.Build();
+
+    // relink old outputs to new outputs
+    for (size_t i = 0; i < program->size(); i++) {
+      auto& inputs = (*program)[i]->inputs;
+      for (size_t j = 0; j < inputs.size(); j++) {
+        if (origin2new.count(inputs[j].get())) {
+          inputs[j] = origin2new.at(inputs[j].get());
+        }
+      }
+    }
+    VLOG(4) << "-- After fusing attentions: " << *program;
+  }
+
+ private:
+  struct Attention {
+    Variable q;
+    Variable k;
+    Variable v;
+    float scale = 1.f;
+    // the instructions replaced by the fused one, except the last matmul.
+    std::vector<_Instruction_*> fused_instrs;
+  };
+
+  template <typename T>
+  static T GetAttrOr(const Instruction& instr, const std::string& key, T default_value) {
+    return instr->attrs.count(key) ? instr.GetAttrs<T>(key) : default_value;
+  }
+
+  // Get the instruction producing \p var if \p var is used only by the next instruction of the pattern.
+  static Instruction* GetSingleUseProducer(const Variable& var,
+                                           const absl::flat_hash_map<_Variable_*, Instruction*>& out2instr,
+                                           const absl::flat_hash_map<_Variable_*, int>& var_used_count,
+                                           const std::unordered_set<std::string>& fetch_ids) {
+    auto it = out2instr.find(var.get());
+    if (it == out2instr.end() || fetch_ids.count(var->id) || var_used_count.at(var.get()) > 1) {
+      return nullptr;
+    }
+    return it->second;
+  }
+
+  static bool MatchAttention(const Instruction& pv_matmul,
+                             const absl::flat_hash_map<_Variable_*, Instruction*>& out2instr,
+                             const absl::flat_hash_map<_Variable_*, int>& var_used_count,
+                             const std::unordered_set<std::string>& fetch_ids,
+                             Attention* attention) {
+    if (pv_matmul->op_type != "matmul" || GetAttrOr(pv_matmul, "trans_a", false) ||
+        GetAttrOr(pv_matmul, "trans_b", false) || GetAttrOr(pv_matmul, "alpha", 1.f) != 1.f) {
+      return false;
+    }
+    auto* softmax = GetSingleUseProducer(pv_matmul->inputs[0], out2instr, var_used_count, fetch_ids);
+    if (!softmax || (*softmax)->op_type != "softmax" || softmax->GetOutput(0).get() != pv_matmul->inputs[0].get()) {
+      return false;
+    }
+    int rank = (*softmax)->inputs[0]->shape.size();
+    int axis = GetAttrOr(*softmax, "axis", -1);
+    if (axis != -1 && axis != rank - 1) {
+      return false;
+    }
+
+    float scale  = 1.f;
+    auto* scores = GetSingleUseProducer((*softmax)->inputs[0], out2instr, var_used_count, fetch_ids);
+    if (scores && (*scores)->op_type == "scale") {
+      if (GetAttrOr(*scores, "bias", 0.f) != 0.f) {
+        return false;
+      }
+      attention->fused_instrs.push_back(scores->get());
+      scale  = GetAttrOr(*scores, "scale", 1.f);
+      scores = GetSingleUseProducer((*scores)->inputs[0], out2instr, var_used_count, fetch_ids);
+    }
+    if (!scores || (*scores)->op_type != "matmul" || GetAttrOr(*scores, "trans_a", false) ||
+        !GetAttrOr(*scores, "trans_b", false)) {
+      return false;
+    }
+
+    const auto& q = (*scores)->inputs[0];
+    const auto& k = (*scores)->inputs[1];
+    const auto& v = pv_matmul->inputs[1];
+    // the leading dimensions should be the same without broadcasting.
+    if (q->shape.size() < 2 || q->shape.size() != k->shape.size() || q->shape.size() != v->shape.size() ||
+        !q->type.is_float(32)) {
+      return false;
+    }
+    for (size_t i = 0; i + 2 < q->shape.size(); i++) {
+      if (q->shape[i] != k->shape[i] || q->shape[i] != v->shape[i]) {
+        return false;
+      }
+    }
+    if (q->shape.back() != k->shape.back() || k->shape[k->shape.size() - 2] != v->shape[v->shape.size() - 2]) {
+      return false;
+    }
+
+    attention->q     = q;
+    attention->k     = k;
+    attention->v     = v;
+    attention->scale = scale * GetAttrOr(*scores, "alpha", 1.f);
+    attention->fused_instrs.push_back(scores->get());
+    attention->fused_instrs.push_back(softmax->get());
+    return true;
+  }
+};
+
+}  // namespace cinn::frontend::pass
+
+CINN_REGISTER_HELPER(AttentionFusion) {
+  CINN_REGISTER_PROGRAM_PASS(AttentionFusion, ::cinn::frontend::pass::AttentionFusionPass);
+
+  return true;
+}
@@ -0,0 +1,122 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/tensor.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+#include "gtest/gtest.h"
+
+namespace cinn::frontend {
+
+namespace {
+
+std::vector<float> RunProgram(const Program& program,
+                              const Target& target,
+                              const std::vector<std::string>& input_ids,
+                              const std::string& output_id) {
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = hlir::framework::BuildScope(target, graph);
+  // the same inputs for the origin and the fused program.
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  for (auto& input_id : input_ids) {
+    scope->Var<hlir::framework::Tensor>(input_id);
+    auto input_tensor = scope->GetTensor(input_id);
+    auto* data        = input_tensor->mutable_data<float>(target);
+    for (size_t i = 0; i < input_tensor->shape().numel(); i++) {
+      data[i] = dist(engine);
+    }
+  }
+
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  runtime_program->Execute();
+
+  auto output_tensor = scope->GetTensor(output_id);
+  const float* data  = output_tensor->data<float>();
+  return std::vector<float>(data, data + output_tensor->shape().numel());
+}
+
+void CompareResult(Program* program,
+                   const Target& target,
+                   const std::vector<std::string>& input_ids,
+                   const std::string& output_id,
+                   size_t size_diff) {
+  std::unordered_set<std::string> fetch_ids({output_id});
+  ProgramPass::Apply(program, fetch_ids, target, {"Decomposer", "TransposeFolding"});
+  auto origin_size = program->size();
+  auto origin_out  = RunProgram(*program, target, input_ids, output_id);
+
+  ProgramPass::Apply(program, fetch_ids, target, {"AttentionFusion"});
+  ASSERT_EQ(size_diff, origin_size - program->size());
+  auto fused_out = RunProgram(*program, target, input_ids, output_id);
+
+  ASSERT_EQ(origin_out.size(), fused_out.size());
+  for (size_t i = 0; i < origin_out.size(); ++i) {
+    ASSERT_NEAR(origin_out[i], fused_out[i], 1e-4);
+  }
+}
+
+}  // namespace
+
+TEST(AttentionFusion, ScaledDotProduct) {
+  NetBuilder builder("net_builder");
+  auto q       = builder.CreateInput(Float(32), {4, 40, 16}, "Q");
+  auto k       = builder.CreateInput(Float(32), {4, 150, 16}, "K");
+  auto v       = builder.CreateInput(Float(32), {4, 150, 8}, "V");
+  auto k_t     = builder.Transpose(k, {0, 2, 1});
+  auto scores  = builder.Matmul(q, k_t);
+  auto scaled  = builder.Scale(scores, 0.25f);
+  auto probs   = builder.Softmax(scaled, -1);
+  auto out     = builder.Matmul(probs, v);
+  auto program = builder.Build();
+
+  // matmul, scale, softmax and matmul are fused into one.
+  CompareResult(&program, common::DefaultHostTarget(), {"Q", "K", "V"}, out->id, 3);
+}
+
+TEST(AttentionFusion, SharedProbs) {
+  NetBuilder builder("net_builder");
+  auto q       = builder.CreateInput(Float(32), {2, 8, 16}, "Q");
+  auto k       = builder.CreateInput(Float(32), {2, 16, 16}, "K");
+  auto v       = builder.CreateInput(Float(32), {2, 16, 8}, "V");
+  auto k_t     = builder.Transpose(k, {0, 2, 1});
+  auto scores  = builder.Matmul(q, k_t);
+  auto probs   = builder.Softmax(scores, -1);
+  auto out     = builder.Matmul(probs, v);
+  auto sum     = builder.Add(probs, probs);
+  auto program = builder.Build();
+
+  // the probabilities are used by another instruction, nothing is fused.
+  std::unordered_set<std::string> fetch_ids({out->id, sum->id});
+  ProgramPass::Apply(&program, fetch_ids, common::DefaultHostTarget(), {"TransposeFolding"});
+  auto origin_size = program.size();
+  ProgramPass::Apply(&program, fetch_ids, common::DefaultHostTarget(), {"AttentionFusion"});
+  ASSERT_EQ(origin_size, program.size());
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,115 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <absl/container/flat_hash_map.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/cinn_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+#include "glog/logging.h"
+
+namespace cinn::frontend::pass {
+
+// Pass `CommonSubexpressionElimination` removes the instructions computing the same op with the same attributes on
+// the same inputs as an earlier instruction, such as the reshapes, broadcasts and casts of a weight duplicated by the
+// model importers. The uses of their outputs are replaced by the outputs of the earlier one, so the duplicated
+// subgraphs are merged from the inputs on. The instructions whose outputs are fetched are kept.
+class CommonSubexpressionEliminationPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) const override {
+    CinnBuilder builder("common_subexpression_elimination_builder");
+    for (auto& var : program->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    // `replaced` maps the outputs of the removed instructions to the ones of the instructions kept.
+    absl::flat_hash_map<_Variable_*, Variable> replaced;
+    absl::flat_hash_map<size_t, std::vector<Instruction>> kept_instrs;
+    int remove_num = 0;
+    for (size_t i = 0; i < program->size(); i++) {
+      auto& instr = (*program)[i];
+      for (auto& in : instr->inputs) {
+        auto it = replaced.find(in.get());
+        if (it != replaced.end()) {
+          in = it->second;
+        }
+      }
+
+      auto& candidates = kept_instrs[Hash(instr)];
+      auto same_it     = std::find_if(
+          candidates.begin(), candidates.end(), [&](const Instruction& other) { return IsSame(instr, other); });
+      if (same_it == candidates.end() || IsFetched(instr, fetch_ids)) {
+        candidates.push_back(instr);
+        builder.AppendInstruction(instr);
+        continue;
+      }
+      VLOG(3) << "Remove instruction " << instr << ", which is the same as " << *same_it;
+      for (size_t j = 0; j < instr->outputs.size(); j++) {
+        replaced.emplace(instr->outputs[j].get(), (*same_it)->outputs[j]);
+      }
+      remove_num++;
+    }
+    VLOG(3) << "Total remove " << remove_num << " common subexpressions.";
+    *program = builder.Build();
+  }
+
+ private:
+  static size_t Hash(const Instruction& instr) {
+    size_t seed  = std::hash<std::string>()(instr->op_type);
+    auto combine = [&seed](size_t value) { seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2); };
+    for (auto& in : instr->inputs) {
+      combine(std::hash<_Variable_*>()(in.get()));
+    }
+    combine(instr->attrs.size());
+    combine(instr->outputs.size());
+    return seed;
+  }
+
+  static bool IsSame(const Instruction& a, const Instruction& b) {
+    if (a->op_type != b->op_type || a->outputs.size() != b->outputs.size() || a->inputs.size() != b->inputs.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < a->inputs.size(); i++) {
+      if (a->inputs[i].get() != b->inputs[i].get()) {
+        return false;
+      }
+    }
+    return a->attrs == b->attrs;
+  }
+
+  static bool IsFetched(const Instruction& instr, const std::unordered_set<std::string>& fetch_ids) {
+    return std::any_of(instr->outputs.begin(), instr->outputs.end(), [&](const Variable& out) {
+      return fetch_ids.count(out->id);
+    });
+  }
+};
+
+}  // namespace cinn::frontend::pass
+
+CINN_REGISTER_HELPER(CommonSubexpressionElimination) {
+  CINN_REGISTER_PROGRAM_PASS(CommonSubexpressionElimination,
+                             ::cinn::frontend::pass::CommonSubexpressionEliminationPass);
+
+  return true;
+}
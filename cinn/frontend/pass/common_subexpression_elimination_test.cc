@@ -0,0 +1,96 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/framework/tensor.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn::frontend {
+
+namespace {
+
+std::vector<float> RunProgram(const Program& program, const Target& target, const std::string& output_id) {
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  auto scope = hlir::framework::BuildScope(target, graph);
+  scope->Var<hlir::framework::Tensor>("X");
+  auto input_tensor = scope->GetTensor("X");
+  auto* input_data  = input_tensor->mutable_data<float>(target);
+  for (size_t i = 0; i < input_tensor->shape().numel(); i++) {
+    input_data[i] = static_cast<float>(i % 11) - 5.f;
+  }
+
+  hlir::framework::ApplyPass(graph.get(), "OpFusion");
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  runtime_program->Execute();
+
+  auto output_tensor = scope->GetTensor(output_id);
+  const float* data  = output_tensor->data<float>();
+  return std::vector<float>(data, data + output_tensor->shape().numel());
+}
+
+}  // namespace
+
+TEST(CommonSubexpressionElimination, DuplicatedSubgraph) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {32, 16}, "X");
+  auto r1      = builder.Reshape(x, {16, 32});
+  auto r2      = builder.Reshape(x, {16, 32});
+  auto s1      = builder.Relu(r1);
+  auto s2      = builder.Relu(r2);
+  auto out     = builder.Add(s1, s2);
+  auto program = builder.Build();
+
+  auto target      = common::DefaultHostTarget();
+  auto origin_out  = RunProgram(program, target, out->id);
+  auto origin_size = program.size();
+  // the second reshape and the relu on it are the same as the first ones.
+  ProgramPass::Apply(&program, {out->id}, target, {"CommonSubexpressionElimination"});
+  ASSERT_EQ(origin_size, program.size() + 2);
+
+  auto cse_out = RunProgram(program, target, out->id);
+  ASSERT_EQ(origin_out.size(), cse_out.size());
+  for (size_t i = 0; i < origin_out.size(); ++i) {
+    ASSERT_FLOAT_EQ(origin_out[i], cse_out[i]);
+  }
+}
+
+TEST(CommonSubexpressionElimination, KeepDifferentAttrsAndFetched) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {32, 16}, "X");
+  auto r1      = builder.Reshape(x, {16, 32});
+  auto r2      = builder.Reshape(x, {512});
+  auto r3      = builder.Reshape(x, {16, 32});
+  auto program = builder.Build();
+
+  // r2 has different attributes and r3 is fetched, nothing is removed.
+  auto origin_size = program.size();
+  ProgramPass::Apply(
+      &program, {r1->id, r2->id, r3->id}, common::DefaultHostTarget(), {"CommonSubexpressionElimination"});
+  ASSERT_EQ(origin_size, program.size());
+}
+
+}  // namespace cinn::frontend
@@ -0,0 +1,89 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <absl/container/flat_hash_set.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/cinn_builder.h"
+#include "cinn/frontend/program_pass.h"
+#include "cinn/frontend/syntax.h"
+#include "glog/logging.h"
+
+namespace cinn::frontend::pass {
+
+// Pass `DeadCodeElimination` removes the instructions whose outputs are neither in `fetch_ids` nor used by the
+// instructions kept, such as the ones left unused by `CommonSubexpressionElimination` or by the model importers.
+// The instructions are visited in reverse order so the whole dead subgraph is removed in one pass. Nothing is
+// removed without `fetch_ids` or when no instruction computes them, since every output may be the result then.
+class DeadCodeEliminationPass : public ProgramPass {
+ public:
+  using ProgramPass::ProgramPass;
+
+ protected:
+  void ApplyImpl(Program* program,
+                 const std::unordered_set<std::string>& fetch_ids,
+                 const common::Target& target) const override {
+    if (fetch_ids.empty()) {
+      return;
+    }
+    absl::flat_hash_set<std::string> used_vars(fetch_ids.begin(), fetch_ids.end());
+    std::vector<bool> is_dead(program->size(), true);
+    int remove_num = program->size();
+    for (int i = program->size() - 1; i >= 0; --i) {
+      const auto& instr = (*program)[i];
+      for (const auto& out : instr->outputs) {
+        if (used_vars.count(out->id)) {
+          is_dead[i] = false;
+          break;
+        }
+      }
+      if (is_dead[i]) {
+        VLOG(3) << "Find dead instruction: " << instr;
+        continue;
+      }
+      remove_num--;
+      for (const auto& in : instr->inputs) {
+        used_vars.insert(in->id);
+      }
+    }
+    // the fetch ids are not computed by the program, e.g. only the inputs are fetched, it is kept as it is.
+    if (!remove_num || remove_num == program->size()) {
+      return;
+    }
+    VLOG(3) << "Total remove " << remove_num << " dead instructions.";
+
+    CinnBuilder builder("dead_code_elimination_builder");
+    for (auto& var : program->GetInputs()) {
+      builder.CreateInput(var);
+    }
+    for (int i = 0; i < program->size(); i++) {
+      if (!is_dead[i]) {
+        builder.AppendInstruction((*program)[i]);
+      }
+    }
+    *program = builder.Build();
+  }
+};
+
+}  // namespace cinn::frontend::pass
+
+CINN_REGISTER_HELPER(DeadCodeElimination) {
+  CINN_REGISTER_PROGRAM_PASS(DeadCodeElimination, ::cinn::frontend::pass::DeadCodeEliminationPass);
+
+  return true;
+}
@@ -0,0 +1,44 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/frontend/pass/use_program_pass.h"
+#include "cinn/frontend/program_pass.h"
+
+namespace cinn::frontend {
+
+TEST(DeadCodeElimination, RemoveUnusedSubgraph) {
+  NetBuilder builder("net_builder");
+  auto x       = builder.CreateInput(Float(32), {32, 16}, "X");
+  auto r       = builder.Reshape(x, {16, 32});
+  auto unused  = builder.Relu(builder.Cast(r, "float64"));
+  auto out     = builder.Relu(x);
+  auto program = builder.Build();
+
+  // the reshape, the cast and the relu on them are not used by the fetched output.
+  auto target      = common::DefaultHostTarget();
+  auto origin_size = program.size();
+  ProgramPass::Apply(&program, {out->id}, target, {"DeadCodeElimination"});
+  ASSERT_EQ(program.size(), 1);
+  ASSERT_EQ(program[0]->outputs[0]->id, out->id);
+
+  // nothing is removed without fetch ids.
+  auto unchanged = builder.Build();
+  ProgramPass::Apply(&unchanged, {}, target, {"DeadCodeElimination"});
+  ASSERT_EQ(unchanged.size(), origin_size);
+}
+
+}  // namespace cinn::frontend
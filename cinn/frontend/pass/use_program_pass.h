@@ -20,3 +20,6 @@ CINN_USE_REGISTER(Decomposer)
 CINN_USE_REGISTER(RemoveIdentity)
 CINN_USE_REGISTER(TransposeFolding)
 CINN_USE_REGISTER(GemmRewriter)
+CINN_USE_REGISTER(AttentionFusion)
+CINN_USE_REGISTER(CommonSubexpressionElimination)
+CINN_USE_REGISTER(DeadCodeElimination)
@@ -14,8 +14,15 @@
 
 #include "cinn/frontend/program_pass.h"
 
+#include <gflags/gflags.h>
+
 #include <unordered_set>
 
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/utils/timer.h"
+
+DECLARE_bool(cinn_pass_profile);
+
 namespace cinn {
 namespace frontend {
 
@@ -28,8 +35,18 @@ void ProgramPass::Apply(Program* prog,
     const auto* pass = ProgramPassRegistry::Global()->Get(name);
     fpass.push_back(pass);
   }
-  for (const auto* pass : fpass) {
-    pass->ApplyImpl(prog, fetch_ids, target);
+  for (size_t i = 0; i < fpass.size(); i++) {
+    if (!FLAGS_cinn_pass_profile) {
+      fpass[i]->ApplyImpl(prog, fetch_ids, target);
+      continue;
+    }
+    utils::Timer timer;
+    int64_t peak_memory = hlir::framework::PassProfiler::PeakMemoryKB();
+    timer.Start();
+    fpass[i]->ApplyImpl(prog, fetch_ids, target);
+    double time_ms = timer.Stop();
+    hlir::framework::PassProfiler::Global()->Record(
+        passes[i], time_ms, 0, hlir::framework::PassProfiler::PeakMemoryKB() - peak_memory);
   }
 }
 
@@ -14,6 +14,8 @@
 
 #include "cinn/hlir/framework/buffer.h"
 
+#include <utility>
+
 namespace cinn {
 namespace hlir {
 namespace framework {
@@ -49,6 +51,20 @@ void Buffer::SetTarget(const common::Target& target) {
   memory_mng_cache_ = MemoryManager::Global().RetrieveSafely(target_.arch);
 }
 
+void Buffer::ShareExternalMemory(void* memory,
+                                 uint32_t size,
+                                 const common::Target& target,
+                                 std::shared_ptr<void> holder) {
+  CHECK(memory) << "The external memory should not be null";
+  Free();
+  SetTarget(target);
+  data_.memory      = reinterpret_cast<uint8_t*>(memory);
+  data_.memory_size = size;
+  size_             = size;
+  is_external_      = true;
+  external_holder_  = std::move(holder);
+}
+
 void Buffer::ResizeLazy(uint32_t size) {
   if (size <= size_) return;
   Resize(size);
@@ -53,12 +53,34 @@ struct Buffer final {
 
   void SetTarget(const common::Target& target);
 
+  /**
+   * Use the external memory \p memory of \p size bytes in target \p target without copying.
+   * The memory is not owned by this buffer, it should outlive the use of this buffer, or be kept alive by the
+   * optional \p holder, which is released when the memory is detached.
+   */
+  void ShareExternalMemory(void* memory,
+                           uint32_t size,
+                           const common::Target& target,
+                           std::shared_ptr<void> holder = nullptr);
+
+  //! Whether the memory is external, that is not owned by this buffer.
+  bool is_external() const { return is_external_; }
+
+  //! The place where the memory locates.
+  const common::Target& target() const { return target_; }
+
   const cinn_buffer_t* data() const { return &data_; }
   cinn_buffer_t* data() { return &data_; }
 
-  //! Free all the memory owned by this buffer.
+  //! Free all the memory owned by this buffer, the external memory is just detached.
   void Free() {
     if (!data_.memory) return;
+    if (is_external_) {
+      data_.memory = nullptr;
+      is_external_ = false;
+      external_holder_.reset();
+      return;
+    }
     memory_mng_cache_->free(data_.memory);
   }
 
@@ -84,6 +106,11 @@ struct Buffer final {
 
   //! Hold the corresponding memory manager for speed.
   MemoryInterface* memory_mng_cache_{};
+
+  //! Whether data_.memory is bound by ShareExternalMemory.
+  bool is_external_{false};
+  //! Keep the external memory alive.
+  std::shared_ptr<void> external_holder_;
 };
 
 }  // namespace framework
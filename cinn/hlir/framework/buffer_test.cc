@@ -31,6 +31,25 @@ TEST(Buffer, basic) {
   for (int i = 0; i < 10; i++) data[i] = i;
 }
 
+TEST(Buffer, share_external_memory) {
+  std::vector<float> external(10, 1.f);
+  Buffer buffer(common::DefaultHostTarget());
+  buffer.Resize(10 * sizeof(float));
+  buffer.ShareExternalMemory(external.data(), external.size() * sizeof(float), common::DefaultHostTarget());
+  ASSERT_TRUE(buffer.is_external());
+  ASSERT_EQ(buffer.data()->memory, reinterpret_cast<uint8_t*>(external.data()));
+
+  // a lazy resize within the external memory keeps it
+  buffer.ResizeLazy(5 * sizeof(float));
+  ASSERT_EQ(buffer.data()->memory, reinterpret_cast<uint8_t*>(external.data()));
+
+  // a larger resize allocates the memory owned by the buffer
+  buffer.ResizeLazy(20 * sizeof(float));
+  ASSERT_FALSE(buffer.is_external());
+  ASSERT_NE(buffer.data()->memory, reinterpret_cast<uint8_t*>(external.data()));
+  buffer.Free();
+}
+
 #ifdef CINN_WITH_CUDA
 TEST(Buffer, nvgpu) {
   const int num_elements = 10;
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cinn/common/graph_utils.h"
@@ -43,6 +44,10 @@ class Graph : public cinn::common::Graph {
   /** \brief attributes of a graph */
   absl::flat_hash_map<std::string, std::shared_ptr<absl::any>> attrs;
 
+  /** \brief analyses of the graph cached by the passes with the topology version they are built at, see GetAnalysis
+   * in pass.h */
+  absl::flat_hash_map<std::string, std::pair<std::shared_ptr<absl::any>, uint64_t>> analyses;
+
   std::vector<std::vector<Node*>> groups;
   struct Group {
     std::string group_id{""};
@@ -22,6 +22,7 @@
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/common/context.h"
 #include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/memory_planner.h"
 #include "cinn/hlir/framework/op_lowering.h"
 #include "cinn/hlir/framework/tensor.h"
 #include "cinn/hlir/pe/schedule.h"
@@ -212,6 +213,14 @@ void Program::Execute(const std::map<std::string, cinn_pod_value_t>* name2podarg
 #endif
 }
 
+std::unique_ptr<Program> Program::Clone(const std::shared_ptr<Scope>& scope) const {
+  std::vector<std::unique_ptr<Instruction>> instrs;
+  for (auto& ins : instrs_) {
+    instrs.push_back(ins->CloneWithScope(scope.get()));
+  }
+  return std::unique_ptr<Program>(new Program(scope, std::move(instrs)));
+}
+
 void Program::ExecuteTest(int repeat_) {
   cinn::utils::Timer timer1;
   for (int i = 0; i < 100; i++) {
@@ -602,6 +611,36 @@ void GraphCompiler::ProcessFunction(const std::vector<ir::LoweredFunc>& lowered_
   } else {
     m_builder_.AddFunction(lowered_func[0]);
   }
+  if (pipelined_compiler_ && ++module_group_num_ >= compile_options_.pipelined_compile_groups) {
+    SubmitModule();
+  }
+}
+
+void GraphCompiler::SubmitModule() {
+  if (module_group_num_ == 0) {
+    return;
+  }
+  VLOG(3) << "Submit the module of " << module_group_num_ << " groups to compile in the background";
+  auto build_module = m_builder_.Build();
+  if (VLOG_IS_ON(3) && this->target_.arch == Target::Arch::X86) {
+    CodeGenCX86 codegen(this->target_, CodeGenCX86::Feature::AVX512);
+    codegen.SetInlineBuiltinCodes(false);
+    auto out = codegen.Compile(build_module, CodeGenC::OutputKind::CImpl);
+    VLOG(3) << "[X86] C Code is:\n" << out;
+  }
+  pipelined_compiler_->Submit(build_module);
+  m_builder_.Clear();
+  module_group_num_ = 0;
+}
+
+void GraphCompiler::SetLoweredFunc(Instruction* instr, const std::string& func_name) {
+  if (pipelined_compiler_) {
+    instr->SetLoweredFunc(nullptr, func_name);
+    return;
+  }
+  auto* fn = compiler_->Lookup(func_name);
+  CHECK(fn) << "Function [" << func_name << "] is not found";
+  instr->SetLoweredFunc(fn, func_name);
 }
 
 std::unique_ptr<Program> GraphCompiler::Build(const std::string& code) {
@@ -634,6 +673,16 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   auto& nodes      = std::get<0>(topo_order);
 
   m_builder_.Clear();
+  pipelined_compiler_.reset();
+  module_group_num_ = 0;
+  if (options.pipelined_compile_groups > 0) {
+    // the CUDA modules are loaded into the context of the thread building them, so they are built as a whole now
+    if (target_.arch == Target::Arch::X86) {
+      pipelined_compiler_ = std::make_shared<backends::PipelinedCompiler>(target_, options.pipelined_compile_threads);
+    } else {
+      LOG(WARNING) << "The pipelined compile is only supported on X86 now, compile the kernels as a whole module";
+    }
+  }
   // if there are no avaiable groups, we will take each node as a group
   if (options.groups.empty() && graph_->groups.empty() && graph_->fusion_groups.empty()) {
     VLOG(3) << "not run opfusion pass";
@@ -646,6 +695,12 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   }
   // use the input groups in options firstly if exists
   auto groups = options.groups.empty() ? graph_->groups : options.groups;
+  // the groups of the new fusion pass and the given lowered_funcs are built as they are, and the buffers managed by
+  // the buffer handle instructions are released after used so they can not hold the folded constants.
+  if (options.fold_constants && options.lowered_funcs.empty() && graph_->fusion_groups.empty() &&
+      !options.with_buffer_handle_instruction_inserted) {
+    FoldConstantGroups(&groups);
+  }
 
   // if the input lowered_funcs is empty, we will use the defalut lowering process to generate
   std::vector<std::vector<ir::LoweredFunc>> local_lowered_funcs;
@@ -676,6 +731,10 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
         local_lowered_funcs.emplace_back(std::move(op_lowerer.Lower(group)));
         CHECK_EQ(local_lowered_funcs.back().size(), 1) << "Lowerd Function Is Not Equal 1!";
         VLOG(3) << local_lowered_funcs.back()[0];
+        // compile the groups lowered in the background while lowering the rest
+        if (pipelined_compiler_) {
+          this->ProcessFunction(local_lowered_funcs.back());
+        }
       }
     } else {
       for (int i = 0; i < groups.size(); i++) {
@@ -686,6 +745,9 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
           lowered_func = GetOpFunc(groups[i]);
         }
         local_lowered_funcs.emplace_back(std::move(lowered_func));
+        if (pipelined_compiler_) {
+          this->ProcessFunction(local_lowered_funcs.back());
+        }
       }
     }
   }
@@ -693,30 +755,49 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
   // use the input lowered_funcs in options firstly if exists
   const auto& lowered_funcs = options.lowered_funcs.empty() ? local_lowered_funcs : options.lowered_funcs;
   CHECK_EQ(groups.size(), lowered_funcs.size()) << "The size of groups and lowered_funcs shoule be equal";
-  for (auto&& lowered_func : lowered_funcs) {
-    this->ProcessFunction(lowered_func);
+  // the local lowered functions are processed once lowered in the pipelined compile
+  if (!pipelined_compiler_ || !options.lowered_funcs.empty()) {
+    for (auto&& lowered_func : lowered_funcs) {
+      this->ProcessFunction(lowered_func);
+    }
   }
 
   graph_->VisualizeGroupedGraph(groups, fetch_var_ids_);
 
-  // compile the module
-  // Need to create a new compiler for every call of Build,
-  // because the underneath jit engine does't support addIRModule repeatedly now.
-  compiler_ = backends::Compiler::Create(target_);
+  if (pipelined_compiler_) {
+    SubmitModule();
+    compiler_.reset();
+  } else {
+    // compile the module
+    // Need to create a new compiler for every call of Build,
+    // because the underneath jit engine does't support addIRModule repeatedly now.
+    compiler_ = backends::Compiler::Create(target_);
 
-  auto build_module = m_builder_.Build();
-  if (this->target_.arch == Target::Arch::X86) {
-    CodeGenCX86 codegen(this->target_, CodeGenCX86::Feature::AVX512);
-    codegen.SetInlineBuiltinCodes(false);
-    auto out = codegen.Compile(build_module, CodeGenC::OutputKind::CImpl);
-    VLOG(3) << "[X86] C Code is:\n" << out;
-  }
+    auto build_module = m_builder_.Build();
+    if (this->target_.arch == Target::Arch::X86) {
+      CodeGenCX86 codegen(this->target_, CodeGenCX86::Feature::AVX512);
+      codegen.SetInlineBuiltinCodes(false);
+      auto out = codegen.Compile(build_module, CodeGenC::OutputKind::CImpl);
+      VLOG(3) << "[X86] C Code is:\n" << out;
+    }
 
-  compiler_->Build(build_module, options.attached_code, stream);
+    compiler_->Build(build_module, options.attached_code, stream);
+  }
   auto instructions = BuildInstructions(groups, graph_->fusion_groups);
+  if (pipelined_compiler_) {
+    // the instructions share the pipelined compiler to keep the compiled functions alive
+    auto pipelined_compiler = pipelined_compiler_;
+    for (auto& instr : instructions) {
+      instr->SetLoweredFuncLoader(
+          [pipelined_compiler](const std::string& fn_name) { return pipelined_compiler->Lookup(fn_name); });
+    }
+  }
   if (options.remove_unused_variables) {
     RemoveInvalidVariables(instructions);
   }
+  if (options.plan_memory && options.with_instantiate_variables && !options.with_buffer_handle_instruction_inserted) {
+    PlanMemory(groups, &instructions);
+  }
   if (options.with_buffer_handle_instruction_inserted) {
     VLOG(3) << "option.with_buffer_handle_instruction_inserted enable";
     InsertBufferHandlers(&instructions);
@@ -730,8 +811,12 @@ GraphCompiler::CompilationResult GraphCompiler::Build(const GraphCompiler::Compi
       auto& tensor = absl::get<Tensor>(*var);
       if (reuse_vars_map_.count(name)) {
         auto src_var_name = reuse_vars_map_.at(name);
-        auto* src_var     = scope_->Var<Tensor>(src_var_name);
-        auto& src_tensor  = absl::get<Tensor>(*src_var);
+        // follow the reused variables to the one owning the buffer
+        while (reuse_vars_map_.count(src_var_name)) {
+          src_var_name = reuse_vars_map_.at(src_var_name);
+        }
+        auto* src_var    = scope_->Var<Tensor>(src_var_name);
+        auto& src_tensor = absl::get<Tensor>(*src_var);
         tensor->set_buffer(src_tensor->get_buffer());
       } else {
         tensor->mutable_data<float>(target_);
@@ -752,9 +837,7 @@ void GraphCompiler::SetSubKernels(Instruction* instr, const std::string& func_na
     instr->AddOutArgs(function2output_args_[func_name]);
   }
   while (function2input_args_.count(new_op_func) != 0) {
-    auto* fn2 = compiler_->Lookup(new_op_func);
-    CHECK(fn2);
-    instr->SetLoweredFunc(fn2, new_op_func);
+    SetLoweredFunc(instr, new_op_func);
     instr->AddInArgs(function2input_args_[new_op_func]);
     instr->AddOutArgs(function2output_args_[new_op_func]);
     i++;
@@ -792,6 +875,63 @@ void GraphCompiler::BuildCublasInstr(const Node& node, Instruction* instr) const
   instr->attrs.push_back(*reinterpret_cast<int*>(&alpha));
 }
 
+void GraphCompiler::FoldConstantGroups(std::vector<std::vector<Node*>>* groups) {
+  auto& dtype_dict = graph_->GetAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
+  auto is_pre_run  = [](const Node* node) {
+    return node->attrs.attr_store.count("pre_run") && absl::get<bool>(node->attrs.attr_store.at("pre_run"));
+  };
+  auto has_data = [this](const std::string& var_name) {
+    auto* var = scope_->FindVar(var_name);
+    return var && absl::get<Tensor>(*var)->buffer()->memory != nullptr;
+  };
+
+  std::unordered_set<std::string> folded_vars;
+  std::vector<std::vector<Node*>> const_groups;
+  std::vector<std::vector<Node*>> remained_groups;
+  for (auto& group : *groups) {
+    std::unordered_set<std::string> group_outputs;
+    for (auto* node : group) {
+      for (auto& link : node->outlinks_in_order()) {
+        group_outputs.insert(link->sink()->id());
+      }
+    }
+    // reshape shares the buffer of its input rather than running a kernel, so it is left to the instructions
+    bool foldable = !group.empty();
+    for (auto* node : group) {
+      foldable = foldable && is_pre_run(node) && node->op()->name != "reshape";
+      for (auto& link : node->inlinks_in_order()) {
+        auto var_name = link->source()->id();
+        bool ready    = group_outputs.count(var_name) || folded_vars.count(var_name) || has_data(var_name);
+        foldable      = foldable && ready;
+      }
+    }
+    if (!foldable) {
+      remained_groups.push_back(group);
+      continue;
+    }
+    for (auto& var_name : group_outputs) {
+      CHECK(dtype_dict.count(var_name)) << "The dtype of " << var_name << " is not inferred";
+      scope_->GetTensor(var_name)->mutable_data(target_, dtype_dict.at(var_name));
+      folded_vars.insert(var_name);
+    }
+    const_groups.push_back(group);
+  }
+  // a program of constants only is left to PreRun, the runtime program should have instructions
+  if (const_groups.empty() || remained_groups.empty()) {
+    return;
+  }
+
+  VLOG(3) << "Fold " << const_groups.size() << " constant groups into " << folded_vars.size() << " variables";
+  GraphCompiler folder(target_, scope_, graph_);
+  CompileOptions options;
+  options.groups                  = std::move(const_groups);
+  options.remove_unused_variables = false;
+  options.fold_constants          = false;
+  auto program                    = folder.Build(options).runtime_program;
+  program->PreRun();
+  *groups = std::move(remained_groups);
+}
+
 std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
     const std::vector<std::vector<Node*>>& groups, const std::vector<std::shared_ptr<Graph::Group>>& fusion_groups) {
   std::vector<std::unique_ptr<Instruction>> instructions;
@@ -968,9 +1108,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
       }
       std::string op_func_name =
           fusion_group.get() ? fusion_group->GetFuncName() : GetOrGenFullFuncName(GenOpFuncName(node));
-      auto* fn = compiler_->Lookup(op_func_name);
-      CHECK(fn);
-      instr->SetLoweredFunc(fn, op_func_name);
+      SetLoweredFunc(instr.get(), op_func_name);
 
       // As some instruction like reduce, will generate more than one kernel.
       // So try to find the rest kernel, if it exist.
@@ -1033,9 +1171,7 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
                                                        fusion_group.get() ? fusion_group->output_names : outputNames,
                                                        fuse_name));
 
-      auto* fn = compiler_->Lookup(fuse_name);
-      CHECK(fn);
-      instr->SetLoweredFunc(fn, fuse_name);
+      SetLoweredFunc(instr.get(), fuse_name);
       // As some situation like reduce,will generate more than one kernel.
       // So try to find the rest kernel, if it exist.
       SetSubKernels(instr.get(), fuse_name);
@@ -1054,6 +1190,45 @@ std::vector<std::unique_ptr<Instruction>> GraphCompiler::BuildInstructions(
   return instructions;
 }
 
+void GraphCompiler::PlanMemory(const std::vector<std::vector<Node*>>& groups,
+                               std::vector<std::unique_ptr<Instruction>>* instructions) {
+  CHECK_EQ(groups.size(), instructions->size()) << "Each group should be built into an instruction";
+  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  std::unordered_map<const Instruction*, OpPatternKind> op_patterns;
+  for (int i = 0; i < groups.size(); ++i) {
+    if (groups[i].size() != 1) {
+      continue;
+    }
+    auto* op = groups[i][0]->op();
+    // slice_assign writes only a slice of its output, so it is not computed in place though it is elementwise.
+    if (op_pattern_dict.Find(op) && op->name != "slice_assign") {
+      op_patterns[instructions->at(i).get()] = op_pattern_dict[op];
+    }
+  }
+  // the fetched variables and the ones sharing buffers already are kept as they are
+  std::unordered_set<std::string> persistent_vars(fetch_var_ids_.begin(), fetch_var_ids_.end());
+  for (auto& item : reuse_vars_map_) {
+    persistent_vars.insert(item.first);
+    persistent_vars.insert(item.second);
+  }
+
+  MemoryPlanner planner(scope_.get(), persistent_vars, op_patterns);
+  int64_t origin_peak  = planner.PeakBytes(*instructions);
+  int64_t origin_bytes = planner.AllocatedBytes(*instructions, {});
+  int recompute_num    = 0;
+  if (compile_options_.memory_budget > 0) {
+    recompute_num = planner.Recompute(instructions, compile_options_.memory_budget);
+  }
+  auto reuse_vars = planner.PlanReuse(*instructions);
+  VLOG(1) << "Plan the memory of the intermediate variables: recompute " << recompute_num << " variables, "
+          << reuse_vars.size() << " variables share buffers, the peak bytes " << origin_peak << " -> "
+          << planner.PeakBytes(*instructions) << ", the allocated bytes " << origin_bytes << " -> "
+          << planner.AllocatedBytes(*instructions, reuse_vars);
+  for (auto& item : reuse_vars) {
+    reuse_vars_map_[item.first] = item.second;
+  }
+}
+
 void GraphCompiler::RemoveInvalidVariables(const std::vector<std::unique_ptr<Instruction>>& instructions) {
   // mark all variables are invalid initially
   std::unordered_set<std::string> invalid_variables;
@@ -1071,6 +1246,11 @@ void GraphCompiler::RemoveInvalidVariables(const std::vector<std::unique_ptr<Ins
     });
   };
 
+  // the fetched variables may be folded at compile time and used by no instruction
+  for (auto& var_name : fetch_var_ids_) {
+    invalid_variables.erase(var_name);
+  }
+
   // iterate the arguments of each instruction, eliminate the
   // used variables, and remain variables are invalid finally
   auto unused_var_num = invalid_variables.size();
@@ -1214,10 +1394,11 @@ std::shared_ptr<Scope> BuildScope(Target target, const std::shared_ptr<Graph>& g
     }
     VLOG(3) << "Tensor [" << iter.first << "] resize to " << utils::Join(shape, ",");
     tensor->Resize(Shape{shape});
-    CHECK(dtype_dict.at(iter.first) == Float(32) || dtype_dict.at(iter.first).is_bool() ||
-          dtype_dict.at(iter.first) == Int(32))
+    const auto& dtype = dtype_dict.at(iter.first);
+    CHECK(dtype == Float(32) || dtype.is_float16() || dtype.is_bfloat16() || dtype.is_bool() || dtype == Int(32) ||
+          dtype == Int(8))
         << "The dtype of node " << iter.first << " is not float or bool or int! Other dtype is not implemented yet.";
-    tensor->set_type(dtype_dict.at(iter.first));
+    tensor->set_type(dtype);
   }
   return scope;
 }
@@ -26,6 +26,7 @@
 #include "cinn/auto_schedule/tuning.h"
 #include "cinn/backends/compiler.h"
 #include "cinn/backends/cuda_util.h"
+#include "cinn/backends/pipelined_compiler.h"
 #include "cinn/common/macros.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/instruction.h"
@@ -62,6 +63,13 @@ class Program {
 
   void ExecuteTest(int repeat_);
 
+  /**
+   * Copy the runtime instructions to run on the variables of \p scope. The compiled kernels are shared and the
+   * copies hold their own arguments, so the copy can be executed concurrently with this program. The prerun
+   * instructions are not copied, since their results are kept in the variables shared with \p scope.
+   */
+  std::unique_ptr<Program> Clone(const std::shared_ptr<Scope>& scope) const;
+
   /**
    * Get the number of instructions.
    */
@@ -96,6 +104,21 @@ class GraphCompiler final {
     bool with_instantiate_variables              = false;
     bool with_buffer_handle_instruction_inserted = false;
     bool remove_unused_variables                 = true;
+    // evaluate the groups marked pre_run by ConstPropagate at compile time if their inputs already hold data,
+    // the results are kept in the scope and no kernels are built for them.
+    bool fold_constants = true;
+    // plan the intermediate variables to share buffers when they are instantiated, so an intermediate variable not
+    // fetched should not be read after running, see MemoryPlanner.
+    bool plan_memory = false;
+    // the budget in bytes of the live intermediate variables when plan_memory is enabled, the cheap ones exceeding it
+    // are recomputed before used again, 0 means no budget.
+    int64_t memory_budget = 0;
+    // compile the kernels by the background threads into the modules of this number of groups in order, so lowering,
+    // compilation and execution overlap, and an instruction waits for its kernels when it runs first. 0 means
+    // compiling all the kernels into a single module before building the program. It is only supported on X86 now.
+    int pipelined_compile_groups = 0;
+    // the number of the background threads compiling the modules when pipelined_compile_groups is positive.
+    int pipelined_compile_threads = 2;
     // nodes group, it may come from the result of op fusion or graph tuning.
     // nodes in a group will be built into an Instruction
     std::vector<std::vector<Node*>> groups;
@@ -111,7 +134,10 @@ class GraphCompiler final {
   CompilationResult Build(const CompileOptions& options,
                           std::unordered_set<std::string>&& fetch_var_ids = {},
                           void* stream                                    = nullptr);
-  void ExportObject(const std::string& path) { compiler_->ExportObject(path); }
+  void ExportObject(const std::string& path) {
+    CHECK(compiler_) << "The kernels compiled by the pipelined compile can not be exported";
+    compiler_->ExportObject(path);
+  }
 
   std::unique_ptr<Program> Build(const std::string& code = "");
 
@@ -148,11 +174,19 @@ class GraphCompiler final {
       const std::vector<std::vector<Node*>>& groups, const std::vector<std::shared_ptr<Graph::Group>>& fusion_groups);
 
   void BuildCublasInstr(const Node& node, Instruction* instr) const;
+  // run the groups whose nodes are all pre_run and whose inputs hold data in the scope, such as the transposes of
+  // the weights, and erase them from \p groups, their results are kept in the scope as the constants.
+  void FoldConstantGroups(std::vector<std::vector<Node*>>* groups);
   // some variables are eliminated by optimized passes(such as OpFusion),
   // we can filter out them according to arguments of the built instructions,
   // and erase them from the scope to avoid unnecessary buffer allocation
   void RemoveInvalidVariables(const std::vector<std::unique_ptr<Instruction>>& instructions);
 
+  // recompute the cheap intermediate variables to fit in the memory budget, and plan the intermediate variables
+  // sharing buffers by reuse_vars_map_, \p instructions are built from \p groups one by one.
+  void PlanMemory(const std::vector<std::vector<Node*>>& groups,
+                  std::vector<std::unique_ptr<Instruction>>* instructions);
+
   // find the first and last instruction where a variable used, and mark the
   // variable should allocate buffer before the first instruction runing and
   // can release the buffer after the last instruction finished.
@@ -167,6 +201,10 @@ class GraphCompiler final {
 
  private:
   void ProcessFunction(const std::vector<ir::LoweredFunc>& lowered_func);
+  // submit the functions added to m_builder_ to pipelined_compiler_ as a module.
+  void SubmitModule();
+  // set the function \p func_name to \p instr, which is looked up when it runs first in the pipelined compile.
+  void SetLoweredFunc(Instruction* instr, const std::string& func_name);
   void SetSubKernels(Instruction* instr, const std::string& func_name);
   Target target_;
   std::shared_ptr<Graph> graph_;
@@ -183,6 +221,10 @@ class GraphCompiler final {
   absl::flat_hash_map<std::string, std::string> reuse_vars_map_;
 
   std::unique_ptr<backends::Compiler> compiler_;
+  // compile the modules in the background when compile_options_.pipelined_compile_groups is positive
+  std::shared_ptr<backends::PipelinedCompiler> pipelined_compiler_;
+  // the number of the groups whose functions are added to m_builder_ in the pipelined compile
+  int module_group_num_{0};
   CompileOptions compile_options_;
 
   ir::Module::Builder m_builder_;
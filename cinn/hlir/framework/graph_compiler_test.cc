@@ -21,6 +21,7 @@
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/timer.h"
 
 namespace cinn {
 namespace hlir {
@@ -114,6 +115,93 @@ TEST(GraphCompilerTest, TestInsertBufferHandlers) {
             used_variable_names);
 }
 
+TEST(GraphCompilerTest, TestFoldConstants) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {16, 32}, "A");
+  auto w = builder.CreateInput(Float(32), {32, 16}, "W");
+  w.set_const(true);
+
+  auto w_t    = builder.Transpose(w, {1, 0});
+  auto c      = builder.ElementwiseAdd(a, w_t);
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(builder.Build(), target);
+  ApplyPass(graph.get(), "ConstPropagate");
+  ApplyPass(graph.get(), "OpFusion");
+  auto scope = BuildScope(target, graph);
+
+  auto* a_data = scope->GetTensor(static_cast<frontend::Variable>(a)->id)->mutable_data<float>(target);
+  auto* w_data = scope->GetTensor(static_cast<frontend::Variable>(w)->id)->mutable_data<float>(target);
+  for (int i = 0; i < 16 * 32; ++i) {
+    a_data[i] = i % 7;
+    w_data[i] = i % 5;
+  }
+
+  // the transpose of the const weight is evaluated at compile time, only the add is left in the program.
+  GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build(GraphCompiler::CompileOptions(), {c->id}).runtime_program;
+  ASSERT_EQ(runtime_program->size(), 1);
+  ASSERT_TRUE(runtime_program->GetPreRunInstructions().empty());
+  ASSERT_NE(scope->FindVar(w_t->id), nullptr);
+
+  runtime_program->Execute();
+  auto* c_data = scope->GetTensor(c->id)->data<float>();
+  for (int i = 0; i < 16; ++i) {
+    for (int j = 0; j < 32; ++j) {
+      ASSERT_FLOAT_EQ(c_data[i * 32 + j], a_data[i * 32 + j] + w_data[j * 16 + i]);
+    }
+  }
+}
+
+TEST(GraphCompilerTest, TestPipelinedCompile) {
+  frontend::NetBuilder builder("test");
+  auto a = builder.CreateInput(Float(32), {16, 32}, "A");
+  auto b = builder.CreateInput(Float(32), {16, 32}, "B");
+
+  frontend::Variable c = a;
+  for (int i = 0; i < 4; ++i) {
+    c = builder.Relu(builder.Add(builder.Tanh(c), b));
+  }
+  auto program = builder.Build();
+  auto target  = common::DefaultHostTarget();
+
+  // each op is built into an instruction, and compiled into the modules of 2 groups in the pipelined compile.
+  auto build_and_run = [&](int pipelined_compile_groups) {
+    auto graph = std::make_shared<Graph>(program, target);
+    ApplyPass(graph.get(), "InferShape");
+    auto scope = BuildScope(target, graph);
+
+    utils::Timer timer;
+    timer.Start();
+    GraphCompiler gc(target, scope, graph);
+    GraphCompiler::CompileOptions options;
+    options.with_instantiate_variables = true;
+    options.pipelined_compile_groups   = pipelined_compile_groups;
+    auto runtime_program               = gc.Build(options, {c->id}).runtime_program;
+    EXPECT_EQ(runtime_program->size(), 12);
+
+    for (auto& var : program.GetInputs()) {
+      auto tensor = scope->GetTensor(var->id);
+      auto* data  = tensor->mutable_data<float>(target);
+      for (int i = 0; i < tensor->shape().numel(); ++i) {
+        data[i] = (i % 11 - 5) * 0.1f;
+      }
+    }
+    runtime_program->Execute();
+    LOG(INFO) << "The first run with pipelined_compile_groups = " << pipelined_compile_groups << " completes in "
+              << timer.Stop() << " ms";
+
+    auto result = scope->GetTensor(c->id);
+    return std::vector<float>(result->data<float>(), result->data<float>() + result->shape().numel());
+  };
+
+  auto expected = build_and_run(0);
+  auto result   = build_and_run(2);
+  ASSERT_EQ(result.size(), expected.size());
+  for (int i = 0; i < expected.size(); ++i) {
+    ASSERT_FLOAT_EQ(result[i], expected[i]);
+  }
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
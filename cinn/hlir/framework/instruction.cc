@@ -61,6 +61,18 @@ std::vector<cinn_pod_value_t>& Instruction::PreparePodArgs(
   return args_cached_[i];
 }
 
+void Instruction::LoadLoweredFuncs() {
+  if (!fn_loader_) {
+    return;
+  }
+  for (int i = 0; i < fn_.size(); ++i) {
+    if (!fn_[i]) {
+      fn_[i] = fn_loader_(fn_names_[i]);
+      CHECK(fn_[i]) << "Function [" << fn_names_[i] << "] is not found";
+    }
+  }
+}
+
 void Instruction::Finalize() {
   if (fn_.size() > 1 && fn_.size() != in_args_.size()) {
     out_args_.back()[0] = out_args_.front()[0];
@@ -79,6 +91,7 @@ void Instruction::Run(const std::map<std::string, cinn_pod_value_t>* name2podarg
   }
 
   VLOG(2) << "Run function " << function_name_;
+  LoadLoweredFuncs();
 
   if (name2podargs != nullptr) {
     args_cached_.clear();
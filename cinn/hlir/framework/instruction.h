@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -64,6 +67,13 @@ class Instruction {
     fn_names_.push_back(name);
   }
 
+  /**
+   * Set the loader of the functions whose addresses are not set yet, it is called with the function names when the
+   * instruction runs first, such as to wait for the functions compiled in the background.
+   * @param loader The loader returning the address of a function by name.
+   */
+  void SetLoweredFuncLoader(const std::function<lower_func_ptr_t(const std::string&)>& loader) { fn_loader_ = loader; }
+
   // explicitly finalize the instruction, and can't append function again after call it
   void Finalize();
 
@@ -76,6 +86,7 @@ class Instruction {
 
   void PreRun(const std::map<std::string, cinn_pod_value_t>* name2podargs = nullptr) {
     CHECK_EQ(fn_.size(), 4);
+    LoadLoweredFuncs();
     if (fn_.size() > 1 && fn_.size() != in_args_.size()) {
       out_args_.back()[0] = out_args_.front()[0];
       out_args_.erase(out_args_.begin());
@@ -109,6 +120,35 @@ class Instruction {
     }
   }
 
+  /**
+   * Copy this instruction to run on the variables of \p scope, the compiled functions are shared.
+   * @param scope The scope containing the variables with the same names as the ones of this instruction.
+   */
+  std::unique_ptr<Instruction> CloneWithScope(Scope* scope) const {
+    std::unique_ptr<Instruction> instr(new Instruction(*this));
+    instr->scope_ = scope;
+    instr->args_cached_.clear();
+    return instr;
+  }
+
+  /**
+   * Replace the argument \p old_name by \p new_name, such as to run the compiled functions on another variable.
+   * @param old_name The name of the argument replaced.
+   * @param new_name The name of the variable to run on.
+   * @param in_args Whether to replace it in the inputs.
+   * @param out_args Whether to replace it in the outputs.
+   */
+  void RenameArg(const std::string& old_name, const std::string& new_name, bool in_args, bool out_args) {
+    auto rename = [&](std::vector<std::vector<std::string>>* args_list) {
+      for (auto& args : *args_list) {
+        std::replace(args.begin(), args.end(), old_name, new_name);
+      }
+    };
+    if (in_args) rename(&in_args_);
+    if (out_args) rename(&out_args_);
+    args_cached_.clear();
+  }
+
   int size() { return fn_.size(); }
 
   std::vector<std::vector<std::string>> GetInArgs() { return in_args_; }
@@ -124,6 +164,9 @@ class Instruction {
  protected:
   std::vector<cinn_pod_value_t>& PreparePodArgs(int i, const std::map<std::string, cinn_pod_value_t>* name2podargs);
 
+  // set the addresses of the functions not set yet by fn_loader_.
+  void LoadLoweredFuncs();
+
  private:
   bool finalized_flag_ = false;
   Scope* scope_{};
@@ -135,6 +178,8 @@ class Instruction {
 
   std::vector<lower_func_ptr_t> fn_{};
   std::vector<std::string> fn_names_;
+  // it also keeps the functions loaded alive.
+  std::function<lower_func_ptr_t(const std::string&)> fn_loader_;
 };
 
 }  // namespace framework
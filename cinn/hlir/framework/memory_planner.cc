@@ -0,0 +1,269 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/memory_planner.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "cinn/common/context.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+namespace {
+
+std::vector<std::string> Flatten(const std::vector<std::vector<std::string>>& args_list) {
+  std::vector<std::string> res;
+  for (auto& args : args_list) {
+    res.insert(res.end(), args.begin(), args.end());
+  }
+  return res;
+}
+
+}  // namespace
+
+MemoryPlanner::MemoryPlanner(Scope* scope,
+                             const std::unordered_set<std::string>& persistent_vars,
+                             const std::unordered_map<const Instruction*, OpPatternKind>& op_patterns)
+    : scope_(scope), persistent_vars_(persistent_vars), op_patterns_(op_patterns) {}
+
+int64_t MemoryPlanner::Bytes(const std::string& var_name) const {
+  auto* var = scope_->FindVar(var_name);
+  if (!var) {
+    return 0;
+  }
+  auto& tensor = absl::get<Tensor>(*var);
+  return static_cast<int64_t>(tensor->shape().numel()) * std::max(tensor->type().bits() / 8, 1);
+}
+
+bool MemoryPlanner::IsPattern(const Instruction* instr, OpPatternKind kind) const {
+  auto it = op_patterns_.find(instr);
+  return it != op_patterns_.end() && it->second == kind;
+}
+
+absl::flat_hash_map<std::string, MemoryPlanner::VarInfo> MemoryPlanner::Analyze(
+    const std::vector<std::unique_ptr<Instruction>>& instructions) {
+  absl::flat_hash_map<std::string, VarInfo> infos;
+  std::unordered_set<std::string> unplanned;
+  for (int step = 0; step < instructions.size(); ++step) {
+    auto& instr = instructions[step];
+    for (auto& var_name : Flatten(instr->GetInArgs())) {
+      auto& info = infos[var_name];
+      if (info.uses.empty() || info.uses.back() != step) {
+        info.uses.push_back(step);
+      }
+      info.last = step;
+      if (instr->pre_run) {
+        unplanned.insert(var_name);
+      }
+    }
+    for (auto& var_name : Flatten(instr->GetOutArgs())) {
+      auto& info = infos[var_name];
+      // the variables computed by several instructions or used before computed are not planned.
+      if (info.def >= 0 || !info.uses.empty() || instr->pre_run) {
+        unplanned.insert(var_name);
+      }
+      info.def  = step;
+      info.last = step;
+    }
+  }
+  for (auto& item : infos) {
+    auto& info   = item.second;
+    info.planned = info.def >= 0 && !info.uses.empty() && !unplanned.count(item.first) &&
+                   !persistent_vars_.count(item.first) && scope_->FindVar(item.first);
+  }
+  return infos;
+}
+
+int64_t MemoryPlanner::PeakBytes(const std::vector<std::unique_ptr<Instruction>>& instructions) {
+  auto infos = Analyze(instructions);
+  std::vector<int64_t> delta(instructions.size() + 1, 0);
+  for (auto& item : infos) {
+    if (item.second.planned) {
+      delta[item.second.def] += Bytes(item.first);
+      delta[item.second.last + 1] -= Bytes(item.first);
+    }
+  }
+  int64_t live = 0, peak = 0;
+  for (int step = 0; step < instructions.size(); ++step) {
+    live += delta[step];
+    peak = std::max(peak, live);
+  }
+  return peak;
+}
+
+int MemoryPlanner::Recompute(std::vector<std::unique_ptr<Instruction>>* instructions, int64_t budget_bytes) {
+  int recompute_num = 0;
+  // each recomputation shortens the live range of a variable over the peak, the bound just guards the loop.
+  for (size_t iter = 0, max_iter = 2 * instructions->size(); iter < max_iter; ++iter) {
+    auto infos = Analyze(*instructions);
+    std::vector<int64_t> live(instructions->size() + 1, 0);
+    for (auto& item : infos) {
+      if (item.second.planned) {
+        live[item.second.def] += Bytes(item.first);
+        live[item.second.last + 1] -= Bytes(item.first);
+      }
+    }
+    int peak_step = 0;
+    for (int step = 1; step < instructions->size(); ++step) {
+      live[step] += live[step - 1];
+      if (live[step] > live[peak_step]) {
+        peak_step = step;
+      }
+    }
+    if (live[peak_step] <= budget_bytes) {
+      break;
+    }
+
+    int best = -1, best_next = -1;
+    int64_t best_bytes = 0;
+    for (int step = 0; step < peak_step; ++step) {
+      auto* instr = (*instructions)[step].get();
+      auto outs   = Flatten(instr->GetOutArgs());
+      if (instr->pre_run || instr->size() != 1 || outs.size() != 1 || !infos.at(outs[0]).planned ||
+          !(IsPattern(instr, kElemWise) || IsPattern(instr, kBroadcast))) {
+        continue;
+      }
+      auto& uses = infos.at(outs[0]).uses;
+      auto next  = std::upper_bound(uses.begin(), uses.end(), peak_step);
+      // the variable should be unused at the peak and used after it.
+      if (next == uses.end() || std::binary_search(uses.begin(), uses.end(), peak_step)) {
+        continue;
+      }
+      // the inputs should keep the same values until the next use.
+      auto ins         = Flatten(instr->GetInArgs());
+      bool inputs_live = std::all_of(ins.begin(), ins.end(), [&](const std::string& in) {
+        auto& info = infos.at(in);
+        return info.planned ? info.last >= *next : info.def < step;
+      });
+      if (inputs_live && Bytes(outs[0]) > best_bytes) {
+        best       = step;
+        best_next  = *next;
+        best_bytes = Bytes(outs[0]);
+      }
+    }
+    if (best < 0) {
+      break;
+    }
+
+    auto* origin  = (*instructions)[best].get();
+    auto var_name = Flatten(origin->GetOutArgs())[0];
+    if (infos.at(var_name).uses.front() > peak_step) {
+      // the variable is not used before, so the instruction is moved to its next use and it keeps its name.
+      VLOG(3) << "Move the computation of " << var_name << " of " << best_bytes << " bytes before instruction "
+              << best_next;
+      auto moved = std::move((*instructions)[best]);
+      instructions->erase(instructions->begin() + best);
+      instructions->insert(instructions->begin() + best_next - 1, std::move(moved));
+    } else {
+      auto new_var_name = common::UniqName(var_name + "_recompute");
+      auto src_tensor   = scope_->GetTensor(var_name);
+      auto& new_tensor  = absl::get<Tensor>(*scope_->Var<Tensor>(new_var_name));
+      new_tensor->Resize(src_tensor->shape());
+      new_tensor->set_type(src_tensor->type());
+
+      auto recomputed = origin->CloneWithScope(scope_);
+      recomputed->RenameArg(var_name, new_var_name, false, true);
+      op_patterns_[recomputed.get()] = op_patterns_.at(origin);
+      for (int step = best_next; step < instructions->size(); ++step) {
+        (*instructions)[step]->RenameArg(var_name, new_var_name, true, false);
+      }
+      VLOG(3) << "Recompute " << var_name << " of " << best_bytes << " bytes as " << new_var_name
+              << " before instruction " << best_next;
+      instructions->insert(instructions->begin() + best_next, std::move(recomputed));
+    }
+    recompute_num++;
+  }
+  return recompute_num;
+}
+
+absl::flat_hash_map<std::string, std::string> MemoryPlanner::PlanReuse(
+    const std::vector<std::unique_ptr<Instruction>>& instructions) {
+  auto infos = Analyze(instructions);
+  absl::flat_hash_map<std::string, std::string> reuse_vars;
+  // the variables owning the buffers, with the sizes and the last steps the buffers are used.
+  absl::flat_hash_map<std::string, int64_t> capacity;
+  absl::flat_hash_map<std::string, int> live_until;
+  std::multimap<int64_t, std::string> free_buffers;
+  std::vector<std::vector<std::string>> release_at(instructions.size());
+
+  for (int step = 0; step < instructions.size(); ++step) {
+    auto* instr = instructions[step].get();
+    auto outs   = Flatten(instr->GetOutArgs());
+    // an elementwise op reads each element of an input before writing the same one of the output, so the output can
+    // be written into an input of the same dtype dead after it.
+    std::vector<std::string> inplace_buffers;
+    if (instr->size() == 1 && outs.size() == 1 && IsPattern(instr, kElemWise)) {
+      for (auto& in : Flatten(instr->GetInArgs())) {
+        if (infos.at(in).planned && infos.at(in).last == step && Bytes(in) == Bytes(outs[0]) &&
+            scope_->GetTensor(in)->type() == scope_->GetTensor(outs[0])->type()) {
+          auto it = reuse_vars.find(in);
+          inplace_buffers.push_back(it == reuse_vars.end() ? in : it->second);
+        }
+      }
+    }
+    for (auto& out : outs) {
+      auto& info = infos.at(out);
+      if (!info.planned || info.def != step) {
+        continue;
+      }
+      int64_t bytes = Bytes(out);
+      std::string buffer;
+      if (!inplace_buffers.empty()) {
+        buffer = inplace_buffers.front();
+        VLOG(4) << "Compute " << out << " in place of " << buffer;
+      } else {
+        auto it = free_buffers.lower_bound(bytes);
+        if (it != free_buffers.end()) {
+          buffer = it->second;
+          free_buffers.erase(it);
+        }
+      }
+      if (buffer.empty()) {
+        buffer           = out;
+        capacity[buffer] = bytes;
+      } else {
+        reuse_vars[out] = buffer;
+      }
+      live_until[buffer] = std::max(live_until[buffer], info.last);
+      release_at[info.last].push_back(buffer);
+    }
+    for (auto& buffer : release_at[step]) {
+      // the buffer may be reused by a variable living longer.
+      if (live_until.at(buffer) == step) {
+        live_until[buffer] = -1;
+        free_buffers.emplace(capacity.at(buffer), buffer);
+      }
+    }
+  }
+  return reuse_vars;
+}
+
+int64_t MemoryPlanner::AllocatedBytes(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                                      const absl::flat_hash_map<std::string, std::string>& reuse_vars) {
+  int64_t bytes = 0;
+  for (auto& item : Analyze(instructions)) {
+    if (item.second.planned && !reuse_vars.count(item.first)) {
+      bytes += Bytes(item.first);
+    }
+  }
+  return bytes;
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
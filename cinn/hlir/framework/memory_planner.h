@@ -0,0 +1,103 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/hlir/framework/instruction.h"
+#include "cinn/hlir/framework/op.h"
+#include "cinn/hlir/framework/scope.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+/**
+ * MemoryPlanner lowers the memory of the intermediate variables of the instructions built by GraphCompiler, which are
+ * all allocated at compile time and kept alive during the whole run by default, e.g. the forward activations of a
+ * training step kept for the backward ops.
+ *
+ * The variables are planned in the order of the instructions, those not computed by the runtime instructions, the
+ * fetched ones and the persistent ones given are left as they are. The size of a variable is counted by its dtype in
+ * the scope, the buffers instantiated as float32 are never smaller than that.
+ */
+class MemoryPlanner {
+ public:
+  /**
+   * @param scope The scope containing the variables of the instructions.
+   * @param persistent_vars The variables kept as they are, such as the fetched ones.
+   * @param op_patterns The pattern of the op of the instructions computing a single op.
+   */
+  MemoryPlanner(Scope* scope,
+                const std::unordered_set<std::string>& persistent_vars,
+                const std::unordered_map<const Instruction*, OpPatternKind>& op_patterns);
+
+  /**
+   * \brief Recompute the intermediate variables until the estimated peak of the live ones fits in \p budget_bytes.
+   * At the peak, the largest output of an elementwise or broadcast instruction which is live but unused there is
+   * recomputed by a copy of the instruction inserted right before its next use, if the inputs of the instruction are
+   * still live there, so no other variable lives longer. The instruction is moved instead when its output is not used
+   * before, and the output keeps its name.
+   * @return The number of the variables recomputed.
+   */
+  int Recompute(std::vector<std::unique_ptr<Instruction>>* instructions, int64_t budget_bytes);
+
+  /**
+   * \brief Plan the variables sharing a buffer, a variable reuses the buffer of the variables whose last use is
+   * before its computation, and an elementwise instruction writes its output into the buffer of an input of the same
+   * size which is dead after it.
+   * @return The map from a variable to the one whose buffer it shares.
+   */
+  absl::flat_hash_map<std::string, std::string> PlanReuse(
+      const std::vector<std::unique_ptr<Instruction>>& instructions);
+
+  //! Estimate the peak bytes of the live intermediate variables when running \p instructions.
+  int64_t PeakBytes(const std::vector<std::unique_ptr<Instruction>>& instructions);
+
+  //! Get the bytes of the buffers allocated for the intermediate variables sharing buffers by \p reuse_vars.
+  int64_t AllocatedBytes(const std::vector<std::unique_ptr<Instruction>>& instructions,
+                         const absl::flat_hash_map<std::string, std::string>& reuse_vars);
+
+ private:
+  struct VarInfo {
+    // the first and the last instruction using the variable.
+    int def{-1};
+    int last{-1};
+    // the instructions reading the variable in order.
+    std::vector<int> uses;
+    // whether the variable is planned.
+    bool planned{false};
+  };
+
+  absl::flat_hash_map<std::string, VarInfo> Analyze(const std::vector<std::unique_ptr<Instruction>>& instructions);
+
+  int64_t Bytes(const std::string& var_name) const;
+
+  bool IsPattern(const Instruction* instr, OpPatternKind kind) const;
+
+  Scope* scope_;
+  std::unordered_set<std::string> persistent_vars_;
+  std::unordered_map<const Instruction*, OpPatternKind> op_patterns_;
+};
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,180 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/memory_planner.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph_compiler.h"
+#include "cinn/hlir/framework/pass.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+using common::Float;
+
+namespace {
+
+// compile each op into an instruction, and run it with the same random inputs.
+std::unique_ptr<Program> CompileAndRun(const frontend::Program& program,
+                                       const std::string& fetch_id,
+                                       bool plan_memory,
+                                       int64_t memory_budget,
+                                       std::shared_ptr<Scope>* scope) {
+  auto target = common::DefaultHostTarget();
+  auto graph  = std::make_shared<Graph>(program, target);
+  ApplyPass(graph.get(), "InferShape");
+  *scope = BuildScope(target, graph);
+
+  GraphCompiler gc(target, *scope, graph);
+  GraphCompiler::CompileOptions options;
+  options.with_instantiate_variables = true;
+  options.plan_memory                = plan_memory;
+  options.memory_budget              = memory_budget;
+  auto runtime_program               = gc.Build(options, {fetch_id}).runtime_program;
+
+  std::default_random_engine engine(0);
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::uniform_int_distribution<int> int_dist(-100, 100);
+  for (auto& var : program.GetInputs()) {
+    // the instantiated variables are all allocated as float, so the inputs are filled by the dtypes of the program.
+    auto tensor = (*scope)->GetTensor(var->id);
+    if (var->type.is_float(32)) {
+      auto* data = tensor->mutable_data<float>(target);
+      for (int i = 0; i < tensor->shape().numel(); ++i) {
+        data[i] = dist(engine);
+      }
+    } else if (var->type.is_int(8)) {
+      auto* data = tensor->mutable_data<int8_t>(target);
+      for (int i = 0; i < tensor->shape().numel(); ++i) {
+        data[i] = static_cast<int8_t>(int_dist(engine));
+      }
+    } else if (var->type.is_bool()) {
+      auto* data = tensor->mutable_data<bool>(target);
+      for (int i = 0; i < tensor->shape().numel(); ++i) {
+        data[i] = int_dist(engine) > 0;
+      }
+    } else {
+      LOG(FATAL) << "Not supported input dtype " << var->type << " of " << var->id;
+    }
+  }
+  runtime_program->Execute();
+  return runtime_program;
+}
+
+void ExpectSameTensor(const Tensor& result, const Tensor& expected) {
+  ASSERT_EQ(result->shape().numel(), expected->shape().numel());
+  for (int i = 0; i < expected->shape().numel(); ++i) {
+    ASSERT_NEAR(result->data<float>()[i], expected->data<float>()[i], 1e-5);
+  }
+}
+
+}  // namespace
+
+TEST(MemoryPlanner, ReuseBuffers) {
+  frontend::NetBuilder builder("reuse_buffers");
+  auto a       = builder.CreateInput(Float(32), {32, 64}, "A");
+  auto b       = builder.Relu(a);
+  auto c       = builder.Tanh(b);
+  auto d       = builder.Sigmoid(c);
+  auto e       = builder.Relu(d);
+  auto program = builder.Build();
+
+  std::shared_ptr<Scope> expected_scope, scope;
+  CompileAndRun(program, e->id, false, 0, &expected_scope);
+  CompileAndRun(program, e->id, true, 0, &scope);
+  ExpectSameTensor(scope->GetTensor(e->id), expected_scope->GetTensor(e->id));
+
+  // the elementwise ops are computed in place of the intermediate variables, the fetched one is kept.
+  auto buffer = scope->GetTensor(b->id)->get_buffer();
+  EXPECT_EQ(scope->GetTensor(c->id)->get_buffer(), buffer);
+  EXPECT_EQ(scope->GetTensor(d->id)->get_buffer(), buffer);
+  EXPECT_NE(scope->GetTensor(e->id)->get_buffer(), buffer);
+}
+
+TEST(MemoryPlanner, KeepDtypes) {
+  frontend::NetBuilder builder("keep_dtypes");
+  auto a       = builder.CreateInput(common::I8(), {32, 64}, "A");
+  auto b       = builder.Cast(a, "float32");
+  auto c       = builder.Relu(b);
+  auto d       = builder.Cast(c, "int32");
+  auto e       = builder.Cast(d, "float32");
+  auto program = builder.Build();
+
+  std::shared_ptr<Scope> expected_scope, scope;
+  CompileAndRun(program, e->id, false, 0, &expected_scope);
+  CompileAndRun(program, e->id, true, 0, &scope);
+  ExpectSameTensor(scope->GetTensor(e->id), expected_scope->GetTensor(e->id));
+
+  // relu is computed in place of its float input, the int32 cast is not though its output has the same size.
+  auto buffer = scope->GetTensor(b->id)->get_buffer();
+  EXPECT_EQ(scope->GetTensor(c->id)->get_buffer(), buffer);
+  EXPECT_NE(scope->GetTensor(d->id)->get_buffer(), buffer);
+}
+
+TEST(MemoryPlanner, RecomputeUnderBudget) {
+  frontend::NetBuilder builder("recompute_under_budget");
+  auto a       = builder.CreateInput(Float(32), {32, 32}, "A");
+  auto w       = builder.CreateInput(Float(32), {32, 32}, "W");
+  auto r       = builder.Relu(a);
+  auto m1      = builder.Matmul(r, w);
+  auto m2      = builder.Matmul(m1, w);
+  auto m3      = builder.Matmul(m2, w);
+  auto out     = builder.Add(m3, r);
+  auto program = builder.Build();
+
+  // r is alive from the beginning to the end, so 3 variables of 4KB are alive when m2 is computed.
+  constexpr int64_t kBytes = 32 * 32 * sizeof(float);
+  std::shared_ptr<Scope> expected_scope, scope;
+  auto expected_program = CompileAndRun(program, out->id, false, 0, &expected_scope);
+  auto runtime_program  = CompileAndRun(program, out->id, true, 2 * kBytes, &scope);
+  ExpectSameTensor(scope->GetTensor(out->id), expected_scope->GetTensor(out->id));
+
+  // relu is computed again before the add instead of keeping r alive.
+  ASSERT_EQ(runtime_program->size(), expected_program->size() + 1);
+}
+
+TEST(MemoryPlanner, MoveUnusedBefore) {
+  frontend::NetBuilder builder("move_unused_before");
+  auto a       = builder.CreateInput(Float(32), {32, 32}, "A");
+  auto w       = builder.CreateInput(Float(32), {32, 32}, "W");
+  auto r       = builder.Relu(a);
+  auto m1      = builder.Matmul(a, w);
+  auto m2      = builder.Matmul(m1, w);
+  auto m3      = builder.Matmul(m2, w);
+  auto out     = builder.Add(m3, r);
+  auto program = builder.Build();
+
+  constexpr int64_t kBytes = 32 * 32 * sizeof(float);
+  std::shared_ptr<Scope> expected_scope, scope;
+  auto expected_program = CompileAndRun(program, out->id, false, 0, &expected_scope);
+  auto runtime_program  = CompileAndRun(program, out->id, true, 2 * kBytes, &scope);
+  ExpectSameTensor(scope->GetTensor(out->id), expected_scope->GetTensor(out->id));
+
+  // r is used by the add only, so relu is moved before it rather than copied, and no variable is left unused.
+  ASSERT_EQ(runtime_program->size(), expected_program->size());
+  for (auto& name : scope->var_names()) {
+    EXPECT_EQ(std::string(name.data(), name.size()).find("_recompute"), std::string::npos);
+  }
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -14,7 +14,18 @@
 
 #include "cinn/hlir/framework/pass.h"
 
+#include <gflags/gflags.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "cinn/common/csr_graph.h"
 #include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/timer.h"
+
+DECLARE_bool(cinn_pass_profile);
 
 namespace cinn {
 namespace hlir {
@@ -37,7 +48,21 @@ void ApplyPasses(Graph* g, const std::vector<std::string>& passes) {
         CHECK(!pass_dep) << "And the attribute is provided by pass [" << pass_dep->name << "].";
       }
     }
+
+    utils::Timer timer;
+    int64_t peak_memory = FLAGS_cinn_pass_profile ? PassProfiler::PeakMemoryKB() : 0;
+    timer.Start();
+    for (auto& analysis : r->required_analyses) {
+      GetAnalysis(g, analysis);
+    }
+    double analysis_time = timer.Stop();
+    timer.Start();
     r->body(g);
+    double pass_time = timer.Stop();
+    InvalidateAnalyses(g, r->preserved_analyses);
+    if (FLAGS_cinn_pass_profile) {
+      PassProfiler::Global()->Record(r->name, pass_time, analysis_time, PassProfiler::PeakMemoryKB() - peak_memory);
+    }
   }
 }
 
@@ -50,6 +75,150 @@ const PassFunctionRegister* FindPassDep(const std::string& attr_name) {
   return nullptr;
 }
 
+AnalysisRegistry* AnalysisRegistry::Global() {
+  static AnalysisRegistry registry;
+  return &registry;
+}
+
+bool AnalysisRegistry::Register(const std::string& analysis_name, AnalysisFunction builder) {
+  CHECK(!builders_.count(analysis_name)) << "The analysis [" << analysis_name << "] is registered twice";
+  builders_.emplace(analysis_name, std::move(builder));
+  return true;
+}
+
+const AnalysisFunction& AnalysisRegistry::Get(const std::string& analysis_name) const {
+  auto it = builders_.find(analysis_name);
+  CHECK(it != builders_.end()) << "Cannot find analysis [" << analysis_name << "] in the registry";
+  return it->second;
+}
+
+std::shared_ptr<const absl::any> GetAnalysis(Graph* g, const std::string& analysis_name) {
+  uint64_t topology_version = g->topology_version();
+  auto it                   = g->analyses.find(analysis_name);
+  if (it != g->analyses.end() && it->second.second == topology_version) {
+    return it->second.first;
+  }
+  if (it != g->analyses.end()) {
+    VLOG(3) << "The analysis [" << analysis_name << "] is stale, the graph is changed after it is built";
+  }
+  VLOG(3) << "Build the analysis [" << analysis_name << "] of the graph";
+  // the builder may get the other analyses and so change the cache, the entry is set after it. A stale analysis is
+  // only released by the cache, the holders of it keep it alive.
+  auto analysis              = AnalysisRegistry::Global()->Get(analysis_name)(g);
+  g->analyses[analysis_name] = std::make_pair(analysis, topology_version);
+  return analysis;
+}
+
+void InvalidateAnalyses(Graph* g, const std::vector<std::string>& preserved) {
+  for (auto it = g->analyses.begin(); it != g->analyses.end();) {
+    if (std::find(preserved.begin(), preserved.end(), it->first) == preserved.end()) {
+      g->analyses.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// The index-based snapshot of the graph, whose nodes are numbered in topological order.
+static bool __cinn_csr_graph_analysis__ = AnalysisRegistry::Global()->Register(
+    "csr_graph", [](Graph* g) { return std::make_shared<absl::any>(common::CsrGraph(*g)); });
+
+// The shapes and the dtypes share the graph attrs, so the changes made to the attrs in place are seen.
+static bool __cinn_shape_dict_analysis__ = AnalysisRegistry::Global()->Register("shape_dict", [](Graph* g) {
+  CHECK(g->attrs.count("infershape")) << "The shapes are not inferred, please apply InferShape first";
+  return g->attrs.at("infershape");
+});
+static bool __cinn_dtype_dict_analysis__ = AnalysisRegistry::Global()->Register("dtype_dict", [](Graph* g) {
+  CHECK(g->attrs.count("inferdtype")) << "The dtypes are not inferred, please apply InferShape first";
+  return g->attrs.at("inferdtype");
+});
+
+static bool __cinn_consumer_map_analysis__ = AnalysisRegistry::Global()->Register("consumer_map", [](Graph* g) {
+  auto csr_graph = GetAnalysis<common::CsrGraph>(g, "csr_graph");
+  ConsumerMap consumer_map;
+  for (int id = 0; id < csr_graph->num_nodes(); id++) {
+    auto node_data = csr_graph->node(id)->safe_as<NodeData>();
+    if (!node_data) {
+      continue;
+    }
+    auto& consumers = consumer_map[node_data];
+    for (int consumer : csr_graph->consumers(id)) {
+      auto node = csr_graph->node(consumer)->safe_as<Node>();
+      CHECK(node) << "The consumer of " << node_data->id() << " is not an op node";
+      consumers.push_back(node);
+    }
+  }
+  return std::make_shared<absl::any>(std::move(consumer_map));
+});
+
+// The ops without a pattern are left out, the fusion passes check them when they look up the kinds.
+static bool __cinn_op_pattern_kinds_analysis__ = AnalysisRegistry::Global()->Register("op_pattern_kinds", [](Graph* g) {
+  auto& op_pattern_dict = Operator::GetAttrs<OpPatternKind>("OpPattern");
+  OpPatternKindMap op_pattern_kinds;
+  for (auto& graph_node : g->nodes()) {
+    auto node = graph_node->safe_as<Node>();
+    if (node && op_pattern_dict.Find(node->op())) {
+      op_pattern_kinds[node] = op_pattern_dict[node->op()];
+    }
+  }
+  return std::make_shared<absl::any>(std::move(op_pattern_kinds));
+});
+
+PassProfiler* PassProfiler::Global() {
+  static PassProfiler profiler;
+  return &profiler;
+}
+
+void PassProfiler::Record(const std::string& pass_name,
+                          double time_ms,
+                          double analysis_time_ms,
+                          int64_t peak_memory_growth_kb) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& stat = stats_[pass_name];
+  stat.runs++;
+  stat.time_ms += time_ms;
+  stat.analysis_time_ms += analysis_time_ms;
+  stat.peak_memory_growth_kb += peak_memory_growth_kb;
+}
+
+std::string PassProfiler::Summary() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::pair<std::string, PassStat>> stats(stats_.begin(), stats_.end());
+  std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) {
+    return a.second.time_ms + a.second.analysis_time_ms > b.second.time_ms + b.second.analysis_time_ms;
+  });
+  double total_ms = 0;
+  for (auto& stat : stats) {
+    total_ms += stat.second.time_ms + stat.second.analysis_time_ms;
+  }
+
+  std::stringstream ss;
+  ss << std::left << std::setw(24) << "pass" << std::right << std::setw(8) << "runs" << std::setw(14) << "time(ms)"
+     << std::setw(16) << "analysis(ms)" << std::setw(10) << "ratio" << std::setw(17) << "peak memory(KB)"
+     << "\n";
+  ss << std::fixed << std::setprecision(3);
+  for (auto& stat : stats) {
+    double ms = stat.second.time_ms + stat.second.analysis_time_ms;
+    ss << std::left << std::setw(24) << stat.first << std::right << std::setw(8) << stat.second.runs << std::setw(14)
+       << stat.second.time_ms << std::setw(16) << stat.second.analysis_time_ms << std::setw(9)
+       << (total_ms > 0 ? 100. * ms / total_ms : 0.) << "%" << std::setw(17) << stat.second.peak_memory_growth_kb
+       << "\n";
+  }
+  ss << "total time: " << total_ms << " ms";
+  return ss.str();
+}
+
+void PassProfiler::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.clear();
+}
+
+int64_t PassProfiler::PeakMemoryKB() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
 }  // namespace framework
 }  // namespace hlir
 }  // namespace cinn
@@ -13,6 +13,12 @@
 // limitations under the License.
 
 #pragma once
+#include <absl/types/any.h>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -46,6 +52,10 @@ class PassFunctionRegister : public FunctionRegEntryBase<PassFunctionRegister, P
   std::vector<std::string> graph_attr_dependency{};
   //! generated targets of graph attributes
   std::vector<std::string> graph_attr_targets{};
+  //! analyses built before the pass is applied
+  std::vector<std::string> required_analyses{};
+  //! analyses kept valid by the pass, the others cached on the graph are dropped after it is applied
+  std::vector<std::string> preserved_analyses{};
 
   /**
    * \brief Imply whether this pass will change the Graph's structure.
@@ -89,10 +99,119 @@ class PassFunctionRegister : public FunctionRegEntryBase<PassFunctionRegister, P
     graph_attr_dependency.push_back(attr_name);
     return *this;
   }
+
+  /**
+   * \brief Declare this pass uses the given analysis, which is built before the pass is applied if it is not cached
+   *        on the graph, so the time to build it is counted apart from the pass.
+   * @param analysis_name Name of the analysis.
+   * @return Reference to self.
+   */
+  PassFunctionRegister& require_analysis(const std::string& analysis_name) {
+    required_analyses.push_back(analysis_name);
+    return *this;
+  }
+
+  /**
+   * \brief Declare this pass keeps the given analysis valid, that is it doesn't change what the analysis is derived
+   *        from, so the cached analysis is reused by the following passes.
+   * @param analysis_name Name of the analysis.
+   * @return Reference to self.
+   */
+  PassFunctionRegister& preserve_analysis(const std::string& analysis_name) {
+    preserved_analyses.push_back(analysis_name);
+    return *this;
+  }
 };
 
 const PassFunctionRegister* FindPassDep(const std::string& attr_name);
 
+typedef std::function<std::shared_ptr<absl::any>(Graph* g)> AnalysisFunction;
+
+//! The consumers of each data node in topological order.
+using ConsumerMap = absl::flat_hash_map<const NodeData*, std::vector<Node*>>;
+//! The pattern kind of the op of each op node.
+using OpPatternKindMap = absl::flat_hash_map<const Node*, OpPatternKind>;
+
+/**
+ * \brief The registry of the functions building the analyses of graphs. The analyses are cached on the graph by their
+ * names, the registered ones are:
+ * - "csr_graph": the CSR snapshot of the graph, a common::CsrGraph.
+ * - "shape_dict" and "dtype_dict": the shapes and the dtypes of the data nodes inferred by InferShape, shared with the
+ *   graph attrs "infershape" and "inferdtype".
+ * - "consumer_map": the op nodes consuming each data node, a ConsumerMap.
+ * - "op_pattern_kinds": the pattern kind of the op of each op node, by which the fusion passes look up their fusion
+ *   relations, an OpPatternKindMap.
+ */
+class AnalysisRegistry {
+ public:
+  static AnalysisRegistry* Global();
+
+  bool Register(const std::string& analysis_name, AnalysisFunction builder);
+
+  const AnalysisFunction& Get(const std::string& analysis_name) const;
+
+ private:
+  AnalysisRegistry() = default;
+
+  std::map<std::string, AnalysisFunction> builders_;
+};
+
+/**
+ * \brief Get an analysis of the graph, which is built on the first request and cached on the graph until a pass not
+ *        preserving it is applied, or the topology of the graph is changed out of the passes, see
+ *        common::Graph::topology_version.
+ * @param g The graph.
+ * @param analysis_name Name of the analysis.
+ * @return The analysis, which is shared with the cache, so it stays valid after the cache drops or rebuilds it.
+ */
+std::shared_ptr<const absl::any> GetAnalysis(Graph* g, const std::string& analysis_name);
+
+template <typename T>
+std::shared_ptr<const T> GetAnalysis(Graph* g, const std::string& analysis_name) {
+  auto analysis = GetAnalysis(g, analysis_name);
+  return std::shared_ptr<const T>(analysis, &absl::any_cast<const T&>(*analysis));
+}
+
+/**
+ * \brief Drop the analyses cached on the graph.
+ * @param g The graph.
+ * @param preserved The analyses to keep.
+ */
+void InvalidateAnalyses(Graph* g, const std::vector<std::string>& preserved = {});
+
+/**
+ * \brief Collect the wall time of the passes and the growth of the peak resident memory of the process during them,
+ * when FLAGS_cinn_pass_profile is on. Both the graph passes and the program passes are recorded, the time to build the
+ * analyses required by a graph pass is counted apart.
+ */
+class PassProfiler {
+ public:
+  static PassProfiler* Global();
+
+  void Record(const std::string& pass_name, double time_ms, double analysis_time_ms, int64_t peak_memory_growth_kb);
+
+  //! Get a table of the recorded passes, sorted by their total time.
+  std::string Summary() const;
+
+  void Clear();
+
+  //! Get the peak resident memory of the process in KB.
+  static int64_t PeakMemoryKB();
+
+ private:
+  struct PassStat {
+    int runs{0};
+    double time_ms{0};
+    double analysis_time_ms{0};
+    int64_t peak_memory_growth_kb{0};
+  };
+
+  PassProfiler() = default;
+
+  mutable std::mutex mutex_;
+  std::map<std::string, PassStat> stats_;
+};
+
 /**
  * \brief Apply a sequence of passes on a graph.
  * @param g The input graph to apply passes on.
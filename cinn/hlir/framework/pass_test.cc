@@ -0,0 +1,137 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/framework/pass.h"
+
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "cinn/common/csr_graph.h"
+#include "cinn/frontend/net_builder.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/op/use_ops.h"
+#include "cinn/hlir/pass/use_pass.h"
+
+DECLARE_bool(cinn_pass_profile);
+
+namespace cinn {
+namespace hlir {
+namespace framework {
+
+void CountNodesPass(Graph* g) {
+  auto csr_graph         = GetAnalysis<common::CsrGraph>(g, "csr_graph");
+  g->attrs["node_count"] = std::make_shared<absl::any>(csr_graph->num_nodes());
+}
+
+// Hold the analyses like the fusion passes, and change the graph while they are held.
+void ChangeGraphPass(Graph* g) {
+  auto csr_graph    = GetAnalysis<common::CsrGraph>(g, "csr_graph");
+  auto consumer_map = GetAnalysis<ConsumerMap>(g, "consumer_map");
+  auto* node_data   = new NodeData(nullptr, 0, 0, "D", false);
+  g->RegisterNode(node_data->id(), node_data);
+  // the analyses are rebuilt, the held ones are kept alive as they were.
+  ASSERT_EQ(GetAnalysis<common::CsrGraph>(g, "csr_graph")->num_nodes(), 7);
+  ASSERT_EQ(GetAnalysis<ConsumerMap>(g, "consumer_map")->size(), 5UL);
+  ASSERT_EQ(csr_graph->num_nodes(), 6);
+  ASSERT_EQ(consumer_map->size(), 4UL);
+  ASSERT_EQ(csr_graph->topological_order().size(), 6UL);
+}
+
+CINN_REGISTER_PASS(ChangeGraph)
+    .describe("This pass registers a new data node while holding the analyses.")
+    .set_change_structure(true)
+    .require_analysis("csr_graph")
+    .set_body(ChangeGraphPass);
+
+CINN_REGISTER_PASS(CountNodes)
+    .describe("This pass just save the number of nodes to g.attrs[\"node_count\"].")
+    .set_change_structure(false)
+    .provide_graph_attr("node_count")
+    .require_analysis("csr_graph")
+    .set_body(CountNodesPass);
+
+std::unique_ptr<Graph> BuildGraph() {
+  frontend::NetBuilder builder("net_builder");
+  auto a       = builder.CreateInput(Float(32), {16, 32}, "A");
+  auto b       = builder.CreateInput(Float(32), {16, 32}, "B");
+  auto c       = builder.Add(a, b);
+  builder.Relu(c);
+  auto program = builder.Build();
+  return std::make_unique<Graph>(program, common::DefaultHostTarget());
+}
+
+TEST(ApplyPasses, CacheAnalysis) {
+  auto graph = BuildGraph();
+  ApplyPass(graph.get(), "InferShape");
+  // InferShape builds the snapshot and preserves it.
+  ASSERT_EQ(graph->analyses.count("csr_graph"), 1);
+  auto csr_graph = GetAnalysis<common::CsrGraph>(graph.get(), "csr_graph");
+  ASSERT_EQ(csr_graph->num_nodes(), 6);
+  // the cached snapshot is reused without rebuilding.
+  ASSERT_EQ(csr_graph, GetAnalysis<common::CsrGraph>(graph.get(), "csr_graph"));
+
+  // CountNodes doesn't preserve the snapshot, so it is dropped after the pass.
+  ApplyPass(graph.get(), "CountNodes");
+  ASSERT_EQ(graph->GetAttrs<int>("node_count"), 6);
+  ASSERT_EQ(graph->analyses.count("csr_graph"), 0);
+}
+
+TEST(ApplyPasses, StaleAnalysis) {
+  auto graph = BuildGraph();
+  ApplyPass(graph.get(), "InferShape");
+  ASSERT_EQ(GetAnalysis<common::CsrGraph>(graph.get(), "csr_graph")->num_nodes(), 6);
+  auto consumer_map = GetAnalysis<ConsumerMap>(graph.get(), "consumer_map");
+  ASSERT_EQ(consumer_map->size(), 4UL);
+
+  // change another graph, the analyses of this one are kept.
+  auto other_graph = BuildGraph();
+  auto* other_data = new NodeData(nullptr, 0, 0, "D", false);
+  other_graph->RegisterNode(other_data->id(), other_data);
+  ASSERT_EQ(consumer_map, GetAnalysis<ConsumerMap>(graph.get(), "consumer_map"));
+
+  // change the graph out of the passes, the cached snapshot is rebuilt on the next request.
+  auto* node_data = new NodeData(nullptr, 0, 0, "D", false);
+  graph->RegisterNode(node_data->id(), node_data);
+  ASSERT_EQ(GetAnalysis<common::CsrGraph>(graph.get(), "csr_graph")->num_nodes(), 7);
+  ASSERT_EQ(GetAnalysis<ConsumerMap>(graph.get(), "consumer_map")->size(), 5UL);
+  ASSERT_EQ(consumer_map->size(), 4UL);
+}
+
+TEST(ApplyPasses, ChangeGraphHoldingAnalysis) {
+  auto graph = BuildGraph();
+  ApplyPasses(graph.get(), {"InferShape", "ChangeGraph"});
+  // ChangeGraph doesn't preserve the analyses, so they are all dropped after it.
+  ASSERT_TRUE(graph->analyses.empty());
+}
+
+TEST(ApplyPasses, Profile) {
+  FLAGS_cinn_pass_profile = true;
+  PassProfiler::Global()->Clear();
+  auto graph = BuildGraph();
+  ApplyPasses(graph.get(), {"InferShape", "CountNodes", "CountNodes"});
+  FLAGS_cinn_pass_profile = false;
+
+  auto summary = PassProfiler::Global()->Summary();
+  LOG(INFO) << "\n" << summary;
+  ASSERT_NE(summary.find("InferShape"), std::string::npos);
+  ASSERT_NE(summary.find("CountNodes"), std::string::npos);
+  PassProfiler::Global()->Clear();
+  ASSERT_EQ(PassProfiler::Global()->Summary().find("InferShape"), std::string::npos);
+}
+
+}  // namespace framework
+}  // namespace hlir
+}  // namespace cinn
@@ -16,9 +16,11 @@
 
 #include <absl/strings/string_view.h>
 
+#include <algorithm>
 #include <functional>
 #include <memory>
 #include <numeric>
+#include <utility>
 #include <vector>
 
 #include "cinn/common/common.h"
@@ -82,6 +84,22 @@ class _Tensor_ : public Object {
     return reinterpret_cast<T*>(buffer_->data()->memory);
   }
 
+  /**
+   * Bind the caller-owned \p data of \p type in \p target as the memory of this tensor, no copy is made.
+   * The data should hold the whole tensor, be aligned to the element size and outlive the use of this tensor, or be
+   * kept alive by the optional \p holder.
+   */
+  inline void ShareExternalData(void* data,
+                                const Target& target,
+                                const Type& type,
+                                std::shared_ptr<void> holder = nullptr) {
+    size_t element_bytes = std::max((type.bits() + 7) / 8, 1);
+    CHECK_EQ(reinterpret_cast<uintptr_t>(data) % element_bytes, 0UL)
+        << "The external data should be aligned to " << element_bytes << " bytes";
+    set_type(type);
+    buffer_->ShareExternalMemory(data, (shape_.numel() * type.bits() + 7) / 8, target, std::move(holder));
+  }
+
   template <typename T>
   const T* data() const {
     return reinterpret_cast<T*>(buffer_->data()->memory);
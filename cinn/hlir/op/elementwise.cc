@@ -359,6 +359,213 @@ std::vector<std::vector<std::string>> InferLayoutForFillConstant(const std::vect
   return {{""}, input_layouts};
 }
 
+using QuantPeFunc = std::function<ir::Tensor(
+    const std::vector<ir::Tensor> &inputs, int axis, int zero_point, const std::string &out_name)>;
+
+std::shared_ptr<OpStrategy> StrategyForQuantization(const framework::NodeAttr &attrs,
+                                                    const std::vector<ir::Tensor> &inputs,
+                                                    const std::vector<Type> &out_type,
+                                                    const std::vector<std::vector<int>> &output_shapes,
+                                                    const Target &target,
+                                                    const std::string &op_name,
+                                                    size_t num_inputs,
+                                                    const QuantPeFunc &pe_func) {
+  int axis       = -1;
+  int zero_point = 0;
+  if (attrs.attr_store.count("axis")) {
+    axis = absl::get<int>(attrs.attr_store.at("axis"));
+  }
+  if (attrs.attr_store.count("zero_point")) {
+    zero_point = absl::get<int>(attrs.attr_store.at("zero_point"));
+  }
+
+  framework::CINNCompute quant_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of " << op_name << " compute is empty! Please check.";
+    CINNValuePack a = args[0];
+    CHECK_EQ(a.size(), num_inputs) << num_inputs << " input tensors for " << op_name << " compute";
+    std::vector<ir::Tensor> tensors;
+    for (size_t i = 0; i < num_inputs; ++i) {
+      Expr expr = a[i];
+      CHECK(expr.as_tensor());
+      tensors.push_back(expr.as_tensor_ref());
+    }
+    auto out    = pe_func(tensors, axis, zero_point, UniqName(op_name + "_Out"));
+    auto stages = CreateStages(tensors);
+    stages->InsertLazily(out);
+    *ret = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  framework::CINNSchedule quant_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of " << op_name << " schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 2UL);
+    Expr Out              = arg_pack[0];
+    poly::StageMap stages = arg_pack[1];
+    CHECK(Out.as_tensor());
+    if (target.arch == Target::Arch::NVGPU) {
+      pe::CudaScheduleInjective(stages[Out.as_tensor_ref()], output_shapes.front(), target);
+    } else if (target.arch == Target::Arch::X86) {
+      pe::ScheduleInjectiveCPU(stages[Out.as_tensor_ref()], output_shapes.front(), target);
+    }
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(quant_compute, quant_schedule, "strategy." + op_name + ".x86", 1);
+  return strategy;
+}
+
+std::shared_ptr<OpStrategy> StrategyForQuantize(const framework::NodeAttr &attrs,
+                                                const std::vector<ir::Tensor> &inputs,
+                                                const std::vector<Type> &out_type,
+                                                const std::vector<std::vector<int>> &output_shapes,
+                                                const Target &target) {
+  return StrategyForQuantization(
+      attrs,
+      inputs,
+      out_type,
+      output_shapes,
+      target,
+      "quantize",
+      2,
+      [](const std::vector<ir::Tensor> &tensors, int axis, int zero_point, const std::string &out_name) {
+        return pe::Quantize(tensors[0], tensors[1], axis, zero_point, out_name);
+      });
+}
+
+std::shared_ptr<OpStrategy> StrategyForDequantize(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<Type> &out_type,
+                                                  const std::vector<std::vector<int>> &output_shapes,
+                                                  const Target &target) {
+  return StrategyForQuantization(
+      attrs,
+      inputs,
+      out_type,
+      output_shapes,
+      target,
+      "dequantize",
+      2,
+      [](const std::vector<ir::Tensor> &tensors, int axis, int zero_point, const std::string &out_name) {
+        return pe::Dequantize(tensors[0], tensors[1], axis, zero_point, out_name);
+      });
+}
+
+std::shared_ptr<OpStrategy> StrategyForRequantize(const framework::NodeAttr &attrs,
+                                                  const std::vector<ir::Tensor> &inputs,
+                                                  const std::vector<Type> &out_type,
+                                                  const std::vector<std::vector<int>> &output_shapes,
+                                                  const Target &target) {
+  return StrategyForQuantization(
+      attrs,
+      inputs,
+      out_type,
+      output_shapes,
+      target,
+      "requantize",
+      3,
+      [](const std::vector<ir::Tensor> &tensors, int axis, int zero_point, const std::string &out_name) {
+        return pe::Requantize(tensors[0], tensors[1], tensors[2], axis, zero_point, out_name);
+      });
+}
+
+std::vector<shape_t> InferShapeForQuantization(const std::vector<shape_t> &inputs_shape,
+                                               const framework::AttrMapType &attrs) {
+  CHECK_GE(inputs_shape.size(), 2UL) << "The quantization op needs the input tensor and its scales.";
+  const auto &x_shape = inputs_shape[0];
+  int axis            = -1;
+  if (attrs.count("axis")) {
+    axis = absl::get<int>(attrs.at("axis"));
+  }
+  CHECK_LT(axis, static_cast<int>(x_shape.size())) << "The quantization axis " << axis << " is out of range!";
+  for (size_t i = 1; i < inputs_shape.size(); ++i) {
+    const auto &scale_shape = inputs_shape[i];
+    CHECK_EQ(scale_shape.size(), 1UL) << "The scale of quantization op should be 1-D, but get shape ["
+                                      << utils::Join(scale_shape, ", ") << "]";
+    if (axis < 0 || i == 2) {
+      // the output scale of requantize is always per-tensor
+      CHECK_EQ(scale_shape[0], 1) << "The per-tensor scale should have shape [1]";
+    } else {
+      CHECK_EQ(scale_shape[0], x_shape[axis]) << "The per-channel scale size should equal to dim " << axis;
+    }
+  }
+  return {x_shape};
+}
+
+std::vector<Type> InferDtypeForQuantize(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  return {common::Int(8)};
+}
+
+std::vector<Type> InferDtypeForDequantize(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  CHECK(inputs_type[0].is_int(8) || inputs_type[0].is_int(32))
+      << "The input of dequantize should be int8 or int32, but get " << inputs_type[0];
+  return {common::Float(32)};
+}
+
+std::vector<Type> InferDtypeForRequantize(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  CHECK(inputs_type[0].is_int(32)) << "The input of requantize should be the int32 accumulator, but get "
+                                   << inputs_type[0];
+  return {common::Int(8)};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForQuantization(const std::vector<framework::shape_t> &input_shapes,
+                                                                 const std::vector<std::string> &input_layouts,
+                                                                 const framework::NodeAttr &attrs,
+                                                                 const Target &target) {
+  CHECK_GE(input_layouts.size(), 2U) << "The input's layouts size is less than 2! Please check again.";
+  return {{input_layouts[0]}, input_layouts};
+}
+
+std::shared_ptr<OpStrategy> StrategyForCast(const framework::NodeAttr &attrs,
+                                            const std::vector<ir::Tensor> &inputs,
+                                            const std::vector<Type> &out_type,
+                                            const std::vector<std::vector<int>> &output_shapes,
+                                            const Target &target) {
+  CHECK(!out_type.empty()) << "The output type of cast is empty! Please check.";
+  Type dtype = out_type[0];
+
+  framework::CINNCompute cast_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of cast compute is empty! Please check.";
+    CINNValuePack a = args[0];
+    CHECK(!a.empty()) << "The input tensor of cast compute is empty! Please check.";
+    Expr A_expr = a[0];
+    CHECK(A_expr.as_tensor());
+    ir::Tensor A = A_expr.as_tensor_ref();
+    auto out     = pe::Cast(A, dtype, UniqName("Cast_Out"));
+    auto stages  = CreateStages({A});
+    stages->InsertLazily(out);
+    *ret = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  framework::CINNSchedule cast_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input argument of cast schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 2UL);
+    Expr Out              = arg_pack[0];
+    poly::StageMap stages = arg_pack[1];
+    CHECK(Out.as_tensor());
+    if (target.arch == Target::Arch::NVGPU) {
+      pe::CudaScheduleInjective(stages[Out.as_tensor_ref()], output_shapes.front(), target);
+    } else if (target.arch == Target::Arch::X86) {
+      pe::ScheduleInjectiveCPU(stages[Out.as_tensor_ref()], output_shapes.front(), target);
+    }
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(cast_compute, cast_schedule, "strategy.cast.x86", 1);
+  return strategy;
+}
+
+std::vector<Type> InferDtypeForCast(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  CHECK(attrs.count("dtype")) << "The cast op should have the attribute [dtype]!";
+  return {common::Str2Type(absl::get<std::string>(attrs.at("dtype")))};
+}
+
 StrategyForUnary(exp, Exp);
 StrategyForUnary(erf, Erf);
 StrategyForUnary(sqrt, Sqrt);
@@ -465,6 +672,50 @@ CINN_REGISTER_HELPER(elementwise_ops) {
       .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
       .set_support_level(4);
 
+  CINN_REGISTER_OP(quantize)
+      .describe("Quantize a float tensor to int8 with per-tensor or per-channel scales")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForQuantize)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantization))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForQuantize))
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForQuantization))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(dequantize)
+      .describe("Dequantize an int8 or int32 tensor to float32 with per-tensor or per-channel scales")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForDequantize)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantization))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForDequantize))
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForQuantization))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(requantize)
+      .describe("Requantize an int32 accumulator tensor to int8, the epilogue of integer matmul and conv2d")
+      .set_num_inputs(3)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForRequantize)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantization))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForRequantize))
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForQuantization))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(cast)
+      .describe("Cast the input tensor to the data type given by the attribute [dtype]")
+      .set_num_inputs(1)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForCast)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForElementwise))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForCast))
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForElementwise))
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kElemWise)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(const_scalar)
       .describe("create const scalar with the given value")
       .set_num_inputs(0)
@@ -14,6 +14,8 @@
 
 #include "cinn/hlir/pe/nn.h"
 
+#include <gflags/gflags.h>
+
 #include <functional>
 
 #include "cinn/hlir/framework/node.h"
@@ -26,6 +28,8 @@
 #include "cinn/ir/layout.h"
 #include "cinn/poly/stage.h"
 
+DECLARE_bool(cinn_cpu_two_step_reduce);
+
 namespace cinn {
 namespace hlir {
 namespace op {
@@ -1659,18 +1663,30 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
 #ifdef CINN_WITH_MKLDNN
     if (use_mkldnn) {
       out = pe::SoftmaxMKLDNN(A, new_axis, UniqName("Softmax_mkldnn_output"));
+    } else if (target.arch == Target::Arch::X86 && FLAGS_cinn_cpu_two_step_reduce) {
+      out = pe::SoftmaxCpuTwoStep(A, new_axis, UniqName("Softmax_output"));
     } else {
       out = pe::Softmax(A, new_axis, UniqName("Softmax_output"));
     }
 #else
-    out = pe::Softmax(A, new_axis, UniqName("Softmax_output"));
+    if (target.arch == Target::Arch::X86 && FLAGS_cinn_cpu_two_step_reduce) {
+      out = pe::SoftmaxCpuTwoStep(A, new_axis, UniqName("Softmax_output"));
+    } else {
+      out = pe::Softmax(A, new_axis, UniqName("Softmax_output"));
+    }
 #endif
+    if (out.size() == 4U) {
+      // the exps are only computed in the partial sums.
+      stages->InsertLazily(out.back());
+      stages[out.back()]->ComputeInline();
+      out.pop_back();
+    }
     std::vector<CINNValue> res;
     for (auto &t : out) {
       stages->InsertLazily(t);
       res.push_back(CINNValue(t));
     }
-    CHECK_EQ(out.size(), 2U) << "The size of pe::Softmax's output should be 2.";
+    CHECK(out.size() == 2U || out.size() == 3U) << "The size of pe::Softmax's output should be 2 or 3.";
     CHECK(!out_type.empty()) << "Output type of Softmax is empty! Please check.\n";
     res.push_back(CINNValue(stages));
     *ret = CINNValuePack{res};
@@ -1679,11 +1695,12 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
   framework::CINNSchedule softmax_schedule([=](lang::Args args, lang::RetValue *ret) {
     CHECK(!args.empty()) << "The input arguments of softmax schedule is empty! Please check.";
     CINNValuePack arg_pack = args[0];
-    CHECK_EQ(arg_pack.size(), 3UL) << "The input tensor's size of softmax schedule is " << arg_pack.size()
-                                   << "and it should be equal to 3! Please check.";
+    CHECK(arg_pack.size() == 3UL || arg_pack.size() == 4UL)
+        << "The input tensor's size of softmax schedule is " << arg_pack.size()
+        << "and it should be equal to 3 or 4! Please check.";
     Expr out1             = arg_pack[0];
     Expr out2             = arg_pack[1];
-    poly::StageMap stages = arg_pack[2];
+    poly::StageMap stages = arg_pack.back();
     CHECK(out1.as_tensor());
     CHECK(out2.as_tensor());
     ir::Tensor tensor_a = out1.as_tensor_ref();
@@ -1697,7 +1714,12 @@ std::shared_ptr<OpStrategy> StrategyForSoftmax(const framework::NodeAttr &attrs,
         stages[tensor_b]->ComputeAt(stages[tensor_a], shape_size);
       }
     } else if (target.arch == Target::Arch::X86) {
-      pe::SoftmaxScheduleCPU(stages, tensor_a, tensor_b, axis);
+      if (arg_pack.size() == 4UL) {
+        Expr internal = arg_pack[2];
+        pe::SoftmaxCpuTwoStepSchedule(stages, tensor_a, tensor_b, internal.as_tensor_ref(), target);
+      } else {
+        pe::SoftmaxScheduleCPU(stages, tensor_a, tensor_b, axis);
+      }
     }
     *ret = arg_pack;
   });
@@ -1733,6 +1755,238 @@ std::vector<std::vector<std::string>> InferLayoutForSoftmax(const std::vector<fr
   return {{input_layouts[0], input_layouts[0]}, input_layouts};
 }
 
+std::shared_ptr<OpStrategy> StrategyForFusedAttention(const framework::NodeAttr &attrs,
+                                                      const std::vector<ir::Tensor> &inputs,
+                                                      const std::vector<Type> &out_type,
+                                                      const std::vector<std::vector<int>> &output_shapes,
+                                                      const Target &target) {
+  CHECK(attrs.attr_store.count("scale")) << "The attr scale of fused_attention is not found! Please check.";
+  float scale = absl::get<float>(attrs.attr_store.at("scale"));
+  CHECK(target.arch == Target::Arch::X86) << "fused_attention is only supported on X86";
+
+  framework::CINNCompute fused_attention_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of fused_attention compute is empty! Please check.";
+    CINNValuePack a = args[0];
+    CHECK_EQ(a.size(), 3U) << "fused_attention should have 3 input tensors! Please check.";
+    std::vector<ir::Tensor> qkv;
+    for (int i = 0; i < 3; i++) {
+      Expr expr = a[i];
+      CHECK(expr.as_tensor());
+      qkv.push_back(expr.as_tensor_ref());
+    }
+    auto stages = CreateStages(qkv);
+    auto out    = pe::FusedAttention(qkv[0], qkv[1], qkv[2], scale, UniqName("FusedAttention_output"));
+    CHECK_EQ(out.size(), 2U) << "The size of pe::FusedAttention's output should be 2.";
+    CHECK(!out_type.empty()) << "Output type of fused_attention is empty! Please check.\n";
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule fused_attention_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of fused_attention schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 3UL) << "The input tensor's size of fused_attention schedule is " << arg_pack.size()
+                                   << "and it should be equal to 3! Please check.";
+    // The tiling over the query and key blocks is done inside the extern kernel.
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(fused_attention_compute, fused_attention_schedule, "strategy.fused_attention.x86", 1);
+
+  return strategy;
+}
+
+std::vector<std::vector<int>> InferShapeForFusedAttention(const std::vector<std::vector<int>> &inputs_shape,
+                                                          const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 3U) << "The input's shape size should be 3! Please check again.";
+  const auto &q_shape = inputs_shape[0];
+  const auto &k_shape = inputs_shape[1];
+  const auto &v_shape = inputs_shape[2];
+  CHECK_GE(q_shape.size(), 2U) << "The query of fused_attention should be at least 2-D! Please check again.";
+  CHECK(q_shape.size() == k_shape.size() && q_shape.size() == v_shape.size())
+      << "The query, key and value of fused_attention should have the same rank! Please check again.";
+  int rank = q_shape.size();
+  for (int i = 0; i < rank - 2; i++) {
+    CHECK(q_shape[i] == k_shape[i] && q_shape[i] == v_shape[i])
+        << "The leading dimensions of the query, key and value of fused_attention should be the same!";
+  }
+  CHECK_EQ(q_shape[rank - 1], k_shape[rank - 1]) << "The query and key should have the same head dim!";
+  CHECK_EQ(k_shape[rank - 2], v_shape[rank - 2]) << "The key and value should have the same sequence length!";
+
+  std::vector<int> out_shape = q_shape;
+  out_shape.back()           = v_shape.back();
+  std::vector<std::vector<int>> res{out_shape, {1}};
+  return res;
+}
+
+std::vector<Type> InferDtypeForFusedAttention(const std::vector<Type> &inputs_type,
+                                              const framework::AttrMapType &attrs) {
+  CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  std::vector<Type> res{inputs_type[0], inputs_type[0]};
+  return res;
+}
+
+std::vector<std::vector<std::string>> InferLayoutForFusedAttention(const std::vector<framework::shape_t> &input_shapes,
+                                                                   const std::vector<std::string> &input_layouts,
+                                                                   const framework::NodeAttr &attrs,
+                                                                   const Target &target) {
+  CHECK_EQ(input_layouts.size(), 3U) << "The input's layout size is not 3! Please check again.";
+  return {{"", ""}, input_layouts};
+}
+
+std::shared_ptr<OpStrategy> StrategyForQuantizedMatmul(const framework::NodeAttr &attrs,
+                                                       const std::vector<ir::Tensor> &inputs,
+                                                       const std::vector<Type> &out_type,
+                                                       const std::vector<std::vector<int>> &output_shapes,
+                                                       const Target &target) {
+  CHECK(target.arch == Target::Arch::X86) << "quantized_matmul is only supported on X86";
+
+  framework::CINNCompute quantized_matmul_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of quantized_matmul compute is empty! Please check.";
+    CINNValuePack a = args[0];
+    CHECK_EQ(a.size(), 2U) << "quantized_matmul should have 2 input tensors! Please check.";
+    Expr A = a[0];
+    Expr B = a[1];
+    CHECK(A.as_tensor() && B.as_tensor());
+    auto out    = pe::QuantizedMatmul(A.as_tensor_ref(), B.as_tensor_ref(), UniqName("QuantizedMatmul_output"));
+    auto stages = CreateStages({A.as_tensor_ref(), B.as_tensor_ref(), out});
+    *ret        = CINNValuePack{{CINNValue(out), CINNValue(stages)}};
+  });
+
+  framework::CINNSchedule quantized_matmul_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of quantized_matmul schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 2UL);
+    Expr Out              = arg_pack[0];
+    poly::StageMap stages = arg_pack.back();
+    pe::QuantizedGemmScheduleCPU(stages, Out.as_tensor_ref(), target);
+    *ret = arg_pack;
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(quantized_matmul_compute, quantized_matmul_schedule, "strategy.quantized_matmul.x86", 1);
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForQuantizedMatmul(const std::vector<shape_t> &inputs_shape,
+                                                  const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The input's shape size should be 2! Please check again.";
+  CHECK_EQ(inputs_shape[0].size(), 2U) << "The first input of quantized_matmul should be 2-D! Please check again.";
+  CHECK_EQ(inputs_shape[1].size(), 2U) << "The second input of quantized_matmul should be 2-D! Please check again.";
+  CHECK_EQ(inputs_shape[0][1], inputs_shape[1][0])
+      << "The width of the first input should equal to the height of the second one! Please check again.";
+  return {{inputs_shape[0][0], inputs_shape[1][1]}};
+}
+
+std::shared_ptr<OpStrategy> StrategyForQuantizedConv2d(const framework::NodeAttr &attrs,
+                                                       const std::vector<ir::Tensor> &inputs,
+                                                       const std::vector<Type> &out_type,
+                                                       const std::vector<std::vector<int>> &output_shapes,
+                                                       const Target &target) {
+  std::vector<int> padding({0, 0});
+  std::vector<int> stride({1, 1});
+  std::vector<int> dilation({1, 1});
+  if (attrs.attr_store.find("padding") != attrs.attr_store.end()) {
+    padding = absl::get<std::vector<int>>(attrs.attr_store.at("padding"));
+  }
+  if (attrs.attr_store.find("stride") != attrs.attr_store.end()) {
+    stride = absl::get<std::vector<int>>(attrs.attr_store.at("stride"));
+  }
+  if (attrs.attr_store.find("dilation") != attrs.attr_store.end()) {
+    dilation = absl::get<std::vector<int>>(attrs.attr_store.at("dilation"));
+  }
+  CHECK(target.arch == Target::Arch::X86) << "quantized_conv2d is only supported on X86";
+
+  framework::CINNCompute quantized_conv2d_compute([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of quantized_conv2d compute is empty! Please check.";
+    CINNValuePack a = args[0];
+    CHECK_EQ(a.size(), 2U) << "quantized_conv2d should have 2 input tensors! Please check.";
+    Expr A = a[0];
+    Expr B = a[1];
+    CHECK(A.as_tensor() && B.as_tensor());
+    auto out    = pe::QuantizedConv2d_NCHW(A.as_tensor_ref(),
+                                           B.as_tensor_ref(),
+                                           padding[0],
+                                           padding[1],
+                                           stride[0],
+                                           stride[1],
+                                           dilation[0],
+                                           dilation[1],
+                                           UniqName("QuantizedConv2d_output"));
+    auto stages = CreateStages({A.as_tensor_ref(), B.as_tensor_ref()});
+    std::vector<CINNValue> res;
+    for (auto &t : out) {
+      stages->InsertLazily(t);
+      res.push_back(CINNValue(t));
+    }
+    res.push_back(CINNValue(stages));
+    *ret = CINNValuePack{res};
+  });
+
+  framework::CINNSchedule quantized_conv2d_schedule([=](lang::Args args, lang::RetValue *ret) {
+    CHECK(!args.empty()) << "The input arguments of quantized_conv2d schedule is empty! Please check.";
+    CINNValuePack arg_pack = args[0];
+    CHECK_EQ(arg_pack.size(), 3UL);
+    Expr Out              = arg_pack[0];
+    Expr input_pad        = arg_pack[1];
+    poly::StageMap stages = arg_pack.back();
+    stages[input_pad.as_tensor_ref()]->ComputeInline();
+    pe::QuantizedGemmScheduleCPU(stages, Out.as_tensor_ref(), target);
+    *ret = CINNValuePack{{arg_pack[0], CINNValue(stages)}};
+  });
+
+  auto strategy = std::make_shared<framework::OpStrategy>();
+  strategy->AddImpl(quantized_conv2d_compute, quantized_conv2d_schedule, "strategy.quantized_conv2d.x86", 1);
+  return strategy;
+}
+
+std::vector<shape_t> InferShapeForQuantizedConv2d(const std::vector<shape_t> &inputs_shape,
+                                                  const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_shape.size(), 2U) << "The input's shape size should be 2! Please check again.";
+  std::vector<int> padding({0, 0});
+  std::vector<int> stride({1, 1});
+  std::vector<int> dilation({1, 1});
+  if (attrs.find("padding") != attrs.end()) {
+    padding = absl::get<std::vector<int>>(attrs.at("padding"));
+  }
+  if (attrs.find("stride") != attrs.end()) {
+    stride = absl::get<std::vector<int>>(attrs.at("stride"));
+  }
+  if (attrs.find("dilation") != attrs.end()) {
+    dilation = absl::get<std::vector<int>>(attrs.at("dilation"));
+  }
+  const auto &x_shape = inputs_shape[0];
+  const auto &w_shape = inputs_shape[1];
+  CHECK_EQ(x_shape.size(), 4U) << "The input of quantized_conv2d should be 4-D NCHW! Please check again.";
+  CHECK_EQ(w_shape.size(), 4U) << "The weights of quantized_conv2d should be 4-D OIHW! Please check again.";
+  CHECK_EQ(x_shape[1], w_shape[1]) << "The grouped quantized_conv2d is not supported! Please check again.";
+  int out_h = (x_shape[2] + 2 * padding[0] - ((w_shape[2] - 1) * dilation[0] + 1)) / stride[0] + 1;
+  int out_w = (x_shape[3] + 2 * padding[1] - ((w_shape[3] - 1) * dilation[1] + 1)) / stride[1] + 1;
+  return {{x_shape[0], w_shape[0], out_h, out_w}};
+}
+
+std::vector<Type> InferDtypeForQuantizedGemm(const std::vector<Type> &inputs_type,
+                                             const framework::AttrMapType &attrs) {
+  CHECK_EQ(inputs_type.size(), 2U) << "The input's type size should be 2! Please check again.";
+  CHECK(inputs_type[0].is_int(8) && inputs_type[1].is_int(8))
+      << "The inputs should be int8, but get " << inputs_type[0] << " and " << inputs_type[1];
+  return {common::Int(32)};
+}
+
+std::vector<std::vector<std::string>> InferLayoutForQuantizedGemm(const std::vector<framework::shape_t> &input_shapes,
+                                                                  const std::vector<std::string> &input_layouts,
+                                                                  const framework::NodeAttr &attrs,
+                                                                  const Target &target) {
+  CHECK_EQ(input_layouts.size(), 2U) << "The input's layout size is not 2! Please check again.";
+  return {{input_layouts[0]}, input_layouts};
+}
+
 std::shared_ptr<OpStrategy> StrategyForDropoutInfer(const framework::NodeAttr &attrs,
                                                     const std::vector<ir::Tensor> &inputs,
                                                     const std::vector<Type> &out_type,
@@ -2130,6 +2384,47 @@ CINN_REGISTER_HELPER(nn_ops) {
       .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
       .set_support_level(4);
 
+  CINN_REGISTER_OP(fused_attention)
+      .describe("This operator computes softmax(Q * K^T * scale) * V with the online softmax")
+      .set_num_inputs(3)
+      .set_num_outputs(2)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForFusedAttention)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForFusedAttention))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForFusedAttention))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForFusedAttention))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern", cinn::hlir::framework::OpPatternKind::kOpaque)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(quantized_matmul)
+      .describe("Multiply two int8 matrices with int32 accumulation")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForQuantizedMatmul)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantizedMatmul))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForQuantizedGemm))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForQuantizedGemm))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern",
+                                                      cinn::hlir::framework::OpPatternKind::kOutEWiseFusable)
+      .set_support_level(4);
+
+  CINN_REGISTER_OP(quantized_conv2d)
+      .describe("Do a 2-D convolution of int8 tensors in NCHW layout with int32 accumulation")
+      .set_num_inputs(2)
+      .set_num_outputs(1)
+      .set_attr<cinn::hlir::framework::StrategyFunction>("CINNStrategy", cinn::hlir::op::StrategyForQuantizedConv2d)
+      .set_attr("infershape", MakeOpFunction(cinn::hlir::op::InferShapeForQuantizedConv2d))
+      .set_attr("inferdtype", MakeOpFunction(cinn::hlir::op::InferDtypeForQuantizedGemm))
+#ifndef CINN_WITH_CUDA
+      .set_attr("inferlayout", MakeOpFunction(cinn::hlir::op::InferLayoutForQuantizedGemm))
+#endif
+      .set_attr<cinn::hlir::framework::OpPatternKind>("OpPattern",
+                                                      cinn::hlir::framework::OpPatternKind::kOutEWiseFusable)
+      .set_support_level(4);
+
   CINN_REGISTER_OP(dropout_infer)
       .describe("Downgrade the outcome at inference or keep the same.")
       .set_num_inputs(1)
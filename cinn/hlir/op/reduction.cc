@@ -14,6 +14,8 @@
 
 #include "cinn/hlir/pe/reduction.h"
 
+#include <gflags/gflags.h>
+
 #include <iostream>
 #include <vector>
 
@@ -25,6 +27,8 @@
 #include "cinn/hlir/pe/transform.h"
 #include "cinn/ir/ir_operators.h"
 
+DECLARE_bool(cinn_cpu_two_step_reduce);
+
 namespace cinn {
 namespace hlir {
 namespace op {
@@ -40,22 +44,27 @@ using BlockReduceFunc = std::function<std::vector<ir::Tensor>(
 using ReduceFunc =
     std::function<ir::Tensor(const ir::Tensor &, const std::vector<int> &, const bool, const std::string &)>;
 
-#define STRATEGY_FOR_REDUCE(                                                                                  \
-    op_name_, reduce_op_, gpu_reduce_with_last_axis_func, gpu_reduce_without_last_axis_func, cpu_reduce_func) \
-  std::shared_ptr<OpStrategy> StrategyFor##reduce_op_(const framework::NodeAttr &attrs,                       \
-                                                      const std::vector<ir::Tensor> &inputs,                  \
-                                                      const std::vector<Type> &out_type,                      \
-                                                      const std::vector<std::vector<int>> &output_shapes,     \
-                                                      const Target &target) {                                 \
-    return StrategyForReduce(attrs,                                                                           \
-                             inputs,                                                                          \
-                             out_type,                                                                        \
-                             output_shapes,                                                                   \
-                             target,                                                                          \
-                             #op_name_,                                                                       \
-                             gpu_reduce_with_last_axis_func,                                                  \
-                             gpu_reduce_without_last_axis_func,                                               \
-                             cpu_reduce_func);                                                                \
+#define STRATEGY_FOR_REDUCE(op_name_,                                                                     \
+                            reduce_op_,                                                                   \
+                            gpu_reduce_with_last_axis_func,                                               \
+                            gpu_reduce_without_last_axis_func,                                            \
+                            cpu_reduce_func,                                                              \
+                            cpu_two_step_reduce_func)                                                     \
+  std::shared_ptr<OpStrategy> StrategyFor##reduce_op_(const framework::NodeAttr &attrs,                   \
+                                                      const std::vector<ir::Tensor> &inputs,              \
+                                                      const std::vector<Type> &out_type,                  \
+                                                      const std::vector<std::vector<int>> &output_shapes, \
+                                                      const Target &target) {                             \
+    return StrategyForReduce(attrs,                                                                       \
+                             inputs,                                                                      \
+                             out_type,                                                                    \
+                             output_shapes,                                                               \
+                             target,                                                                      \
+                             #op_name_,                                                                   \
+                             gpu_reduce_with_last_axis_func,                                              \
+                             gpu_reduce_without_last_axis_func,                                           \
+                             cpu_reduce_func,                                                             \
+                             cpu_two_step_reduce_func);                                                   \
   }
 
 std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
@@ -66,16 +75,12 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
                                               const std::string &op_name,
                                               BlockReduceFunc gpu_reduce_with_last_axis_func,
                                               BlockReduceFunc gpu_reduce_without_last_axis_func,
-                                              ReduceFunc cpu_reduce_func) {
+                                              ReduceFunc cpu_reduce_func,
+                                              BlockReduceFunc cpu_two_step_reduce_func) {
   std::vector<int> reduce_axes;
   if (attrs.attr_store.count("dim")) {
-    reduce_axes = absl::get<std::vector<int>>(attrs.attr_store.at("dim"));
-    if (reduce_axes.empty()) {
-      for (int i = 0; i < inputs[0]->shape.size(); ++i) {
-        reduce_axes.push_back(i);
-      }
-    }
-    std::sort(reduce_axes.begin(), reduce_axes.end());
+    // the negative axes count from the last one, the schedules take the real ones.
+    pe::GetRealAxes(inputs[0]->shape.size(), absl::get<std::vector<int>>(attrs.attr_store.at("dim")), &reduce_axes);
     // check reduce_axes
     CHECK_LE(reduce_axes.size(), inputs[0]->shape.size());
     CHECK_LT(reduce_axes.back(), inputs[0]->shape.size());
@@ -142,11 +147,21 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
         *ret = CINNValuePack{cinn_values};
       }
     } else {
-      VLOG(3) << "Do Reduce Compute!";
-      auto out    = cpu_reduce_func(x, reduce_axes, keep_dim, UniqName(op_name + "_out"));
-      auto stages = CreateStages({out});
+      std::vector<ir::Tensor> res;
+      if (FLAGS_cinn_cpu_two_step_reduce) {
+        VLOG(3) << "Do Two Step Reduce Compute!";
+        res = cpu_two_step_reduce_func(x, reduce_axes, keep_dim, UniqName(op_name + "_out"));
+      } else {
+        VLOG(3) << "Do Reduce Compute!";
+        res = {cpu_reduce_func(x, reduce_axes, keep_dim, UniqName(op_name + "_out"))};
+      }
+      auto stages = CreateStages(res);
 
-      std::vector<CINNValue> cinn_values{CINNValue(out), CINNValue(stages)};
+      std::vector<CINNValue> cinn_values;
+      for (auto &t : res) {
+        cinn_values.emplace_back(t);
+      }
+      cinn_values.emplace_back(stages);
       *ret = CINNValuePack{cinn_values};
     }
   });
@@ -211,6 +226,17 @@ std::shared_ptr<OpStrategy> StrategyForReduce(const framework::NodeAttr &attrs,
                                              target);
         }
       }
+    } else if (target.arch == Target::Arch::X86 && FLAGS_cinn_cpu_two_step_reduce) {
+      Expr out              = arg_pack[0];
+      poly::StageMap stages = arg_pack.back();
+      if (arg_pack.size() == 3) {
+        Expr internal = arg_pack[1];
+        VLOG(3) << "Do CpuTwoStepReduceSchedule Schedule!";
+        pe::CpuTwoStepReduceSchedule(stages, internal.as_tensor_ref(), out.as_tensor_ref(), target);
+      } else {
+        VLOG(3) << "Do ReduceScheduleCPU Schedule!";
+        pe::ReduceScheduleCPU(stages, out.as_tensor_ref(), inputs[0]->shape.size(), reduce_axes, target);
+      }
     }
     *ret = arg_pack;
   });
@@ -257,6 +283,10 @@ std::vector<shape_t> InferShapeForReduction(const std::vector<shape_t> &inputs_s
 
 std::vector<Type> InferDtypeForReduction(const std::vector<Type> &inputs_type, const framework::AttrMapType &attrs) {
   CHECK(!inputs_type.empty()) << "The input's type size is 0! Please check again.";
+  if (inputs_type[0].is_float16() || inputs_type[0].is_bfloat16()) {
+    // the low precision inputs are accumulated and returned in float32
+    return {Float(32)};
+  }
   std::vector<Type> res{inputs_type[0]};
   return res;
 }
@@ -295,10 +325,30 @@ std::vector<std::vector<std::string>> InferLayoutForBnOptimize(const std::vector
   return {{"", ""}, {"", ""}};
 }
 
-STRATEGY_FOR_REDUCE(reduce_sum, ReduceSum, pe::TwoStepBlockReduceSum, pe::BlockShuffleReduceSum, pe::ReduceSum);
-STRATEGY_FOR_REDUCE(reduce_prod, ReduceProd, pe::TwoStepBlockReduceProd, pe::BlockShuffleReduceProd, pe::ReduceProd);
-STRATEGY_FOR_REDUCE(reduce_max, ReduceMax, pe::TwoStepBlockReduceMax, pe::BlockShuffleReduceMax, pe::ReduceMax);
-STRATEGY_FOR_REDUCE(reduce_min, ReduceMin, pe::TwoStepBlockReduceMin, pe::BlockShuffleReduceMin, pe::ReduceMin);
+STRATEGY_FOR_REDUCE(reduce_sum,
+                    ReduceSum,
+                    pe::TwoStepBlockReduceSum,
+                    pe::BlockShuffleReduceSum,
+                    pe::ReduceSum,
+                    pe::CpuTwoStepReduceSum);
+STRATEGY_FOR_REDUCE(reduce_prod,
+                    ReduceProd,
+                    pe::TwoStepBlockReduceProd,
+                    pe::BlockShuffleReduceProd,
+                    pe::ReduceProd,
+                    pe::CpuTwoStepReduceProd);
+STRATEGY_FOR_REDUCE(reduce_max,
+                    ReduceMax,
+                    pe::TwoStepBlockReduceMax,
+                    pe::BlockShuffleReduceMax,
+                    pe::ReduceMax,
+                    pe::CpuTwoStepReduceMax);
+STRATEGY_FOR_REDUCE(reduce_min,
+                    ReduceMin,
+                    pe::TwoStepBlockReduceMin,
+                    pe::BlockShuffleReduceMin,
+                    pe::ReduceMin,
+                    pe::CpuTwoStepReduceMin);
 
 #undef STRATEGY_FOR_REDUCE
 
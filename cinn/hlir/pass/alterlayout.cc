@@ -12,6 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gflags/gflags.h>
+
+#include <functional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
@@ -21,6 +28,8 @@
 #include "cinn/ir/layout.h"
 #include "cinn/utils/string.h"
 
+DECLARE_bool(cinn_alter_layout_plan_blocks);
+
 namespace cinn {
 namespace hlir {
 namespace pass {
@@ -40,16 +49,52 @@ using InferLayoutFunc = std::function<std::vector<std::vector<std::string>>(cons
                                                                             const std::vector<std::string>&,
                                                                             const framework::NodeAttr&,
                                                                             const Target&)>;
-// insert layout_transform after the input var
+// the layout_transforms inserted after the input vars, keyed by the var and the dst layout, so a var used by several
+// ops in the same layout is transformed only once.
+struct LayoutTransformCache {
+  absl::flat_hash_map<std::string, NodeData*> transformed_vars;
+  int inserted_num{0};
+  int reused_num{0};
+};
+
+// replace the pos-th input of dst_node with new_input and keep the order of the inputs
+void ReplaceInput(Node* dst_node, int pos, NodeData* new_input) {
+  std::vector<GraphNode*> old_sources;
+  auto input_links = dst_node->inlinks_in_order(true);
+  for (auto& link : input_links) {
+    auto* source = link->source();
+    source->UnLinkSingleTo(dst_node);
+    old_sources.push_back(source);
+  }
+  for (int i = 0; i < old_sources.size(); i++) {
+    if (i == pos) {
+      new_input->LinkTo(dst_node);
+    } else {
+      old_sources[i]->LinkTo(dst_node);
+    }
+  }
+}
+
+// insert layout_transform after the input var, if the var has been transformed to dst_layout for another op and
+// cache is given, the transformed var is reused and the returned node is nullptr.
 std::tuple<Node*, NodeData*> InsertLayoutTransformNodeAfter(Graph* graph,
                                                             NodeData* input_data,
                                                             Node* dst_node,
                                                             int pos,
                                                             const std::string& src_layout,
                                                             const std::string& dst_layout,
-                                                            const std::string& name) {
+                                                            const std::string& name,
+                                                            LayoutTransformCache* cache = nullptr) {
   CHECK(graph);
   CHECK(input_data);
+  std::string key = input_data->id() + "->" + dst_layout;
+  if (cache && cache->transformed_vars.count(key)) {
+    auto* output_data = cache->transformed_vars.at(key);
+    VLOG(3) << "reuse " << output_data->id() << " as the " << dst_layout << " layout of " << input_data->id();
+    ReplaceInput(dst_node, pos, output_data);
+    cache->reused_num++;
+    return std::make_tuple(nullptr, output_data);
+  }
   std::string op_type                           = "layout_transform";
   auto trans_node                               = new Node(Operator::Get(op_type), op_type, name);
   trans_node->attrs.attr_store["src_layout"]    = src_layout;
@@ -57,6 +102,10 @@ std::tuple<Node*, NodeData*> InsertLayoutTransformNodeAfter(Graph* graph,
   auto output_data                              = InsertGraphOpNodeAfter(graph, trans_node, input_data, dst_node, pos);
   trans_node->attrs.attr_store["input_layouts"] = {src_layout};
   trans_node->attrs.attr_store["out_layouts"]   = {dst_layout};
+  if (cache) {
+    cache->transformed_vars[key] = output_data;
+    cache->inserted_num++;
+  }
   return std::make_tuple(trans_node, output_data);
 }
 
@@ -124,6 +173,139 @@ std::vector<framework::shape_t> UpdateInferInfos(Node* node,
   return infershapes;
 }
 
+// the ops computing each channel of their 4D outputs from the same channel of their 4D inputs, the NCHWxc layout
+// propagates through them without layout_transform.
+bool IsLayoutAgnostic(const Node* node) {
+  static const std::unordered_set<std::string> agnostic_ops = {"batchnorm", "pool2d", "concat"};
+  if (agnostic_ops.count(node->op()->name)) {
+    return true;
+  }
+  auto& op_pattern = Operator::GetAttrs<framework::OpPatternKind>("OpPattern");
+  if (!op_pattern.Find(node->op())) {
+    return false;
+  }
+  auto kind = op_pattern[node->op()];
+  return kind == framework::OpPatternKind::kElemWise || kind == framework::OpPatternKind::kBroadcast;
+}
+
+// get the largest factor of n which is not larger than bound
+int GetLargestFactor(int n, int bound) {
+  for (int i = bound; i > 1; i--) {
+    if (n % i == 0) {
+      return i;
+    }
+  }
+  return 1;
+}
+
+// Plan the block factors of the NCHWxc layouts of the 4D vars connected by the layout agnostic ops, e.g. the vars of
+// conv -> batchnorm -> relu -> conv or the ones added in a residual block. The connected vars share one block factor,
+// the oc_bn preferred by the first conv producing them or else the ic_bn of the first conv using them, reduced to
+// divide the channels of all of them, so the convs and the ops among them agree on the layout without
+// layout_transform.
+absl::flat_hash_map<std::string, int> PlanLayoutBlocks(
+    const std::vector<GraphNode*>& store_nodes,
+    const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict,
+    const absl::flat_hash_map<std::string, Type>& type_dict,
+    const common::Target& target) {
+  absl::flat_hash_map<std::string, std::string> parent;
+  std::function<std::string(const std::string&)> find_root = [&](const std::string& id) {
+    auto it = parent.find(id);
+    if (it == parent.end() || it->second == id) {
+      return id;
+    }
+    auto root  = find_root(it->second);
+    parent[id] = root;
+    return root;
+  };
+  auto is_4d = [&](const GraphNode* var) {
+    return shape_dict.count(var->id()) && shape_dict.at(var->id()).size() == 4;
+  };
+  for (auto* graph_node : store_nodes) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!node || !IsLayoutAgnostic(node)) {
+      continue;
+    }
+    auto outlinks = node->outlinks_in_order(true);
+    if (outlinks.empty() || !is_4d(outlinks[0]->sink())) {
+      continue;
+    }
+    auto out_root = find_root(outlinks[0]->sink()->id());
+    for (auto& link : node->inlinks_in_order(true)) {
+      if (is_4d(link->source())) {
+        auto in_root = find_root(link->source()->id());
+        if (in_root != out_root) {
+          parent[in_root] = out_root;
+        }
+      }
+    }
+  }
+
+  // the preferred block factors of the convs, the first ones in topological order take precedence
+  absl::flat_hash_map<std::string, int> producer_blocks;
+  absl::flat_hash_map<std::string, int> consumer_blocks;
+  for (auto* graph_node : store_nodes) {
+    auto* node = graph_node->safe_as<Node>();
+    if (!node || node->op()->name != "conv2d" || !node->attrs.attr_store.count("key") ||
+        !node->attrs.attr_store.count("data_format") ||
+        absl::get<std::string>(node->attrs.attr_store.at("data_format")) != "NCHW") {
+      continue;
+    }
+    auto& inlinks = node->inlinks_in_order(true);
+    CHECK_EQ(inlinks.size(), 2U) << "conv2d should have 2 inputs";
+    auto* input   = inlinks[0]->source();
+    auto* weight  = inlinks[1]->source();
+    auto outlinks = node->outlinks_in_order(true);
+    if (!is_4d(input) || !is_4d(weight) || outlinks.empty()) {
+      continue;
+    }
+    auto& input_shape  = shape_dict.at(input->id());
+    auto& weight_shape = shape_dict.at(weight->id());
+    absl::flat_hash_map<std::string, int> conv2d_factors;
+    pe::GetConv2dFactors(&conv2d_factors,
+                         weight_shape[0],
+                         input_shape[1],
+                         weight_shape[1],
+                         -1,
+                         -1,
+                         type_dict.at(input->id()),
+                         target,
+                         absl::get<std::string>(node->attrs.attr_store.at("key")));
+    producer_blocks.emplace(find_root(outlinks[0]->sink()->id()), conv2d_factors["oc_bn"]);
+    consumer_blocks.emplace(find_root(input->id()), conv2d_factors["ic_bn"]);
+  }
+
+  absl::flat_hash_map<std::string, int> channel_gcds;
+  for (auto& item : shape_dict) {
+    if (item.second.size() != 4) {
+      continue;
+    }
+    auto root = find_root(item.first);
+    int a     = item.second[1];
+    int b     = channel_gcds.count(root) ? channel_gcds[root] : a;
+    while (b) {
+      std::swap(a, b);
+      b %= a;
+    }
+    channel_gcds[root] = a;
+  }
+  absl::flat_hash_map<std::string, int> layout_blocks;
+  for (auto& item : shape_dict) {
+    if (item.second.size() != 4) {
+      continue;
+    }
+    auto root  = find_root(item.first);
+    int prefer = producer_blocks.count(root) ? producer_blocks[root] : 0;
+    if (!prefer && consumer_blocks.count(root)) {
+      prefer = consumer_blocks[root];
+    }
+    if (prefer) {
+      layout_blocks[item.first] = GetLargestFactor(channel_gcds[root], prefer);
+    }
+  }
+  return layout_blocks;
+}
+
 void AlterLayoutPass(Graph* graph) {
   // alterlayout only in X86 for it's specific layout requirements
   if (graph->target_.arch == Target::Arch::X86) {
@@ -171,6 +353,12 @@ void AlterLayoutPass(Graph* graph) {
       }
     }
 
+    // without the plan, each conv takes its own block factors, except the one of an NCHWc input.
+    absl::flat_hash_map<std::string, int> layout_blocks;
+    if (FLAGS_cinn_alter_layout_plan_blocks) {
+      layout_blocks = PlanLayoutBlocks(store_nodes, shape_dict, type_dict, graph->target_);
+    }
+    LayoutTransformCache transform_cache;
     bool has_altered = false;
     for (int i = 0; i < store_nodes.size(); i++) {
       auto node = store_nodes[i]->safe_as<Node>();
@@ -249,6 +437,22 @@ void AlterLayoutPass(Graph* graph) {
           int oc_bn = conv2d_factors["oc_bn"];
           int ic_bn = conv2d_factors["ic_bn"];
           int fc_bn = conv2d_factors["fc_bn"];
+          // take the block factors planned for the vars, so the conv agrees with the ops around it on the layout
+          auto& conv_outlinks = node->outlinks_in_order(true);
+          CHECK(!conv_outlinks.empty()) << "conv2d should have outputs";
+          std::string conv_out_id = conv_outlinks[0]->sink()->id();
+          int planned_ic_bn       = ic_bn;
+          if (input_shape.size() == 5) {
+            planned_ic_bn = input_shape[4];
+          } else if (layout_blocks.count(input_node->id())) {
+            planned_ic_bn = layout_blocks.at(input_node->id());
+          }
+          int planned_oc_bn = layout_blocks.count(conv_out_id) ? layout_blocks.at(conv_out_id) : oc_bn;
+          if (weight_shape.size() == 4 && (planned_ic_bn != ic_bn || planned_oc_bn != oc_bn)) {
+            ic_bn = planned_ic_bn;
+            oc_bn = planned_oc_bn;
+            fc_bn = ic == fc ? ic_bn : GetLargestFactor(fc, oc_bn);
+          }
           VLOG(3) << "oc_bn: " << oc_bn;
           VLOG(3) << "ic_bn: " << ic_bn;
           VLOG(3) << "fc_bn: " << fc_bn;
@@ -268,18 +472,21 @@ void AlterLayoutPass(Graph* graph) {
                                                0,
                                                src_input_layout,
                                                dst_input_layout,
-                                               common::UniqName(node->op()->name + "_input_layout_tranform"));
-            UpdateInferInfos(input_trans_node,
-                             {input_shape},
-                             {input_type},
-                             {src_input_layout},
-                             graph->target_,
-                             op_infershape,
-                             op_inferdtype,
-                             op_inferlayout,
-                             &shape_dict,
-                             &type_dict,
-                             &layout_dict);
+                                               common::UniqName(node->op()->name + "_input_layout_tranform"),
+                                               &transform_cache);
+            if (input_trans_node) {
+              UpdateInferInfos(input_trans_node,
+                               {input_shape},
+                               {input_type},
+                               {src_input_layout},
+                               graph->target_,
+                               op_infershape,
+                               op_inferdtype,
+                               op_inferlayout,
+                               &shape_dict,
+                               &type_dict,
+                               &layout_dict);
+            }
             CHECK(shape_dict.count(output_data->id())) << output_data->id() << " finds no infershape in shape_dict.";
             CHECK(type_dict.count(output_data->id())) << output_data->id() << " finds no infertype in shape_dict.";
             auto trans_out_shapes = shape_dict[output_data->id()];
@@ -309,18 +516,21 @@ void AlterLayoutPass(Graph* graph) {
                                                1,
                                                src_kernel_layout,
                                                dst_kernel_layout,
-                                               common::UniqName(node->op()->name + "_weight_layout_tranform"));
-            UpdateInferInfos(weight_trans_node,
-                             {weight_shape},
-                             {weight_type},
-                             {src_kernel_layout},
-                             graph->target_,
-                             op_infershape,
-                             op_inferdtype,
-                             op_inferlayout,
-                             &shape_dict,
-                             &type_dict,
-                             &layout_dict);
+                                               common::UniqName(node->op()->name + "_weight_layout_tranform"),
+                                               &transform_cache);
+            if (weight_trans_node) {
+              UpdateInferInfos(weight_trans_node,
+                               {weight_shape},
+                               {weight_type},
+                               {src_kernel_layout},
+                               graph->target_,
+                               op_infershape,
+                               op_inferdtype,
+                               op_inferlayout,
+                               &shape_dict,
+                               &type_dict,
+                               &layout_dict);
+            }
             CHECK(shape_dict.count(output_data->id())) << output_data->id() << " finds no infershape in shape_dict.";
             CHECK(type_dict.count(output_data->id())) << output_data->id() << " finds no infertype in shape_dict.";
             auto trans_out_shapes = shape_dict[output_data->id()];
@@ -497,18 +707,21 @@ void AlterLayoutPass(Graph* graph) {
                                                    i,
                                                    src_layout,
                                                    new_input_layouts[i],
-                                                   common::UniqName(source->id() + "_layout_tranform"));
-                UpdateInferInfos(trans_node,
-                                 {input_shapes[i]},
-                                 {input_types[i]},
-                                 {src_layout},
-                                 graph->target_,
-                                 op_infershape,
-                                 op_inferdtype,
-                                 op_inferlayout,
-                                 &shape_dict,
-                                 &type_dict,
-                                 &layout_dict);
+                                                   common::UniqName(source->id() + "_layout_tranform"),
+                                                   &transform_cache);
+                if (trans_node) {
+                  UpdateInferInfos(trans_node,
+                                   {input_shapes[i]},
+                                   {input_types[i]},
+                                   {src_layout},
+                                   graph->target_,
+                                   op_infershape,
+                                   op_inferdtype,
+                                   op_inferlayout,
+                                   &shape_dict,
+                                   &type_dict,
+                                   &layout_dict);
+                }
               } else if (input_shape_size == 5 && new_input_layouts[i].size() == 4) {
                 // NCHWxc -> NCHW
                 // insert layout tranfrom
@@ -527,18 +740,21 @@ void AlterLayoutPass(Graph* graph) {
                                                    i,
                                                    src_layout,
                                                    new_input_layouts[i],
-                                                   common::UniqName(source->id() + "_layout_tranform"));
-                UpdateInferInfos(trans_node,
-                                 {input_shapes[i]},
-                                 {input_types[i]},
-                                 {src_layout},
-                                 graph->target_,
-                                 op_infershape,
-                                 op_inferdtype,
-                                 op_inferlayout,
-                                 &shape_dict,
-                                 &type_dict,
-                                 &layout_dict);
+                                                   common::UniqName(source->id() + "_layout_tranform"),
+                                                   &transform_cache);
+                if (trans_node) {
+                  UpdateInferInfos(trans_node,
+                                   {input_shapes[i]},
+                                   {input_types[i]},
+                                   {src_layout},
+                                   graph->target_,
+                                   op_infershape,
+                                   op_inferdtype,
+                                   op_inferlayout,
+                                   &shape_dict,
+                                   &type_dict,
+                                   &layout_dict);
+                }
               }
             }
           }
@@ -625,6 +841,8 @@ void AlterLayoutPass(Graph* graph) {
           break;
         }
       }
+      VLOG(1) << "AlterLayout inserts " << transform_cache.inserted_num
+              << " layout_transforms on the inputs and reuses them " << transform_cache.reused_num << " times";
       graph->ClearUnlinkedNodes(&shape_dict, &type_dict, &layout_dict);
       graph->attrs["infershape"]  = std::make_shared<absl::any>(shape_dict);
       graph->attrs["inferdtype"]  = std::make_shared<absl::any>(type_dict);
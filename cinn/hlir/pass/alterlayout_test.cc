@@ -23,8 +23,10 @@
 #include "cinn/hlir/framework/pass.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/hlir/pass/use_pass.h"
+#include "cinn/utils/timer.h"
 
 DEFINE_string(model_dir, "", "");
+DECLARE_bool(cinn_alter_layout_plan_blocks);
 
 namespace cinn {
 namespace frontend {
@@ -460,5 +462,134 @@ TEST(conv_mul_conv, conv_mul_conv) {
   runtime_program->Execute();
 }
 
+
+std::vector<float> RunResidualBlock(bool alter_layout, int* layout_transform_num) {
+  Placeholder A(Float(32), {1, 3, 32, 32}, "A");
+  Placeholder B(Float(32), {64, 3, 3, 3}, "B");
+  Placeholder D(Float(32), {64, 3, 3, 3}, "D");
+  Placeholder E(Float(32), {24, 64, 3, 3}, "E");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]        = std::vector<int>({1, 1});
+  attrs["dilation"]      = std::vector<int>({1, 1});
+  attrs["padding"]       = std::vector<int>({1, 1});
+  std::string src_layout = "NCHW";
+  attrs["data_format"]   = src_layout;
+
+  auto c = program.conv2d(A, B, attrs);
+  auto d = program.conv2d(A, D, attrs);
+  auto s = program.elementwise_add(c, d);
+  auto r = program.relu(s);
+  auto e = program.conv2d(r, E, attrs);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B, D, E});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  if (alter_layout) {
+    hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+  }
+  *layout_transform_num = 0;
+  for (auto* graph_node : graph->nodes()) {
+    auto* node = graph_node->safe_as<hlir::framework::Node>();
+    *layout_transform_num += node && node->op()->name == "layout_transform";
+  }
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  for (auto& name : std::vector<std::string>({"A", "B", "D", "E"})) {
+    auto tensor = scope->GetTensor(name);
+    auto* data  = tensor->mutable_data<float>(target);
+    for (size_t j = 0; j < tensor->shape().numel(); j++) {
+      data[j] = static_cast<float>(j % 13) / 13.f - 0.5f;
+    }
+  }
+  runtime_program->Execute();
+
+  auto out         = scope->GetTensor(e->id);
+  const float* res = out->data<float>();
+  return std::vector<float>(res, res + out->shape().numel());
+}
+
+TEST(AlterLayout, residual_block) {
+  int layout_transform_num = 0;
+  auto expected            = RunResidualBlock(false, &layout_transform_num);
+  auto result              = RunResidualBlock(true, &layout_transform_num);
+  // A is transformed once for both convs, the weights 3 times and the output once, the convs agree on the block
+  // factors of the add and relu between them.
+  ASSERT_EQ(layout_transform_num, 5);
+  ASSERT_EQ(expected.size(), result.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(expected[i], result[i], 1e-4);
+  }
+}
+
+// Run a chain of convs of different channels, whose preferred block factors differ, and get the average time of a run.
+std::vector<float> RunConvChain(bool plan_blocks, int repeat, double* run_time) {
+  Placeholder A(Float(32), {1, 32, 28, 28}, "A");
+  Placeholder B(Float(32), {64, 32, 3, 3}, "B");
+  Placeholder C(Float(32), {96, 64, 3, 3}, "C");
+  Placeholder D(Float(32), {48, 96, 3, 3}, "D");
+
+  Program program;
+  absl::flat_hash_map<std::string, Program::attr_t> attrs;
+  attrs["stride"]        = std::vector<int>({1, 1});
+  attrs["dilation"]      = std::vector<int>({1, 1});
+  attrs["padding"]       = std::vector<int>({1, 1});
+  std::string src_layout = "NCHW";
+  attrs["data_format"]   = src_layout;
+
+  auto b = program.relu(program.conv2d(A, B, attrs));
+  auto c = program.relu(program.conv2d(b, C, attrs));
+  auto d = program.conv2d(c, D, attrs);
+
+  Target target = common::DefaultHostTarget();
+  program.SetInputs({A, B, C, D});
+  program.Validate();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  FLAGS_cinn_alter_layout_plan_blocks = plan_blocks;
+  hlir::framework::ApplyPass(graph.get(), "AlterLayout");
+  FLAGS_cinn_alter_layout_plan_blocks = true;
+
+  auto scope = BuildScope(target, graph);
+  hlir::framework::GraphCompiler gc(target, scope, graph);
+  auto runtime_program = gc.Build();
+  for (auto& name : std::vector<std::string>({"A", "B", "C", "D"})) {
+    auto tensor = scope->GetTensor(name);
+    auto* data  = tensor->mutable_data<float>(target);
+    for (size_t j = 0; j < tensor->shape().numel(); j++) {
+      data[j] = static_cast<float>(j % 13) / 13.f - 0.5f;
+    }
+  }
+  // the first run is left out, which compiles the lazy jit components.
+  runtime_program->Execute();
+  utils::Timer timer;
+  timer.Start();
+  for (int i = 0; i < repeat; i++) {
+    runtime_program->Execute();
+  }
+  *run_time = timer.Stop() / repeat;
+
+  auto out         = scope->GetTensor(d->id);
+  const float* res = out->data<float>();
+  return std::vector<float>(res, res + out->shape().numel());
+}
+
+TEST(AlterLayout, benchmark_conv_chain) {
+  double own_blocks_time = 0, planned_blocks_time = 0;
+  auto expected          = RunConvChain(false, 20, &own_blocks_time);
+  auto result            = RunConvChain(true, 20, &planned_blocks_time);
+  LOG(INFO) << "The conv chain takes " << own_blocks_time << " ms with the block factors of each conv, "
+            << planned_blocks_time << " ms with the planned block factors";
+  ASSERT_EQ(expected.size(), result.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(expected[i], result[i], 1e-4);
+  }
+}
+
 }  // namespace frontend
 }  // namespace cinn
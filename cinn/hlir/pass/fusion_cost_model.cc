@@ -0,0 +1,286 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/pass/fusion_cost_model.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+using framework::Node;
+using framework::NodeData;
+
+namespace {
+
+std::mutex& ParamsMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<common::Target::Arch, FusionCostModel::Params>& ParamsMap() {
+  // the defaults are the peaks of a V100 and of a server CPU core with AVX2, calibrate them for other devices.
+  static std::map<common::Target::Arch, FusionCostModel::Params> params = {
+      {common::Target::Arch::NVGPU, {5.0, 7e5, 1e7, 64, 80 * 2048}},
+      {common::Target::Arch::X86, {1.0, 2e4, 5e4, 16, 64}},
+  };
+  return params;
+}
+
+double Occupancy(const GroupCost& cost, const FusionCostModel::Params& params) {
+  return std::min(1.0, static_cast<double>(cost.parallelism) / params.parallel_capacity);
+}
+
+// each spilled value is stored and loaded once.
+double SpillBytes(const GroupCost& cost, const FusionCostModel::Params& params) {
+  return 2.0 * std::max(0, cost.live_values - params.register_budget) * cost.parallelism * cost.element_bytes;
+}
+
+// the constant, the bytes and the flops, by which the kernel time is linear in the launch overhead, the time per byte
+// and the time per flop.
+constexpr int kNumFeatures = 3;
+using Features             = std::array<double, kNumFeatures>;
+
+// Solve the least squares of times = features * solution by the normal equations. The features are normalized by
+// their means, the ones which are all zero are left out and solved as 0.
+bool SolveLeastSquares(const std::vector<Features>& features, const std::vector<double>& times, Features* solution) {
+  Features scales = {};
+  for (auto& feature : features) {
+    for (int c = 0; c < kNumFeatures; ++c) {
+      scales[c] += std::abs(feature[c]);
+    }
+  }
+  std::vector<int> columns;
+  for (int c = 0; c < kNumFeatures; ++c) {
+    if (scales[c] > 0) {
+      scales[c] /= features.size();
+      columns.push_back(c);
+    }
+  }
+
+  int n                                    = columns.size();
+  double m[kNumFeatures][kNumFeatures + 1] = {};
+  for (size_t i = 0; i < features.size(); ++i) {
+    for (int r = 0; r < n; ++r) {
+      double row = features[i][columns[r]] / scales[columns[r]];
+      for (int c = 0; c < n; ++c) {
+        m[r][c] += row * features[i][columns[c]] / scales[columns[c]];
+      }
+      m[r][n] += row * times[i];
+    }
+  }
+  // gaussian elimination with partial pivoting.
+  for (int col = 0; col < n; ++col) {
+    int pivot = col;
+    for (int r = col + 1; r < n; ++r) {
+      if (std::abs(m[r][col]) > std::abs(m[pivot][col])) {
+        pivot = r;
+      }
+    }
+    std::swap(m[col], m[pivot]);
+    if (std::abs(m[col][col]) < 1e-12) {
+      return false;
+    }
+    for (int r = 0; r < n; ++r) {
+      if (r == col) continue;
+      double factor = m[r][col] / m[col][col];
+      for (int c = col; c <= n; ++c) {
+        m[r][c] -= factor * m[col][c];
+      }
+    }
+  }
+  solution->fill(0);
+  for (int r = 0; r < n; ++r) {
+    (*solution)[columns[r]] = m[r][n] / m[r][r] / scales[columns[r]];
+  }
+  return true;
+}
+
+}  // namespace
+
+FusionCostModel::FusionCostModel(const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict,
+                                 const absl::flat_hash_map<std::string, common::Type>& dtype_dict,
+                                 const common::Target& target)
+    : shape_dict_(shape_dict), dtype_dict_(dtype_dict), params_(GetParams(target)) {}
+
+int64_t FusionCostModel::GetNumel(const std::string& node_data_id) const {
+  auto it = shape_dict_.find(node_data_id);
+  if (it == shape_dict_.end()) {
+    return 1;
+  }
+  int64_t numel = 1;
+  for (auto dim : it->second) {
+    numel *= dim;
+  }
+  return numel;
+}
+
+int FusionCostModel::GetElementBytes(const std::string& node_data_id) const {
+  auto it = dtype_dict_.find(node_data_id);
+  if (it == dtype_dict_.end()) {
+    return sizeof(float);
+  }
+  // a bool takes a byte.
+  return std::max(it->second.bits() / 8, 1);
+}
+
+int64_t FusionCostModel::OutputBytes(const std::unordered_set<Node*>& nodes) const {
+  int64_t bytes = 0;
+  for (auto* node : nodes) {
+    for (auto& edge : node->outlinks()) {
+      bytes += GetBytes(edge->sink()->id());
+    }
+  }
+  return bytes;
+}
+
+GroupCost FusionCostModel::Analyze(const std::vector<Node*>& nodes,
+                                   const std::unordered_set<Node*>& output_nodes) const {
+  GroupCost cost;
+  // widened by the tensors the group touches.
+  cost.element_bytes = 1;
+  std::unordered_set<Node*> nodes_set(nodes.begin(), nodes.end());
+  std::unordered_set<NodeData*> inputs;
+  int internal_values = 0;
+  // the nodes of a producer fused into several groups are listed more than once.
+  for (auto* node : nodes_set) {
+    int64_t input_numel = 0;
+    for (auto& edge : node->inlinks()) {
+      auto* node_data = edge->source()->safe_as<NodeData>();
+      CHECK(node_data);
+      input_numel        = std::max(input_numel, GetNumel(node_data->id()));
+      cost.element_bytes = std::max(cost.element_bytes, GetElementBytes(node_data->id()));
+      if (!nodes_set.count(node_data->source_node.get())) {
+        inputs.insert(node_data);
+      }
+    }
+    int64_t output_numel = 0;
+    for (auto& edge : node->outlinks()) {
+      auto* node_data = edge->sink()->safe_as<NodeData>();
+      CHECK(node_data);
+      output_numel       += GetNumel(node_data->id());
+      cost.element_bytes = std::max(cost.element_bytes, GetElementBytes(node_data->id()));
+      int uses           = 0;
+      for (auto& out_edge : node_data->outlinks()) {
+        uses += nodes_set.count(out_edge->sink()->safe_as<Node>());
+      }
+      // the values used by several ops in the group are kept alive.
+      internal_values += uses > 1;
+    }
+    // a reduce computes over its input, an elementwise op over its output.
+    cost.flops += std::max(input_numel, output_numel);
+    cost.parallelism = std::max(cost.parallelism, std::max(input_numel, output_numel));
+  }
+
+  for (auto* node_data : inputs) {
+    cost.input_bytes += GetBytes(node_data->id());
+  }
+  cost.output_bytes = OutputBytes(output_nodes);
+  cost.live_values  = inputs.size() + output_nodes.size() + internal_values;
+  return cost;
+}
+
+GroupCost FusionCostModel::Analyze(const std::shared_ptr<framework::Graph::Group>& group) const {
+  return Analyze(group->CollectNodes(), group->output_nodes);
+}
+
+double FusionCostModel::Latency(const GroupCost& cost, const Params& params) {
+  double memory_us  = (cost.input_bytes + cost.output_bytes) / params.bandwidth;
+  double compute_us = cost.flops / params.throughput;
+  double spill_us   = SpillBytes(cost, params) / params.bandwidth;
+  return params.launch_us + std::max(memory_us, compute_us) / Occupancy(cost, params) + spill_us;
+}
+
+FusionCostModel::Params FusionCostModel::GetParams(const common::Target& target) {
+  std::lock_guard<std::mutex> lock(ParamsMutex());
+  auto& params = ParamsMap();
+  auto it      = params.find(target.arch);
+  return it != params.end() ? it->second : params.at(common::Target::Arch::X86);
+}
+
+void FusionCostModel::SetParams(const common::Target& target, const Params& params) {
+  std::lock_guard<std::mutex> lock(ParamsMutex());
+  ParamsMap()[target.arch] = params;
+}
+
+FusionCostModel::Params FusionCostModel::Calibrate(const std::vector<GroupCost>& costs,
+                                                   const std::vector<double>& times_us,
+                                                   Params params) {
+  CHECK_EQ(costs.size(), times_us.size()) << "Each kernel should have a measured time";
+  CHECK_GE(costs.size(), 3UL) << "At least 3 kernels are needed to calibrate the cost model";
+  // the form of Latency is linear in the launch overhead, the time per byte and the time per flop once it is known
+  // whether each kernel is bound by the memory or by the compute, the occupancy and the spills only depend on the
+  // parameters kept. The bounds are taken from the fit of the sum of the memory and the compute time first, then from
+  // the previous fit until they don't change, and the fit closest to the measured times is kept.
+  constexpr int kMaxIterations = 16;
+  std::vector<Features> features(costs.size());
+  std::vector<bool> memory_bound(costs.size());
+  Params best_params   = params;
+  double best_residual = std::numeric_limits<double>::infinity();
+  for (int iter = 0; iter < kMaxIterations; ++iter) {
+    for (size_t i = 0; i < costs.size(); ++i) {
+      double occupancy = Occupancy(costs[i], params);
+      double bytes     = costs[i].input_bytes + costs[i].output_bytes;
+      bool memory      = iter == 0 || memory_bound[i];
+      bool compute     = iter == 0 || !memory_bound[i];
+      features[i][0]   = 1.0;
+      features[i][1]   = (memory ? bytes / occupancy : 0.0) + SpillBytes(costs[i], params);
+      features[i][2]   = compute ? costs[i].flops / occupancy : 0.0;
+    }
+    Features solution;
+    if (!SolveLeastSquares(features, times_us, &solution)) {
+      LOG(WARNING) << "The measured kernels are degenerate, the cost model is not calibrated";
+      break;
+    }
+    Params fitted = params;
+    if (solution[0] > 0) fitted.launch_us = solution[0];
+    if (solution[1] > 0) fitted.bandwidth = 1.0 / solution[1];
+    if (solution[2] > 0) fitted.throughput = 1.0 / solution[2];
+
+    double residual = 0;
+    bool changed    = false;
+    for (size_t i = 0; i < costs.size(); ++i) {
+      double error = Latency(costs[i], fitted) - times_us[i];
+      residual     += error * error;
+
+      double memory_us  = (costs[i].input_bytes + costs[i].output_bytes) / fitted.bandwidth;
+      double compute_us = costs[i].flops / fitted.throughput;
+      if (iter == 0 || (memory_us >= compute_us) != memory_bound[i]) {
+        changed = true;
+      }
+      memory_bound[i] = memory_us >= compute_us;
+    }
+    if (residual < best_residual) {
+      best_residual = residual;
+      best_params   = fitted;
+    }
+    if (!changed) {
+      break;
+    }
+  }
+  params = best_params;
+  VLOG(3) << "Calibrated the fusion cost model with " << costs.size() << " kernels, launch " << params.launch_us
+          << " us, bandwidth " << params.bandwidth << " bytes/us, throughput " << params.throughput << " flops/us";
+  return params;
+}
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
@@ -0,0 +1,129 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/hlir/framework/graph.h"
+#include "cinn/hlir/framework/node.h"
+
+namespace cinn {
+namespace hlir {
+namespace pass {
+
+/**
+ * The features of a kernel generated for a fusion group, the tensors are counted by their dtypes.
+ */
+struct GroupCost {
+  // bytes of the tensors read from outside the group.
+  int64_t input_bytes{0};
+  // bytes of the tensors written by the group.
+  int64_t output_bytes{0};
+  // elements computed by the ops of the group, the ops recomputed in several groups are counted in each of them.
+  int64_t flops{0};
+  // the number of elements of the largest tensor the group touches, which is the parallelism of the kernel.
+  int64_t parallelism{1};
+  // the tensors live in a thread at the same time, that is the inputs, the outputs and the internal nodes.
+  int live_values{0};
+  // bytes of the widest element the group touches, by which the spilled values are counted.
+  int element_bytes{4};
+};
+
+/**
+ * \brief An analytical model estimating the latency of the kernels of fusion groups. FusionMergePass uses it to decide
+ * whether fusing a candidate, such as a producer recomputed in several consumers, reduces the end-to-end latency.
+ *
+ * The latency of a kernel is the launch overhead plus the time to move its bytes or compute its flops, whichever is
+ * longer, scaled by the occupancy of the device, and the live values beyond the register budget are spilled.
+ */
+class FusionCostModel {
+ public:
+  struct Params {
+    // the overhead to launch a kernel, in us.
+    double launch_us;
+    // bytes moved per us.
+    double bandwidth;
+    // elements computed per us.
+    double throughput;
+    // the values a thread keeps in registers before spilling.
+    int register_budget;
+    // the parallelism to occupy the device.
+    int64_t parallel_capacity;
+  };
+
+  FusionCostModel(const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict,
+                  const absl::flat_hash_map<std::string, common::Type>& dtype_dict,
+                  const common::Target& target);
+
+  //! Get the features of the kernel computing \p nodes, whose results in \p output_nodes are written back.
+  GroupCost Analyze(const std::vector<framework::Node*>& nodes,
+                    const std::unordered_set<framework::Node*>& output_nodes) const;
+
+  GroupCost Analyze(const std::shared_ptr<framework::Graph::Group>& group) const;
+
+  //! Estimate the latency of a kernel in us.
+  double Latency(const GroupCost& cost) const { return Latency(cost, params_); }
+
+  //! Estimate the latency of a kernel in us with \p params.
+  static double Latency(const GroupCost& cost, const Params& params);
+
+  double Latency(const std::shared_ptr<framework::Graph::Group>& group) const { return Latency(Analyze(group)); }
+
+  //! Get the bytes of the results of \p nodes.
+  int64_t OutputBytes(const std::unordered_set<framework::Node*>& nodes) const;
+
+  //! Estimate the time to move \p bytes in us.
+  double MemoryLatency(int64_t bytes) const { return bytes / params_.bandwidth; }
+
+  //! Get the parameters of the model used for \p target.
+  static Params GetParams(const common::Target& target);
+
+  //! Set the parameters of the model used for \p target, e.g. the ones calibrated by Calibrate.
+  static void SetParams(const common::Target& target, const Params& params);
+
+  /**
+   * \brief Fit the launch overhead, the bandwidth and the throughput of \p params by least squares to the kernel times
+   * measured on the device, in the form Latency estimates them. The register budget and the parallel capacity are
+   * kept.
+   * @param costs The features of the measured kernels.
+   * @param times_us The measured times of the kernels in us.
+   * @param params The parameters to start from, the fitted values which are not positive are dropped.
+   * @return The calibrated parameters.
+   */
+  static Params Calibrate(const std::vector<GroupCost>& costs, const std::vector<double>& times_us, Params params);
+
+ private:
+  int64_t GetNumel(const std::string& node_data_id) const;
+
+  int GetElementBytes(const std::string& node_data_id) const;
+
+  int64_t GetBytes(const std::string& node_data_id) const {
+    return GetNumel(node_data_id) * GetElementBytes(node_data_id);
+  }
+
+  const absl::flat_hash_map<std::string, framework::shape_t>& shape_dict_;
+  const absl::flat_hash_map<std::string, common::Type>& dtype_dict_;
+  Params params_;
+};
+
+}  // namespace pass
+}  // namespace hlir
+}  // namespace cinn
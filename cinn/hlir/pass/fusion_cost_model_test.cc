@@ -0,0 +1,83 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/hlir/pass/fusion_cost_model.h"
+
+#include "cinn/frontend/decomposer/test_helper.h"
+
+namespace cinn {
+namespace frontend {
+
+using hlir::pass::FusionCostModel;
+using hlir::pass::GroupCost;
+
+// The kernels are bound by the compute or by the memory, some of them don't occupy the device and some spill.
+TEST(FusionCostModel, Calibrate) {
+  FusionCostModel::Params expected = {3.0, 5e5, 2e6, 64, 1024};
+  std::vector<GroupCost> costs;
+  std::vector<double> times_us;
+  for (int i = 1; i <= 8; ++i) {
+    GroupCost cost;
+    cost.input_bytes  = i * 1024 * 1024;
+    cost.output_bytes = (i % 3) * 512 * 1024;
+    cost.flops        = (9 - i) * (i % 2 + 1) * 4 * 1024 * 1024;
+    cost.parallelism  = i * 256;
+    cost.live_values  = 60 + i;
+    costs.push_back(cost);
+    times_us.push_back(FusionCostModel::Latency(cost, expected));
+  }
+
+  auto params = FusionCostModel::Calibrate(costs, times_us, {1.0, 1.0, 1.0, 64, 1024});
+  ASSERT_NEAR(params.launch_us, expected.launch_us, 1e-3 * expected.launch_us);
+  ASSERT_NEAR(params.bandwidth, expected.bandwidth, 1e-3 * expected.bandwidth);
+  ASSERT_NEAR(params.throughput, expected.throughput, 1e-3 * expected.throughput);
+}
+
+TEST(FusionCostModel, Avoid_Expensive_Recompute) {
+  int h = 256, w = 256;
+  NetBuilder net_builder("Avoid_Expensive_Recompute");
+  Variable X;
+  // create model
+  {
+    auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
+    auto B = net_builder.CreateInput(Float(32), {h, w}, "B");
+    auto C = net_builder.CreateInput(Float(32), {h, w}, "C");
+    auto D = net_builder.CreateInput(Float(32), {h, w}, "D");
+    X      = net_builder.ElementwiseAdd(net_builder.ElementwiseAdd(net_builder.ElementwiseAdd(A, B), C), D);
+    auto E = net_builder.Reduce(X, ReduceKind::kSum, {0});
+    auto F = net_builder.Reduce(X, ReduceKind::kSum, {1});
+  }
+
+  auto program = net_builder.Build();
+  auto target  = GetTarget();
+  RunDecomposer(&program, target);
+
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+
+  // reading the 4 inputs again costs more than reading X, so X is computed once rather than in each reduce.
+  int computed_times = 0;
+  for (auto& group : graph->fusion_groups) {
+    for (auto* node : group->CollectNodes()) {
+      for (auto& edge : node->outlinks()) {
+        computed_times += edge->sink()->id() == X->id;
+      }
+    }
+  }
+  ASSERT_EQ(computed_times, 1);
+}
+
+}  // namespace frontend
+}  // namespace cinn
@@ -31,16 +31,18 @@ using namespace framework;
 
 class FusionHelperBase {
  public:
-  FusionHelperBase(const absl::flat_hash_map<std::string, shape_t>& shape_dict, const common::Target target)
-      : shape_dict_(shape_dict), target_(target) {
-    // get op pattern dict
-    op_pattern_dict_ = &framework::Operator::GetAttrs<OpPatternKind>("OpPattern");
+  explicit FusionHelperBase(Graph* graph)
+      : shape_dict_(framework::GetAnalysis<absl::flat_hash_map<std::string, shape_t>>(graph, "shape_dict")),
+        target_(graph->target_) {
+    // get op pattern kinds
+    op_pattern_kinds_ = framework::GetAnalysis<framework::OpPatternKindMap>(graph, "op_pattern_kinds");
   }
 
  protected:
   OpPatternKind GetOpKind(const framework::Node* node) {
-    CHECK(op_pattern_dict_->Find(node->op())) << "Don't find the pattern of op : " << node->id();
-    auto kind = op_pattern_dict_[0][node->op()];
+    auto iter = op_pattern_kinds_->find(node);
+    CHECK(iter != op_pattern_kinds_->end()) << "Don't find the pattern of op : " << node->id();
+    auto kind = iter->second;
 
     CHECK_NE(kind, framework::kTuple) << "kTuple is not support now!";
     if (kind == framework::kBroadcast) {
@@ -62,8 +64,8 @@ class FusionHelperBase {
   shape_t GetNodeDataShape(const Node* node) {
     auto node_data = (*node->outlinks().begin())->sink()->safe_as<NodeData>();
     CHECK(node_data);
-    CHECK(shape_dict_.count(node_data->id())) << "Can't find " << node_data->id() << " 's shape!";
-    return shape_dict_.at(node_data->id());
+    CHECK(shape_dict_->count(node_data->id())) << "Can't find " << node_data->id() << " 's shape!";
+    return shape_dict_->at(node_data->id());
   }
 
   std::vector<NodeData*> GetProducerNodeData(const Node* node) {
@@ -98,9 +100,9 @@ class FusionHelperBase {
   // target
   common::Target target_;
   // shape dict
-  const absl::flat_hash_map<std::string, shape_t>& shape_dict_;
-  // op pattern dict
-  const framework::OpValueType<OpPatternKind>* op_pattern_dict_;
+  std::shared_ptr<const absl::flat_hash_map<std::string, shape_t>> shape_dict_;
+  // op pattern kinds
+  std::shared_ptr<const framework::OpPatternKindMap> op_pattern_kinds_;
 };
 
 }  // namespace pass
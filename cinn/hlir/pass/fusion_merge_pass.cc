@@ -12,10 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <gflags/gflags.h>
+
 #include <queue>
 
+#include "cinn/common/csr_graph.h"
+#include "cinn/hlir/pass/fusion_cost_model.h"
 #include "cinn/hlir/pass/fusion_helper_base.h"
 
+DECLARE_bool(cinn_fusion_cost_model_single_consumer);
+
 namespace cinn {
 namespace hlir {
 namespace pass {
@@ -38,6 +44,9 @@ using GroupList = std::vector<GroupPtr>;
 using ShapeDict         = absl::flat_hash_map<std::string, shape_t>;
 using ConditionFunction = std::function<bool(const GroupPtr&, const GroupPtr&)>;
 
+// the fusions predicted to be slower within the tolerance are still applied, which saves the kernels.
+constexpr double kFusionTolerance = 0.01;
+
 // Op Fusion Pass which performs Ops fusion, Ops are fused
 // "vertically", meaning producing Ops are fused into their consumers
 // with the intent that the loops which compute their values will be fused in
@@ -45,7 +54,10 @@ using ConditionFunction = std::function<bool(const GroupPtr&, const GroupPtr&)>;
 class FusionMergePassHelper : public FusionHelperBase {
  public:
   FusionMergePassHelper(Graph* graph)
-      : FusionHelperBase(graph->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape"), graph->target_) {
+      : FusionHelperBase(graph),
+        dtype_dict_(framework::GetAnalysis<absl::flat_hash_map<std::string, common::Type>>(graph, "dtype_dict")),
+        cost_model_(*shape_dict_, *dtype_dict_, target_),
+        csr_graph_(framework::GetAnalysis<common::CsrGraph>(graph, "csr_graph")) {
     fusion_groups_ = graph->fusion_groups;
     InitInputToConsumers();
     InitFusionRelation();
@@ -85,7 +97,6 @@ class FusionMergePassHelper : public FusionHelperBase {
 
   void UpdateFusionGroup() {
     GroupList fusion_groups;
-    std::unordered_set<GroupPtr, Hasher, Comparator> fusion_groups_set;
     // update fusion_groups_
     for (auto& group : fusion_groups_) {
       if (!group->belong_groups.size()) {
@@ -94,39 +105,49 @@ class FusionMergePassHelper : public FusionHelperBase {
           VLOG(3) << "  Fused Sub-Group -> " << sub_group->group_id;
         }
         fusion_groups.push_back(group);
-        fusion_groups_set.insert(group);
       }
     }
-    // keep group in order
-    fusion_groups_.clear();
-    while (!fusion_groups_set.empty()) {
-      bool is_ring = true;
-      for (int idx = 0; idx < fusion_groups.size(); ++idx) {
-        auto& group = fusion_groups[idx];
-        if (!group.get()) {
-          continue;
-        }
-
-        bool exist = false;
-        for (auto& producer : group->producer_groups) {
-          if (fusion_groups_set.count(producer)) {
-            exist = true;
-            break;
-          }
+    // keep group in order, the ready groups are taken by the first of their nodes in the topological order of the
+    // graph, which is the id of the node in the CSR snapshot.
+    std::unordered_map<GroupPtr, int, Hasher, Comparator> group_index;
+    for (int idx = 0; idx < fusion_groups.size(); ++idx) {
+      group_index[fusion_groups[idx]] = idx;
+    }
+    std::vector<int> first_node_ids(fusion_groups.size(), csr_graph_->num_nodes());
+    std::vector<int> in_degrees(fusion_groups.size(), 0);
+    std::vector<std::vector<int>> consumers(fusion_groups.size());
+    for (int idx = 0; idx < fusion_groups.size(); ++idx) {
+      for (auto node : fusion_groups[idx]->CollectNodes()) {
+        first_node_ids[idx] = std::min(first_node_ids[idx], csr_graph_->id(node));
+      }
+      for (auto& producer : fusion_groups[idx]->producer_groups) {
+        auto iter = group_index.find(producer);
+        if (iter != group_index.end()) {
+          consumers[iter->second].push_back(idx);
+          ++in_degrees[idx];
         }
+      }
+    }
 
-        if (!exist) {
-          fusion_groups_.push_back(group);
-          fusion_groups_set.erase(group);
-          group.reset();
-          is_ring = false;
-          continue;
-        }
+    using ReadyGroup = std::pair<int, int>;
+    std::priority_queue<ReadyGroup, std::vector<ReadyGroup>, std::greater<ReadyGroup>> ready_groups;
+    for (int idx = 0; idx < fusion_groups.size(); ++idx) {
+      if (!in_degrees[idx]) {
+        ready_groups.emplace(first_node_ids[idx], idx);
       }
-      if (is_ring) {
-        LOG(FATAL) << "Exists Ring, Please Check!";
+    }
+    fusion_groups_.clear();
+    while (!ready_groups.empty()) {
+      int idx = ready_groups.top().second;
+      ready_groups.pop();
+      fusion_groups_.push_back(fusion_groups[idx]);
+      for (int consumer : consumers[idx]) {
+        if (!--in_degrees[consumer]) {
+          ready_groups.emplace(first_node_ids[consumer], consumer);
+        }
       }
     }
+    CHECK_EQ(fusion_groups_.size(), fusion_groups.size()) << "Exists Ring, Please Check!";
   }
 
   bool DoHorizontalFusion(GroupPtr& producer, std::unordered_set<GroupPtr, Hasher, Comparator>& consumers) {
@@ -168,6 +189,10 @@ class FusionMergePassHelper : public FusionHelperBase {
           continue;
         }
 
+        if (!HorizontalFusionReducesLatency(groups, consumer)) {
+          continue;
+        }
+
         groups.push_back(consumer);
         fusionable = true;
         break;
@@ -318,7 +343,9 @@ class FusionMergePassHelper : public FusionHelperBase {
       fusionable_consumers.insert(consumer);
     }
 
-    if (fusionable_consumers.size() > 1) {
+    // a producer is fused into its only consumer unless the cost model is asked to check it too.
+    if (fusionable_consumers.size() > 1 ||
+        (fusionable_consumers.size() == 1 && FLAGS_cinn_fusion_cost_model_single_consumer)) {
       RecomputeWithCostModel(producer, fusionable_consumers);
     }
 
@@ -492,14 +519,95 @@ class FusionMergePassHelper : public FusionHelperBase {
     }
   }
 
+  // Horizontal fusion reads the shared inputs once and saves the launches, but the fused kernel keeps more values
+  // alive in a thread.
+  bool HorizontalFusionReducesLatency(const GroupList& groups, const GroupPtr& consumer) {
+    std::vector<Node*> nodes;
+    std::unordered_set<Node*> output_nodes;
+    for (auto& group : groups) {
+      auto group_nodes = group->CollectNodes();
+      nodes.insert(nodes.end(), group_nodes.begin(), group_nodes.end());
+      output_nodes.insert(group->output_nodes.begin(), group->output_nodes.end());
+    }
+    double unfused_latency = cost_model_.Latency(cost_model_.Analyze(nodes, output_nodes));
+    unfused_latency += cost_model_.Latency(consumer);
+
+    auto consumer_nodes = consumer->CollectNodes();
+    nodes.insert(nodes.end(), consumer_nodes.begin(), consumer_nodes.end());
+    output_nodes.insert(consumer->output_nodes.begin(), consumer->output_nodes.end());
+    double fused_latency = cost_model_.Latency(cost_model_.Analyze(nodes, output_nodes));
+    VLOG(3) << "Horizontal fusion of " << consumer->group_id << " takes " << fused_latency << " us, unfused takes "
+            << unfused_latency << " us";
+    return fused_latency <= unfused_latency * (1 + kFusionTolerance);
+  }
+
+  // The latency of the kernel fusing the producer into the consumer, where the producer is recomputed.
+  double VerticalFusionLatency(const GroupPtr& producer, const GroupPtr& consumer) {
+    auto nodes          = producer->CollectNodes();
+    auto consumer_nodes = consumer->CollectNodes();
+    nodes.insert(nodes.end(), consumer_nodes.begin(), consumer_nodes.end());
+    return cost_model_.Latency(cost_model_.Analyze(nodes, consumer->output_nodes));
+  }
+
+  // Choose the consumers to fuse the producer into, with which the producer and its consumers take the least time.
+  // The producer is recomputed in each fused consumer, and its outputs are still written when they are used by the
+  // consumers not fused or fetched.
   void RecomputeWithCostModel(const GroupPtr& producer,
                               std::unordered_set<GroupPtr, Hasher, Comparator>& fusionable_consumers) {
+    std::vector<std::pair<double, GroupPtr>> gains;
+    for (auto& consumer : fusionable_consumers) {
+      // the latency saved by fusing the producer into the consumer.
+      gains.emplace_back(cost_model_.Latency(consumer) - VerticalFusionLatency(producer, consumer), consumer);
+    }
+    std::sort(gains.begin(), gains.end(), [](const auto& first, const auto& second) {
+      return first.first > second.first;
+    });
+
+    // the reduce is too expensive to recompute, it is fused into the consumer of the most gain only, even if the gain
+    // is negative.
     if (producer->op_pattern_kind == framework::kCommReduce) {
-      auto consumer = *fusionable_consumers.begin();
       fusionable_consumers.clear();
-      fusionable_consumers.insert(consumer);
+      fusionable_consumers.insert(gains.front().second);
       return;
     }
+
+    // fuse the producer into the consumers of the most gains.
+    double unfused_latency = cost_model_.Latency(producer);
+    double best_latency    = unfused_latency;
+    int best_count         = 0;
+    std::unordered_set<GroupPtr, Hasher, Comparator> fused_consumers;
+    for (int count = 1; count <= gains.size(); ++count) {
+      fused_consumers.insert(gains[count - 1].second);
+      std::unordered_set<Node*> written_nodes;
+      for (auto* node : producer->output_nodes) {
+        bool used_by_fused = false, used_by_others = false;
+        for (auto& consumer : producer->consumer_groups) {
+          if (consumer->input_nodes.count(node)) {
+            used_by_fused  |= fused_consumers.count(consumer) > 0;
+            used_by_others |= fused_consumers.count(consumer) == 0;
+          }
+        }
+        if (used_by_others || !used_by_fused) {
+          written_nodes.insert(node);
+        }
+      }
+      // the latency relative to the consumers without fusion.
+      double latency = cost_model_.MemoryLatency(cost_model_.OutputBytes(written_nodes));
+      for (int idx = 0; idx < count; ++idx) {
+        latency -= gains[idx].first;
+      }
+      VLOG(3) << "Fuse producer " << producer->group_id << " into " << count << " consumers takes " << latency
+              << " us more than the consumers, unfused takes " << unfused_latency << " us";
+      if (latency <= best_latency + unfused_latency * kFusionTolerance) {
+        best_latency = std::min(best_latency, latency);
+        best_count   = count;
+      }
+    }
+
+    fusionable_consumers.clear();
+    for (int idx = 0; idx < best_count; ++idx) {
+      fusionable_consumers.insert(gains[idx].second);
+    }
   }
 
   bool IsDepency(const GroupPtr& producer_g,
@@ -627,7 +735,7 @@ class FusionMergePassHelper : public FusionHelperBase {
         }
       }
       CHECK(reducer) << "Don't find reduce op in group " << second->group_id;
-      auto input_shape = shape_dict_.at(reducer->inlinks_in_order()[0]->source()->id());
+      auto input_shape = shape_dict_->at(reducer->inlinks_in_order()[0]->source()->id());
       auto reduce_axes = absl::get<std::vector<int>>(reducer->attrs.attr_store.at("dim"));
 
       int max_num_threads = target_.max_num_threads();
@@ -677,7 +785,7 @@ class FusionMergePassHelper : public FusionHelperBase {
       }
       CHECK(reducer) << "Don't find reduce op in group " << second->group_id;
 
-      auto input_shape  = shape_dict_.at(reducer->inlinks_in_order()[0]->source()->id());
+      auto input_shape  = shape_dict_->at(reducer->inlinks_in_order()[0]->source()->id());
       auto reduce_axes  = absl::get<std::vector<int>>(reducer->attrs.attr_store.at("dim"));
       auto output_shape = this->GetNodeDataShape(*first->master_nodes.begin());
       if (input_shape == output_shape) {
@@ -714,11 +822,11 @@ class FusionMergePassHelper : public FusionHelperBase {
       CHECK(reducer_1) << "Don't find reduce op in group " << second->group_id;
 
       // check reduce has same input shape and output shape
-      auto reducer_0_input_shape  = shape_dict_.at(reducer_0->inlinks_in_order()[0]->source()->id());
-      auto reducer_0_output_shape = shape_dict_.at(reducer_0->outlinks_in_order()[0]->sink()->id());
+      auto reducer_0_input_shape  = shape_dict_->at(reducer_0->inlinks_in_order()[0]->source()->id());
+      auto reducer_0_output_shape = shape_dict_->at(reducer_0->outlinks_in_order()[0]->sink()->id());
 
-      auto reducer_1_input_shape  = shape_dict_.at(reducer_1->inlinks_in_order()[0]->source()->id());
-      auto reducer_1_output_shape = shape_dict_.at(reducer_1->outlinks_in_order()[0]->sink()->id());
+      auto reducer_1_input_shape  = shape_dict_->at(reducer_1->inlinks_in_order()[0]->source()->id());
+      auto reducer_1_output_shape = shape_dict_->at(reducer_1->outlinks_in_order()[0]->sink()->id());
 
       auto reducer_0_reduce_dim = absl::get<std::vector<int>>(reducer_0->attrs.attr_store.at("dim"));
       auto reducer_1_reduce_dim = absl::get<std::vector<int>>(reducer_1->attrs.attr_store.at("dim"));
@@ -842,6 +950,10 @@ class FusionMergePassHelper : public FusionHelperBase {
     std::unordered_map<framework::OpPatternKind, ConditionFunction> horizontal_relation;
   };
   std::unordered_map<framework::OpPatternKind, Relation> fusion_relation_map_;
+  // the cost model refers to the dtypes, so they are kept alive by the helper.
+  std::shared_ptr<const absl::flat_hash_map<std::string, common::Type>> dtype_dict_;
+  FusionCostModel cost_model_;
+  std::shared_ptr<const common::CsrGraph> csr_graph_;
 };  // namespace pass
 
 void FusionMergePassInternal(Graph* graph) {
@@ -865,6 +977,15 @@ CINN_REGISTER_HELPER(FusionMergePass) {
           "Fusion Merge Pass which performs Fusion-Ops fusion, Producer Fusion-Ops are fused into Consumer Fusion-Ops "
           "with certain conditions.")
       .set_change_structure(false)
+      .require_analysis("csr_graph")
+      .require_analysis("shape_dict")
+      .require_analysis("dtype_dict")
+      .require_analysis("op_pattern_kinds")
+      .preserve_analysis("csr_graph")
+      .preserve_analysis("shape_dict")
+      .preserve_analysis("dtype_dict")
+      .preserve_analysis("consumer_map")
+      .preserve_analysis("op_pattern_kinds")
       .set_body(cinn::hlir::pass::FusionMergePassInternal);
 
   return true;
@@ -12,7 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+
+#include "cinn/common/csr_graph.h"
 #include "cinn/frontend/decomposer/test_helper.h"
+#include "cinn/utils/timer.h"
 
 namespace cinn {
 namespace frontend {
@@ -407,6 +413,7 @@ TEST(FusionMergePass, Reduce_Test_2) {
 TEST(FusionMergePass, Reduce_Test_3) {
   int h = 32, w = 32;
   NetBuilder net_builder("Reduce_Test_3");
+  std::unordered_set<std::string> consumer_ids;
   // create model
   {
     auto A = net_builder.CreateInput(Float(32), {h, w}, "A");
@@ -417,6 +424,8 @@ TEST(FusionMergePass, Reduce_Test_3) {
     auto F = net_builder.Reduce(E, ReduceKind::kSum, {0});
     auto G = net_builder.ElementwiseAdd(C, F);
     auto H = net_builder.ElementwiseAdd(D, F);
+    // the consumers of the reduce.
+    consumer_ids = {G->id, H->id};
   }
 
   auto program = net_builder.Build();
@@ -428,6 +437,23 @@ TEST(FusionMergePass, Reduce_Test_3) {
   CHECK_EQ(graph->fusion_groups.size(), 4);
   hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
   // CHECK_EQ(graph->fusion_groups.size(), 3);
+  // the reduce is not recomputed, it is fused into one of its consumers.
+  int reduce_groups = 0;
+  for (auto& group : graph->fusion_groups) {
+    auto nodes      = group->CollectNodes();
+    bool has_reduce = std::any_of(nodes.begin(), nodes.end(), [](hlir::framework::Node* node) {
+      return node->op()->name == "reduce_sum";
+    });
+    if (!has_reduce) {
+      continue;
+    }
+    reduce_groups++;
+    bool has_consumer = std::any_of(nodes.begin(), nodes.end(), [&](hlir::framework::Node* node) {
+      return consumer_ids.count(node->outlinks_in_order().front()->sink()->id()) > 0;
+    });
+    CHECK(has_consumer);
+  }
+  CHECK_EQ(reduce_groups, 1);
 }
 
 TEST(FusionMergePass, Reduce_Test_4) {
@@ -481,5 +507,53 @@ TEST(FusionMergePass, Reduce_Test_5) {
   CHECK_EQ(graph->fusion_groups.size(), 1);
 }
 
+// Time the pass pipeline on the graph of a deep stack of transformer-like layers.
+TEST(FusionMergePass, Benchmark_Deep_Graph) {
+  int h = 32, w = 32, num_layers = 500;
+  NetBuilder net_builder("Benchmark_Deep_Graph");
+  // create model
+  {
+    auto X = net_builder.CreateInput(Float(32), {h, w}, "X");
+    for (int i = 0; i < num_layers; i++) {
+      auto W = net_builder.CreateInput(Float(32), {w, w}, "W_" + std::to_string(i));
+      auto Y = net_builder.Matmul(X, W);
+      auto Z = net_builder.ElementwiseAdd(Y, X);
+      auto R = net_builder.Relu(Z);
+      net_builder.Reduce(R, ReduceKind::kSum, {1});
+      X = R;
+    }
+  }
+
+  auto program = net_builder.Build();
+  auto target  = GetTarget();
+  RunDecomposer(&program, target);
+
+  utils::Timer timer;
+  timer.Start();
+  auto graph = std::make_shared<hlir::framework::Graph>(program, target);
+  LOG(INFO) << "Building the graph of " << graph->num_nodes() << " nodes takes " << timer.Stop() << " ms";
+
+  // the topological order the passes used to sort for themselves, against the CSR snapshot they share now.
+  timer.Start();
+  auto topo_order        = std::get<0>(graph->topological_order());
+  double topo_order_time = timer.Stop();
+  timer.Start();
+  common::CsrGraph csr_graph(*graph);
+  double csr_graph_time = timer.Stop();
+  ASSERT_EQ(csr_graph.topological_order(), topo_order);
+  LOG(INFO) << "Graph::topological_order takes " << topo_order_time << " ms, building the CsrGraph takes "
+            << csr_graph_time << " ms";
+
+  timer.Start();
+  hlir::framework::ApplyPass(graph.get(), "InferShape");
+  LOG(INFO) << "InferShape takes " << timer.Stop() << " ms";
+  timer.Start();
+  hlir::framework::ApplyPass(graph.get(), "OpFusionPass");
+  LOG(INFO) << "OpFusionPass takes " << timer.Stop() << " ms";
+  timer.Start();
+  hlir::framework::ApplyPass(graph.get(), "FusionMergePass");
+  LOG(INFO) << "FusionMergePass takes " << timer.Stop() << " ms";
+}
+
 }  // namespace frontend
 }  // namespace cinn
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "cinn/common/csr_graph.h"
 #include "cinn/hlir/framework/graph.h"
 #include "cinn/hlir/framework/node.h"
 #include "cinn/hlir/framework/op.h"
@@ -33,7 +34,6 @@ using framework::Operator;
 void InferShapePass(Graph* graph) {
   auto& shape_dict    = graph->GetMutableAttrs<absl::flat_hash_map<std::string, framework::shape_t>>("infershape");
   auto& dtype_dict    = graph->GetMutableAttrs<absl::flat_hash_map<std::string, Type>>("inferdtype");
-  auto store_nodes    = std::get<0>(graph->topological_order());
   auto& op_infershape = Operator::GetAttrs<std::function<std::vector<framework::shape_t>(
       const std::vector<framework::shape_t>&, const framework::AttrMapType&)>>("infershape");
   auto& op_inferdtype =
@@ -46,12 +46,14 @@ void InferShapePass(Graph* graph) {
     return numel;
   };
 
-  for (auto& n : store_nodes) {
-    auto node = n->safe_as<Node>();
+  // the shapes are inferred in one pass over the snapshot, without sorting the links of each node.
+  auto csr_graph = framework::GetAnalysis<common::CsrGraph>(graph, "csr_graph");
+  for (int id = 0; id < csr_graph->num_nodes(); id++) {
+    auto node = csr_graph->node(id)->safe_as<Node>();
     if (node) {
       std::vector<framework::shape_t> inputs_shape;
       std::vector<Type> inputs_dtype;
-      for (auto& in_edge : node->inlinks_in_order()) {
+      for (auto* in_edge : csr_graph->in_edges(id)) {
         auto* source_node = in_edge->source()->safe_as<NodeData>();
         CHECK(source_node);
         CHECK(shape_dict.count(source_node->id())) << "No shape for " << source_node->id();
@@ -69,17 +71,17 @@ void InferShapePass(Graph* graph) {
       auto out_dtype =
           op_inferdtype[node->safe_as<Node>()->op()](inputs_dtype, node->safe_as<Node>()->attrs.attr_store);
 
-      CHECK_GE(node->outlinks_in_order().size(), out_shape.size())
-          << "The output number of node " << node->id() << " is " << node->outlinks_in_order().size()
+      CHECK_GE(csr_graph->out_edges(id).size(), out_shape.size())
+          << "The output number of node " << node->id() << " is " << csr_graph->out_edges(id).size()
           << " , which is smaller than the output shape size " << out_shape.size() << " . And the op type is "
           << node->safe_as<Node>()->op()->name;
-      CHECK_GE(node->outlinks_in_order().size(), out_dtype.size())
-          << "The output number of node " << node->id() << " is " << node->outlinks_in_order().size()
+      CHECK_GE(csr_graph->out_edges(id).size(), out_dtype.size())
+          << "The output number of node " << node->id() << " is " << csr_graph->out_edges(id).size()
           << " , which is smaller than the output dtype size " << out_dtype.size() << " . And the op type is "
           << node->safe_as<Node>()->op()->name;
 
       int counter = 0;
-      for (auto& out_edge : node->outlinks_in_order()) {
+      for (auto* out_edge : csr_graph->out_edges(id)) {
         auto* sink_node = out_edge->sink()->safe_as<NodeData>();
         CHECK(sink_node);
 
@@ -108,6 +110,10 @@ CINN_REGISTER_HELPER(InferShape) {
       .set_change_structure(false)
       .provide_graph_attr("infershape")
       .provide_graph_attr("inferdtype")
+      .require_analysis("csr_graph")
+      .preserve_analysis("csr_graph")
+      .preserve_analysis("consumer_map")
+      .preserve_analysis("op_pattern_kinds")
       .set_body(cinn::hlir::pass::InferShapePass);
   return true;
 }
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "cinn/common/csr_graph.h"
 #include "cinn/hlir/pass/fusion_helper_base.h"
 
 namespace cinn {
@@ -39,14 +40,14 @@ using ConditionFunction = std::function<bool(const Node*, const Node*)>;
 // code generation.
 class OpFusionPassHelper : public FusionHelperBase {
  public:
-  OpFusionPassHelper(const std::vector<GraphNode*>& graph_nodes,
-                     const absl::flat_hash_map<std::string, shape_t>& shape_dict,
-                     const common::Target target)
-      : FusionHelperBase(shape_dict, target) {
+  explicit OpFusionPassHelper(Graph* graph)
+      : FusionHelperBase(graph),
+        consumer_map_(framework::GetAnalysis<framework::ConsumerMap>(graph, "consumer_map")) {
     // init fusion relation
     InitFusionRelation();
     // filter node data, create group for each node
-    for (auto graph_node : graph_nodes) {
+    auto csr_graph = framework::GetAnalysis<common::CsrGraph>(graph, "csr_graph");
+    for (auto graph_node : csr_graph->topological_order()) {
       auto node = graph_node->safe_as<Node>();
       if (node) {
         nodes_.push_back(node);
@@ -145,9 +146,7 @@ class OpFusionPassHelper : public FusionHelperBase {
                 << " -> Consumer Op: " << consumer->id() << ", Op Pattern: " << GetOpKind(consumer);
         bool can_fuse = true;
         // checkout producer node outputs are all in fusion op
-        for (auto& link : producer_data->outlinks()) {
-          auto consumer_node = link->sink()->safe_as<Node>();
-          CHECK(consumer_node);
+        for (auto consumer_node : consumer_map_->at(producer_data)) {
           // if fusion group can't find node, can't merge
           if (consumer_fusion->nodes_set.find(consumer_node) == consumer_fusion->nodes_set.end()) {
             can_fuse = false;
@@ -207,7 +206,7 @@ class OpFusionPassHelper : public FusionHelperBase {
     };
     // 4. without last dimension in reduce axis.
     auto without_last_dimension_in_reduce = [this](const Node* producer, const Node* consumer) -> bool {
-      auto in_shape    = this->shape_dict_.at(producer->inlinks_in_order()[0]->source()->id());
+      auto in_shape    = this->shape_dict_->at(producer->inlinks_in_order()[0]->source()->id());
       auto reduce_axes = absl::get<std::vector<int>>(producer->attrs.attr_store.at("dim"));
       return this->WithoutLastDimInReduce(in_shape, reduce_axes);
     };
@@ -222,11 +221,11 @@ class OpFusionPassHelper : public FusionHelperBase {
         }
       }
       // check reduce has same input shape and output shape
-      auto producer_input_shape  = shape_dict_.at(producer->inlinks_in_order()[0]->source()->id());
-      auto producer_output_shape = shape_dict_.at(producer->outlinks_in_order()[0]->sink()->id());
+      auto producer_input_shape  = shape_dict_->at(producer->inlinks_in_order()[0]->source()->id());
+      auto producer_output_shape = shape_dict_->at(producer->outlinks_in_order()[0]->sink()->id());
 
-      auto reducer_input_shape  = shape_dict_.at(reducer->inlinks_in_order()[0]->source()->id());
-      auto reducer_output_shape = shape_dict_.at(reducer->outlinks_in_order()[0]->sink()->id());
+      auto reducer_input_shape  = shape_dict_->at(reducer->inlinks_in_order()[0]->source()->id());
+      auto reducer_output_shape = shape_dict_->at(reducer->outlinks_in_order()[0]->sink()->id());
 
       auto producer_reduce_dim = absl::get<std::vector<int>>(producer->attrs.attr_store.at("dim"));
       auto reducer_reduce_dim  = absl::get<std::vector<int>>(reducer->attrs.attr_store.at("dim"));
@@ -271,7 +270,7 @@ class OpFusionPassHelper : public FusionHelperBase {
       }
 
       // check producer has same shape with reducer node.
-      auto reduce_shape = shape_dict_.at(GetProducerNodeData(reducer)[0]->id());
+      auto reduce_shape = shape_dict_->at(GetProducerNodeData(reducer)[0]->id());
       auto reduce_axes  = absl::get<std::vector<int>>(reducer->attrs.attr_store.at("dim"));
       for (auto& axis : reduce_axes) {
         // if axis = -1, set as shape.size() - 1
@@ -428,6 +427,7 @@ class OpFusionPassHelper : public FusionHelperBase {
   }
   std::vector<Node*> nodes_;
   std::unordered_map<const Node*, GroupPtr> fusion_groups_;
+  std::shared_ptr<const framework::ConsumerMap> consumer_map_;
 
   struct FusionRelation {
     // producer -> consumer
@@ -501,6 +501,8 @@ void InsertBroadcastTo(Graph* graph) {
           shape_dict[tmp_node_data->id()] = output_shape;
           // update dtype_dict
           dtype_dict[tmp_node_data->id()] = dtype_dict[node_data->id()];
+          // the cached analyses don't know the inserted nodes.
+          framework::InvalidateAnalyses(graph);
         }
       }
     }
@@ -509,12 +511,8 @@ void InsertBroadcastTo(Graph* graph) {
 
 void OpFusionPassInternal(Graph* graph) {
   InsertBroadcastTo(graph);
-  // nodes include(node, data node)
-  auto nodes = std::get<0>(graph->topological_order());
-  // shape
-  auto& shape_dict = graph->GetAttrs<absl::flat_hash_map<std::string, shape_t>>("infershape");
-
-  auto op_fusion_helper = OpFusionPassHelper(nodes, shape_dict, graph->target_);
+  // the analyses are got after the broadcast_to are inserted.
+  auto op_fusion_helper = OpFusionPassHelper(graph);
   graph->fusion_groups  = op_fusion_helper();
 
   for (auto& group : graph->fusion_groups) {
@@ -537,6 +535,11 @@ CINN_REGISTER_HELPER(OpFusionPass) {
       .describe(
           "Op Fusion Pass which performs Ops fusion, Producer Ops are fused into Consumer Ops with certain conditions.")
       .set_change_structure(false)
+      .preserve_analysis("csr_graph")
+      .preserve_analysis("shape_dict")
+      .preserve_analysis("dtype_dict")
+      .preserve_analysis("consumer_map")
+      .preserve_analysis("op_pattern_kinds")
       .set_body(cinn::hlir::pass::OpFusionPassInternal);
 
   return true;
@@ -530,6 +530,7 @@ CINN_REGISTER_HELPER(OpFusion) {
   CINN_REGISTER_PASS(OpFusion)
       .describe("This pass traverse the graph and fuse all ops.")
       .set_change_structure(false)
+      .preserve_analysis("csr_graph")
       .set_body(cinn::hlir::pass::OpFusionPass);
 
   return true;
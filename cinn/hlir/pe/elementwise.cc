@@ -16,6 +16,7 @@
 
 #include <string>
 
+#include "cinn/common/ir_util.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/lang/builtin.h"
 
@@ -102,6 +103,71 @@ HLIR_IMP_UNARY_PE(Sign);
 HLIR_IMP_UNARY_PE(Abs);
 HLIR_IMP_UNARY_PE(Rsqrt);
 
+namespace {
+// Load the scale of the element at `indice`, the scale is either per-tensor or indexed by the channel axis.
+Expr GetQuantScale(const Tensor& scale, const std::vector<Expr>& indice, int axis) {
+  if (axis < 0) {
+    return scale(Expr(0));
+  }
+  CHECK_LT(axis, static_cast<int>(indice.size())) << "The quantization axis " << axis << " is out of range!";
+  return scale(indice[axis]);
+}
+
+// Round, shift by the zero point and saturate a float value to the int8 range.
+Expr SaturateToInt8(Expr value, int zero_point) {
+  auto lower = common::make_const(value->type(), -128);
+  auto upper = common::make_const(value->type(), 127);
+  auto q     = lang::Round(value) + common::make_const(value->type(), zero_point);
+  return ir::Cast::Make(common::Int(8), ir::Min::Make(ir::Max::Make(q, lower), upper));
+}
+}  // namespace
+
+ir::Tensor Quantize(const Tensor& A, const Tensor& scale, int axis, int zero_point, const std::string& output_name) {
+  CHECK(A->type().is_float()) << "The input of quantize should be float, but get " << A->type();
+  return Compute(
+      A->shape,
+      [=](const std::vector<Expr>& indice) {
+        return SaturateToInt8(A(indice) / GetQuantScale(scale, indice, axis), zero_point);
+      },
+      output_name);
+}
+
+ir::Tensor Dequantize(const Tensor& A, const Tensor& scale, int axis, int zero_point, const std::string& output_name) {
+  CHECK(A->type().is_int()) << "The input of dequantize should be int8 or int32, but get " << A->type();
+  return Compute(
+      A->shape,
+      [=](const std::vector<Expr>& indice) {
+        auto value = ir::Cast::Make(common::Float(32), A(indice));
+        if (zero_point != 0) {
+          value = value - common::make_const(common::Float(32), zero_point);
+        }
+        return value * GetQuantScale(scale, indice, axis);
+      },
+      output_name);
+}
+
+ir::Tensor Requantize(const Tensor& A,
+                      const Tensor& in_scale,
+                      const Tensor& out_scale,
+                      int axis,
+                      int zero_point,
+                      const std::string& output_name) {
+  CHECK(A->type().is_int(32)) << "The input of requantize should be int32, but get " << A->type();
+  return Compute(
+      A->shape,
+      [=](const std::vector<Expr>& indice) {
+        auto value = ir::Cast::Make(common::Float(32), A(indice));
+        auto ratio = GetQuantScale(in_scale, indice, axis) / out_scale(Expr(0));
+        return SaturateToInt8(value * ratio, zero_point);
+      },
+      output_name);
+}
+
+ir::Tensor Cast(const Tensor& A, const Type& dtype, const std::string& output_name) {
+  return Compute(
+      A->shape, [=](const std::vector<Expr>& indice) { return ir::Cast::Make(dtype, A(indice)); }, output_name);
+}
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
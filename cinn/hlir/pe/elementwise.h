@@ -76,6 +76,71 @@ HLIR_DCL_UNARY_PE(ElementwiseSum);
 HLIR_DCL_UNARY_PE(Full);
 HLIR_DCL_UNARY_PE(FullLike);
 
+/**
+ * @brief Quantize a float Tensor to int8 with symmetric linear quantization: clip(round(A / scale) + zero_point).
+ *
+ * @param A The input float Tensor
+ * @param scale The quantization scale, a Tensor of shape [1] (per-tensor) or [A->shape[axis]] (per-channel)
+ * @param axis The channel axis of a per-channel scale, -1 means per-tensor
+ * @param zero_point The zero point added after rounding
+ * @param output_name The name of the output Tensor
+ *
+ * @return The int8 result Tensor.
+ */
+ir::Tensor Quantize(const ir::Tensor& A,
+                    const ir::Tensor& scale,
+                    int axis                       = -1,
+                    int zero_point                 = 0,
+                    const std::string& output_name = "T_Quantize_out");
+
+/**
+ * @brief Dequantize an integer Tensor (int8 values or int32 accumulators) to float32: (A - zero_point) * scale.
+ *
+ * @param A The input integer Tensor
+ * @param scale The quantization scale, a Tensor of shape [1] (per-tensor) or [A->shape[axis]] (per-channel)
+ * @param axis The channel axis of a per-channel scale, -1 means per-tensor
+ * @param zero_point The zero point of the input
+ * @param output_name The name of the output Tensor
+ *
+ * @return The float32 result Tensor.
+ */
+ir::Tensor Dequantize(const ir::Tensor& A,
+                      const ir::Tensor& scale,
+                      int axis                       = -1,
+                      int zero_point                 = 0,
+                      const std::string& output_name = "T_Dequantize_out");
+
+/**
+ * @brief Requantize an int32 accumulator Tensor to int8: clip(round(A * in_scale / out_scale) + zero_point).
+ * It is the epilogue of an integer GEMM/convolution, whose accumulator scale is usually per output channel.
+ *
+ * @param A The input int32 Tensor
+ * @param in_scale The scale of A, a Tensor of shape [1] or [A->shape[axis]]
+ * @param out_scale The scale of the output, a Tensor of shape [1]
+ * @param axis The channel axis of a per-channel in_scale, -1 means per-tensor
+ * @param zero_point The zero point of the output
+ * @param output_name The name of the output Tensor
+ *
+ * @return The int8 result Tensor.
+ */
+ir::Tensor Requantize(const ir::Tensor& A,
+                      const ir::Tensor& in_scale,
+                      const ir::Tensor& out_scale,
+                      int axis                       = -1,
+                      int zero_point                 = 0,
+                      const std::string& output_name = "T_Requantize_out");
+
+/**
+ * @brief Cast a Tensor to another data type, e.g. between float32 and the float16/bfloat16 storage types.
+ *
+ * @param A The input Tensor
+ * @param dtype The data type of the output Tensor
+ * @param output_name The name of the output Tensor
+ *
+ * @return The result Tensor.
+ */
+ir::Tensor Cast(const ir::Tensor& A, const Type& dtype, const std::string& output_name = "T_Cast_out");
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -27,6 +27,7 @@
 #include "cinn/hlir/pe/broadcast.h"
 #include "cinn/hlir/pe/elementwise.h"
 #include "cinn/hlir/pe/nn_util.h"
+#include "cinn/hlir/pe/reduction.h"
 #include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/lang/builtin.h"
@@ -759,6 +760,31 @@ std::vector<ir::Tensor> Softmax(const ir::Tensor &A, int axis, const std::string
   return {out, temp};
 }
 
+std::vector<ir::Tensor> SoftmaxCpuTwoStep(const ir::Tensor &A, int axis, const std::string &output_name) {
+  if (axis == -1) {
+    axis = A->shape.size() - 1;
+  }
+  if (A->shape.size() < 2 || axis != static_cast<int>(A->shape.size()) - 1) {
+    return Softmax(A, axis, output_name);
+  }
+  auto exps = Compute(
+      A->shape, [=](const std::vector<Expr> &indice) { return lang::Exp(A(indice)); }, UniqName("softmax_exp"));
+  auto sums = CpuTwoStepReduceSum(exps, {axis}, false, UniqName("softmax_temp_out"));
+  if (sums.size() != 2) {
+    return Softmax(A, axis, output_name);
+  }
+
+  auto sum       = sums[0];
+  ir::Tensor out = Compute(
+      A->shape,
+      [=](const std::vector<Expr> &indice) {
+        std::vector<Expr> sum_indice(indice.begin(), indice.end() - 1);
+        return lang::Exp(A(indice)) / sum(sum_indice);
+      },
+      UniqName("softmax_out"));
+  return {out, sum, sums[1], exps};
+}
+
 #ifdef CINN_WITH_MKLDNN
 std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A, int axis, const std::string &output_name) {
   CHECK_LE(A->shape.size(), 4U) << "Input's dimension of mkldnn softmax op is less than 4! Please check.";
@@ -790,6 +816,101 @@ std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A, int axis, const std::
 }
 #endif
 
+std::vector<ir::Tensor> FusedAttention(const ir::Tensor &Q,
+                                       const ir::Tensor &K,
+                                       const ir::Tensor &V,
+                                       float scale,
+                                       const std::string &output_name) {
+  CHECK_GE(Q->shape.size(), 2U) << "The query of fused attention should be at least 2-D";
+  CHECK_EQ(Q->shape.size(), K->shape.size()) << "The query and key of fused attention should have the same rank";
+  CHECK_EQ(Q->shape.size(), V->shape.size()) << "The query and value of fused attention should have the same rank";
+  CHECK(Q->type().is_float(32)) << "Only float32 is supported by fused attention";
+  int rank = Q->shape.size();
+  // all the leading dimensions are flattened to the batch of heads.
+  Expr batch_size(1);
+  for (int i = 0; i < rank - 2; i++) {
+    CHECK(MathEqual(Q->shape[i], K->shape[i]) && MathEqual(Q->shape[i], V->shape[i]))
+        << "The leading dimensions of the query, key and value of fused attention should be the same";
+    batch_size = batch_size * Q->shape[i];
+  }
+  CHECK(MathEqual(Q->shape[rank - 1], K->shape[rank - 1])) << "The query and key should have the same head dim";
+  CHECK(MathEqual(K->shape[rank - 2], V->shape[rank - 2])) << "The key and value should have the same sequence length";
+
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_fused_attention_fp32",
+                                {
+                                    common::AutoSimplify(batch_size),  // batch_size
+                                    Q->shape[rank - 2],                // seq_q
+                                    K->shape[rank - 2],                // seq_k
+                                    Q->shape[rank - 1],                // head_dim
+                                    V->shape[rank - 1],                // value_dim
+                                    Expr(scale),                       // scale
+                                    Q,                                 // Q
+                                    K,                                 // K
+                                    V,                                 // V
+                                });
+      },
+      output_name);
+  auto out = call->TupleGet(0);
+  out->WithBuffer(Q->type());
+  return {out, call};
+}
+
+ir::Tensor QuantizedMatmul(const ir::Tensor &A, const ir::Tensor &B, const std::string &output_name) {
+  CHECK_EQ(A->shape.size(), 2U) << "The first input of quantized matmul should be 2-D";
+  CHECK_EQ(B->shape.size(), 2U) << "The second input of quantized matmul should be 2-D";
+  CHECK(A->type().is_int(8) && B->type().is_int(8)) << "The inputs of quantized matmul should be int8, but get "
+                                                     << A->type() << " and " << B->type();
+  CHECK(MathEqual(A->shape[1], B->shape[0])) << "The quantized matmul requires the width of A equal to the height of B";
+  Var reduce_k(A->shape[1], UniqName("reduce_k"));
+  return Compute(
+      {A->shape[0], B->shape[1]},
+      [=](Expr i, Expr j) {
+        auto a = ir::Cast::Make(common::Int(32), A(i, reduce_k));
+        auto b = ir::Cast::Make(common::Int(32), B(reduce_k, j));
+        return lang::ReduceSum(a * b, {reduce_k});
+      },
+      output_name);
+}
+
+std::vector<ir::Tensor> QuantizedConv2d_NCHW(const ir::Tensor &input,
+                                             const ir::Tensor &weights,
+                                             int pad_h,
+                                             int pad_w,
+                                             int stride_h,
+                                             int stride_w,
+                                             int dilation_h,
+                                             int dilation_w,
+                                             const std::string &output_name) {
+  CHECK_EQ(input->shape.size(), 4U) << "The input of quantized conv2d should be 4-D";
+  CHECK_EQ(weights->shape.size(), 4U) << "The weights of quantized conv2d should be 4-D";
+  CHECK(input->type().is_int(8) && weights->type().is_int(8))
+      << "The inputs of quantized conv2d should be int8, but get " << input->type() << " and " << weights->type();
+  CHECK(MathEqual(input->shape[1], weights->shape[1])) << "The grouped quantized conv2d is not supported";
+  int kernel_h = (weights->shape[2].as_int32() - 1) * dilation_h + 1;
+  int kernel_w = (weights->shape[3].as_int32() - 1) * dilation_w + 1;
+  int out_h    = (input->shape[2].as_int32() + 2 * pad_h - kernel_h) / stride_h + 1;
+  int out_w    = (input->shape[3].as_int32() + 2 * pad_w - kernel_w) / stride_w + 1;
+  std::vector<Expr> output_shape{input->shape[0], weights->shape[0], Expr(out_h), Expr(out_w)};
+
+  auto input_pad = Pad(input, {Expr(0), Expr(0), Expr(pad_h), Expr(pad_w)}, {}, Expr(), UniqName("input_pad"));
+  Var rc(weights->shape[1], UniqName("rc"));
+  Var ry(weights->shape[2], UniqName("ry"));
+  Var rx(weights->shape[3], UniqName("rx"));
+  auto res = Compute(
+      output_shape,
+      [=](Expr nn, Expr ff, Expr yy, Expr xx) {
+        auto a = ir::Cast::Make(common::Int(32),
+                                input_pad(nn, rc, yy * stride_h + ry * dilation_h, xx * stride_w + rx * dilation_w));
+        auto b = ir::Cast::Make(common::Int(32), weights(ff, rc, ry, rx));
+        return lang::ReduceSum(a * b, {rc, ry, rx});
+      },
+      output_name);
+  return {res, input_pad};
+}
+
 /**
  * @brief Perform padding operation.
  * @param tensor The input tensor.
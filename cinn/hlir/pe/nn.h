@@ -316,12 +316,77 @@ std::vector<ir::Tensor> Softmax(const ir::Tensor &A,
                                 int axis                       = -1,
                                 const std::string &output_name = UniqName("T_softmax_out"));
 
+/**
+ * Softmax on CPU whose sum of the exps over the last axis is reduced in two steps by CpuTwoStepReduceSum, so that the
+ * sum is vectorized too.
+ *
+ * @return {out, sum, internal, exp} with the partial sums in internal, or the results of Softmax if the sum can't be
+ * split.
+ */
+std::vector<ir::Tensor> SoftmaxCpuTwoStep(const ir::Tensor &A,
+                                          int axis                       = -1,
+                                          const std::string &output_name = UniqName("T_softmax_out"));
+
 #ifdef CINN_WITH_MKLDNN
 std::vector<ir::Tensor> SoftmaxMKLDNN(const ir::Tensor &A,
                                       int axis                       = -1,
                                       const std::string &output_name = UniqName("T_softmax_out"));
 #endif
 
+/**
+ * @brief Compute softmax(Q * K^T * scale) * V by calling the fused attention kernel on the host.
+ * @param Q The query tensor of shape [..., seq_q, head_dim].
+ * @param K The key tensor of shape [..., seq_k, head_dim].
+ * @param V The value tensor of shape [..., seq_k, value_dim].
+ * @param scale The factor multiplied to the scores before softmax.
+ * @param output_name The name of the output tensor.
+ *
+ * @return The output tensor of shape [..., seq_q, value_dim] and the extern call.
+ */
+std::vector<ir::Tensor> FusedAttention(const ir::Tensor &Q,
+                                       const ir::Tensor &K,
+                                       const ir::Tensor &V,
+                                       float scale,
+                                       const std::string &output_name = UniqName("T_fused_attention_out"));
+
+/**
+ * @brief Multiply two int8 matrices with int32 accumulation, the integer GEMM of a quantized model. The int32 result
+ * is usually requantized or dequantized with the product of the input scales afterwards.
+ * @param A The int8 tensor of shape [M, K].
+ * @param B The int8 tensor of shape [K, N].
+ * @param output_name The name of the output tensor.
+ *
+ * @return The int32 tensor of shape [M, N].
+ */
+ir::Tensor QuantizedMatmul(const ir::Tensor &A,
+                           const ir::Tensor &B,
+                           const std::string &output_name = UniqName("T_quantized_matmul_out"));
+
+/**
+ * @brief Perform a 2-D convolution of int8 tensors in NCHW-layout with int32 accumulation. The padding is filled
+ * with zero, the zero point of the symmetric quantization.
+ * @param input The 4-D int8 input tensor {N, C_in, H, W}
+ * @param weights The 4-D int8 weight tensor {C_out, C_in, filter_h, filter_w}
+ * @param pad_h padding applied to the height of the image
+ * @param pad_w padding applied to the width of the image
+ * @param stride_h striding applied to the height of the image
+ * @param stride_w striding applied to the width of the image
+ * @param dilation_h dilation applied to the height of the image
+ * @param dilation_w dilation applied to the width of the image
+ * @param output_name The name of the output tensor
+ *
+ * @return The int32 output tensor and the padded input.
+ */
+std::vector<ir::Tensor> QuantizedConv2d_NCHW(const ir::Tensor &input,
+                                             const ir::Tensor &weights,
+                                             int pad_h,
+                                             int pad_w,
+                                             int stride_h,
+                                             int stride_w,
+                                             int dilation_h,
+                                             int dilation_w,
+                                             const std::string &output_name = UniqName("T_quantized_conv2d_out"));
+
 /**
  * @brief Perform pooling on the width dimension of the tensor.
  *        Width axis is determined by the data_format string in which 'W' means width. Only support NCW and NWC
@@ -14,6 +14,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
 #include "cinn/backends/codegen_cuda_dev.h"
 #include "cinn/backends/codegen_cuda_util.h"
 #include "cinn/backends/cuda_util.h"
@@ -937,6 +943,122 @@ TEST(Reduce, Reduce_Test_13) {
 }
 #endif
 
+using CpuTwoStepReduceFunc = std::function<std::vector<ir::Tensor>(
+    const ir::Tensor &, const std::vector<int> &, const bool, const std::string &)>;
+
+/**
+ * Run the two step reduction \p reduce_func scheduled as the reduce ops do on CPU, and check it against combining the
+ * elements by \p combine from \p initial. The inputs are in [0.99, 1.01] for \p combine to keep the products finite.
+ */
+void TestCpuTwoStepReduce(const CpuTwoStepReduceFunc &reduce_func,
+                          const std::function<float(float, float)> &combine,
+                          float initial,
+                          const std::vector<int> &shape,
+                          const std::vector<int> &axes,
+                          bool keep_dim) {
+  std::vector<Expr> shape_expr;
+  for (int dim : shape) {
+    shape_expr.emplace_back(dim);
+  }
+  Placeholder<float> A("A", shape_expr);
+  auto target = common::DefaultHostTarget();
+  auto res    = reduce_func(A.tensor(), axes, keep_dim, "reduce_out");
+  auto stages = CreateStages(res);
+  std::vector<int> real_axes;
+  GetRealAxes(shape.size(), axes, &real_axes);
+  if (res.size() == 2) {
+    CpuTwoStepReduceSchedule(stages, res[1], res[0], target);
+  } else {
+    ReduceScheduleCPU(stages, res[0], shape.size(), real_axes, target);
+  }
+  std::vector<ir::Tensor> tensor_args = {A};
+  tensor_args.insert(tensor_args.end(), res.begin(), res.end());
+  auto func = Lower("fn", stages, tensor_args);
+  LOG(INFO) << "func:\n" << func;
+
+  Module::Builder builder("module0", target);
+  builder.AddFunction(func);
+  auto jit = backends::ExecutionEngine::Create({});
+  jit->Link(builder.Build());
+  auto fn_ = reinterpret_cast<void (*)(void *, int32_t)>(jit->Lookup("fn"));
+  CHECK(fn_);
+
+  cinn_buffer_t *A_buf = common::BufferBuilder(Float(32), shape).set_random().Build();
+  auto *ad             = reinterpret_cast<float *>(A_buf->memory);
+  for (int i = 0; i < A_buf->num_elements(); i++) {
+    ad[i] = 0.99f + 0.02f * ad[i];
+  }
+  std::vector<cinn_pod_value_t> args = {cinn_pod_value_t(A_buf)};
+  std::vector<cinn_buffer_t *> res_bufs;
+  for (auto &t : res) {
+    std::vector<int> res_shape;
+    for (auto &dim : t->shape) {
+      res_shape.push_back(dim.as_int32());
+    }
+    res_bufs.push_back(common::BufferBuilder(Float(32), res_shape).set_zero().Build());
+    args.emplace_back(res_bufs.back());
+  }
+  fn_(reinterpret_cast<void **>(args.data()), args.size());
+
+  // combine each input element into the output element of its not reduced coordinates.
+  auto *od = reinterpret_cast<float *>(res_bufs[0]->memory);
+  std::vector<float> expect(res_bufs[0]->num_elements(), initial);
+  for (int i = 0; i < A_buf->num_elements(); i++) {
+    int offset = 0;
+    int index  = i;
+    int stride = 1;
+    for (int dim = static_cast<int>(shape.size()) - 1; dim >= 0; --dim) {
+      int coordinate = index % shape[dim];
+      index /= shape[dim];
+      if (std::find(real_axes.begin(), real_axes.end(), dim) == real_axes.end()) {
+        offset += coordinate * stride;
+        stride *= shape[dim];
+      }
+    }
+    expect[offset] = combine(expect[offset], ad[i]);
+  }
+  for (int i = 0; i < expect.size(); i++) {
+    ASSERT_NEAR(od[i], expect[i], 1e-3 * std::max(1.f, std::abs(expect[i])));
+  }
+}
+
+void TestCpuTwoStepReduce(const CpuTwoStepReduceFunc &reduce_func,
+                          const std::function<float(float, float)> &combine,
+                          float initial) {
+  // the rows of layer_norm and softmax.
+  TestCpuTwoStepReduce(reduce_func, combine, initial, {32, 768}, {1}, false);
+  TestCpuTwoStepReduce(reduce_func, combine, initial, {32, 768}, {1}, true);
+  TestCpuTwoStepReduce(reduce_func, combine, initial, {8, 4, 96}, {1, 2}, false);
+  // few rows, the reduction is split into parallel chunks.
+  TestCpuTwoStepReduce(reduce_func, combine, initial, {2, 16384}, {1}, false);
+  TestCpuTwoStepReduce(reduce_func, combine, initial, {16384}, {0}, false);
+  // the negative axes count from the last one.
+  TestCpuTwoStepReduce(reduce_func, combine, initial, {32, 768}, {-1}, false);
+  // fall back to the one step reduction.
+  TestCpuTwoStepReduce(reduce_func, combine, initial, {64, 48}, {0}, false);
+  TestCpuTwoStepReduce(reduce_func, combine, initial, {16, 10}, {1}, false);
+  TestCpuTwoStepReduce(reduce_func, combine, initial, {16, 10}, {-1}, false);
+  TestCpuTwoStepReduce(reduce_func, combine, initial, {16, 10, 8}, {-2}, true);
+}
+
+TEST(Reduce, CpuTwoStepReduceSum) {
+  TestCpuTwoStepReduce(CpuTwoStepReduceSum, [](float a, float b) { return a + b; }, 0.f);
+}
+
+TEST(Reduce, CpuTwoStepReduceProd) {
+  TestCpuTwoStepReduce(CpuTwoStepReduceProd, [](float a, float b) { return a * b; }, 1.f);
+}
+
+TEST(Reduce, CpuTwoStepReduceMax) {
+  TestCpuTwoStepReduce(
+      CpuTwoStepReduceMax, [](float a, float b) { return std::max(a, b); }, std::numeric_limits<float>::lowest());
+}
+
+TEST(Reduce, CpuTwoStepReduceMin) {
+  TestCpuTwoStepReduce(
+      CpuTwoStepReduceMin, [](float a, float b) { return std::min(a, b); }, std::numeric_limits<float>::max());
+}
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
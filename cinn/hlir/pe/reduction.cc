@@ -20,6 +20,7 @@
 
 #include "cinn/common/ir_util.h"
 #include "cinn/hlir/pe/broadcast.h"
+#include "cinn/hlir/pe/schedule.h"
 #include "cinn/ir/ir_operators.h"
 #include "cinn/ir/tensor.h"
 #include "cinn/lang/builtin.h"
@@ -58,8 +59,8 @@ void GetRealAxes(int ndim, const std::vector<int>& axes, std::vector<int>* real_
       CHECK_GE(axis, 0);
       real_axes->push_back(axis);
     }
-    real_axes->resize(std::unique(real_axes->begin(), real_axes->end()) - real_axes->begin());
     std::sort(real_axes->begin(), real_axes->end());
+    real_axes->resize(std::unique(real_axes->begin(), real_axes->end()) - real_axes->begin());
   }
 }
 
@@ -140,7 +141,12 @@ Tensor DoReduce(const Tensor& tensor,
       eval_indice.push_back(indices[indice_cnt]);
       indice_cnt++;
     }
-    return fn(tensor(eval_indice), reduce_axes, initial);
+    Expr value = tensor(eval_indice);
+    if (value.type().is_float16() || value.type().is_bfloat16()) {
+      // accumulate the low precision inputs in float32
+      value = ir::Cast::Make(Float(32), value);
+    }
+    return fn(value, reduce_axes, initial);
   };
 
   Tensor C = Compute(output_shape, compute, output_name);
@@ -784,6 +790,148 @@ std::vector<ir::Tensor> TwoStepBlockReduceMin(const ir::Tensor& A,
   return TwoStepBlockReduceInternal(A, axes, keep_dim, output_name, ReduceMin, BlockReduceMinInternal);
 }
 
+/**
+ * @brief Get the number of partial results a CPU two step reduction keeps per output element, that is the vector
+ * lanes times the number of accumulators, or 0 if \p reduce_size can't be split into them.
+ */
+int GetCpuReduceWidth(int reduce_size, int lanes) {
+  // Up to 4 accumulators hide the latency of the vector adds, each of them should accumulate 2 elements at least.
+  for (int width = lanes * 4; width >= lanes; width /= 2) {
+    if (reduce_size % width == 0 && reduce_size / width >= 2) {
+      return width;
+    }
+  }
+  return 0;
+}
+
+template <typename FuncOp>
+std::vector<ir::Tensor> CpuTwoStepReduceInternal(const ir::Tensor& A,
+                                                 const std::vector<int>& axes,
+                                                 const bool keep_dim,
+                                                 const std::string& output_name,
+                                                 const FuncOp& fn,
+                                                 Expr initial,
+                                                 ReduceFunc reduce_func) {
+  int ndim = A->shape.size();
+  std::vector<int> real_axes;
+  GetRealAxes(ndim, axes, &real_axes);
+  // only the reductions over the last axes are split, as their elements are contiguous.
+  int first = real_axes.front();
+  if (real_axes.back() != ndim - 1 || static_cast<int>(real_axes.size()) != ndim - first) {
+    return {reduce_func(A, axes, keep_dim, output_name)};
+  }
+
+  int reduce_size = 1;
+  for (int idx = first; idx < ndim; ++idx) {
+    reduce_size *= A->shape[idx].as_int32();
+  }
+  Type acc_type = A->type().is_float16() || A->type().is_bfloat16() ? Float(32) : A->type();
+  int width     = GetCpuReduceWidth(reduce_size, GetBasicFactor(acc_type, common::DefaultHostTarget()));
+  if (width == 0) {
+    return {reduce_func(A, axes, keep_dim, output_name)};
+  }
+
+  // if there are too few outputs to keep the threads busy, split the reduction into chunks which are parallel.
+  int outer_size = 1;
+  for (int idx = 0; idx < first; ++idx) {
+    outer_size *= A->shape[idx].as_int32();
+  }
+  int steps  = reduce_size / width;
+  int chunks = 1;
+  if (outer_size < 16) {
+    for (int chunk : {16, 8, 4, 2}) {
+      if (steps % chunk == 0 && steps / chunk >= 16) {
+        chunks = chunk;
+        break;
+      }
+    }
+  }
+  steps /= chunks;
+
+  std::vector<int> tail_strides(ndim - first, 1);
+  for (int idx = static_cast<int>(tail_strides.size()) - 2; idx >= 0; --idx) {
+    tail_strides[idx] = tail_strides[idx + 1] * A->shape[first + idx + 1].as_int32();
+  }
+
+  // internal[outer..., chunk, lane] accumulates the elements lane, lane + width, ... of the chunk.
+  std::vector<Expr> internal_shape(A->shape.begin(), A->shape.begin() + first);
+  if (chunks > 1) {
+    internal_shape.emplace_back(chunks);
+  }
+  internal_shape.emplace_back(width);
+  Var k(Expr(steps), UniqName("kk"));
+  auto internal = Compute(
+      internal_shape,
+      [=](const std::vector<Expr>& indexs) -> Expr {
+        std::vector<Expr> a_indexs(indexs.begin(), indexs.begin() + first);
+        Expr step  = chunks > 1 ? indexs[first] * Expr(steps) + k : Expr(k);
+        Expr index = step * Expr(width) + indexs.back();
+        for (auto tail_stride : tail_strides) {
+          a_indexs.push_back(index / Expr(tail_stride));
+          index = index % Expr(tail_stride);
+        }
+        Expr value = A(a_indexs);
+        if (value.type() != acc_type) {
+          value = ir::Cast::Make(acc_type, value);
+        }
+        return fn(value, {k}, initial);
+      },
+      UniqName(output_name + "_internal"));
+
+  // combine the partial results.
+  std::vector<Expr> out_shape(A->shape.begin(), A->shape.begin() + first);
+  for (int idx = first; idx < ndim && keep_dim; ++idx) {
+    out_shape.emplace_back(1);
+  }
+  if (out_shape.empty()) {
+    out_shape.emplace_back(1);
+  }
+  std::vector<Var> combine_axes;
+  if (chunks > 1) {
+    combine_axes.emplace_back(Expr(chunks), UniqName("kk"));
+  }
+  combine_axes.emplace_back(Expr(width), UniqName("kk"));
+  auto out = Compute(
+      out_shape,
+      [=](const std::vector<Expr>& indexs) -> Expr {
+        std::vector<Expr> internal_indexs(indexs.begin(), indexs.begin() + first);
+        for (auto& axis : combine_axes) {
+          internal_indexs.push_back(axis);
+        }
+        return fn(internal(internal_indexs), combine_axes, initial);
+      },
+      output_name);
+  return {out, internal};
+}
+
+std::vector<ir::Tensor> CpuTwoStepReduceSum(const ir::Tensor& A,
+                                            const std::vector<int>& axes,
+                                            const bool keep_dim,
+                                            const std::string& output_name) {
+  return CpuTwoStepReduceInternal(A, axes, keep_dim, output_name, lang::ReduceSum, Expr(0.0f), ReduceSum);
+}
+
+std::vector<ir::Tensor> CpuTwoStepReduceProd(const ir::Tensor& A,
+                                             const std::vector<int>& axes,
+                                             const bool keep_dim,
+                                             const std::string& output_name) {
+  return CpuTwoStepReduceInternal(A, axes, keep_dim, output_name, lang::ReduceMul, Expr(1.0f), ReduceProd);
+}
+
+std::vector<ir::Tensor> CpuTwoStepReduceMax(const ir::Tensor& A,
+                                            const std::vector<int>& axes,
+                                            const bool keep_dim,
+                                            const std::string& output_name) {
+  return CpuTwoStepReduceInternal(A, axes, keep_dim, output_name, lang::ReduceMax, Expr(-3.402823e+38f), ReduceMax);
+}
+
+std::vector<ir::Tensor> CpuTwoStepReduceMin(const ir::Tensor& A,
+                                            const std::vector<int>& axes,
+                                            const bool keep_dim,
+                                            const std::string& output_name) {
+  return CpuTwoStepReduceInternal(A, axes, keep_dim, output_name, lang::ReduceMin, Expr(3.402823e+38f), ReduceMin);
+}
+
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -21,6 +21,16 @@
 namespace cinn {
 namespace hlir {
 namespace pe {
+/**
+ * @brief transform reduction axes which could be empty or have negative elements into real axes with valid dimension
+ * indices.
+ *
+ * @param ndim Number of dimensions of the output tensor.
+ * @param axes The axes parameter.
+ * @param real_axes A non-empty sorted array of valid dimension indices, with no duplicates.
+ */
+void GetRealAxes(int ndim, const std::vector<int>& axes, std::vector<int>* real_axes);
+
 /**
  * @brief sums array elements over a given axis
  *
@@ -302,6 +312,39 @@ std::vector<ir::Tensor> TwoStepBlockReduceMin(const ir::Tensor& A,
                                               const std::vector<int>& axes,
                                               const bool keep_dim,
                                               const std::string& output_name = "T_Reduce_Min_out");
+/**
+ * @brief reduce the array elements on CPU in two steps. The elements of each output are first accumulated into a few
+ * vectors of partial results, the i-th partial result accumulating the elements i, i + width, ..., so that a step loads
+ * contiguous elements. Then the partial results are combined into the output. If there are few outputs, the reduction
+ * is also split into chunks that can be computed in parallel.
+ *
+ * @param A The input Tensor.
+ * @param axes the reduce axes.
+ * @param keep_dim keep the output tensor shape size as input.
+ * @param output_name The name of the output Tensor.
+ *
+ * @return {out, internal} with the partial results in internal, or {out} of the one step reduction if the reduce axes
+ * are not the last axes of A or their size can't be split into the vectors.
+ */
+std::vector<ir::Tensor> CpuTwoStepReduceSum(const ir::Tensor& A,
+                                            const std::vector<int>& axes,
+                                            const bool keep_dim,
+                                            const std::string& output_name = "T_Reduce_Sum_out");
+
+std::vector<ir::Tensor> CpuTwoStepReduceProd(const ir::Tensor& A,
+                                             const std::vector<int>& axes,
+                                             const bool keep_dim,
+                                             const std::string& output_name = "T_Reduce_Prod_out");
+
+std::vector<ir::Tensor> CpuTwoStepReduceMax(const ir::Tensor& A,
+                                            const std::vector<int>& axes,
+                                            const bool keep_dim,
+                                            const std::string& output_name = "T_Reduce_Max_out");
+
+std::vector<ir::Tensor> CpuTwoStepReduceMin(const ir::Tensor& A,
+                                            const std::vector<int>& axes,
+                                            const bool keep_dim,
+                                            const std::string& output_name = "T_Reduce_Min_out");
 }  // namespace pe
 }  // namespace hlir
 }  // namespace cinn
@@ -535,7 +535,11 @@ void CudaTwoStepReduceSchedule(poly::StageMap stages,
   stages[out]->Bind(0, "blockIdx.x");
 }
 
-void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir::Tensor &temp, int axis) {
+namespace {
+
+// fuse the axes before \p axis of the softmax output in parallel, and vectorize the elementwise division by the sum
+// along the contiguous last axis.
+void SoftmaxOutputScheduleCPU(poly::StageMap stage, const ir::Tensor &output, int axis) {
   if (axis == -1) {
     axis += output->shape.size();
   }
@@ -545,9 +549,121 @@ void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir
     fused = stage[output]->Fuse(0, 1);
   }
   CHECK_GT(stage[output]->n_out_dims(), 1);
+  int last_shape = output->shape.back().as_int32();
+  int factor     = GetVectorizeFactor(last_shape, GetBasicFactor(output->type(), common::DefaultHostTarget()));
+  if (factor > 1) {
+    stage[output]->Vectorize(stage[output]->n_out_dims() - 1, factor);
+  }
+}
+
+}  // namespace
+
+void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir::Tensor &temp, int axis) {
+  SoftmaxOutputScheduleCPU(stage, output, axis);
   stage[temp]->ComputeAt(stage[output], 0);
 }
 
+void SoftmaxCpuTwoStepSchedule(poly::StageMap stages,
+                               const ir::Tensor &output,
+                               const ir::Tensor &sum,
+                               const ir::Tensor &internal,
+                               const common::Target &target) {
+  CpuTwoStepReduceSchedule(stages, internal, sum, target);
+  SoftmaxOutputScheduleCPU(stages, output, -1);
+}
+
+void ReduceScheduleCPU(poly::StageMap stages,
+                       const ir::Tensor &out,
+                       int input_dims,
+                       const std::vector<int> &axes,
+                       const common::Target &target) {
+  auto stage = stages[out];
+  // the output axes are followed by the reduce axes.
+  int out_dims  = out->shape.size();
+  int n_dims    = stage->n_out_dims();
+  int tail_dims = input_dims - axes.back() - 1;
+  if (axes.front() > 0) {
+    stage->Parallel(0);
+  }
+  if (tail_dims == 0) {
+    return;
+  }
+
+  std::vector<int> order;
+  for (int idx = 0; idx < out_dims - tail_dims; ++idx) {
+    order.push_back(idx);
+  }
+  for (int idx = out_dims; idx < n_dims; ++idx) {
+    order.push_back(idx);
+  }
+  for (int idx = out_dims - tail_dims; idx < out_dims; ++idx) {
+    order.push_back(idx);
+  }
+  stage->Reorder(order);
+
+  int last_shape = out->shape.back().as_int32();
+  int factor     = GetVectorizeFactor(last_shape, GetBasicFactor(out->type(), target));
+  if (factor > 1) {
+    stage->Vectorize(n_dims - 1, factor);
+  }
+}
+
+void CpuTwoStepReduceSchedule(poly::StageMap stages,
+                              const ir::Tensor &internal,
+                              const ir::Tensor &out,
+                              const common::Target &target) {
+  // the outer axes (and the chunks) are followed by the partial results and the reduce axis.
+  auto internal_stage = stages[internal];
+  int dims            = internal_stage->n_out_dims();
+  internal_stage->Reorder({internal_stage->axis(dims - 1), internal_stage->axis(dims - 2)});
+  internal_stage->Vectorize(dims - 1, GetBasicFactor(internal->type(), target));
+  if (dims > 2) {
+    internal_stage->Parallel(0);
+  }
+
+  // the combination reduces the partial results of a single output.
+  if (internal->shape.size() > out->reduce_axis.size()) {
+    stages[out]->Parallel(0);
+  }
+}
+
+void QuantizedGemmScheduleCPU(poly::StageMap stages, const ir::Tensor &out, const common::Target &target) {
+  CHECK(!out->reduce_axis.empty()) << "The quantized gemm " << out->name << " should have reduce axes";
+  auto stage   = stages[out];
+  int out_dims = out->shape.size();
+  int n_dims   = stage->n_out_dims();
+  // the output axes are followed by the reduce axes.
+  auto &inner_reduce = out->reduce_axis.back();
+  bool split_reduce  = inner_reduce->upper_bound.is_constant() && inner_reduce->upper_bound.as_int32() > 4 &&
+                      inner_reduce->upper_bound.as_int32() % 4 == 0;
+  poly::Iterator reduce_group;
+  if (split_reduce) {
+    reduce_group = std::get<1>(stage->Split(n_dims - 1, 4));
+    n_dims++;
+  }
+
+  std::vector<int> order;
+  for (int idx = 0; idx < out_dims - 1; ++idx) {
+    order.push_back(idx);
+  }
+  for (int idx = out_dims; idx < n_dims; ++idx) {
+    order.push_back(idx);
+  }
+  order.push_back(out_dims - 1);
+  stage->Reorder(order);
+  if (split_reduce) {
+    stage->Unroll(reduce_group);
+  }
+  if (out_dims > 1) {
+    stage->Parallel(0);
+  }
+
+  int factor = GetVectorizeFactor(out->shape.back().as_int32(), GetBasicFactor(out->type(), target));
+  if (factor > 1) {
+    stage->Vectorize(n_dims - 1, factor);
+  }
+}
+
 void GlobalPoolScheduleGPU(poly::StageMap stages, const std::vector<ir::Tensor> &output, const common::Target &target) {
   auto &out    = output[0];
   auto &reduce = output[1];
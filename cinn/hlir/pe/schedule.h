@@ -84,6 +84,43 @@ void MulScheduleCPU(poly::StageMap stage,
 
 void SoftmaxScheduleCPU(poly::StageMap stage, const ir::Tensor &output, const ir::Tensor &temp, int axis = -1);
 
+/**
+ * Schedule the results of SoftmaxCpuTwoStep, whose exps should be inlined into the partial sums. The partial sums are
+ * vectorized as in CpuTwoStepReduceSchedule, and the division as in SoftmaxScheduleCPU.
+ */
+void SoftmaxCpuTwoStepSchedule(poly::StageMap stages,
+                               const ir::Tensor &output,
+                               const ir::Tensor &sum,
+                               const ir::Tensor &internal,
+                               const common::Target &target);
+
+/**
+ * Schedule a one step reduction on CPU. If the last axis is not reduced, the reduce axes are moved outside the trailing
+ * axes, so that the innermost loop runs over contiguous outputs and is vectorized. \p axes should be the real reduce
+ * axes, sorted and non-negative, see GetRealAxes.
+ */
+void ReduceScheduleCPU(poly::StageMap stages,
+                       const ir::Tensor &out,
+                       int input_dims,
+                       const std::vector<int> &axes,
+                       const common::Target &target);
+
+/**
+ * Schedule the two step reductions of CpuTwoStepReduceSum etc. The loop over the partial results is moved inside the
+ * reduce axis and vectorized, and the outer axes of both steps are parallel.
+ */
+void CpuTwoStepReduceSchedule(poly::StageMap stages,
+                              const ir::Tensor &internal,
+                              const ir::Tensor &out,
+                              const common::Target &target);
+
+/**
+ * Schedule the int32 accumulation of QuantizedMatmul and QuantizedConv2d_NCHW. The innermost reduce axis is split by 4
+ * and unrolled, the group of 4 int8 products summed into an int32 lane like the dot product instructions do, and the
+ * reduce axes are moved outside the last output axis, which is vectorized.
+ */
+void QuantizedGemmScheduleCPU(poly::StageMap stages, const ir::Tensor &out, const common::Target &target);
+
 void GetConv2dFactors(absl::flat_hash_map<std::string, int> *factors,
                       int oc,
                       int ic,
@@ -262,7 +262,7 @@ struct FloatImm : public ExprNode<FloatImm> {
   FloatImm(Type t, float v) : ExprNode<FloatImm>(t), value(v) { Verify(); }
 
   void Verify() const override {
-    CHECK(type().is_float());
+    CHECK(type().is_float() || type().is_bfloat16());
     CHECK(type().is_scalar());
   }
 
@@ -14,6 +14,8 @@
 
 #include "cinn/lang/lower_impl.h"
 
+#include <gflags/gflags.h>
+
 #include <algorithm>
 #include <queue>
 #include <string>
@@ -24,8 +26,13 @@
 #include "cinn/ir/ir_base.h"
 #include "cinn/ir/ir_printer.h"
 #include "cinn/ir/tensor.h"
+#include "cinn/optim/ir_copy.h"
 #include "cinn/optim/replace_var_with_expr.h"
+#include "cinn/poly/isl_utils.h"
 #include "cinn/poly/stage.h"
+#include "cinn/utils/string.h"
+
+DECLARE_bool(cinn_lower_without_isl);
 
 namespace cinn {
 namespace lang {
@@ -111,7 +118,7 @@ Expr LowerGroup(const poly::ScheduleGroup& group,
     Expr statement_candi_expr = tuple_to_expr.at(statement.first);
 
     VLOG(3) << "replacing " << statement.first << " to " << statement_candi_expr;
-    optim::ReplaceIslCallWithExpr(&e, statement.first, statement_candi_expr, axis_expr_map);
+    optim::ReplaceIslCallWithExpr(&e, gen.StatementName(statement.first), statement_candi_expr, axis_expr_map);
   }
   CheckNoIslCallRemains(&e);
 
@@ -206,6 +213,91 @@ Expr LowerGroup(const poly::ScheduleGroup& group,
   return e;
 }
 
+//! Get the only stage with expression in \p group, or nullptr if there are none or several.
+static poly::Stage* GetSingleExpressionStage(const poly::ScheduleGroup& group) {
+  poly::Stage* result = nullptr;
+  for (auto& node : group.nodes) {
+    if (!node->stage->has_expression()) continue;
+    if (result) return nullptr;
+    result = node->stage;
+  }
+  return result;
+}
+
+bool CanLowerWithoutIsl(const poly::ScheduleGroup& group, StageMap stage_map) {
+  if (!FLAGS_cinn_lower_without_isl) return false;
+  // The forloops of several stages in a group are interleaved by the isl schedule.
+  poly::Stage* stage = GetSingleExpressionStage(group);
+  if (!stage || stage->inlined()) return false;
+  auto* tensor = stage->tensor();
+  if (!tensor || !tensor->is_compute_node() || !tensor->reduce_axis.empty() || !tensor->new_indices.empty()) {
+    return false;
+  }
+  if (tensor->shape.empty() || tensor->domain.size() != tensor->shape.size()) return false;
+
+  if (!stage->compute_ats().empty() || !stage->meta.compute_at_infos.empty() || !stage->forloop_infos().empty() ||
+      stage->vectorize_info().valid() || !stage->unroll_info().empty() || !stage->parallel_info().empty()) {
+    return false;
+  }
+
+  // The statement indexes the tensor with the default axis, the domain should iterate over them in order.
+  auto dim_names = poly::isl_get_dim_names(stage->domain());
+  if (dim_names.size() != tensor->domain.size()) return false;
+  std::vector<std::string> constraints;
+  for (int i = 0; i < dim_names.size(); i++) {
+    if (dim_names[i] != common::axis_name(i) || !tensor->domain[i].is_constant()) return false;
+    constraints.push_back(utils::StringFormat(
+        "0 <= %s <= %d", dim_names[i].c_str(), static_cast<int>(tensor->domain[i].get_constant()) - 1));
+  }
+
+  // Any transform other than the initial identity reorders or reshapes the forloops.
+  isl::map identity(stage->domain().ctx(),
+                    utils::StringFormat("{ %s[%s] -> %s[%s] }",
+                                        stage->id(),
+                                        utils::Join(dim_names, ", ").c_str(),
+                                        stage->id(),
+                                        utils::Join(dim_names, ", ").c_str()));
+  if (!isl_map_is_equal(stage->transform().get(), identity.get())) return false;
+  isl::set box(stage->domain().ctx(),
+               utils::StringFormat("{ %s[%s] : %s }",
+                                   stage->id(),
+                                   utils::Join(dim_names, ", ").c_str(),
+                                   utils::Join(constraints, " and ").c_str()));
+  return isl_set_is_equal(stage->domain().get(), box.get());
+}
+
+Expr LowerGroupWithoutIsl(const poly::ScheduleGroup& group,
+                          const std::map<std::string, Expr>& tuple_to_expr,
+                          std::map<std::string, Tensor>* global_tensor_map,
+                          StageMap stage_map) {
+  BindBuffer(stage_map);
+  poly::Stage* stage = GetSingleExpressionStage(group);
+  CHECK(stage) << "The group to lower without isl should have exactly one stage with expression";
+  CHECK(tuple_to_expr.count(stage->id())) << "No statement is found for stage " << stage->id();
+  VLOG(3) << "Lower stage " << stage->id() << " without isl";
+
+  auto* tensor = stage->tensor();
+  Expr e       = optim::IRCopy(tuple_to_expr.at(stage->id()));
+  // Build the forloops from the innermost, the axis of extent 1 gets no forloop as isl does.
+  for (int i = static_cast<int>(tensor->domain.size()) - 1; i >= 0; i--) {
+    Var axis(common::axis_name(i));
+    int extent = tensor->domain[i].get_constant();
+    if (extent == 1) {
+      optim::ReplaceVarWithExpr(&e, axis, Expr(0));
+      continue;
+    }
+    e = ir::For::Make(axis, Expr(0), Expr(extent), ir::ForType::Serial, ir::DeviceAPI::Host, ir::Block::Make({e}));
+  }
+
+  // Update global_tensor_map
+  for (auto& e : stage_map) {
+    if (!global_tensor_map->count(e.second->id())) {
+      (*global_tensor_map)[e.second->id()] = ir::Tensor(e.second->tensor());
+    }
+  }
+  return e;
+}
+
 bool TensorContainsGPUInfo(ir::Tensor t, poly::Stage* stage) {
   if (stage->inlined()) return false;
   if (stage) {
@@ -728,8 +820,13 @@ std::vector<Expr> LowerImpl::GenerateFunctionBody(const poly::Schedule* schedule
     }
 
     ir::CudaAxisInfo temp_cuda_axis_info;
-    Expr group_expr =
-        LowerGroup(group, tuple_to_expr, &global_tensor_map, resized_buffer, stages_, &temp_cuda_axis_info);
+    Expr group_expr;
+    if (target_ == common::DefaultHostTarget() && CanLowerWithoutIsl(group, stages_)) {
+      group_expr = LowerGroupWithoutIsl(group, tuple_to_expr, &global_tensor_map, stages_);
+    } else {
+      group_expr =
+          LowerGroup(group, tuple_to_expr, &global_tensor_map, resized_buffer, stages_, &temp_cuda_axis_info);
+    }
 
     if (group_expr.defined()) {
       cuda_axis_info_.emplace_back(std::move(temp_cuda_axis_info));
@@ -70,6 +70,24 @@ Expr LowerGroup(const poly::ScheduleGroup& group,
                 StageMap stage_map,
                 ir::CudaAxisInfo* cuda_axis_info = nullptr);
 
+/**
+ * \brief Tell whether a group can be lowered without isl.
+ *
+ * That is the group has a single non-inlined stage whose iteration domain is a rectangle of constant extents, with
+ * an identity transform and no other schedule (ComputeAt, vectorize, unroll, parallel, GPU binding) on it, so its
+ * forloops are exactly the axes of the tensor.
+ */
+bool CanLowerWithoutIsl(const poly::ScheduleGroup& group, StageMap stage_map);
+
+/**
+ * \brief Lower a single group by building the forloops over the tensor axes directly, which is much cheaper than
+ * generating the isl AST. The result is the same as LowerGroup's, the group should satisfy CanLowerWithoutIsl.
+ */
+Expr LowerGroupWithoutIsl(const poly::ScheduleGroup& group,
+                          const std::map<std::string, Expr>& tuple_to_expr,
+                          std::map<std::string, Tensor>* global_tensor_map,
+                          StageMap stage_map);
+
 /**
  * A Computation graph node.
  */
@@ -14,8 +14,10 @@
 
 #include "cinn/lang/lower.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <set>
 
 #include "cinn/cinn.h"
@@ -24,6 +26,8 @@
 #include "cinn/lang/placeholder.h"
 #include "cinn/utils/string.h"
 
+DECLARE_bool(cinn_lower_without_isl);
+
 namespace cinn {
 namespace lang {
 
@@ -151,5 +155,61 @@ TEST(lower, temp_buffer_collects) {
   }
 }
 
+//! Lower a chain of \p num_ops elementwise and broadcast ops.
+ir::LoweredFunc LowerElementwiseChain(int num_ops) {
+  Expr M(32), N(64);
+  Placeholder<float> A("A", {M, N});
+  Placeholder<float> B("B", {N});
+
+  std::vector<ir::Tensor> tensors;
+  ir::Tensor last = Compute(
+      {M, N}, [&](Var i, Var j) { return A(i, j) + B(j); }, "T0");
+  tensors.push_back(last);
+  for (int k = 1; k < num_ops; k++) {
+    auto prev = last;
+    if (k % 2) {
+      last = Compute(
+          {M, N}, [&](Var i, Var j) { return prev(i, j) * A(i, j); }, "T" + std::to_string(k));
+    } else {
+      last = Compute(
+          {M, N}, [&](Var i, Var j) { return prev(i, j) - B(j); }, "T" + std::to_string(k));
+    }
+    tensors.push_back(last);
+  }
+  // An axis of extent 1 gets no forloop.
+  auto out = Compute(
+      {Expr(1), M, N}, [&](Var i, Var j, Var k) { return last(j, k) + 1.f; }, "out");
+  tensors.push_back(out);
+
+  auto stages = CreateStages(tensors);
+  return Lower("elementwise_chain", stages, {A, B, out});
+}
+
+TEST(lower, without_isl) {
+  auto lower_time = [](int num_ops, int repeats) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) LowerElementwiseChain(num_ops);
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+  };
+
+  FLAGS_cinn_lower_without_isl = false;
+  auto isl_func                = LowerElementwiseChain(4);
+  FLAGS_cinn_lower_without_isl = true;
+  auto direct_func             = LowerElementwiseChain(4);
+  // The forloops built directly are the same as the ones from the isl AST.
+  ASSERT_EQ(utils::GetStreamCnt(Expr(isl_func)), utils::GetStreamCnt(Expr(direct_func)));
+  LOG(INFO) << "func:\n" << Expr(direct_func);
+
+  const int num_ops = 300;
+  const int repeats = 3;
+  double direct_ms  = lower_time(num_ops, repeats);
+
+  FLAGS_cinn_lower_without_isl = false;
+  double isl_ms                = lower_time(num_ops, repeats);
+  FLAGS_cinn_lower_without_isl = true;
+  LOG(INFO) << "Lowering " << num_ops << " elementwise ops takes " << isl_ms << " ms by the isl AST, " << direct_ms
+            << " ms without isl";
+}
+
 }  // namespace lang
 }  // namespace cinn
@@ -14,13 +14,35 @@
 
 #include "cinn/optim/map_extern_call.h"
 
+#include <gflags/gflags.h>
+
 #include "cinn/cinn.h"
 #include "cinn/ir/ir_mutator.h"
+#include "cinn/lang/builtin.h"
 #include "cinn/runtime/cpu/host_intrinsics.h"
 
+DECLARE_int32(cinn_approx_math_level);
+
 namespace cinn {
 namespace optim {
 
+namespace {
+/**
+ * The erf of Abramowitz and Stegun 7.1.26, the absolute error is below 1.5e-7. It is made of arithmetic and exp only,
+ * which are inlined as polynomials by the LLVM codegen, so the loop can be vectorized unlike the one calling erff.
+ */
+Expr ApproxErf(Expr x) {
+  auto constant = [&](double v) { return common::make_const(x->type(), v); };
+  Expr t        = constant(1) / (constant(1) + constant(0.3275911) * lang::Abs(x));
+  Expr poly     = constant(1.061405429);
+  for (double coeff : {-1.453152027, 1.421413741, -0.284496736, 0.254829592}) {
+    poly = poly * t + constant(coeff);
+  }
+  Expr y = constant(1) - poly * t * lang::Exp(-(x * x));
+  return ir::Select::Make(x < constant(0), -y, y);
+}
+}  // namespace
+
 void MapExternCall(Expr *e, Target target) {
   struct Mutator : ir::IRMutator<Expr *> {
     Target target;
@@ -41,6 +63,11 @@ void MapExternCall(Expr *e, Target target) {
     }
 
     void DealWithCpuintrinsics(ir::Call *node, Expr *expr) {
+      if (node->name == "erf" && FLAGS_cinn_approx_math_level > 0) {
+        CHECK_GE(node->read_args.size(), 1UL);
+        *expr = ApproxErf(node->read_args.front());
+        return;
+      }
       if (kExternFp32CallsCPU.count(node->name)) {
         CHECK_GE(node->read_args.size(), 1UL);
         CHECK_EQ(node->read_args.front().type(), Float(32));
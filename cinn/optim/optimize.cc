@@ -28,6 +28,7 @@
 #include "cinn/optim/lower_function_call_bind_vars.h"
 #include "cinn/optim/lower_intrin.h"
 #include "cinn/optim/map_extern_call.h"
+#include "cinn/optim/promote_low_precision.h"
 #include "cinn/optim/remove_nested_block.h"
 #include "cinn/optim/remove_schedule_block.h"
 #include "cinn/optim/replace_const_param_to_integer.h"
@@ -48,6 +49,7 @@ Expr Optimize(Expr e, Target target, bool runtime_debug_info) {
   ReplaceConstParamToInteger(&copied);
   CastSimplify(&copied);
   Simplify(&copied);
+  PromoteLowPrecision(&copied, target);
   UnrollLoop(&copied);
   VectorizeLoops(&copied, target);
 #ifdef CINN_WITH_CUDA
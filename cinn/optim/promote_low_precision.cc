@@ -0,0 +1,123 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/promote_low_precision.h"
+
+#include <glog/logging.h>
+
+#include <vector>
+
+#include "cinn/ir/ir_mutator.h"
+
+namespace cinn::optim {
+
+namespace {
+
+bool IsLowPrecision(const Type& type) { return type.is_float16() || type.is_bfloat16(); }
+
+// Get the float32 value of a low precision expression, a rounding cast of a float32 value is skipped.
+Expr PromoteToFloat32(const Expr& e) {
+  if (!IsLowPrecision(e.type())) return e;
+  if (auto* cast = e.As<ir::Cast>()) {
+    if (cast->v().type().is_float(32)) {
+      return cast->v();
+    }
+  }
+  return ir::Cast::Make(Float(32, e.type().lanes()), e);
+}
+
+// Round the float32 result back to the low precision type of the original expression.
+Expr RoundTo(const Type& type, const Expr& e) { return IsLowPrecision(type) ? ir::Cast::Make(type, e) : e; }
+
+struct Mutator : public ir::IRMutator<> {
+  using ir::IRMutator<>::Visit;
+
+#define __(op__)                                        \
+  void Visit(const ir::op__* op, Expr* expr) override { \
+    ir::IRMutator<>::Visit(op, expr);                   \
+    auto* node = expr->As<ir::op__>();                  \
+    if (!IsLowPrecision(node->a().type())) return;      \
+    auto type = node->type();                           \
+    auto a    = PromoteToFloat32(node->a());            \
+    auto b    = PromoteToFloat32(node->b());            \
+    *expr     = RoundTo(type, ir::op__::Make(a, b));    \
+  }
+
+  __(Add)
+  __(Sub)
+  __(Mul)
+  __(Div)
+  __(Mod)
+  __(Min)
+  __(Max)
+  __(EQ)
+  __(NE)
+  __(LT)
+  __(LE)
+  __(GT)
+  __(GE)
+#undef __
+
+  void Visit(const ir::Minus* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* node = expr->As<ir::Minus>();
+    if (!IsLowPrecision(node->type())) return;
+    *expr = RoundTo(node->type(), ir::Minus::Make(PromoteToFloat32(node->v())));
+  }
+
+  void Visit(const ir::Select* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* node = expr->As<ir::Select>();
+    if (!IsLowPrecision(node->type())) return;
+    auto res =
+        ir::Select::Make(node->condition, PromoteToFloat32(node->true_value), PromoteToFloat32(node->false_value));
+    *expr = RoundTo(node->type(), res);
+  }
+
+  void Visit(const ir::FloatImm* op, Expr* expr) override {
+    if (!IsLowPrecision(op->type())) return;
+    *expr = ir::Cast::Make(op->type(), Expr(static_cast<float>(op->value)));
+  }
+
+  void Visit(const ir::Call* op, Expr* expr) override {
+    ir::IRMutator<>::Visit(op, expr);
+    auto* node = expr->As<ir::Call>();
+    // only the math functions are promoted, their float32 versions will be chosen by MapExternCall.
+    if (!node->is_extern_call() || !IsLowPrecision(node->type())) return;
+    std::vector<Expr> read_args;
+    for (auto& arg : node->read_args) {
+      read_args.push_back(PromoteToFloat32(arg));
+    }
+    auto res = ir::Call::Make(Float(32, node->type().lanes()),
+                              node->name,
+                              read_args,
+                              node->write_args,
+                              node->call_type,
+                              node->func,
+                              node->value_index,
+                              node->attrs);
+    *expr = RoundTo(node->type(), res);
+  }
+};
+
+}  // namespace
+
+void PromoteLowPrecision(Expr* e, Target target) {
+  if (target.arch == Target::Arch::X86) {
+    Mutator mutator;
+    mutator.Visit(e, e);
+  }
+}
+
+}  // namespace cinn::optim
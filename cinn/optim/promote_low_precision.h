@@ -0,0 +1,38 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "cinn/common/target.h"
+#include "cinn/ir/ir.h"
+
+namespace cinn::optim {
+
+/**
+ * Compute the float16 and bfloat16 arithmetic in float32 on cpu, the low precision types are only used as the storage
+ * types of buffers.
+ *
+ * e.g.
+ *
+ * The expression (A, B and C are bfloat16 buffers):
+ * C[i] = A[i] * B[i] + 1
+ *
+ * to
+ *
+ * C[i] = bfloat16(float32(A[i]) * float32(B[i]) + 1.0f)
+ *
+ * The intermediate values of an expression are kept in float32, only the value stored to memory is rounded.
+ */
+void PromoteLowPrecision(Expr* e, Target target);
+
+}  // namespace cinn::optim
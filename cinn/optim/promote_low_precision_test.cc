@@ -0,0 +1,62 @@
+// Copyright (c) 2022 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/optim/promote_low_precision.h"
+
+#include <gtest/gtest.h>
+
+#include "cinn/ir/ir_operators.h"
+#include "cinn/ir/ir_printer.h"
+
+namespace cinn::optim {
+
+TEST(PromoteLowPrecision, bfloat16) {
+  Var a("a", common::BF16());
+  Var b("b", common::BF16());
+  Expr e = ir::Add::Make(ir::Mul::Make(a, b), a);
+  PromoteLowPrecision(&e, common::DefaultHostTarget());
+  LOG(INFO) << e;
+
+  // the result is rounded once, the intermediate product stays in float32
+  auto* cast = e.As<ir::Cast>();
+  ASSERT_TRUE(cast);
+  ASSERT_EQ(e.type(), common::BF16());
+  auto* add = cast->v().As<ir::Add>();
+  ASSERT_TRUE(add);
+  ASSERT_EQ(add->type(), Float(32));
+  ASSERT_TRUE(add->a().As<ir::Mul>());
+  ASSERT_EQ(add->a().type(), Float(32));
+}
+
+TEST(PromoteLowPrecision, float16_compare) {
+  Var a("a", common::F16());
+  Expr e = ir::LT::Make(a, ir::Cast::Make(common::F16(), Expr(1.f)));
+  PromoteLowPrecision(&e, common::DefaultHostTarget());
+  LOG(INFO) << e;
+
+  auto* lt = e.As<ir::LT>();
+  ASSERT_TRUE(lt);
+  ASSERT_TRUE(e.type().is_bool());
+  ASSERT_EQ(lt->a().type(), Float(32));
+  ASSERT_EQ(lt->b().type(), Float(32));
+}
+
+TEST(PromoteLowPrecision, float32_unchanged) {
+  Var a("a", Float(32));
+  Expr e = ir::Add::Make(a, a);
+  PromoteLowPrecision(&e, common::DefaultHostTarget());
+  ASSERT_TRUE(e.As<ir::Add>());
+}
+
+}  // namespace cinn::optim
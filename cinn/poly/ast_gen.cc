@@ -14,12 +14,19 @@
 
 #include "cinn/poly/ast_gen.h"
 
+#include <absl/container/flat_hash_map.h>
+#include <gflags/gflags.h>
 #include <llvm/Support/FormatVariadic.h>
 
+#include <algorithm>
+#include <chrono>
 #include <utility>
 
 #include "cinn/common/common.h"
 #include "cinn/ir/ir.h"
+#include "cinn/utils/string.h"
+
+DECLARE_bool(cinn_isl_ast_cache);
 
 namespace cinn {
 namespace poly {
@@ -49,11 +56,22 @@ struct AstGen::Impl {
   //! Get the polyhedral stages.
   const std::vector<Shared<Stage>>& stages() const { return stages_; }
 
+  //! Get the name of the statement \p name in the schedules and the AST built.
+  const std::string& CanonicalName(const std::string& name) const;
+  //! Rename the tuples of \p set and \p map to their canonical names.
+  isl::set Canonicalize(isl::set set) const;
+  isl::map Canonicalize(isl::map map) const;
+
+  //! Collect the schedules of the statements in the group, cached with the AST.
+  std::map<std::string, isl::map> CollectScheduleMap() const;
+
  private:
   isl::set context_;
   std::vector<Shared<Stage>> stages_;
   const poly::ScheduleGroup& schedule_group_;
   std::vector<std::string> iterator_names_;
+  //! statement name -> the canonical name it has in the schedules and the AST, empty if not renamed.
+  std::map<std::string, std::string> canonical_names_;
   //! tuple name -> { axis -> isl_ast }
   std::map<std::string, std::map<std::string, isl::ast_expr>> transformed_indice_map_;
   isl::union_map build_options_;
@@ -63,11 +81,31 @@ struct AstGen::Impl {
 
 isl::union_set AstGen::Impl::domain() {
   CHECK(!stages_.empty());
-  auto sets =
-      utils::Map<std::vector<Shared<Stage>>, isl::set>(stages_, [](const Shared<Stage>& e) { return e->domain(); });
+  auto sets = utils::Map<std::vector<Shared<Stage>>, isl::set>(
+      stages_, [this](const Shared<Stage>& e) { return Canonicalize(e->domain()); });
   return isl_sets_to_union_set(sets);
 }
 
+const std::string& AstGen::Impl::CanonicalName(const std::string& name) const {
+  auto it = canonical_names_.find(name);
+  return it == canonical_names_.end() ? name : it->second;
+}
+
+isl::set AstGen::Impl::Canonicalize(isl::set set) const {
+  if (!isl_set_has_tuple_name(set.get())) return set;
+  auto& name = CanonicalName(isl_set_get_tuple_name(set.get()));
+  return isl::manage(isl_set_set_tuple_name(set.release(), name.c_str()));
+}
+
+isl::map AstGen::Impl::Canonicalize(isl::map map) const {
+  for (auto type : {isl_dim_in, isl_dim_out}) {
+    if (!isl_map_has_tuple_name(map.get(), type)) continue;
+    auto& name = CanonicalName(isl_map_get_tuple_name(map.get(), type));
+    map        = isl::manage(isl_map_set_tuple_name(map.release(), type, name.c_str()));
+  }
+  return map;
+}
+
 isl::ctx AstGen::ctx() const { return impl_->ctx(); }
 
 isl::ctx AstGen::Impl::ctx() const {
@@ -132,17 +170,116 @@ isl::union_set TransIdentityExtentToContextId(isl::union_set set) {
   return isl_union_set_from_sets(sets);
 }
 
+namespace {
+
+struct AstCacheEntry {
+  isl::ast_node ast;
+  std::map<std::string, std::map<std::string, isl::ast_expr>> transformed_indice_map;
+};
+
+//! The isl objects belong to the thread local isl ctx, so does the cache.
+struct AstCache {
+  // Drop all the entries once the cache grows over this size, a lowering rarely has this many distinct stages.
+  static constexpr size_t kMaxEntries = 4096;
+
+  absl::flat_hash_map<std::string, AstCacheEntry> entries;
+  absl::flat_hash_map<std::string, std::map<std::string, isl::map>> schedule_maps;
+  AstGenCacheStats stats;
+};
+
+AstCache& GetAstCache() {
+  static thread_local AstCache cache;
+  return cache;
+}
+
+}  // namespace
+
+std::map<std::string, isl::map> AstGen::Impl::CollectScheduleMap() const {
+  if (canonical_names_.empty()) return CollectScheduleMapFromGroup(schedule_group_);
+
+  // The schedules only depend on the transforms, the compute_at relations and the control dependencies of the stages
+  // in the group, in their order.
+  std::string key;
+  for (auto& node : schedule_group_.nodes) {
+    key += utils::GetStreamCnt(Canonicalize(node->stage->transform()));
+    for (auto& compute_at : node->stage->compute_ats()) {
+      key += llvm::formatv(" at {0}:{1}", CanonicalName(compute_at.stage->id()), compute_at.level).str();
+    }
+    std::vector<std::string> depends;
+    for (auto& depend : node->stage->ctrl_depends()) {
+      // the dependencies out of the group are not scheduled.
+      if (canonical_names_.count(depend->name)) depends.push_back(CanonicalName(depend->name));
+    }
+    std::sort(depends.begin(), depends.end());
+    key += " after " + utils::Join(depends, ",") + ";";
+  }
+
+  auto& cache = GetAstCache();
+  auto it     = cache.schedule_maps.find(key);
+  if (it != cache.schedule_maps.end()) {
+    cache.stats.schedule_hits++;
+    return it->second;
+  }
+  cache.stats.schedule_misses++;
+  std::map<std::string, isl::map> schedule_map;
+  for (auto& item : CollectScheduleMapFromGroup(schedule_group_)) {
+    schedule_map[CanonicalName(item.first)] = Canonicalize(item.second);
+  }
+  if (cache.schedule_maps.size() >= AstCache::kMaxEntries) cache.schedule_maps.clear();
+  cache.schedule_maps[key] = schedule_map;
+  return schedule_map;
+}
+
 isl::ast_node AstGen::Build() {
+  // Rename the statements by their order in the group when caching, so that the groups differing only by the tensor
+  // names, like the repeated layers of a model, share the cached schedules and AST.
+  impl_->canonical_names_.clear();
+  if (FLAGS_cinn_isl_ast_cache) {
+    for (int i = 0; i < impl_->schedule_group_.nodes.size(); i++) {
+      impl_->canonical_names_.emplace(impl_->schedule_group_.nodes[i]->stage->id(), "_cinn_s" + std::to_string(i));
+    }
+  }
+
   // Collect schedule from scheduler.
-  auto schedule_map = CollectScheduleMapFromGroup(impl_->schedule_group_);
+  auto schedule_map = impl_->CollectScheduleMap();
   std::vector<isl::map> maps;
   for (auto& stage : impl_->stages_) {
-    auto it = schedule_map.find(stage->id());
+    auto it = schedule_map.find(impl_->CanonicalName(stage->id()));
     CHECK(it != std::end(schedule_map)) << "stage " << stage->id() << " not found in the map";
     maps.push_back(it->second);
   }
   auto schedule = isl_maps_to_union_map(maps);
 
+  isl::union_map transformed_schedule = impl_->transform().apply_range(schedule);
+  VLOG(4) << "transformed_schedule: " << transformed_schedule;
+  auto schedule_domain = transformed_schedule.intersect_domain(impl_->domain());
+  VLOG(4) << "domain: " << impl_->domain();
+  VLOG(4) << "transform schedule " << impl_->stages()[0]->transform();
+  VLOG(4) << "schedule: " << schedule;
+  VLOG(4) << "schedule_domain: " << schedule_domain;
+
+  auto iterator_names =
+      impl_->iterator_names_.empty() ? impl_->schedule_group_.dimension_names : impl_->iterator_names_;
+  iterator_names = SchedulerBase::WrapIteratorNames(iterator_names);
+
+  // The AST only depends on the scheduled domain, the context, the build options and the iterator names.
+  std::string cache_key;
+  auto& cache = GetAstCache();
+  if (FLAGS_cinn_isl_ast_cache) {
+    cache_key = utils::GetStreamCnt(schedule_domain) + ";" + utils::GetStreamCnt(impl_->context_) + ";" +
+                (impl_->build_options_.is_null() ? "" : utils::GetStreamCnt(impl_->build_options_)) + ";" +
+                utils::Join(iterator_names, ",");
+    auto it = cache.entries.find(cache_key);
+    if (it != cache.entries.end()) {
+      cache.stats.hits++;
+      impl_->transformed_indice_map_ = it->second.transformed_indice_map;
+      VLOG(3) << "Reuse the cached isl AST";
+      return it->second.ast;
+    }
+    cache.stats.misses++;
+  }
+  auto start = std::chrono::steady_clock::now();
+
   // Build it.
   auto ast_build = isl::ast_build::from_context(impl_->context_);
 
@@ -150,9 +287,6 @@ isl::ast_node AstGen::Build() {
     ast_build = isl::manage(isl_ast_build_set_options(ast_build.release(), impl_->build_options_.release()));
 
   // Set iterators names for readable code.
-  auto iterator_names =
-      impl_->iterator_names_.empty() ? impl_->schedule_group_.dimension_names : impl_->iterator_names_;
-  iterator_names   = SchedulerBase::WrapIteratorNames(iterator_names);
   isl::id_list ids = isl::manage(isl_id_list_alloc(ctx().get(), iterator_names.size()));
   for (int i = 0; i < iterator_names.size(); i++) {
     ids = isl::manage(isl_id_list_add(ids.release(), isl_id_alloc(ctx().get(), iterator_names[i].c_str(), nullptr)));
@@ -161,10 +295,11 @@ isl::ast_node AstGen::Build() {
 
   // collect iterator map
   auto get_domain_by_name = [this](const std::string& name) -> isl::set {
-    auto ele_it = std::find_if(
-        impl_->stages_.begin(), impl_->stages_.end(), [&name](const Shared<Stage>& ele) { return ele->id() == name; });
+    auto ele_it = std::find_if(impl_->stages_.begin(), impl_->stages_.end(), [&](const Shared<Stage>& ele) {
+      return impl_->CanonicalName(ele->id()) == name;
+    });
     CHECK(ele_it != std::end(impl_->stages_));
-    return (*ele_it)->domain();
+    return impl_->Canonicalize((*ele_it)->domain());
   };
 
   auto collect = [&](isl::ast_node node, isl::ast_build build) -> isl::ast_node {
@@ -176,18 +311,27 @@ isl::ast_node AstGen::Build() {
 
   ast_build = ast_build.set_at_each_domain(collect);
 
-  isl::union_map transformed_schedule = impl_->transform().apply_range(schedule);
-  VLOG(4) << "transformed_schedule: " << transformed_schedule;
-  auto schedule_domain = transformed_schedule.intersect_domain(impl_->domain());
-  VLOG(4) << "domain: " << impl_->domain();
-  VLOG(4) << "transform schedule " << impl_->stages()[0]->transform();
-  VLOG(4) << "schedule: " << schedule;
-  VLOG(4) << "schedule_domain: " << schedule_domain;
   auto ast = ast_build.node_from_schedule_map(schedule_domain);
   VLOG(2) << "AST:\n" << isl_ast_node_to_C_str(ast.get());
+
+  if (FLAGS_cinn_isl_ast_cache) {
+    cache.stats.build_ms +=
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (cache.entries.size() >= AstCache::kMaxEntries) cache.entries.clear();
+    cache.entries[cache_key] = AstCacheEntry{ast, impl_->transformed_indice_map_};
+  }
   return ast;
 }
 
+const AstGenCacheStats& AstGen::cache_stats() { return GetAstCache().stats; }
+
+void AstGen::ClearCache() {
+  auto& cache = GetAstCache();
+  cache.entries.clear();
+  cache.schedule_maps.clear();
+  cache.stats = AstGenCacheStats();
+}
+
 AstGen& AstGen::SetIteratorNames(const std::vector<std::string>& names) {
   impl_->iterator_names_ = names;
   return *this;
@@ -219,7 +363,7 @@ std::map<std::string, isl::ast_expr> AstGen::Impl::ExtractIslTransformedIndiceMa
 }
 
 const std::map<std::string, isl::ast_expr>& AstGen::axis2ast(const std::string& tuple_name) const {
-  auto it = impl_->transformed_indice_map_.find(tuple_name);
+  auto it = impl_->transformed_indice_map_.find(impl_->CanonicalName(tuple_name));
   CHECK(it != impl_->transformed_indice_map_.end()) << "no id " << tuple_name;
   return it->second;
 }
@@ -262,7 +406,7 @@ isl::ast_expr CreateIslAstIndexExpression(isl_ast_build* build, const isl::map&
 isl::union_map AstGen::Impl::transform() {
   std::vector<isl::map> transforms;
   for (auto& stage : stages()) {
-    transforms.push_back(stage->transform());
+    transforms.push_back(Canonicalize(stage->transform()));
   }
   return isl_maps_to_union_map(transforms);
 }
@@ -526,7 +670,10 @@ AstGen::AstGen(const isl::set& context, const std::vector<Stage*>& stages, const
   impl_->InitIslAstConfig();
 }
 void AstGen::SetBuildOptions(const isl::union_map& options) { impl_->build_options_ = options; }
-bool AstGen::ContainsStatement(const std::string& name) const { return impl_->transformed_indice_map_.count(name); }
+bool AstGen::ContainsStatement(const std::string& name) const {
+  return impl_->transformed_indice_map_.count(impl_->CanonicalName(name));
+}
+std::string AstGen::StatementName(const std::string& name) const { return impl_->CanonicalName(name); }
 
 AstGen::~AstGen() {}
 
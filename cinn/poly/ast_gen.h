@@ -35,8 +35,25 @@ namespace poly {
 
 static const char* kIslParamConstPrefix = "_const_";
 
+//! The statistics of the isl AST cache of AstGen on the current thread.
+struct AstGenCacheStats {
+  int64_t hits{};
+  int64_t misses{};
+  //! The time spent in building the ASTs of the misses, in milliseconds.
+  double build_ms{};
+  //! The lookups of the schedules of the groups.
+  int64_t schedule_hits{};
+  int64_t schedule_misses{};
+};
+
 /**
  * Generate IR from polyhedral schedule.
+ *
+ * The schedules and the ASTs built are cached on the current thread (the isl ctx is thread local), keyed by the
+ * canonical string of the scheduled domain together with the context, the build options and the iterator names, so an
+ * identical stage lowered again reuses the AST instead of running the isl code generation. The statements are renamed
+ * by their order in the group before, so the stages differing only by the tensor names hit too, and the AST refers to
+ * a statement by StatementName. It is controlled by FLAGS_cinn_isl_ast_cache.
  */
 class AstGen {
  public:
@@ -61,8 +78,15 @@ class AstGen {
 
   bool ContainsStatement(const std::string& name) const;
 
+  //! Get the name of the statement \p name in the AST built.
+  std::string StatementName(const std::string& name) const;
+
   void SetBuildOptions(const isl::union_map& options);
 
+  static const AstGenCacheStats& cache_stats();
+  //! Drop the cached ASTs and schedule maps, and reset the statistics.
+  static void ClearCache();
+
  private:
   class Impl;
   std::unique_ptr<Impl> impl_;
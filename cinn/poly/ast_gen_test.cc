@@ -14,10 +14,19 @@
 
 #include "cinn/poly/ast_gen.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+
+#include "cinn/cinn.h"
 #include "cinn/ir/ir.h"
 #include "cinn/ir/ir_printer.h"
+#include "cinn/lang/compute.h"
+#include "cinn/lang/lower.h"
+#include "cinn/lang/placeholder.h"
+
+DECLARE_bool(cinn_isl_ast_cache);
 
 namespace cinn {
 namespace poly {
@@ -40,5 +49,48 @@ TEST(TransIdentityExtentToContextId, basic1) {
   LOG(INFO) << new_set;
 }
 
+ir::LoweredFunc LowerTiledMatmul(const std::string& prefix = "") {
+  Expr M(64), N(64), K(32);
+  lang::Placeholder<float> A(prefix + "A", {M, K});
+  lang::Placeholder<float> B(prefix + "B", {K, N});
+  Var k(K.as_int32(), "k0");
+  auto C = lang::Compute(
+      {M, N}, [&](Var i, Var j) { return lang::ReduceSum(A(i, k) * B(k, j), {k}); }, prefix + "C");
+  auto stages = CreateStages({C});
+  stages[C]->Tile(0, 1, 8, 8);
+  return lang::Lower(prefix + "matmul", stages, {A, B, C});
+}
+
+TEST(AstGen, cache) {
+  AstGen::ClearCache();
+
+  auto lower_time = [](int repeats) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) LowerTiledMatmul();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / repeats;
+  };
+
+  auto func0 = LowerTiledMatmul();
+  ASSERT_EQ(AstGen::cache_stats().misses, 1);
+  ASSERT_EQ(AstGen::cache_stats().hits, 0);
+  auto func1 = LowerTiledMatmul();
+  ASSERT_EQ(AstGen::cache_stats().hits, 1);
+  // The cached AST lowers to the same code.
+  ASSERT_EQ(utils::GetStreamCnt(func0->body), utils::GetStreamCnt(func1->body));
+  // The same computation of other tensors, like another layer of a model, reuses the schedules and the AST too.
+  auto func2 = LowerTiledMatmul("layer1_");
+  ASSERT_EQ(AstGen::cache_stats().hits, 2);
+  ASSERT_EQ(AstGen::cache_stats().schedule_misses, 1);
+  ASSERT_EQ(AstGen::cache_stats().schedule_hits, 2);
+  ASSERT_NE(utils::GetStreamCnt(func2->body).find("layer1_C"), std::string::npos);
+
+  const int repeats = 20;
+  double cached_ms  = lower_time(repeats);
+  FLAGS_cinn_isl_ast_cache = false;
+  double uncached_ms       = lower_time(repeats);
+  FLAGS_cinn_isl_ast_cache = true;
+  LOG(INFO) << "Lowering takes " << uncached_ms << " ms without the isl AST cache, " << cached_ms << " ms with it";
+}
+
 }  // namespace poly
 }  // namespace cinn
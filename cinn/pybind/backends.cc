@@ -29,16 +29,35 @@ namespace cinn::pybind {
 using backends::Compiler;
 using backends::ExecutionEngine;
 using backends::ExecutionOptions;
+using backends::OptimizeOptions;
 
 namespace {
 
 void BindExecutionEngine(py::module *);
 
 void BindExecutionEngine(py::module *m) {
+  py::class_<OptimizeOptions> optimize_options(*m, "OptimizeOptions");
+  optimize_options.def(py::init<>())
+      .def_readwrite("use_new_pass_manager", &OptimizeOptions::use_new_pass_manager)
+      .def_readwrite("loop_vectorize", &OptimizeOptions::loop_vectorize)
+      .def_readwrite("slp_vectorize", &OptimizeOptions::slp_vectorize)
+      .def_readwrite("unroll_loops", &OptimizeOptions::unroll_loops)
+      .def_readwrite("unroll_threshold", &OptimizeOptions::unroll_threshold)
+      .def_readwrite("inline_threshold", &OptimizeOptions::inline_threshold)
+      .def_property(
+          "fast_math",
+          [](const OptimizeOptions &self) { return self.fast_math_flags.isFast(); },
+          [](OptimizeOptions &self, bool fast_math) { self.fast_math_flags.setFast(fast_math); })
+      .def_readwrite("tune_per_function", &OptimizeOptions::tune_per_function)
+      .def_readwrite("tiny_function_size", &OptimizeOptions::tiny_function_size);
+
   py::class_<ExecutionOptions> options(*m, "ExecutionOptions");
   options.def(py::init<>())
       .def_readwrite("opt_level", &ExecutionOptions::opt_level)
-      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info);
+      .def_readwrite("enable_debug_info", &ExecutionOptions::enable_debug_info)
+      .def_readwrite("optimize_options", &ExecutionOptions::optimize_options)
+      .def_readwrite("cpu", &ExecutionOptions::cpu)
+      .def_readwrite("features", &ExecutionOptions::features);
 
   auto lookup = [](ExecutionEngine &self, absl::string_view name) {
     auto *function_ptr    = reinterpret_cast<void (*)(void **, int32_t)>(self.Lookup(name));
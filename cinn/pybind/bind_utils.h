@@ -16,7 +16,9 @@
 
 #include <pybind11/pybind11.h>
 
+#include <memory>
 #include <string>
+#include <utility>
 
 #include "cinn/common/cinn_value.h"
 #include "cinn/common/shared.h"
@@ -30,6 +32,29 @@
 namespace py = pybind11;
 
 namespace cinn::pybind {
+
+//! Get the numpy dtype of \p type, a TypeError is raised for the types numpy has no dtype of, such as bfloat16.
+inline py::dtype NumpyDtype(const common::Type &type) {
+  if (type.is_bfloat16()) {
+    throw py::type_error("numpy has no dtype of bfloat16, the bfloat16 tensors can not be converted to numpy arrays");
+  }
+  std::string name = common::Type2Str(type);
+  try {
+    return py::dtype(name);
+  } catch (py::error_already_set &e) {
+    throw py::type_error("numpy has no dtype of " + name + ", the " + name +
+                         " tensors can not be converted to numpy arrays: " + e.what());
+  }
+}
+
+//! Keep \p obj alive until the returned holder is released, the GIL is taken since it may be released by any thread.
+inline std::shared_ptr<void> HoldPyObject(py::object obj) {
+  return std::shared_ptr<void>(new py::object(std::move(obj)), [](void *p) {
+    py::gil_scoped_acquire gil;
+    delete static_cast<py::object *>(p);
+  });
+}
+
 using common::CINNValue;
 using common::Shared;
 using common::Type;
@@ -126,6 +126,7 @@ void BindType(py::module *m) {
       .value("int", Type::type_t::Int)
       .value("uInt", Type::type_t::UInt)
       .value("float", Type::type_t::Float)
+      .value("bfloat", Type::type_t::BFloat)
       .value("string", Type::type_t::String)
       .value("void", Type::type_t::Void)
       .value("customized", Type::type_t::Customized)
@@ -142,6 +143,7 @@ void BindType(py::module *m) {
       .def("Int", &common::Int, py::arg("bits"), py::arg("lanes") = 1)
       .def("UInt", &common::UInt, py::arg("bits"), py::arg("lanes") = 1)
       .def("Float", &common::Float, py::arg("bits"), py::arg("lanes") = 1)
+      .def("BFloat", &common::BFloat, py::arg("bits"), py::arg("lanes") = 1)
       .def("Bool", &common::Bool, py::arg("lanes") = 1)
       .def("String", &common::String);
 
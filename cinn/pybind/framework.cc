@@ -25,6 +25,7 @@
 #include "cinn/hlir/framework/scope.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/pybind/bind.h"
+#include "cinn/pybind/bind_utils.h"
 
 namespace cinn::pybind {
 
@@ -96,7 +97,7 @@ void BindFramework(pybind11::module *m) {
       .def("get_tensor",
            [](Scope &self, const std::string &name, const Target &target) {
              auto t = self.GetTensor(name);
-             py::dtype dt(common::Type2Str(t->type()));
+             py::dtype dt = NumpyDtype(t->type());
              py::array::ShapeContainer shape(t->shape().data().begin(), t->shape().data().end());
              py::array array(std::move(dt), std::move(shape));
              auto *mutable_data = array.mutable_data();
@@ -119,13 +120,33 @@ void BindFramework(pybind11::module *m) {
       .def("var_names", &Scope::var_names);
 
   py::class_<common::Shared<hlir::framework::_Tensor_>>(*m, "SharedTensor");
-  py::class_<Tensor, common::Shared<hlir::framework::_Tensor_>>(*m, "Tensor")
+  // the tensors in the host memory expose it by the buffer protocol, so numpy.asarray(tensor) aliases it without copy.
+  py::class_<Tensor, common::Shared<hlir::framework::_Tensor_>>(*m, "Tensor", py::buffer_protocol())
       .def(py::init<>())
+      .def_buffer([](hlir::framework::Tensor &self) {
+        CHECK(self->buffer()->memory) << "The tensor has no memory to expose";
+        CHECK(self->get_buffer()->target().arch != Target::Arch::NVGPU)
+            << "Only the tensors in the host memory support the buffer protocol, use numpy(target) to copy it";
+        py::dtype dt = NumpyDtype(self->type());
+        std::vector<py::ssize_t> shape(self->shape().data().begin(), self->shape().data().end());
+        std::vector<py::ssize_t> strides(shape.size());
+        py::ssize_t stride = dt.itemsize();
+        for (int i = static_cast<int>(shape.size()) - 1; i >= 0; --i) {
+          strides[i] = stride;
+          stride *= shape[i];
+        }
+        return py::buffer_info(self->buffer()->memory,
+                               dt.itemsize(),
+                               py::str(dt.attr("char")),
+                               static_cast<py::ssize_t>(shape.size()),
+                               shape,
+                               strides);
+      })
       .def("shape", [](hlir::framework::Tensor &self) { return self->shape().data(); })
       .def("set_type", [](hlir::framework::Tensor &self, Type type) { self->set_type(type); })
       .def("numpy",
            [](hlir::framework::Tensor &self, const common::Target &target) {
-             py::dtype dt(common::Type2Str(self->type()));
+             py::dtype dt = NumpyDtype(self->type());
              py::array::ShapeContainer shape(self->shape().data().begin(), self->shape().data().end());
              py::array array(std::move(dt), std::move(shape));
              void *array_data = array.mutable_data();
@@ -146,7 +167,7 @@ void BindFramework(pybind11::module *m) {
              return array;
            })
       .def("from_numpy", [](hlir::framework::Tensor &self, py::array array, const common::Target &target) {
-        CHECK(array.dtype().is(py::dtype(common::Type2Str(self->type()))))
+        CHECK(array.dtype().is(NumpyDtype(self->type())))
             << "currently only support float32 data type as input";
         hlir::framework::shape_t shape;
         std::copy_n(array.shape(), array.ndim(), std::back_inserter(shape));
@@ -167,6 +188,19 @@ void BindFramework(pybind11::module *m) {
         } else {
           CINN_NOT_IMPLEMENTED
         }
-      });
+      })
+      .def(
+          "share_numpy",
+          [](hlir::framework::Tensor &self, py::array array, const common::Target &target) {
+            CHECK(target.arch == Target::Arch::X86) << "Only the host tensors can share the memory of a numpy array";
+            CHECK(array.dtype().is(NumpyDtype(self->type())))
+                << "The dtype of the array should be " << common::Type2Str(self->type());
+            CHECK(array.flags() & py::array::c_style) << "The array should be C contiguous";
+            CHECK_EQ(array.size(), self->shape().numel());
+            // the array is kept alive by the tensor until it is rebound or destroyed.
+            self->ShareExternalData(array.mutable_data(), target, self->type(), HoldPyObject(array));
+          },
+          py::arg("array"),
+          py::arg("target"));
 }
 }  // namespace cinn::pybind
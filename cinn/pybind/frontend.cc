@@ -33,6 +33,7 @@
 #include "cinn/hlir/framework/tensor.h"
 #include "cinn/hlir/op/use_ops.h"
 #include "cinn/pybind/bind.h"
+#include "cinn/pybind/bind_utils.h"
 #include "cinn/utils/string.h"
 #include "cinn/utils/timer.h"
 
@@ -304,6 +305,8 @@ void BindFrontend(pybind11::module *m) {
            py::arg("target"),
            py::arg("params_combined"),
            py::arg("model_name") = "")
+      .def("set_batch_buckets", &frontend::Interpreter::SetBatchBuckets, py::arg("buckets"))
+      .def("set_batch_size", &frontend::Interpreter::SetBatchSize, py::arg("batch_size"))
       .def("run", &frontend::Interpreter::Run)
       .def("get_tensor", &frontend::Interpreter::GetTensor)
       .def("scope", &frontend::Interpreter::scope);
@@ -514,6 +517,12 @@ void BindFrontend(pybind11::module *m) {
            py::arg("bias")             = 0.0f,
            py::arg("bias_after_scale") = true)
       .def("softmax", &NetBuilder::Softmax, py::arg("a"), py::arg("axis") = -1, py::arg("data_format") = "AnyLayout")
+      .def("fused_attention",
+           &NetBuilder::FusedAttention,
+           py::arg("q"),
+           py::arg("k"),
+           py::arg("v"),
+           py::arg("scale") = 1.0f)
       .def("dropout_infer",
            &NetBuilder::DropoutInfer,
            py::arg("a"),
@@ -530,7 +539,35 @@ void BindFrontend(pybind11::module *m) {
            py::arg("groups")            = 1,
            py::arg("data_format")       = "NCHW",
            py::arg("padding_algorithm") = "EXPLICIT")
-      .def("sum", &NetBuilder::Sum, py::arg("inputs"));
+      .def("sum", &NetBuilder::Sum, py::arg("inputs"))
+      .def("quantize",
+           &NetBuilder::Quantize,
+           py::arg("x"),
+           py::arg("scale"),
+           py::arg("axis")       = -1,
+           py::arg("zero_point") = 0)
+      .def("dequantize",
+           &NetBuilder::Dequantize,
+           py::arg("x"),
+           py::arg("scale"),
+           py::arg("axis")       = -1,
+           py::arg("zero_point") = 0)
+      .def("requantize",
+           &NetBuilder::Requantize,
+           py::arg("x"),
+           py::arg("in_scale"),
+           py::arg("out_scale"),
+           py::arg("axis")       = -1,
+           py::arg("zero_point") = 0)
+      .def("quantized_matmul", &NetBuilder::QuantizedMatmul, py::arg("x"), py::arg("y"))
+      .def("quantized_conv2d",
+           &NetBuilder::QuantizedConv2d,
+           py::arg("x"),
+           py::arg("w"),
+           py::arg("strides")   = std::vector<int>{1, 1},
+           py::arg("paddings")  = std::vector<int>{0, 0},
+           py::arg("dilations") = std::vector<int>{1, 1})
+      .def("cast", &NetBuilder::Cast, py::arg("x"), py::arg("dtype"));
 
   py::class_<CinnBuilder, BaseBuilder>(*m, "CinnBuilder")
       .def(py::init<const std::string &>(), py::arg("name") = "")
@@ -603,6 +640,20 @@ void BindFrontend(pybind11::module *m) {
           py::arg("options") = CinnComputation::DefaultCompileOptions())
       .def("get_all_tensor_names", &CinnComputation::GetAllTensorNames)
       .def("get_tensor", &CinnComputation::GetTensor)
+      // binds the array as the memory of the tensor without copy, the array is kept alive by the tensor.
+      .def(
+          "bind_tensor_data",
+          [](CinnComputation &self, const std::string &name, py::array array) {
+            CHECK(self.GetTarget().arch == Target::Arch::X86)
+                << "Only the computations on host can bind a numpy array, use get_tensor(name).from_numpy to copy it";
+            auto t = self.GetTensor(name);
+            CHECK(array.dtype().is(NumpyDtype(t->type())))
+                << "The dtype of the array should be " << common::Type2Str(t->type());
+            CHECK(array.flags() & py::array::c_style) << "The array should be C contiguous";
+            self.BindTensorData(t, array.mutable_data(), array.nbytes(), HoldPyObject(array));
+          },
+          py::arg("name"),
+          py::arg("array"))
       .def("execute", [](CinnComputation &self) { self.Execute(); });
 
 }  // namespace frontend
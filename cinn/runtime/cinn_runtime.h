@@ -45,7 +45,8 @@ typedef enum cinn_type_code_t {
   cinn_type_int    = 0,   //! signed int
   cinn_type_uint   = 1,   //! unsigned int
   cinn_type_float  = 2,   //! floating point
-  cinn_type_handle = 3    //! void*
+  cinn_type_handle = 3,   //! void*
+  cinn_type_bfloat = 4    //! brain floating point
 } cinn_type_code_t;
 
 #ifndef CINN_ATTRIBUTE_ALIGN
@@ -92,6 +93,8 @@ extern cinn_type_t cinn_int32_t(int num_asterisks = 0);
 extern cinn_type_t cinn_int64_t(int num_asterisks = 0);
 extern cinn_type_t cinn_uint32_t(int num_asterisks = 0);
 extern cinn_type_t cinn_uint64_t(int num_asterisks = 0);
+extern cinn_type_t cinn_float16_t(int num_asterisks = 0);
+extern cinn_type_t cinn_bfloat16_t(int num_asterisks = 0);
 extern cinn_type_t cinn_float32_t(int num_asterisks = 0);
 extern cinn_type_t cinn_float64_t(int num_asterisks = 0);
 // @}
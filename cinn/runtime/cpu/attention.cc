@@ -0,0 +1,179 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/attention.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "cinn/backends/extern_func_jit_register.h"
+
+namespace {
+
+//! The number of query rows computed by a task, and the number of keys whose scores are kept at a time.
+constexpr int kQueryBlock = 32;
+constexpr int kKeyBlock   = 128;
+//! The number of partial sums of a dot product, which the compiler keeps in a vector register.
+constexpr int kDotLanes = 8;
+
+inline float Dot(const float* x, const float* y, int size) {
+  float partial[kDotLanes] = {0.f};
+  int i                    = 0;
+  for (; i + kDotLanes <= size; i += kDotLanes) {
+    for (int l = 0; l < kDotLanes; l++) {
+      partial[l] += x[i + l] * y[i + l];
+    }
+  }
+  float sum = 0.f;
+  for (; i < size; i++) {
+    sum += x[i] * y[i];
+  }
+  for (int l = 0; l < kDotLanes; l++) {
+    sum += partial[l];
+  }
+  return sum;
+}
+
+/**
+ * Attend \p rows query rows of a head. For each block of keys, the scores of the rows are computed and exponentiated
+ * against the running max of the row, the output accumulated so far is rescaled when the max grows, and the block is
+ * added to it. The output is divided by the running sum of the exponentials at last.
+ */
+void AttendQueryBlock(const float* q,
+                      const float* k,
+                      const float* v,
+                      float* out,
+                      int rows,
+                      int seq_k,
+                      int head_dim,
+                      int value_dim,
+                      float scale) {
+  std::vector<float> scores(kKeyBlock);
+  std::vector<float> row_max(rows, -std::numeric_limits<float>::infinity());
+  std::vector<float> row_sum(rows, 0.f);
+  std::fill(out, out + rows * value_dim, 0.f);
+
+  for (int key_begin = 0; key_begin < seq_k; key_begin += kKeyBlock) {
+    int cols = std::min(kKeyBlock, seq_k - key_begin);
+    for (int i = 0; i < rows; i++) {
+      const float* qi = q + i * head_dim;
+      float block_max = -std::numeric_limits<float>::infinity();
+      for (int j = 0; j < cols; j++) {
+        scores[j] = Dot(qi, k + (key_begin + j) * head_dim, head_dim) * scale;
+        block_max = std::max(block_max, scores[j]);
+      }
+
+      float new_max    = std::max(row_max[i], block_max);
+      float correction = std::exp(row_max[i] - new_max);
+      float block_sum  = 0.f;
+      for (int j = 0; j < cols; j++) {
+        scores[j] = std::exp(scores[j] - new_max);
+        block_sum += scores[j];
+      }
+      row_sum[i] = row_sum[i] * correction + block_sum;
+      row_max[i] = new_max;
+
+      float* out_i = out + i * value_dim;
+      for (int d = 0; d < value_dim; d++) {
+        out_i[d] *= correction;
+      }
+      for (int j = 0; j < cols; j++) {
+        const float* vj = v + (key_begin + j) * value_dim;
+        float p         = scores[j];
+        for (int d = 0; d < value_dim; d++) {
+          out_i[d] += p * vj[d];
+        }
+      }
+    }
+  }
+
+  for (int i = 0; i < rows; i++) {
+    float inv_sum = 1.f / row_sum[i];
+    for (int d = 0; d < value_dim; d++) {
+      out[i * value_dim + d] *= inv_sum;
+    }
+  }
+}
+
+}  // namespace
+
+void cinn_cpu_fused_attention_fp32(int batch_size,
+                                   int seq_q,
+                                   int seq_k,
+                                   int head_dim,
+                                   int value_dim,
+                                   float scale,
+                                   cinn_buffer_t* Q,
+                                   cinn_buffer_t* K,
+                                   cinn_buffer_t* V,
+                                   cinn_buffer_t* Out) {
+  const float* q = reinterpret_cast<float*>(Q->memory);
+  const float* k = reinterpret_cast<float*>(K->memory);
+  const float* v = reinterpret_cast<float*>(V->memory);
+  float* out     = reinterpret_cast<float*>(Out->memory);
+
+  int query_blocks = (seq_q + kQueryBlock - 1) / kQueryBlock;
+  int num_tasks    = batch_size * query_blocks;
+#pragma omp parallel for schedule(static)
+  for (int task = 0; task < num_tasks; task++) {
+    int b           = task / query_blocks;
+    int query_begin = task % query_blocks * kQueryBlock;
+    int rows        = std::min(kQueryBlock, seq_q - query_begin);
+    AttendQueryBlock(q + (b * seq_q + query_begin) * head_dim,
+                     k + b * seq_k * head_dim,
+                     v + b * seq_k * value_dim,
+                     out + (b * seq_q + query_begin) * value_dim,
+                     rows,
+                     seq_k,
+                     head_dim,
+                     value_dim,
+                     scale);
+  }
+}
+
+CINN_REGISTER_HELPER(cinn_cpu_attention) {
+  using namespace cinn;  // NOLINT
+  using backends::FunctionProto;
+  auto host_target = common::DefaultHostTarget();
+
+  FunctionProto::shape_inference_t inference_shape_attention = [](const std::vector<Expr>& args, int offset) {
+    CHECK_EQ(offset, 0UL) << "Only one output";
+    CHECK_EQ(args.size(), 9UL) << "Wrong number of arguments passed in";
+    auto Q_tensor = args[6].as_tensor();
+    CHECK(Q_tensor);
+    // the leading dimensions of Q, with the last one replaced by value_dim.
+    std::vector<Expr> shape(Q_tensor->shape.begin(), Q_tensor->shape.end() - 1);
+    shape.push_back(args[4]);
+    return shape;
+  };
+
+  REGISTER_EXTERN_FUNC_HELPER(cinn_cpu_fused_attention_fp32, host_target)
+      .SetRetType<void>()
+      .AddInputType<int>()              // batch_size
+      .AddInputType<int>()              // seq_q
+      .AddInputType<int>()              // seq_k
+      .AddInputType<int>()              // head_dim
+      .AddInputType<int>()              // value_dim
+      .AddInputType<float>()            // scale
+      .AddInputType<cinn_buffer_t*>()   // Q
+      .AddInputType<cinn_buffer_t*>()   // K
+      .AddInputType<cinn_buffer_t*>()   // V
+      .AddOutputType<cinn_buffer_t*>()  // Out
+      .SetShapeInference(inference_shape_attention)
+      .End();
+
+  return true;
+}
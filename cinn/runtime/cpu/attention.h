@@ -0,0 +1,42 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+/**
+ * \file This file implements the fused attention on the host.
+ */
+#include "cinn/runtime/cinn_runtime.h"
+
+extern "C" {
+
+/**
+ * \brief Compute softmax(Q * K^T * scale) * V for each of the \p batch_size heads.
+ *
+ * Q is of shape [batch_size, seq_q, head_dim], K of [batch_size, seq_k, head_dim], V of [batch_size, seq_k, value_dim]
+ * and Out of [batch_size, seq_q, value_dim]. The query rows are split into blocks computed in parallel, each block
+ * visits the keys block by block with the online softmax, so the scores of only one block of keys are kept in cache
+ * instead of the whole seq_q x seq_k matrix.
+ */
+void cinn_cpu_fused_attention_fp32(int batch_size,
+                                   int seq_q,
+                                   int seq_k,
+                                   int head_dim,
+                                   int value_dim,
+                                   float scale,
+                                   cinn_buffer_t* Q,
+                                   cinn_buffer_t* K,
+                                   cinn_buffer_t* V,
+                                   cinn_buffer_t* Out);
+
+}  // extern "C"
@@ -0,0 +1,141 @@
+// Copyright (c) 2021 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cinn/runtime/cpu/attention.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "cinn/backends/llvm/simple_jit.h"
+#include "cinn/cinn.h"
+#include "cinn/common/target.h"
+#include "cinn/common/test_helper.h"
+#include "cinn/runtime/cpu/use_extern_funcs.h"
+
+namespace cinn {
+namespace runtime {
+namespace cpu {
+
+// softmax(Q * K^T * scale) * V computed with the whole score matrix.
+std::vector<float> NaiveAttention(const float* q,
+                                  const float* k,
+                                  const float* v,
+                                  int batch_size,
+                                  int seq_q,
+                                  int seq_k,
+                                  int head_dim,
+                                  int value_dim,
+                                  float scale) {
+  std::vector<float> out(batch_size * seq_q * value_dim, 0.f);
+  std::vector<float> scores(seq_k);
+  for (int b = 0; b < batch_size; b++) {
+    for (int i = 0; i < seq_q; i++) {
+      float max_score = -INFINITY;
+      for (int j = 0; j < seq_k; j++) {
+        float s = 0.f;
+        for (int d = 0; d < head_dim; d++) {
+          s += q[(b * seq_q + i) * head_dim + d] * k[(b * seq_k + j) * head_dim + d];
+        }
+        scores[j] = s * scale;
+        max_score = std::max(max_score, scores[j]);
+      }
+      float sum = 0.f;
+      for (int j = 0; j < seq_k; j++) {
+        scores[j] = std::exp(scores[j] - max_score);
+        sum += scores[j];
+      }
+      for (int j = 0; j < seq_k; j++) {
+        for (int d = 0; d < value_dim; d++) {
+          out[(b * seq_q + i) * value_dim + d] += scores[j] / sum * v[(b * seq_k + j) * value_dim + d];
+        }
+      }
+    }
+  }
+  return out;
+}
+
+TEST(cinn_cpu_fused_attention_fp32, basic) {
+  // The sequence lengths are not multiples of the query and key blocks.
+  const int batch_size = 3, seq_q = 45, seq_k = 300, head_dim = 20, value_dim = 12;
+  const float scale    = 1.f / std::sqrt(static_cast<float>(head_dim));
+
+  Expr B(batch_size), M(seq_q), N(seq_k), D(head_dim), E(value_dim);
+  Placeholder<float> Q("Q", {B, M, D});
+  Placeholder<float> K("K", {B, N, D});
+  Placeholder<float> V("V", {B, N, E});
+
+  auto call = Compute(
+      {Expr(1)},
+      [=]() -> Expr {
+        return lang::CallExtern("cinn_cpu_fused_attention_fp32",
+                                {
+                                    B,                           // batch_size
+                                    M,                           // seq_q
+                                    N,                           // seq_k
+                                    D,                           // head_dim
+                                    E,                           // value_dim
+                                    Expr(scale),                 // scale
+                                    Q.tensor(),                  // Q
+                                    K.tensor(),                  // K
+                                    V.tensor(),                  // V
+                                });
+      },
+      "extern_call");
+  auto out = call->TupleGet(0);
+  out->WithBuffer(Float(32));
+
+  auto stages = CreateStages({call, out});
+  ir::Module::Builder builder("module0", common::DefaultHostTarget());
+  auto func = Lower("fn", stages, {Q, K, V, out, call});
+  builder.AddFunction(func);
+  LOG(INFO) << "func:\n" << func;
+
+  auto jit = backends::SimpleJIT::Create();
+  jit->Link(builder.Build(), /*optimize=*/true);
+  auto fn_ptr = reinterpret_cast<void (*)(void*, int32_t)>(jit->Lookup("fn"));
+  CHECK(fn_ptr);
+
+  auto* Q_buf   = common::BufferBuilder(Float(32), {batch_size, seq_q, head_dim}).set_random().Build();
+  auto* K_buf   = common::BufferBuilder(Float(32), {batch_size, seq_k, head_dim}).set_random().Build();
+  auto* V_buf   = common::BufferBuilder(Float(32), {batch_size, seq_k, value_dim}).set_random().Build();
+  auto* out_buf = common::BufferBuilder(Float(32), {batch_size, seq_q, value_dim}).set_zero().Build();
+  auto args     = common::ArgsBuilder().Add(Q_buf).Add(K_buf).Add(V_buf).Add(out_buf).Build();
+  fn_ptr(args.data(), args.size());
+
+  auto expected = NaiveAttention(reinterpret_cast<float*>(Q_buf->memory),
+                                 reinterpret_cast<float*>(K_buf->memory),
+                                 reinterpret_cast<float*>(V_buf->memory),
+                                 batch_size,
+                                 seq_q,
+                                 seq_k,
+                                 head_dim,
+                                 value_dim,
+                                 scale);
+  auto* out_data = reinterpret_cast<float*>(out_buf->memory);
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(out_data[i], expected[i], 1e-4) << "at " << i;
+  }
+
+  cinn_buffer_free(nullptr, Q_buf);
+  cinn_buffer_free(nullptr, K_buf);
+  cinn_buffer_free(nullptr, V_buf);
+  cinn_buffer_free(nullptr, out_buf);
+}
+
+}  // namespace cpu
+}  // namespace runtime
+}  // namespace cinn
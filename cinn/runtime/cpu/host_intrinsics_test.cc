@@ -14,8 +14,14 @@
 
 #include "cinn/runtime/cpu/host_intrinsics.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <string>
+
 #include "cinn/backends/compiler.h"
 #include "cinn/backends/llvm/execution_engine.h"
 #include "cinn/backends/llvm/simple_jit.h"
@@ -24,6 +30,9 @@
 #include "cinn/common/target.h"
 #include "cinn/common/test_helper.h"
 #include "cinn/runtime/cpu/use_extern_funcs.h"
+#include "cinn/utils/timer.h"
+
+DECLARE_int32(cinn_approx_math_level);
 
 namespace cinn {
 namespace runtime {
@@ -65,6 +74,89 @@ TEST(tanh, basic) {
   }
 }
 
+namespace {
+
+/**
+ * Compile y = fn(x) over \p n floats with the innermost axis vectorized by 8 for each level of
+ * FLAGS_cinn_approx_math_level, check the max error against \p reference within the tolerance of the level and log
+ * the time of a call. The tolerance of level 2 is \p level2_tolerance.
+ */
+void TestApproxMath(const std::string& name,
+                    const std::function<Expr(Expr)>& fn,
+                    const std::function<float(float)>& reference,
+                    float low,
+                    float high,
+                    float level2_tolerance = 1e-3) {
+  const int n = 1 << 16;
+  Expr N(n);
+  Placeholder<float> x("x", {N});
+  auto y = Compute({N}, [&](Expr i) { return fn(x(i)); }, "y");
+
+  auto* x_buf   = common::BufferBuilder(Float(32), {n}).set_zero().Build();
+  auto* out_buf = common::BufferBuilder(Float(32), {n}).set_zero().Build();
+  auto* x_data  = reinterpret_cast<float*>(x_buf->memory);
+  auto* out     = reinterpret_cast<float*>(out_buf->memory);
+  for (int i = 0; i < n; i++) x_data[i] = low + (high - low) * i / n;
+  auto args = common::ArgsBuilder().Add(x_buf).Add(out_buf).Build();
+
+  const float tolerances[] = {1e-5, 1e-5, level2_tolerance};
+  for (int level = 0; level < 3; level++) {
+    FLAGS_cinn_approx_math_level = level;
+    auto stages                  = CreateStages({y});
+    stages[y]->Vectorize(0, 8);
+    std::string fn_name = name + "_level" + std::to_string(level);
+    auto func           = Lower(fn_name, stages, {x, y});
+
+    ir::Module::Builder builder("module_" + fn_name, common::DefaultHostTarget());
+    builder.AddFunction(func);
+    auto jit = backends::SimpleJIT::Create();
+    jit->Link(builder.Build());
+    auto fnp = reinterpret_cast<lower_func_ptr_t>(jit->Lookup(fn_name));
+    ASSERT_TRUE(fnp);
+
+    fnp(args.data(), args.size());
+    utils::Timer timer;
+    timer.Start();
+    const int repeat = 10;
+    for (int i = 0; i < repeat; i++) fnp(args.data(), args.size());
+    float time = timer.Stop() / repeat;
+
+    // The error is relative for the outputs greater than 1 and absolute for the others.
+    float max_error = 0.f;
+    for (int i = 0; i < n; i++) {
+      float expect = reference(x_data[i]);
+      max_error    = std::max(max_error, std::abs(out[i] - expect) / std::max(std::abs(expect), 1.f));
+    }
+    LOG(INFO) << name << " at approx math level " << level << ": max error " << max_error << ", " << time
+              << " ms per call";
+    EXPECT_LE(max_error, tolerances[level]) << name << " at approx math level " << level;
+  }
+  FLAGS_cinn_approx_math_level = 0;
+}
+
+}  // namespace
+
+TEST(approx_math, exp) {
+  // The shorter polynomial of level 2 is accurate to about 4e-5, 5.6e-5 at most.
+  TestApproxMath("exp", lang::Exp, [](float x) { return std::exp(x); }, -20.f, 20.f, 6e-5);
+}
+
+TEST(approx_math, log) {
+  TestApproxMath("log", lang::Log, [](float x) { return std::log(x); }, 1e-4f, 1e4f);
+}
+
+TEST(approx_math, tanh) {
+  TestApproxMath("tanh", lang::Tanh, [](float x) { return std::tanh(x); }, -6.f, 6.f);
+}
+
+TEST(approx_math, sigmoid) {
+  TestApproxMath("sigmoid", lang::Sigmoid, [](float x) { return 1.f / (1.f + std::exp(-x)); }, -20.f, 20.f);
+}
+
+TEST(approx_math, erf) {
+  TestApproxMath("erf", lang::Erf, [](float x) { return std::erf(x); }, -4.f, 4.f);
+}
+
 }  // namespace cpu
 }  // namespace runtime
 }  // namespace cinn
@@ -26,6 +26,7 @@ DEFINE_bool(cinn_cudnn_deterministic,
 #endif
 
 using ::GFLAGS_NAMESPACE::BoolFromEnv;
+using ::GFLAGS_NAMESPACE::Int32FromEnv;
 using ::GFLAGS_NAMESPACE::StringFromEnv;
 
 DEFINE_bool(cinn_use_new_fusion_pass,
@@ -34,6 +35,35 @@ DEFINE_bool(cinn_use_new_fusion_pass,
 DEFINE_bool(cinn_sync_run,
             BoolFromEnv("FLAGS_cinn_sync_run", false),
             "Whether sync all devices after each instruction run, which is used for debug.");
+DEFINE_bool(cinn_mmap_params,
+            BoolFromEnv("FLAGS_cinn_mmap_params", false),
+            "Whether map the Paddle parameter files into memory and let the host tensors alias the mapped pages.");
+DEFINE_bool(cinn_isl_ast_cache,
+            BoolFromEnv("FLAGS_cinn_isl_ast_cache", true),
+            "Whether reuse the isl AST built for an identical schedule domain in the previous lowerings.");
+DEFINE_bool(cinn_lower_without_isl,
+            BoolFromEnv("FLAGS_cinn_lower_without_isl", true),
+            "Whether build the forloops of the unscheduled rectangular stages on the host directly instead of by the "
+            "isl AST, the other stages are always lowered by isl.");
+DEFINE_bool(cinn_cpu_two_step_reduce,
+            BoolFromEnv("FLAGS_cinn_cpu_two_step_reduce", false),
+            "Whether reduce the last axes on CPU, including the sum of softmax, into vectors of partial results "
+            "first, which are then combined.");
+DEFINE_int32(cinn_approx_math_level,
+             Int32FromEnv("FLAGS_cinn_approx_math_level", 0),
+             "The precision tier of the float32 exp, log and erf on CPU: 0 calls libm, 1 inlines polynomials accurate "
+             "to about 2e-7, 2 also uses a shorter polynomial of exp accurate to about 4e-5.");
+DEFINE_bool(cinn_pass_profile,
+            BoolFromEnv("FLAGS_cinn_pass_profile", false),
+            "Whether record the time and the memory of each program and graph pass, and log a summary after Optimize.");
+DEFINE_bool(cinn_fusion_cost_model_single_consumer,
+            BoolFromEnv("FLAGS_cinn_fusion_cost_model_single_consumer", false),
+            "Whether FusionMergePass asks the cost model before fusing a producer into its only consumer, rather than "
+            "fusing it always.");
+DEFINE_bool(cinn_alter_layout_plan_blocks,
+            BoolFromEnv("FLAGS_cinn_alter_layout_plan_blocks", true),
+            "Whether AlterLayout plans one NCHWc block factor for the vars connected by the layout agnostic ops, "
+            "rather than letting each conv take its own.");
 DEFINE_string(cinn_fusion_groups_graphviz_dir,
               StringFromEnv("FLAGS_cinn_fusion_groups_graphviz_dir", ""),
               "Specify the directory path of dot file of graph, which is used for debug.");
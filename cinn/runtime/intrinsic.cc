@@ -32,6 +32,8 @@ cinn_type_t ToRuntimeType(Type type) {
   SET_TYPE_CASE_ITEM(I64, cinn_int64_t)
   SET_TYPE_CASE_ITEM(UI32, cinn_uint32_t)
   SET_TYPE_CASE_ITEM(UI64, cinn_uint64_t)
+  SET_TYPE_CASE_ITEM(F16, cinn_float16_t)
+  SET_TYPE_CASE_ITEM(BF16, cinn_bfloat16_t)
   SET_TYPE_CASE_ITEM(F32, cinn_float32_t)
   SET_TYPE_CASE_ITEM(F64, cinn_float64_t)
   SET_TYPE_CASE_ITEM(Float(32).PointerOf, cinn_type_of<float*>);
@@ -16,6 +16,7 @@
 #include "infrt/host_context/mlir_function_executable.h"
 #include "infrt/host_context/mlir_to_runtime_translate.h"
 #include "infrt/host_context/op_executable.h"
+#include "infrt/host_context/thread_pool.h"
 #include "infrt/host_context/value.h"
 #include "infrt/kernel/basic_kernels.h"
 #include "infrt/kernel/control_flow_kernels.h"
@@ -80,6 +81,16 @@ class PredictExecutor : public MlirToRuntimeTranslator {
     function_executable_->Execute(arguments, results);
   }
 
+  void SetThreadPool(ThreadPool* pool) {
+    CHECK(function_executable_) << "The predict function is not initialized";
+    function_executable_->set_thread_pool(pool);
+  }
+
+  void SetUseBytecode(bool use_bytecode) {
+    CHECK(function_executable_) << "The predict function is not initialized";
+    function_executable_->set_use_bytecode(use_bytecode);
+  }
+
   int GetInputNum() { return inputs_.size(); }
 
   DenseHostTensor* GetInput(int i) { return inputs_[i]; }
@@ -158,6 +169,8 @@ std::shared_ptr<CinnRtPredictor> CreateCinnRtPredictor(const CinnRtConfig& confi
 
 struct CinnRtPredictor::Impl {
   mlir::OwningModuleRef module_ref;
+  // The pool should outlive the executor using it.
+  std::unique_ptr<ThreadPool> thread_pool;
   std::unique_ptr<PredictExecutor> executor;
 };
 
@@ -201,6 +214,11 @@ int CinnRtPredictor::Init(const CinnRtConfig& config) {
 
   // Create PredictExecutor
   impl_->executor.reset(new PredictExecutor(impl_->module_ref.get(), registry, tensor_map));
+  if (config.num_threads() > 1) {
+    impl_->thread_pool.reset(new ThreadPool(config.num_threads()));
+    impl_->executor->SetThreadPool(impl_->thread_pool.get());
+  }
+  impl_->executor->SetUseBytecode(config.use_bytecode());
   return 0;
 }
 
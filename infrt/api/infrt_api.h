@@ -10,6 +10,8 @@ class CinnRtConfig {
   std::string model_dir_;
   std::string mlir_path_;
   std::vector<std::string> shared_libs_;
+  int num_threads_{1};
+  bool use_bytecode_{false};
 
  public:
   CinnRtConfig() = default;
@@ -22,6 +24,14 @@ class CinnRtConfig {
   void set_shared_libs(const std::vector<std::string>& shared_libs) { shared_libs_ = shared_libs; };
   const std::vector<std::string>& shared_libs() const { return shared_libs_; }
 
+  //! Run the independent ops of the predict function concurrently on num_threads threads when it is larger than 1.
+  void set_num_threads(int num_threads) { num_threads_ = num_threads; }
+  int num_threads() const { return num_threads_; }
+
+  //! Run the scalar arithmetic ops of the predict function on a register bytecode, used with a single thread only.
+  void set_use_bytecode(bool use_bytecode) { use_bytecode_ = use_bytecode; }
+  bool use_bytecode() const { return use_bytecode_; }
+
   virtual ~CinnRtConfig() = default;
 };
 
@@ -29,6 +39,8 @@ class CinnRtPredictor {
  public:
   CinnRtPredictor();
   ~CinnRtPredictor();
+  //! Run the predict function. The runs share the input, output and intermediate Values, so the concurrent requests
+  //! should be served by a predictor each.
   void Run();
   int Init(const CinnRtConfig& config);
   int GetInputNum();
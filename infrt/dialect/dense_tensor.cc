@@ -141,11 +141,6 @@ raw_ostream &operator<<(raw_ostream &os, PrecisionType type) {
   return os;
 }
 
-static Type getTensorType(mlir::MLIRContext *context) {
-  auto t_dialect = Identifier::get("t", context);
-  return OpaqueType::get(t_dialect, "tensor", context);
-}
-
 static ParseResult parseCreateUninitTensorOp(OpAsmParser &parser, OperationState &result) {
   auto loc = parser.getCurrentLocation();
   ::mlir::Type outputRawTypes[1];
@@ -205,24 +200,6 @@ static void printCreateUninitTensorOp(OpAsmPrinter &p, CreateUninitTensorOp op)
 //  p << op.getAttr("value");
 //}
 
-static ParseResult parseSetTensorOp(OpAsmParser &parser, OperationState &result) {
-  SmallVector<OpAsmParser::OperandType, 1> operands;
-  if (parser.parseOperandList(operands, 1)) return failure();
-
-  auto tensor_type = getTensorType(result.getContext());
-
-  Attribute value_attr;
-  return failure(parser.resolveOperand(operands[0], tensor_type, result.operands) ||
-                 parser.parseAttribute(value_attr, "values", result.attributes));
-}
-
-template <typename SetTensorOp>
-static void printSetTensorOp(OpAsmPrinter &p, SetTensorOp op) {
-  p << SetTensorOp::getOperationName() << " ";
-  p.printOperand(op.getOperand());
-  p << " " << op.getAttr("values");
-}
-
 #define GET_OP_CLASSES
 #include "infrt/dialect/dense_tensor.cpp.inc"
 
@@ -0,0 +1,37 @@
+// CHECK-LABEL: @fc_relu
+func @fc_relu() {
+  // the rows of x are 1, 2, 0 and 1.5.
+  %x = dt.create_uninit_tensor.f32 [4, 8] -> !cinn.tensor<X86, NCHW, F32>
+  dt.set_tensor_with_constant_values.f32 (%x : !cinn.tensor<X86, NCHW, F32>) {values=[
+    1.0:f32, 1.0:f32, 1.0:f32, 1.0:f32, 1.0:f32, 1.0:f32, 1.0:f32, 1.0:f32,
+    2.0:f32, 2.0:f32, 2.0:f32, 2.0:f32, 2.0:f32, 2.0:f32, 2.0:f32, 2.0:f32,
+    0.0:f32, 0.0:f32, 0.0:f32, 0.0:f32, 0.0:f32, 0.0:f32, 0.0:f32, 0.0:f32,
+    1.5:f32, 1.5:f32, 1.5:f32, 1.5:f32, 1.5:f32, 1.5:f32, 1.5:f32, 1.5:f32]}
+  %w = dt.create_uninit_tensor.f32 [8, 2] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%w : !cinn.tensor<X86, NCHW, F32>) {value=0.5:f32}
+  %b = dt.create_uninit_tensor.f32 [2] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%b : !cinn.tensor<X86, NCHW, F32>) {value=-3.0:f32}
+
+  // relu(x * w + b), fused and compiled by CINN
+  %out = "external.cinn_compiled_call"(%x, %w, %b) ({
+  ^bb0(%a: tensor<4x8xf32>, %c: tensor<8x2xf32>, %d: tensor<2xf32>):
+    %0 = "pd.Matmul"(%a, %c) : (tensor<4x8xf32>, tensor<8x2xf32>) -> tensor<4x2xf32>
+    %1 = "pd.ElementwiseAdd"(%0, %d) {axis = 1 : i32} : (tensor<4x2xf32>, tensor<2xf32>) -> tensor<4x2xf32>
+    %2 = "pd.Relu"(%1) : (tensor<4x2xf32>) -> tensor<4x2xf32>
+    "cinn.return"(%2) : (tensor<4x2xf32>) -> ()
+  }) : (!cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+
+  // CHECK: tensor: shape=shape[4,2], values=[1, 1, 5, 5, 0, 0, 3, 3]
+  dt.print_tensor (%out : !cinn.tensor<X86, NCHW, F32>)
+
+  %y = "external.cinn_compiled_call"(%x, %w) ({
+  ^bb0(%a: tensor<4x8xf32>, %c: tensor<8x2xf32>):
+    %0 = "pd.Matmul"(%a, %c) : (tensor<4x8xf32>, tensor<8x2xf32>) -> tensor<4x2xf32>
+    "cinn.return"(%0) : (tensor<4x2xf32>) -> ()
+  }) : (!cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+
+  // CHECK: tensor: shape=shape[4,2], values=[4, 4, 8, 8, 0, 0, 6, 6]
+  dt.print_tensor (%y : !cinn.tensor<X86, NCHW, F32>)
+
+  cinn.return
+}
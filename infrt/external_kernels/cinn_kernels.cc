@@ -0,0 +1,221 @@
+// Kernels that hand a region of pd ops over to CINN, which fuses and compiles them into host functions.
+// Load the library with --shared_libs, the kernels are registered by RegisterKernels.
+
+#include <llvm/ADT/DenseMap.h>
+#include <mlir/IR/Attributes.h>
+#include <mlir/IR/Operation.h>
+#include <mlir/IR/Region.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cinn/common/target.h"
+#include "cinn/frontend/computation.h"
+#include "cinn/frontend/net_builder.h"
+#include "infrt/host_context/kernel_registry.h"
+#include "infrt/host_context/kernel_utils.h"
+#include "infrt/host_context/mlir_function_executable.h"
+#include "infrt/tensor/dense_host_tensor.h"
+
+namespace {
+using infrt::host_context::Attribute;
+using infrt::host_context::MlirFunctionExecutable;
+using infrt::host_context::RemainingArguments;
+using infrt::host_context::RemainingResults;
+using infrt::tensor::DenseHostTensor;
+
+using shape_t = std::vector<int>;
+
+/**
+ * A region of pd ops compiled by CINN for some input shapes, with the names of its inputs and outputs in the scope of
+ * the compiled program.
+ */
+struct CompiledRegion {
+  std::shared_ptr<cinn::frontend::CinnComputation> computation;
+  std::vector<std::string> input_names;
+  std::vector<std::string> output_names;
+  std::vector<shape_t> output_shapes;
+
+  //! Take an execution context not used by other calls, creating one if all of them are busy.
+  std::shared_ptr<cinn::frontend::CinnExecutionContext> AcquireContext() {
+    {
+      std::lock_guard<std::mutex> lock(mu);
+      if (!idle_contexts.empty()) {
+        auto context = std::move(idle_contexts.back());
+        idle_contexts.pop_back();
+        return context;
+      }
+    }
+    return computation->CreateExecutionContext();
+  }
+
+  void ReleaseContext(std::shared_ptr<cinn::frontend::CinnExecutionContext> context) {
+    std::lock_guard<std::mutex> lock(mu);
+    idle_contexts.push_back(std::move(context));
+  }
+
+ private:
+  // A call binds its tensors to a context of its own, so the concurrent calls of a region, e.g. by the parallel
+  // executor, never share the tensors of the computation.
+  std::mutex mu;
+  std::vector<std::shared_ptr<cinn::frontend::CinnExecutionContext>> idle_contexts;
+};
+
+cinn::frontend::Variable GetVariable(const llvm::DenseMap<mlir::Value, cinn::frontend::Variable>& vars,
+                                     mlir::Value value) {
+  auto it = vars.find(value);
+  CHECK(it != vars.end()) << "The operand is not defined in the compiled region";
+  return it->second;
+}
+
+int GetIntAttr(mlir::Operation* op, const char* name, int default_value) {
+  auto attr = op->getAttrOfType<mlir::IntegerAttr>(name);
+  return attr ? attr.getInt() : default_value;
+}
+
+/**
+ * Translate the pd ops of \p region to a NetBuilder program over inputs of \p input_shapes, and compile it for the
+ * host. The values returned by the cinn.return of the region are the outputs.
+ */
+std::unique_ptr<CompiledRegion> CompileRegion(mlir::Region* region, const std::vector<shape_t>& input_shapes) {
+  CHECK_EQ(region->getBlocks().size(), 1UL) << "The compiled region should have exactly one block";
+  auto& block = region->front();
+  CHECK_EQ(block.getNumArguments(), input_shapes.size()) << "The number of arguments mismatches the region";
+
+  cinn::frontend::NetBuilder builder("cinn_compiled_region");
+  llvm::DenseMap<mlir::Value, cinn::frontend::Variable> vars;
+  auto compiled = std::make_unique<CompiledRegion>();
+  for (size_t i = 0; i < input_shapes.size(); i++) {
+    cinn::frontend::Variable input =
+        builder.CreateInput(cinn::common::Float(32), input_shapes[i], "cinn_region_input_" + std::to_string(i));
+    compiled->input_names.push_back(input->id);
+    vars[block.getArgument(i)] = input;
+  }
+
+  std::vector<cinn::frontend::Variable> outputs;
+  for (auto& op : block) {
+    std::string name = op.getName().getStringRef().str();
+    if (name == "cinn.return") {
+      for (auto operand : op.getOperands()) outputs.push_back(GetVariable(vars, operand));
+      break;
+    }
+
+    cinn::frontend::Variable out;
+    if (name == "pd.ElementwiseAdd") {
+      out = builder.ElementwiseAdd(
+          GetVariable(vars, op.getOperand(0)), GetVariable(vars, op.getOperand(1)), GetIntAttr(&op, "axis", -1));
+    } else if (name == "pd.ElementwiseMul") {
+      out = builder.ElementwiseMul(
+          GetVariable(vars, op.getOperand(0)), GetVariable(vars, op.getOperand(1)), GetIntAttr(&op, "axis", -1));
+    } else if (name == "pd.ElementwiseSub") {
+      CHECK_EQ(GetIntAttr(&op, "axis", -1), -1) << "pd.ElementwiseSub with an axis is not supported";
+      out = builder.Sub(GetVariable(vars, op.getOperand(0)), GetVariable(vars, op.getOperand(1)));
+    } else if (name == "pd.ElementwiseDiv") {
+      CHECK_EQ(GetIntAttr(&op, "axis", -1), -1) << "pd.ElementwiseDiv with an axis is not supported";
+      out = builder.Div(GetVariable(vars, op.getOperand(0)), GetVariable(vars, op.getOperand(1)));
+    } else if (name == "pd.Relu") {
+      out = builder.Relu(GetVariable(vars, op.getOperand(0)));
+    } else if (name == "pd.Relu6") {
+      out = builder.Relu6(GetVariable(vars, op.getOperand(0)));
+    } else if (name == "pd.Matmul") {
+      auto transpose_x = op.getAttrOfType<mlir::BoolAttr>("transpose_x");
+      auto transpose_y = op.getAttrOfType<mlir::BoolAttr>("transpose_y");
+      auto alpha       = op.getAttrOfType<mlir::FloatAttr>("alpha");
+      CHECK(!(transpose_x && transpose_x.getValue()) && !(transpose_y && transpose_y.getValue()) &&
+            !(alpha && alpha.getValueAsDouble() != 1.0))
+          << "pd.Matmul with transpose or alpha is not supported";
+      out = builder.Matmul(GetVariable(vars, op.getOperand(0)), GetVariable(vars, op.getOperand(1)));
+    } else if (name == "pd.mul") {
+      out = builder.Mul(GetVariable(vars, op.getOperand(0)), GetVariable(vars, op.getOperand(1)));
+    } else {
+      LOG(FATAL) << "The op [" << name << "] is not supported in a CINN compiled region";
+    }
+    CHECK_EQ(op.getNumResults(), 1U) << "The op [" << name << "] should have exactly one result";
+    vars[op.getResult(0)] = out;
+  }
+  CHECK(!outputs.empty()) << "The compiled region should return its outputs with cinn.return";
+
+  auto options          = cinn::frontend::CinnComputation::DefaultCompileOptions();
+  compiled->computation = cinn::frontend::CinnComputation::BuildAndCompile(
+      cinn::common::DefaultHostTarget(), builder, options, outputs);
+  for (auto& output : outputs) {
+    compiled->output_names.push_back(output->id);
+    compiled->output_shapes.push_back(output->shape);
+  }
+  return compiled;
+}
+
+/**
+ * The programs compiled for the regions, keyed by the region and the shapes of its inputs, so that a region is
+ * compiled once for each input shapes it is called with.
+ */
+class CompiledRegionCache {
+ public:
+  static CompiledRegionCache& Global() {
+    static CompiledRegionCache cache;
+    return cache;
+  }
+
+  CompiledRegion* Get(mlir::Region* region, const std::vector<shape_t>& input_shapes) {
+    std::lock_guard<std::mutex> lock(mu_);
+    auto key = std::make_pair(region, input_shapes);
+    auto it  = compiled_.find(key);
+    if (it == compiled_.end()) {
+      VLOG(3) << "Compile a region with " << input_shapes.size() << " inputs by CINN";
+      it = compiled_.emplace(key, CompileRegion(region, input_shapes)).first;
+    }
+    return it->second.get();
+  }
+
+ private:
+  std::mutex mu_;
+  std::map<std::pair<mlir::Region*, std::vector<shape_t>>, std::unique_ptr<CompiledRegion>> compiled_;
+};
+
+shape_t GetShape(const DenseHostTensor& tensor) {
+  shape_t shape;
+  for (int i = 0; i < tensor.shape().GetRank(); i++) shape.push_back(tensor.shape().GetDim(i));
+  return shape;
+}
+
+/**
+ * Run the region \p fn compiled by CINN. The arguments and the results are float32 DenseHostTensors, their memory is
+ * bound to the inputs and outputs of the compiled program, so no copy is made.
+ */
+void CinnCompiledCall(RemainingArguments args, RemainingResults results, Attribute<MlirFunctionExecutable*> fn) {
+  std::vector<shape_t> input_shapes;
+  for (auto* arg : args.values()) {
+    const auto& tensor = arg->get<DenseHostTensor>();
+    CHECK(tensor.metadata().dtype == infrt::GetDType<float>()) << "Only float32 inputs are supported";
+    input_shapes.push_back(GetShape(tensor));
+  }
+
+  auto* compiled = CompiledRegionCache::Global().Get(fn.get()->region(), input_shapes);
+  CHECK_EQ(results.size(), compiled->output_names.size()) << "The number of results mismatches the region";
+
+  auto context = compiled->AcquireContext();
+  for (size_t i = 0; i < args.size(); i++) {
+    auto& tensor = args.values()[i]->get<DenseHostTensor>();
+    context->BindTensorData(
+        compiled->input_names[i], tensor.raw_data(), tensor.shape().GetNumElements() * sizeof(float));
+  }
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto& shape = compiled->output_shapes[i];
+    DenseHostTensor out(infrt::tensor::TensorShape(std::vector<int64_t>(shape.begin(), shape.end())),
+                        infrt::GetDType<float>());
+    context->BindTensorData(compiled->output_names[i], out.raw_data(), out.shape().GetNumElements() * sizeof(float));
+    results[i]->set(std::move(out));
+  }
+  context->Execute();
+  compiled->ReleaseContext(std::move(context));
+}
+
+}  // namespace
+
+void RegisterKernels(infrt::host_context::KernelRegistry* registry) {
+  registry->AddKernel("external.cinn_compiled_call", CINN_KERNEL(CinnCompiledCall));
+}
@@ -0,0 +1,138 @@
+#include "infrt/host_context/bytecode.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/container/flat_hash_set.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "infrt/host_context/kernel_frame.h"
+#include "infrt/host_context/op_executable.h"
+#include "infrt/host_context/value.h"
+
+namespace infrt::host_context {
+
+BytecodeProgram::BytecodeProgram(llvm::ArrayRef<OpExecutable*> ops) {
+  // The arithmetic kernels lowered to instructions, with whether they work on float32.
+  static const absl::flat_hash_map<std::string, std::pair<OpCode, bool>> arithmetic_kernels{
+      {"cinn.add.i32", {OpCode::kAddI32, false}},
+      {"cinn.sub.i32", {OpCode::kSubI32, false}},
+      {"cinn.mul.i32", {OpCode::kMulI32, false}},
+      {"cinn.div.i32", {OpCode::kDivI32, false}},
+      {"cinn.add.f32", {OpCode::kAddF32, true}},
+      {"cinn.sub.f32", {OpCode::kSubF32, true}},
+      {"cinn.mul.f32", {OpCode::kMulF32, true}},
+      {"cinn.div.f32", {OpCode::kDivF32, true}},
+  };
+
+  absl::flat_hash_map<Value*, std::pair<uint32_t, bool>> register_of;
+  // The Values whose registers hold their current content.
+  absl::flat_hash_set<Value*> valid;
+  // The Values whose registers are newer than themselves.
+  absl::flat_hash_set<Value*> dirty;
+
+  auto get_register = [&](Value* value, bool is_float) {
+    auto it = register_of.find(value);
+    if (it != register_of.end()) {
+      CHECK_EQ(it->second.second, is_float) << "A Value is used as both int32 and float32";
+      return it->second.first;
+    }
+    uint32_t id = registers_.size();
+    registers_.emplace_back();
+    register_of.emplace(value, std::make_pair(id, is_float));
+    return id;
+  };
+  auto emit_load = [&](Value* value, uint32_t reg, bool is_float) {
+    if (valid.count(value)) return;
+    Instruction instr{is_float ? OpCode::kLoadF32 : OpCode::kLoadI32};
+    instr.dst   = reg;
+    instr.value = value;
+    instructions_.push_back(instr);
+    valid.insert(value);
+  };
+  auto emit_store = [&](Value* value) {
+    if (!dirty.count(value)) return;
+    auto& reg = register_of.at(value);
+    Instruction instr{reg.second ? OpCode::kStoreF32 : OpCode::kStoreI32};
+    instr.dst   = reg.first;
+    instr.value = value;
+    instructions_.push_back(instr);
+    dirty.erase(value);
+  };
+
+  for (OpExecutable* op : ops) {
+    const auto& frame = op->frame();
+    auto kernel       = arithmetic_kernels.find(std::string(op->name()));
+    if (kernel != arithmetic_kernels.end() && frame.GetNumArgs() == 2 && frame.GetNumResults() == 1) {
+      bool is_float = kernel->second.second;
+      Instruction instr{kernel->second.first};
+      Value* lhs = frame.GetArguments()[0];
+      Value* rhs = frame.GetArguments()[1];
+      Value* out = frame.GetResults()[0];
+      instr.lhs  = get_register(lhs, is_float);
+      emit_load(lhs, instr.lhs, is_float);
+      instr.rhs = get_register(rhs, is_float);
+      emit_load(rhs, instr.rhs, is_float);
+      instr.dst = get_register(out, is_float);
+      instructions_.push_back(instr);
+      valid.insert(out);
+      dirty.insert(out);
+      continue;
+    }
+
+    // A general op may read and write the Values of its arguments and results, sync them with the registers.
+    llvm::ArrayRef<Value*> values = frame.GetValues(0, frame.GetNumArgs() + std::max(frame.GetNumResults(), 0));
+    for (Value* value : values) emit_store(value);
+    Instruction instr{OpCode::kCallOp};
+    instr.op = op;
+    instructions_.push_back(instr);
+    for (Value* value : values) valid.erase(value);
+  }
+
+  std::vector<Value*> dirty_values(dirty.begin(), dirty.end());
+  for (Value* value : dirty_values) emit_store(value);
+  VLOG(3) << "Compiled " << ops.size() << " ops to " << instructions_.size() << " instructions with "
+          << registers_.size() << " registers";
+}
+
+void BytecodeProgram::Execute() {
+  Register* regs = registers_.data();
+  for (const Instruction& instr : instructions_) {
+    switch (instr.opcode) {
+#define ARITHMETIC_CASE(opcode__, field__, op__)                                     \
+  case OpCode::opcode__:                                                             \
+    regs[instr.dst].field__ = regs[instr.lhs].field__ op__ regs[instr.rhs].field__; \
+    break;
+
+      ARITHMETIC_CASE(kAddI32, i32, +)
+      ARITHMETIC_CASE(kSubI32, i32, -)
+      ARITHMETIC_CASE(kMulI32, i32, *)
+      ARITHMETIC_CASE(kDivI32, i32, /)
+      ARITHMETIC_CASE(kAddF32, f32, +)
+      ARITHMETIC_CASE(kSubF32, f32, -)
+      ARITHMETIC_CASE(kMulF32, f32, *)
+      ARITHMETIC_CASE(kDivF32, f32, /)
+#undef ARITHMETIC_CASE
+
+      case OpCode::kLoadI32:
+        regs[instr.dst].i32 = instr.value->get<int32_t>();
+        break;
+      case OpCode::kLoadF32:
+        regs[instr.dst].f32 = instr.value->get<float>();
+        break;
+      case OpCode::kStoreI32:
+        instr.value->set(int32_t(regs[instr.dst].i32));
+        break;
+      case OpCode::kStoreF32:
+        instr.value->set(float(regs[instr.dst].f32));
+        break;
+      case OpCode::kCallOp:
+        instr.op->Execute();
+        break;
+    }
+  }
+}
+
+}  // namespace infrt::host_context
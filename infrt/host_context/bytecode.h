@@ -0,0 +1,70 @@
+#pragma once
+#include <llvm/ADT/ArrayRef.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace infrt::host_context {
+
+class OpExecutable;
+class Value;
+
+/**
+ * A compiled form of a sequence of ops for scalar-heavy programs.
+ *
+ * The scalar Values used by the arithmetic kernels (cinn.add.i32, cinn.mul.f32 and so on) are assigned to typed slots
+ * of a flat register file at compile time, and these kernels are lowered to instructions that work on the registers
+ * directly, without the variant dispatch of Value. The other ops are kept as calls to their OpExecutables, with the
+ * loads and stores needed to keep the Values they touch in sync with the registers. The instructions are dispatched
+ * by a switch in a loop, computed-goto threading is not used since it is not portable across our compilers.
+ */
+class BytecodeProgram {
+ public:
+  explicit BytecodeProgram(llvm::ArrayRef<OpExecutable*> ops);
+
+  //! Run the program, the scalar results are written back to their Values at the end.
+  void Execute();
+
+  size_t num_instructions() const { return instructions_.size(); }
+  size_t num_registers() const { return registers_.size(); }
+
+ private:
+  enum class OpCode : uint8_t {
+    kAddI32,
+    kSubI32,
+    kMulI32,
+    kDivI32,
+    kAddF32,
+    kSubF32,
+    kMulF32,
+    kDivF32,
+    // Copy between a register and its Value.
+    kLoadI32,
+    kLoadF32,
+    kStoreI32,
+    kStoreF32,
+    // Run an op through its kernel.
+    kCallOp,
+  };
+
+  struct Instruction {
+    OpCode opcode;
+    // The register operands of the arithmetic, or the register of a load/store.
+    uint32_t dst{};
+    uint32_t lhs{};
+    uint32_t rhs{};
+    // The Value of a load/store.
+    Value* value{};
+    OpExecutable* op{};
+  };
+
+  union Register {
+    int32_t i32;
+    float f32;
+  };
+
+  std::vector<Instruction> instructions_;
+  std::vector<Register> registers_;
+};
+
+}  // namespace infrt::host_context
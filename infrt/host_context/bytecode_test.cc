@@ -0,0 +1,145 @@
+#include "infrt/host_context/bytecode.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "infrt/host_context/core_runtime.h"
+#include "infrt/host_context/kernel_registry.h"
+#include "infrt/host_context/kernel_utils.h"
+#include "infrt/host_context/op_executable.h"
+#include "infrt/host_context/symbol_table.h"
+
+namespace infrt {
+namespace host_context {
+
+namespace {
+int add(int a, int b) { return a + b; }
+int mul(int a, int b) { return a * b; }
+float addf(float a, float b) { return a + b; }
+int negate(int a) { return -a; }
+
+void RegisterKernels(KernelRegistry* registry) {
+  registry->AddKernel("cinn.add.i32", CINN_KERNEL(add));
+  registry->AddKernel("cinn.mul.i32", CINN_KERNEL(mul));
+  registry->AddKernel("cinn.add.f32", CINN_KERNEL(addf));
+  registry->AddKernel("cinn.test.negate", CINN_KERNEL(negate));
+}
+
+// Build acc_{i+1} = (acc_i + one) * two for num_steps steps.
+void BuildChain(CoreRuntimeBuilder* builder, int num_steps) {
+  auto* table = builder->symbol_table();
+  table->Register("acc0", 0);
+  table->Register("one", 1);
+  table->Register("two", 2);
+  for (int i = 0; i < num_steps; i++) {
+    std::string acc = "acc" + std::to_string(i);
+    std::string tmp = "tmp" + std::to_string(i);
+    auto* op0       = builder->NewOpExecutable("cinn.add.i32");
+    op0->AppendArgument(acc);
+    op0->AppendArgument("one");
+    op0->SetResults({tmp});
+    auto* op1 = builder->NewOpExecutable("cinn.mul.i32");
+    op1->AppendArgument(tmp);
+    op1->AppendArgument("two");
+    op1->SetResults({"acc" + std::to_string(i + 1)});
+  }
+}
+}  // namespace
+
+TEST(BytecodeProgram, arithmetic) {
+  KernelRegistry registry;
+  RegisterKernels(&registry);
+
+  CoreRuntimeBuilder builder(&registry);
+  BuildChain(&builder, 4);
+  auto* table = builder.symbol_table();
+  table->Register("x", 1.5f);
+  table->Register("y", 2.f);
+  auto* op = builder.NewOpExecutable("cinn.add.f32");
+  op->AppendArgument("x");
+  op->AppendArgument("y");
+  op->SetResults({"z"});
+
+  builder.ExecuteBytecode();
+
+  // acc: 0 -> 2 -> 6 -> 14 -> 30
+  ASSERT_EQ(table->GetValue("acc4")->get<int>(), 30);
+  ASSERT_EQ(table->GetValue("tmp3")->get<int>(), 15);
+  ASSERT_EQ(table->GetValue("z")->get<float>(), 3.5f);
+}
+
+TEST(BytecodeProgram, mixed_with_general_ops) {
+  KernelRegistry registry;
+  RegisterKernels(&registry);
+
+  CoreRuntimeBuilder builder(&registry);
+  auto* table = builder.symbol_table();
+  table->Register("a", 3);
+  table->Register("b", 4);
+
+  // c = a + b, d = -c, e = d * b
+  auto* op0 = builder.NewOpExecutable("cinn.add.i32");
+  op0->AppendArgument("a");
+  op0->AppendArgument("b");
+  op0->SetResults({"c"});
+
+  auto* op1 = builder.NewOpExecutable("cinn.test.negate");
+  op1->AppendArgument("c");
+  op1->SetResults({"d"});
+
+  auto* op2 = builder.NewOpExecutable("cinn.mul.i32");
+  op2->AppendArgument("d");
+  op2->AppendArgument("b");
+  op2->SetResults({"e"});
+
+  for (int i = 0; i < 3; i++) {
+    builder.ExecuteBytecode();
+    ASSERT_EQ(table->GetValue("c")->get<int>(), 7);
+    ASSERT_EQ(table->GetValue("d")->get<int>(), -7);
+    ASSERT_EQ(table->GetValue("e")->get<int>(), -28);
+  }
+}
+
+TEST(BytecodeProgram, benchmark) {
+  KernelRegistry registry;
+  RegisterKernels(&registry);
+
+  const int num_steps   = 100;
+  const int num_repeats = 1000;
+  CoreRuntimeBuilder builder(&registry);
+  BuildChain(&builder, num_steps);
+  auto* table = builder.symbol_table();
+
+  auto timeit = [&](auto&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_repeats; i++) fn();
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    return builder.num_ops() * num_repeats / duration.count();
+  };
+
+  auto get_values = [&] {
+    std::vector<int> values;
+    for (int i = 0; i < num_steps; i++) {
+      values.push_back(table->GetValue("tmp" + std::to_string(i))->get<int>());
+      values.push_back(table->GetValue("acc" + std::to_string(i + 1))->get<int>());
+    }
+    return values;
+  };
+
+  // compile the bytecode ahead, so only the execution is timed.
+  builder.ExecuteBytecode();
+  double interpreted = timeit([&] { builder.Execute(); });
+  auto expected      = get_values();
+  double compiled    = timeit([&] { builder.ExecuteBytecode(); });
+  ASSERT_EQ(get_values(), expected);
+
+  // the speedup depends on the load of the machine, so it is only logged.
+  LOG(INFO) << "Execute: " << interpreted << " ops/s, ExecuteBytecode: " << compiled
+            << " ops/s, speedup: " << compiled / interpreted;
+}
+
+}  // namespace host_context
+}  // namespace infrt
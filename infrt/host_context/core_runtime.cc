@@ -2,12 +2,21 @@
 
 #include <absl/container/flat_hash_map.h>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "infrt/host_context/bytecode.h"
+#include "infrt/host_context/kernel_frame.h"
 #include "infrt/host_context/kernel_registry.h"
 #include "infrt/host_context/op_executable.h"
 #include "infrt/host_context/symbol_table.h"
+#include "infrt/host_context/thread_pool.h"
 
 namespace infrt::host_context {
 
@@ -17,8 +26,76 @@ struct CoreRuntime::Impl {
   std::vector<OpExecutableBuilder> op_executables;
 
   mutable std::vector<ValueRef> results;
+
+  //! The dependency graph of the ops for the parallel execution, built lazily.
+  // @{
+  std::vector<std::vector<int>> op_successors;
+  std::vector<int> op_num_dependencies;
+  // the last op writing each Value, after which the Value is available.
+  absl::flat_hash_map<Value*, int> value_last_write;
+  // @}
+
+  void BuildDependencies();
+
+  //! The ops compiled to bytecode, and the number of ops compiled.
+  // @{
+  std::unique_ptr<BytecodeProgram> bytecode;
+  size_t bytecode_num_ops{};
+  // @}
 };
 
+void CoreRuntime::Impl::BuildDependencies() {
+  if (op_num_dependencies.size() == op_executables.size()) return;
+  op_successors.assign(op_executables.size(), {});
+  op_num_dependencies.assign(op_executables.size(), 0);
+
+  // An op reading a Value runs after the last op writing it, and an op writing a Value runs after all the ops
+  // accessing it before, so the ops only reading a Value overlap. An op writes its results and reads its arguments,
+  // except that a kernel without results, such as dt.fill_tensor_with_constant, runs for its effects on the
+  // arguments, so they are written.
+  struct ValueAccess {
+    int last_write{-1};
+    // the ops reading the Value after the last write.
+    std::vector<int> reads;
+  };
+  absl::flat_hash_map<Value*, ValueAccess> accesses;
+  auto depend = [&](int op_id, int successor) {
+    if (op_id < 0 || op_id == successor) return;
+    // the dependencies of an op are all added when it is visited, so a repeated one is the last of the list.
+    auto& successors = op_successors[op_id];
+    if (successors.empty() || successors.back() != successor) {
+      successors.push_back(successor);
+      op_num_dependencies[successor]++;
+    }
+  };
+  for (int i = 0; i < op_executables.size(); i++) {
+    const auto& frame = op_executables[i].frame();
+    int num_args      = frame.GetNumArgs();
+    int num_results   = std::max(frame.GetNumResults(), 0);
+    auto values       = frame.GetValues(0, num_args + num_results);
+    for (int j = 0; j < values.size(); j++) {
+      auto& access = accesses[values[j]];
+      depend(access.last_write, i);
+      if (j < num_args && num_results > 0) {
+        access.reads.push_back(i);
+        continue;
+      }
+      for (int reader : access.reads) {
+        depend(reader, i);
+      }
+      access.last_write = i;
+      access.reads.clear();
+    }
+  }
+
+  value_last_write.clear();
+  for (auto& item : accesses) {
+    if (item.second.last_write >= 0) {
+      value_last_write[item.first] = item.second.last_write;
+    }
+  }
+}
+
 SymbolTable* CoreRuntime::symbol_table() { return &impl_->symbol_table; }
 
 CoreRuntime::CoreRuntime(CoreRuntime::Impl* impl) : impl_(impl) { CHECK(impl); }
@@ -32,6 +109,105 @@ void CoreRuntime::Execute() {
   }
 }
 
+struct AsyncExecution::State : public std::enable_shared_from_this<AsyncExecution::State> {
+  std::vector<OpExecutableBuilder>* op_executables{};
+  const std::vector<std::vector<int>>* op_successors{};
+  const absl::flat_hash_map<Value*, int>* value_last_write{};
+  SymbolTable* symbol_table{};
+  ThreadPool* pool{};
+
+  std::unique_ptr<std::atomic<int>[]> num_pending;
+
+  std::mutex mu;
+  std::condition_variable cv;
+  std::vector<bool> op_finished;
+  int num_finished{};
+
+  void RunOp(int op_id);
+
+  //! The op after which the Value named \p name is available, or -1 if no op writes it.
+  int LastWrite(absl::string_view name) const;
+};
+
+void AsyncExecution::State::RunOp(int op_id) {
+  VLOG(3) << "running op " << op_id << " " << (*op_executables)[op_id].name();
+  (*op_executables)[op_id].Execute();
+  for (int successor : (*op_successors)[op_id]) {
+    if (--num_pending[successor] == 0) {
+      auto self = shared_from_this();
+      pool->Schedule([self, successor] { self->RunOp(successor); });
+    }
+  }
+  std::lock_guard<std::mutex> lock(mu);
+  op_finished[op_id] = true;
+  num_finished++;
+  cv.notify_all();
+}
+
+int AsyncExecution::State::LastWrite(absl::string_view name) const {
+  Value* value = symbol_table->GetValue(name);
+  CHECK(value) << "No Value named " << name;
+  auto it = value_last_write->find(value);
+  return it == value_last_write->end() ? -1 : it->second;
+}
+
+ValueRef AsyncExecution::Await(absl::string_view name) {
+  int op_id = state_->LastWrite(name);
+  if (op_id >= 0) {
+    std::unique_lock<std::mutex> lock(state_->mu);
+    state_->cv.wait(lock, [&] { return state_->op_finished[op_id]; });
+  }
+  return ValueRef(state_->symbol_table->GetValue(name));
+}
+
+bool AsyncExecution::IsAvailable(absl::string_view name) const {
+  int op_id = state_->LastWrite(name);
+  std::lock_guard<std::mutex> lock(state_->mu);
+  return op_id < 0 || state_->op_finished[op_id];
+}
+
+void AsyncExecution::Wait() {
+  std::unique_lock<std::mutex> lock(state_->mu);
+  state_->cv.wait(lock, [&] { return state_->num_finished == static_cast<int>(state_->op_finished.size()); });
+}
+
+void CoreRuntime::ExecuteParallel(ThreadPool* pool) { ExecuteAsync(pool)->Wait(); }
+
+std::shared_ptr<AsyncExecution> CoreRuntime::ExecuteAsync(ThreadPool* pool) {
+  CHECK(pool);
+  impl_->BuildDependencies();
+  int num_ops = impl_->op_executables.size();
+
+  auto state              = std::make_shared<AsyncExecution::State>();
+  state->op_executables   = &impl_->op_executables;
+  state->op_successors    = &impl_->op_successors;
+  state->value_last_write = &impl_->value_last_write;
+  state->symbol_table     = &impl_->symbol_table;
+  state->pool             = pool;
+  state->num_pending.reset(new std::atomic<int>[num_ops]);
+  for (int i = 0; i < num_ops; i++) {
+    state->num_pending[i] = impl_->op_num_dependencies[i];
+  }
+  state->op_finished.assign(num_ops, false);
+
+  for (int i = 0; i < num_ops; i++) {
+    if (impl_->op_num_dependencies[i] == 0) {
+      pool->Schedule([state, i] { state->RunOp(i); });
+    }
+  }
+  return std::shared_ptr<AsyncExecution>(new AsyncExecution(state));
+}
+
+void CoreRuntime::ExecuteBytecode() {
+  if (!impl_->bytecode || impl_->bytecode_num_ops != impl_->op_executables.size()) {
+    std::vector<OpExecutable*> ops;
+    for (auto& op : impl_->op_executables) ops.push_back(&op);
+    impl_->bytecode.reset(new BytecodeProgram(ops));
+    impl_->bytecode_num_ops = ops.size();
+  }
+  impl_->bytecode->Execute();
+}
+
 KernelRegistry* CoreRuntime::kernel_registry() const { return impl_->kernel_registry; }
 
 size_t CoreRuntime::num_ops() const { return impl_->op_executables.size(); }
@@ -10,8 +10,10 @@
 
 namespace infrt::host_context {
 
+class AsyncExecution;
 class KernelRegistry;
 class OpExecutable;
+class ThreadPool;
 class OpExecutableBuilder;
 class SymbolTable;
 
@@ -25,6 +27,27 @@ class CoreRuntime : public std::enable_shared_from_this<CoreRuntime> {
   //! Execute a program.
   void Execute();
 
+  /**
+   * Execute a program on the threads of \p pool, an op is dispatched as soon as all the ops it depends on finish.
+   * An op reading a Value depends on the last op writing it, and an op writing a Value depends on all the ops
+   * accessing it before, so the ops only reading a Value overlap. An op writes its results and reads its arguments,
+   * except that an op without results writes its arguments. It returns when all the ops finish.
+   */
+  void ExecuteParallel(ThreadPool* pool);
+
+  /**
+   * Start executing a program on the threads of \p pool like ExecuteParallel, but return without waiting. A Value is
+   * available once the last op writing it finishes, and can be awaited on the returned AsyncExecution alone.
+   * The program should not be executed again or destroyed before the execution finishes.
+   */
+  std::shared_ptr<AsyncExecution> ExecuteAsync(ThreadPool* pool);
+
+  /**
+   * Execute a program compiled to a BytecodeProgram, where the scalar arithmetic ops run on a flat register file.
+   * The program is compiled at the first call, and recompiled if more ops are added.
+   */
+  void ExecuteBytecode();
+
   //! Return the number of ops.
   size_t num_ops() const;
 
@@ -47,6 +70,31 @@ class CoreRuntime : public std::enable_shared_from_this<CoreRuntime> {
   std::unique_ptr<Impl> impl_;
 };
 
+/**
+ * An execution of a CoreRuntime running in the background. The Values of the program are awaited one by one, so the
+ * consumer of a Value starts as soon as the ops computing it finish rather than the whole program.
+ */
+class AsyncExecution {
+ public:
+  //! Block until the Value named \p name is available, and return it.
+  ValueRef Await(absl::string_view name);
+
+  //! Return whether the Value named \p name is available without blocking.
+  bool IsAvailable(absl::string_view name) const;
+
+  //! Block until all the ops finish.
+  void Wait();
+
+ private:
+  friend class CoreRuntime;
+  struct State;
+
+  explicit AsyncExecution(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+  //! The state is shared with the scheduled ops, which may outlive this object.
+  std::shared_ptr<State> state_;
+};
+
 /**
  * The builder for CoreRuntime, help to construct a function.
  */
@@ -2,10 +2,16 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+
 #include "infrt/host_context/kernel_registry.h"
 #include "infrt/host_context/kernel_utils.h"
 #include "infrt/host_context/op_executable.h"
 #include "infrt/host_context/symbol_table.h"
+#include "infrt/host_context/thread_pool.h"
 
 namespace infrt {
 namespace host_context {
@@ -13,6 +19,22 @@ namespace host_context {
 int add(int a, int b) { return a + b; }
 int sub(int a, int b) { return a - b; }
 
+// a kernel of some microseconds of work, so the scheduling overhead does not dominate.
+int spin(int a) {
+  volatile int x = a;
+  for (int i = 0; i < 20000; i++) x = x * 3 + 1;
+  return a + 1;
+}
+
+std::shared_future<void> gate;
+int wait_gate(int a) {
+  gate.wait();
+  return a;
+}
+
+// a kernel without results, which writes its argument.
+void increase(int* a) { (*a)++; }
+
 TEST(CoreRuntime, basic) {
   KernelRegistry registry;
   registry.AddKernel("cinn.test.addi32", CINN_KERNEL(add));
@@ -43,6 +65,168 @@ TEST(CoreRuntime, basic) {
   ASSERT_EQ(table->GetValue("e")->get<int>(), -1);
 }
 
+TEST(CoreRuntime, parallel) {
+  KernelRegistry registry;
+  registry.AddKernel("cinn.test.addi32", CINN_KERNEL(add));
+  registry.AddKernel("cinn.test.subi32", CINN_KERNEL(sub));
+
+  CoreRuntimeBuilder builder(&registry);
+  auto* table = builder.symbol_table();
+  table->Register("a", 1);
+  table->Register("b", 2);
+  table->Register("x", 5);
+  table->Register("y", 3);
+
+  // c = a + b and d = x - y are independent, e = c - d depends on both
+  auto* op0 = builder.NewOpExecutable("cinn.test.addi32");
+  op0->AppendArgument("a");
+  op0->AppendArgument("b");
+  op0->SetResults({"c"});
+
+  auto* op1 = builder.NewOpExecutable("cinn.test.subi32");
+  op1->AppendArgument("x");
+  op1->AppendArgument("y");
+  op1->SetResults({"d"});
+
+  auto* op2 = builder.NewOpExecutable("cinn.test.subi32");
+  op2->AppendArgument("c");
+  op2->AppendArgument("d");
+  op2->SetResults({"e"});
+
+  ThreadPool pool(2);
+  for (int i = 0; i < 10; i++) {
+    builder.ExecuteParallel(&pool);
+    ASSERT_EQ(table->GetValue("c")->get<int>(), 3);
+    ASSERT_EQ(table->GetValue("d")->get<int>(), 2);
+    ASSERT_EQ(table->GetValue("e")->get<int>(), 1);
+  }
+}
+
+TEST(CoreRuntime, async) {
+  KernelRegistry registry;
+  registry.AddKernel("cinn.test.addi32", CINN_KERNEL(add));
+  registry.AddKernel("cinn.test.subi32", CINN_KERNEL(sub));
+  registry.AddKernel("cinn.test.wait_gate", CINN_KERNEL(wait_gate));
+
+  CoreRuntimeBuilder builder(&registry);
+  auto* table = builder.symbol_table();
+  table->Register("a", 1);
+  table->Register("b", 2);
+  table->Register("x", 5);
+
+  // c = a + b is independent of the gated d = wait_gate(x), e = c - d depends on both
+  auto* op0 = builder.NewOpExecutable("cinn.test.addi32");
+  op0->AppendArgument("a");
+  op0->AppendArgument("b");
+  op0->SetResults({"c"});
+
+  auto* op1 = builder.NewOpExecutable("cinn.test.wait_gate");
+  op1->AppendArgument("x");
+  op1->SetResults({"d"});
+
+  auto* op2 = builder.NewOpExecutable("cinn.test.subi32");
+  op2->AppendArgument("c");
+  op2->AppendArgument("d");
+  op2->SetResults({"e"});
+
+  std::promise<void> open_gate;
+  gate = open_gate.get_future().share();
+
+  ThreadPool pool(2);
+  auto execution = builder.ExecuteAsync(&pool);
+  // c is available while d is still being computed, and so is the input a.
+  ASSERT_EQ(execution->Await("c").get<int>(), 3);
+  ASSERT_TRUE(execution->IsAvailable("a"));
+  ASSERT_FALSE(execution->IsAvailable("d"));
+  ASSERT_FALSE(execution->IsAvailable("e"));
+
+  open_gate.set_value();
+  ASSERT_EQ(execution->Await("e").get<int>(), -2);
+  execution->Wait();
+  ASSERT_TRUE(execution->IsAvailable("d"));
+}
+
+TEST(CoreRuntime, read_write_order) {
+  KernelRegistry registry;
+  registry.AddKernel("cinn.test.addi32", CINN_KERNEL(add));
+  registry.AddKernel("cinn.test.wait_gate", CINN_KERNEL(wait_gate));
+  registry.AddKernel("cinn.test.increase", CINN_KERNEL(increase));
+
+  CoreRuntimeBuilder builder(&registry);
+  auto* table = builder.symbol_table();
+  table->Register("a", 1);
+  table->Register("b", 2);
+
+  // d = wait_gate(a) and c = a + b only read a, then increase(a) writes it after both.
+  auto* op0 = builder.NewOpExecutable("cinn.test.wait_gate");
+  op0->AppendArgument("a");
+  op0->SetResults({"d"});
+
+  auto* op1 = builder.NewOpExecutable("cinn.test.addi32");
+  op1->AppendArgument("a");
+  op1->AppendArgument("b");
+  op1->SetResults({"c"});
+
+  auto* op2 = builder.NewOpExecutable("cinn.test.increase");
+  op2->AppendArgument("a");
+
+  std::promise<void> open_gate;
+  gate = open_gate.get_future().share();
+
+  ThreadPool pool(2);
+  auto execution = builder.ExecuteAsync(&pool);
+  // the readers overlap, so c is computed while d is gated, and a is not written before d is computed.
+  ASSERT_EQ(execution->Await("c").get<int>(), 3);
+  ASSERT_FALSE(execution->IsAvailable("d"));
+  ASSERT_FALSE(execution->IsAvailable("a"));
+
+  open_gate.set_value();
+  ASSERT_EQ(execution->Await("a").get<int>(), 2);
+  ASSERT_EQ(execution->Await("d").get<int>(), 1);
+  execution->Wait();
+}
+
+TEST(CoreRuntime, parallel_throughput) {
+  KernelRegistry registry;
+  registry.AddKernel("cinn.test.spin", CINN_KERNEL(spin));
+
+  // num_chains independent chains of num_steps dependent ops.
+  const int num_chains  = 8;
+  const int num_steps   = 8;
+  const int num_repeats = 20;
+  CoreRuntimeBuilder builder(&registry);
+  auto* table = builder.symbol_table();
+  for (int i = 0; i < num_chains; i++) {
+    std::string prefix = "chain" + std::to_string(i) + "_";
+    table->Register(prefix + "0", i);
+    for (int j = 0; j < num_steps; j++) {
+      auto* op = builder.NewOpExecutable("cinn.test.spin");
+      op->AppendArgument(prefix + std::to_string(j));
+      op->SetResults({prefix + std::to_string(j + 1)});
+    }
+  }
+
+  auto timeit = [&](auto&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_repeats; i++) fn();
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    return builder.num_ops() * num_repeats / duration.count();
+  };
+
+  int num_threads = std::max(2U, std::min(std::thread::hardware_concurrency(), 8U));
+  ThreadPool pool(num_threads);
+  double serial   = timeit([&] { builder.Execute(); });
+  double parallel = timeit([&] { builder.ExecuteParallel(&pool); });
+  for (int i = 0; i < num_chains; i++) {
+    ASSERT_EQ(table->GetValue("chain" + std::to_string(i) + "_" + std::to_string(num_steps))->get<int>(),
+              i + num_steps);
+  }
+
+  // the speedup depends on the load of the machine, so it is only logged.
+  LOG(INFO) << "Execute: " << serial << " ops/s, ExecuteParallel on " << num_threads << " threads: " << parallel
+            << " ops/s, speedup " << parallel / serial;
+}
+
 TEST(CoreRuntime, function) {
   // The function:
   // func(int a, int b) {
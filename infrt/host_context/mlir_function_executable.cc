@@ -101,7 +101,13 @@ void MlirFunctionExecutable::Execute(llvm::ArrayRef<Value*> arguments,
     const_cast<MlirFunctionExecutable*>(this)->BuildExecutables(arguments, results, is_region);
   }
 
-  const_cast<CoreRuntimeBuilder*>(&core_runtime_builder_)->Execute();
+  if (thread_pool_) {
+    const_cast<CoreRuntimeBuilder*>(&core_runtime_builder_)->ExecuteParallel(thread_pool_);
+  } else if (use_bytecode_) {
+    const_cast<CoreRuntimeBuilder*>(&core_runtime_builder_)->ExecuteBytecode();
+  } else {
+    const_cast<CoreRuntimeBuilder*>(&core_runtime_builder_)->Execute();
+  }
 
   copy_res_fn_();
 }
@@ -37,6 +37,15 @@ class MlirFunctionExecutable : public Function, public MlirToRuntimeTranslator {
    */
   void Execute(llvm::ArrayRef<Value*> arguments, llvm::MutableArrayRef<ValueRef> results, bool is_region = false) const;
 
+  //! The region of the function, kernels that compile the function by themselves can walk its ops.
+  mlir::Region* region() const { return region_; }
+
+  //! Execute the independent ops of the function concurrently on \p pool, nullptr means serial execution.
+  void set_thread_pool(ThreadPool* pool) { thread_pool_ = pool; }
+
+  //! Execute the function compiled to bytecode, see CoreRuntime::ExecuteBytecode. Ignored with a thread pool.
+  void set_use_bytecode(bool use_bytecode) { use_bytecode_ = use_bytecode; }
+
  private:
   /**
    * Build the runtime executables once the function call arguments and results are passed in.
@@ -49,6 +58,8 @@ class MlirFunctionExecutable : public Function, public MlirToRuntimeTranslator {
   CoreRuntimeBuilder core_runtime_builder_;
   MlirToRuntimeTranslator::function_defs_t& function_table_;
   std::function<void()> copy_res_fn_;
+  ThreadPool* thread_pool_{};
+  bool use_bytecode_{false};
 };
 
 }  // namespace host_context
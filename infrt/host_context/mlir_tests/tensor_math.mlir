@@ -0,0 +1,71 @@
+// CHECK-LABEL: elementwise
+func @elementwise() {
+  %a = dt.create_uninit_tensor.f32 [2, 3] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%a : !cinn.tensor<X86, NCHW, F32>) {value=2.0:f32}
+  %b = dt.create_uninit_tensor.f32 [3] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%b : !cinn.tensor<X86, NCHW, F32>) {value=-1.0:f32}
+
+  %c = "dt.add.f32"(%a, %b) : (!cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+  // CHECK: tensor: shape=shape[2,3], values=[1, 1, 1, 1, 1, 1]
+  dt.print_tensor (%c : !cinn.tensor<X86, NCHW, F32>)
+
+  %d = "dt.mul.f32"(%b, %a) : (!cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+  // CHECK: tensor: shape=shape[2,3], values=[-2, -2, -2, -2, -2, -2]
+  dt.print_tensor (%d : !cinn.tensor<X86, NCHW, F32>)
+
+  %e = "dt.relu.f32"(%d) : (!cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+  // CHECK: tensor: shape=shape[2,3], values=[0, 0, 0, 0, 0, 0]
+  dt.print_tensor (%e : !cinn.tensor<X86, NCHW, F32>)
+
+  cinn.return
+}
+
+// CHECK-LABEL: matmul
+func @matmul() {
+  %a = dt.create_uninit_tensor.f32 [2, 3] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%a : !cinn.tensor<X86, NCHW, F32>) {value=2.0:f32}
+  %b = dt.create_uninit_tensor.f32 [3, 10] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%b : !cinn.tensor<X86, NCHW, F32>) {value=0.5:f32}
+
+  %c = "dt.matmul.f32"(%a, %b) : (!cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+  // CHECK: tensor: shape=shape[2,10], values=[3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3]
+  dt.print_tensor (%c : !cinn.tensor<X86, NCHW, F32>)
+
+  cinn.return
+}
+
+// CHECK-LABEL: reduce
+func @reduce() {
+  %a = dt.create_uninit_tensor.f32 [2, 3, 4] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%a : !cinn.tensor<X86, NCHW, F32>) {value=1.5:f32}
+
+  %b = "dt.reduce_sum.f32"(%a) {axis = 1 : i32} : (!cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+  // CHECK: tensor: shape=shape[2,4], values=[4.5, 4.5, 4.5, 4.5, 4.5, 4.5, 4.5, 4.5]
+  dt.print_tensor (%b : !cinn.tensor<X86, NCHW, F32>)
+
+  %c = "dt.reduce_mean.f32"(%a) {axis = -1 : i32} : (!cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+  // CHECK: tensor: shape=shape[2,3], values=[1.5, 1.5, 1.5, 1.5, 1.5, 1.5]
+  dt.print_tensor (%c : !cinn.tensor<X86, NCHW, F32>)
+
+  cinn.return
+}
+
+// CHECK-LABEL: normalization
+func @normalization() {
+  %a = dt.create_uninit_tensor.f32 [2, 4] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%a : !cinn.tensor<X86, NCHW, F32>) {value=3.0:f32}
+
+  %b = "dt.softmax.f32"(%a) : (!cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+  // CHECK: tensor: shape=shape[2,4], values=[0.25, 0.25, 0.25, 0.25, 0.25, 0.25, 0.25, 0.25]
+  dt.print_tensor (%b : !cinn.tensor<X86, NCHW, F32>)
+
+  %scale = dt.create_uninit_tensor.f32 [4] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%scale : !cinn.tensor<X86, NCHW, F32>) {value=2.0:f32}
+  %bias = dt.create_uninit_tensor.f32 [4] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%bias : !cinn.tensor<X86, NCHW, F32>) {value=0.5:f32}
+  %c = "dt.layer_norm.f32"(%a, %scale, %bias) {epsilon = 1.0e-05 : f32} : (!cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+  // CHECK: tensor: shape=shape[2,4], values=[0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5, 0.5]
+  dt.print_tensor (%c : !cinn.tensor<X86, NCHW, F32>)
+
+  cinn.return
+}
@@ -0,0 +1,45 @@
+// CHECK-LABEL: @benchmark_matmul
+func @benchmark_matmul() {
+  %a = dt.create_uninit_tensor.f32 [256, 512] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%a : !cinn.tensor<X86, NCHW, F32>) {value=1.0:f32}
+  %b = dt.create_uninit_tensor.f32 [512, 512] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%b : !cinn.tensor<X86, NCHW, F32>) {value=1.0:f32}
+
+  // CHECK: BM:matmul.f32:Count: 10
+  cinn.benchmark "matmul.f32"(%a : !cinn.tensor<X86, NCHW, F32>, %b : !cinn.tensor<X86, NCHW, F32>) duration_secs = 10, max_count = 10, num_warmup_runs = 2
+  {
+    %c = "dt.matmul.f32"(%a, %b) : (!cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+    cinn.return %c : !cinn.tensor<X86, NCHW, F32>
+  }
+  cinn.return
+}
+
+// CHECK-LABEL: @benchmark_bias_add
+func @benchmark_bias_add() {
+  %a = dt.create_uninit_tensor.f32 [256, 4096] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%a : !cinn.tensor<X86, NCHW, F32>) {value=1.0:f32}
+  %b = dt.create_uninit_tensor.f32 [4096] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%b : !cinn.tensor<X86, NCHW, F32>) {value=1.0:f32}
+
+  // CHECK: BM:add.f32:Count: 100
+  cinn.benchmark "add.f32"(%a : !cinn.tensor<X86, NCHW, F32>, %b : !cinn.tensor<X86, NCHW, F32>) duration_secs = 10, max_count = 100, num_warmup_runs = 10
+  {
+    %c = "dt.add.f32"(%a, %b) : (!cinn.tensor<X86, NCHW, F32>, !cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+    cinn.return %c : !cinn.tensor<X86, NCHW, F32>
+  }
+  cinn.return
+}
+
+// CHECK-LABEL: @benchmark_softmax
+func @benchmark_softmax() {
+  %a = dt.create_uninit_tensor.f32 [256, 4096] -> !cinn.tensor<X86, NCHW, F32>
+  dt.fill_tensor_with_constant.f32 (%a : !cinn.tensor<X86, NCHW, F32>) {value=1.0:f32}
+
+  // CHECK: BM:softmax.f32:Count: 100
+  cinn.benchmark "softmax.f32"(%a : !cinn.tensor<X86, NCHW, F32>) duration_secs = 10, max_count = 100, num_warmup_runs = 10
+  {
+    %b = "dt.softmax.f32"(%a) : (!cinn.tensor<X86, NCHW, F32>) -> !cinn.tensor<X86, NCHW, F32>
+    cinn.return %b : !cinn.tensor<X86, NCHW, F32>
+  }
+  cinn.return
+}
@@ -0,0 +1,114 @@
+#include "infrt/host_context/thread_pool.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace infrt::host_context {
+
+namespace {
+// The pool and the worker id of the current thread, used to schedule a task to the queue of its own worker.
+thread_local ThreadPool* current_pool = nullptr;
+thread_local int current_worker_id    = -1;
+}  // namespace
+
+ThreadPool::ThreadPool(int num_threads) {
+  CHECK_GT(num_threads, 0) << "The thread pool needs at least one thread";
+  for (int i = 0; i < num_threads; i++) {
+    queues_.emplace_back(new TaskQueue);
+  }
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back([this, i] { WorkerLoop(i); });
+  }
+}
+
+void ThreadPool::Schedule(std::function<void()> task) {
+  int queue_id = current_pool == this ? current_worker_id : next_queue_++ % queues_.size();
+  {
+    std::lock_guard<std::mutex> lock(queues_[queue_id]->mu);
+    queues_[queue_id]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    ++num_pending_;
+  }
+  cv_.notify_one();
+}
+
+void ThreadPool::ParallelFor(int64_t n, int64_t grain_size, const std::function<void(int64_t, int64_t)>& fn) {
+  if (n <= 0) return;
+  int64_t num_blocks = std::min<int64_t>((n + grain_size - 1) / std::max<int64_t>(grain_size, 1), num_threads() + 1);
+  if (num_blocks <= 1) {
+    fn(0, n);
+    return;
+  }
+  int64_t block_size = (n + num_blocks - 1) / num_blocks;
+  num_blocks         = (n + block_size - 1) / block_size;
+
+  std::mutex mu;
+  std::condition_variable cv;
+  int64_t num_finished = 0;
+  for (int64_t i = 1; i < num_blocks; i++) {
+    Schedule([&, i] {
+      fn(i * block_size, std::min(n, (i + 1) * block_size));
+      // Notify with the lock held, the caller may return and destroy cv as soon as it sees the last block finished.
+      std::lock_guard<std::mutex> lock(mu);
+      if (++num_finished == num_blocks - 1) cv.notify_one();
+    });
+  }
+  fn(0, block_size);
+  std::unique_lock<std::mutex> lock(mu);
+  cv.wait(lock, [&] { return num_finished == num_blocks - 1; });
+}
+
+bool ThreadPool::PopTask(int worker_id, std::function<void()>* task) {
+  {
+    auto& queue = *queues_[worker_id];
+    std::lock_guard<std::mutex> lock(queue.mu);
+    if (!queue.tasks.empty()) {
+      *task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      return true;
+    }
+  }
+  for (size_t i = 1; i < queues_.size(); i++) {
+    auto& queue = *queues_[(worker_id + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mu);
+    if (!queue.tasks.empty()) {
+      *task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::WorkerLoop(int worker_id) {
+  current_pool      = this;
+  current_worker_id = worker_id;
+  std::function<void()> task;
+  while (true) {
+    if (PopTask(worker_id, &task)) {
+      --num_pending_;
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait(lock, [this] { return stop_ || num_pending_ > 0; });
+    if (stop_ && num_pending_ <= 0) return;
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mu_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+}  // namespace infrt::host_context
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace infrt::host_context {
+
+/**
+ * A fixed size thread pool with a task queue per worker.
+ * A task scheduled from a worker goes to the queue of that worker, and an idle worker steals tasks from the others, so
+ * a chain of dependent tasks tends to stay on the same thread.
+ */
+class ThreadPool {
+ public:
+  explicit ThreadPool(int num_threads);
+
+  //! Schedule a task to run on some worker.
+  void Schedule(std::function<void()> task);
+
+  /**
+   * Split [0, n) into blocks of at least grain_size iterations and run fn(begin, end) on each of them, the calling
+   * thread runs the first block and waits for the others.
+   */
+  void ParallelFor(int64_t n, int64_t grain_size, const std::function<void(int64_t, int64_t)>& fn);
+
+  int num_threads() const { return workers_.size(); }
+
+  //! Wait for the remaining tasks and stop the workers.
+  ~ThreadPool();
+
+ private:
+  struct TaskQueue {
+    std::mutex mu;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void WorkerLoop(int worker_id);
+
+  //! Pop a task from the back of the worker's own queue, or steal one from the front of another queue.
+  bool PopTask(int worker_id, std::function<void()>* task);
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::atomic<int> num_pending_{0};
+  std::atomic<unsigned> next_queue_{0};
+  bool stop_{false};
+};
+
+}  // namespace infrt::host_context
@@ -0,0 +1,57 @@
+#include "infrt/host_context/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+namespace infrt {
+namespace host_context {
+
+TEST(ThreadPool, basic) {
+  std::atomic<int> sum{0};
+  {
+    ThreadPool pool(4);
+    ASSERT_EQ(pool.num_threads(), 4);
+    for (int i = 1; i <= 100; i++) {
+      pool.Schedule([&sum, i] { sum += i; });
+    }
+  }
+  ASSERT_EQ(sum, 5050);
+}
+
+TEST(ThreadPool, nested_schedule) {
+  std::atomic<int> count{0};
+  {
+    ThreadPool pool(2);
+    for (int i = 0; i < 10; i++) {
+      pool.Schedule([&] {
+        count++;
+        pool.Schedule([&] { count++; });
+      });
+    }
+  }
+  ASSERT_EQ(count, 20);
+}
+
+TEST(ThreadPool, parallel_for) {
+  ThreadPool pool(3);
+  std::vector<int> data(1000, 0);
+  pool.ParallelFor(data.size(), 16, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) data[i] += i;
+  });
+  for (int i = 0; i < data.size(); i++) {
+    ASSERT_EQ(data[i], i);
+  }
+
+  // A range smaller than the grain size runs on the calling thread.
+  int calls = 0;
+  pool.ParallelFor(10, 16, [&](int64_t begin, int64_t end) {
+    calls++;
+    ASSERT_EQ(end - begin, 10);
+  });
+  ASSERT_EQ(calls, 1);
+}
+
+}  // namespace host_context
+}  // namespace infrt
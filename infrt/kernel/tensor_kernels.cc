@@ -1,11 +1,13 @@
 #include "infrt/kernel/tensor_kernels.h"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
 #include "infrt/common/global.h"
 #include "infrt/host_context/kernel_registry.h"
 #include "infrt/host_context/kernel_utils.h"
+#include "infrt/kernel/tensor_math_kernels.h"
 #include "infrt/tensor/dense_host_tensor.h"
 #include "infrt/tensor/dense_tensor_view.h"
 #include "infrt/tensor/tensor_map.h"
@@ -32,6 +34,13 @@ void FillTensorWithConstant(DenseHostTensor *tensor, Attribute<T> v) {
   MutableDTArrayView<T>(tensor).Fill(v.get());
 }
 
+template <typename T>
+void SetTensorWithConstantValues(DenseHostTensor *tensor, Attribute<std::vector<T>> values) {
+  MutableDTArrayView<T> view(tensor);
+  CHECK_EQ(view.GetNumElements(), values.get().size()) << "The number of the values should equal to the tensor's";
+  std::copy(values.get().begin(), values.get().end(), view.data());
+}
+
 TensorMap LoadParams(const std::string &path) { return *(infrt::tensor::LoadParams(path)); }
 
 DenseHostTensor GetParam(TensorMap map, Attribute<std::string> nameAttr) {
@@ -49,9 +58,12 @@ void RegisterTensorKernels(host_context::KernelRegistry *registry) {
   registry->AddKernel("dt.print_tensor", CINN_KERNEL(PrintTensor));
   registry->AddKernel("dt.fill_tensor_with_constant.f32", CINN_KERNEL(FillTensorWithConstant<float>));
   registry->AddKernel("dt.fill_tensor_with_constant.f64", CINN_KERNEL(FillTensorWithConstant<double>));
+  registry->AddKernel("dt.set_tensor_with_constant_values.f32", CINN_KERNEL(SetTensorWithConstantValues<float>));
   registry->AddKernel("dt.load_params", CINN_KERNEL(LoadParams));
   registry->AddKernel("dt.get_param", CINN_KERNEL(GetParam));
   registry->AddKernel("dt.shallow_copy_tensor", CINN_KERNEL(ShallowCopyTensor));
+
+  RegisterTensorMathKernels(registry);
 }
 
 }  // namespace infrt::kernel
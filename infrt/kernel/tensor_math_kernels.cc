@@ -0,0 +1,465 @@
+#include "infrt/kernel/tensor_math_kernels.h"
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <llvm/Support/raw_ostream.h>
+
+#include "infrt/host_context/kernel_registry.h"
+#include "infrt/host_context/kernel_utils.h"
+#include "infrt/host_context/thread_pool.h"
+#include "infrt/tensor/dense_host_tensor.h"
+#include "infrt/tensor/tensor_shape.h"
+
+namespace infrt::kernel {
+using namespace host_context;  // NOLINT
+using namespace tensor;        // NOLINT
+
+namespace {
+
+// The number of scalar operations worth running on a thread of its own.
+constexpr int64_t kGrainSize = 32768;
+
+ThreadPool* IntraOpThreadPool() {
+  // The calling thread runs a block of each parallel loop itself, so the pool leaves one core to it.
+  static std::unique_ptr<ThreadPool> pool(
+      new ThreadPool(std::max<int>(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1)));
+  return pool.get();
+}
+
+//! Run fn(begin, end) over [0, n), where an iteration costs about cost scalar operations.
+template <typename Fn>
+void ParallelFor(int64_t n, int64_t cost, Fn&& fn) {
+  if (n * cost < kGrainSize) {
+    fn(0, n);
+    return;
+  }
+  IntraOpThreadPool()->ParallelFor(n, std::max<int64_t>(kGrainSize / std::max<int64_t>(cost, 1), 1), fn);
+}
+
+std::vector<int64_t> GetDims(const TensorShape& shape) {
+  std::vector<int64_t> dims(shape.GetRank());
+  for (int i = 0; i < shape.GetRank(); i++) dims[i] = shape.GetDim(i);
+  return dims;
+}
+
+DenseHostTensor CreateFloatTensor(const std::vector<int64_t>& dims) {
+  return DenseHostTensor(TensorShape(llvm::ArrayRef<int64_t>(dims.data(), dims.size())), GetDType<float>());
+}
+
+const float* FloatData(const DenseHostTensor& tensor) {
+  CHECK(tensor.metadata().dtype == GetDType<float>()) << "Only float32 tensors are supported";
+  return static_cast<const float*>(tensor.raw_data());
+}
+
+float* MutableFloatData(DenseHostTensor* tensor) { return static_cast<float*>(tensor->raw_data()); }
+
+std::string ShapeToString(const TensorShape& shape) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  os << shape;
+  return os.str();
+}
+
+#ifdef __AVX__
+constexpr int kLanes = 8;
+
+inline float HorizontalSum(__m256 v) {
+  alignas(32) float lanes[kLanes];
+  _mm256_store_ps(lanes, v);
+  float sum = 0.f;
+  for (float x : lanes) sum += x;
+  return sum;
+}
+
+inline float HorizontalMax(__m256 v) {
+  alignas(32) float lanes[kLanes];
+  _mm256_store_ps(lanes, v);
+  return *std::max_element(lanes, lanes + kLanes);
+}
+
+inline __m256 MulAdd(__m256 a, __m256 b, __m256 c) {
+#ifdef __FMA__
+  return _mm256_fmadd_ps(a, b, c);
+#else
+  return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+#endif
+
+// Each op computes on a float, and on a __m256 of kLanes floats when AVX is available.
+#ifdef __AVX__
+#define VECTOR_OP(expr__) \
+  __m256 operator()(__m256 a, __m256 b) const { return expr__; }
+#else
+#define VECTOR_OP(expr__)
+#endif
+
+#define BINARY_OP(name__, scalar_expr__, vector_expr__)               \
+  struct name__ {                                                     \
+    float operator()(float a, float b) const { return scalar_expr__; } \
+    VECTOR_OP(vector_expr__)                                          \
+  };
+
+BINARY_OP(AddOp, a + b, _mm256_add_ps(a, b))
+BINARY_OP(SubOp, a - b, _mm256_sub_ps(a, b))
+BINARY_OP(MulOp, a * b, _mm256_mul_ps(a, b))
+BINARY_OP(DivOp, a / b, _mm256_div_ps(a, b))
+BINARY_OP(MaxOp, std::max(a, b), _mm256_max_ps(a, b))
+#undef BINARY_OP
+#undef VECTOR_OP
+
+/**
+ * out[i] = op(a[i], b[i]) for i in [0, n), where a or b is broadcast from its first element if it is a scalar.
+ */
+template <typename Op>
+void BinaryLoop(const float* a, bool a_scalar, const float* b, bool b_scalar, float* out, int64_t n) {
+  Op op;
+  int64_t i = 0;
+#ifdef __AVX__
+  __m256 va = a_scalar ? _mm256_set1_ps(a[0]) : _mm256_setzero_ps();
+  __m256 vb = b_scalar ? _mm256_set1_ps(b[0]) : _mm256_setzero_ps();
+  for (; i + kLanes <= n; i += kLanes) {
+    __m256 x = a_scalar ? va : _mm256_loadu_ps(a + i);
+    __m256 y = b_scalar ? vb : _mm256_loadu_ps(b + i);
+    _mm256_storeu_ps(out + i, op(x, y));
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = op(a_scalar ? a[0] : a[i], b_scalar ? b[0] : b[i]);
+  }
+}
+
+/**
+ * Elementwise binary op with the numpy broadcasting rule.
+ *
+ * The trailing dimensions where a and b agree are run as one contiguous inner loop, and the leading dimensions index
+ * into a and b with a zero stride where they are broadcast. So the common cases, same shapes, a scalar operand and a
+ * bias over the last dimensions, all run vectorized.
+ */
+template <typename Op>
+DenseHostTensor ElementwiseBinary(const DenseHostTensor& a, const DenseHostTensor& b) {
+  const float* a_data = FloatData(a);
+  const float* b_data = FloatData(b);
+  auto a_dims         = GetDims(a.shape());
+  auto b_dims         = GetDims(b.shape());
+  int rank            = std::max(a_dims.size(), b_dims.size());
+  a_dims.insert(a_dims.begin(), rank - a_dims.size(), 1);
+  b_dims.insert(b_dims.begin(), rank - b_dims.size(), 1);
+
+  std::vector<int64_t> out_dims(rank);
+  for (int i = 0; i < rank; i++) {
+    CHECK(a_dims[i] == b_dims[i] || a_dims[i] == 1 || b_dims[i] == 1)
+        << "Shapes " << ShapeToString(a.shape()) << " and " << ShapeToString(b.shape()) << " can not be broadcast";
+    out_dims[i] = std::max(a_dims[i], b_dims[i]);
+  }
+  auto out        = CreateFloatTensor(out_dims);
+  float* out_data = MutableFloatData(&out);
+
+  int64_t a_numel = a.shape().GetNumElements();
+  int64_t b_numel = b.shape().GetNumElements();
+  if (a_numel == 1 || b_numel == 1 || a_dims == b_dims) {
+    int64_t n = out.shape().GetNumElements();
+    ParallelFor(n, 1, [&](int64_t begin, int64_t end) {
+      BinaryLoop<Op>(a_numel == 1 ? a_data : a_data + begin,
+                     a_numel == 1,
+                     b_numel == 1 ? b_data : b_data + begin,
+                     b_numel == 1,
+                     out_data + begin,
+                     end - begin);
+    });
+    return out;
+  }
+
+  int inner_begin = rank;
+  int64_t inner   = 1;
+  while (inner_begin > 0 && a_dims[inner_begin - 1] == b_dims[inner_begin - 1]) {
+    inner *= a_dims[--inner_begin];
+  }
+  // The strides of a and b over the leading dimensions, zero on a broadcast dimension.
+  std::vector<int64_t> a_strides(inner_begin), b_strides(inner_begin);
+  int64_t a_stride = inner, b_stride = inner, outer = 1;
+  for (int i = inner_begin - 1; i >= 0; i--) {
+    a_strides[i] = a_dims[i] == 1 ? 0 : a_stride;
+    b_strides[i] = b_dims[i] == 1 ? 0 : b_stride;
+    a_stride *= a_dims[i];
+    b_stride *= b_dims[i];
+    outer *= out_dims[i];
+  }
+
+  ParallelFor(outer, inner, [&](int64_t begin, int64_t end) {
+    for (int64_t o = begin; o < end; o++) {
+      int64_t a_offset = 0, b_offset = 0;
+      for (int64_t i = inner_begin - 1, index = o; i >= 0; i--) {
+        int64_t coord = index % out_dims[i];
+        index /= out_dims[i];
+        a_offset += coord * a_strides[i];
+        b_offset += coord * b_strides[i];
+      }
+      BinaryLoop<Op>(a_data + a_offset, false, b_data + b_offset, false, out_data + o * inner, inner);
+    }
+  });
+  return out;
+}
+
+DenseHostTensor Add(const DenseHostTensor& a, const DenseHostTensor& b) { return ElementwiseBinary<AddOp>(a, b); }
+DenseHostTensor Sub(const DenseHostTensor& a, const DenseHostTensor& b) { return ElementwiseBinary<SubOp>(a, b); }
+DenseHostTensor Mul(const DenseHostTensor& a, const DenseHostTensor& b) { return ElementwiseBinary<MulOp>(a, b); }
+DenseHostTensor Div(const DenseHostTensor& a, const DenseHostTensor& b) { return ElementwiseBinary<DivOp>(a, b); }
+DenseHostTensor Maximum(const DenseHostTensor& a, const DenseHostTensor& b) { return ElementwiseBinary<MaxOp>(a, b); }
+
+template <typename Fn>
+DenseHostTensor ElementwiseUnary(const DenseHostTensor& x, int64_t cost, Fn&& fn) {
+  const float* x_data = FloatData(x);
+  auto out            = CreateFloatTensor(GetDims(x.shape()));
+  float* out_data     = MutableFloatData(&out);
+  ParallelFor(x.shape().GetNumElements(), cost, [&](int64_t begin, int64_t end) {
+    fn(x_data + begin, out_data + begin, end - begin);
+  });
+  return out;
+}
+
+DenseHostTensor Relu(const DenseHostTensor& x) {
+  return ElementwiseUnary(x, 1, [](const float* in, float* out, int64_t n) {
+    float zero = 0.f;
+    BinaryLoop<MaxOp>(in, false, &zero, true, out, n);
+  });
+}
+
+// The transcendental functions are left to libm, with a larger cost so that they are split into smaller blocks.
+DenseHostTensor Exp(const DenseHostTensor& x) {
+  return ElementwiseUnary(x, 8, [](const float* in, float* out, int64_t n) {
+    for (int64_t i = 0; i < n; i++) out[i] = std::exp(in[i]);
+  });
+}
+
+DenseHostTensor Tanh(const DenseHostTensor& x) {
+  return ElementwiseUnary(x, 8, [](const float* in, float* out, int64_t n) {
+    for (int64_t i = 0; i < n; i++) out[i] = std::tanh(in[i]);
+  });
+}
+
+DenseHostTensor Sigmoid(const DenseHostTensor& x) {
+  return ElementwiseUnary(x, 8, [](const float* in, float* out, int64_t n) {
+    for (int64_t i = 0; i < n; i++) out[i] = 1.f / (1.f + std::exp(-in[i]));
+  });
+}
+
+/**
+ * Matmul of a [..., K] and b [K, N] to [..., N], the leading dimensions of a are flattened to the rows.
+ *
+ * Each row of the output is accumulated as a linear combination of the rows of b, so the innermost loop runs
+ * contiguously over N with fused multiply-adds, and the rows are split over the threads.
+ */
+DenseHostTensor Matmul(const DenseHostTensor& a, const DenseHostTensor& b) {
+  const float* a_data = FloatData(a);
+  const float* b_data = FloatData(b);
+  auto a_dims         = GetDims(a.shape());
+  auto b_dims         = GetDims(b.shape());
+  CHECK_GE(a_dims.size(), 2UL) << "dt.matmul needs a of rank >= 2";
+  CHECK_EQ(b_dims.size(), 2UL) << "dt.matmul needs b of rank 2";
+  int64_t K = a_dims.back();
+  int64_t N = b_dims[1];
+  CHECK_EQ(K, b_dims[0]) << "The reduce dimensions of dt.matmul mismatch: " << ShapeToString(a.shape()) << " vs "
+                       << ShapeToString(b.shape());
+  int64_t M = a.shape().GetNumElements() / std::max<int64_t>(K, 1);
+
+  auto out_dims   = a_dims;
+  out_dims.back() = N;
+  auto out        = CreateFloatTensor(out_dims);
+  float* out_data = MutableFloatData(&out);
+
+  ParallelFor(M, K * N, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      float* c = out_data + i * N;
+      std::fill(c, c + N, 0.f);
+      for (int64_t k = 0; k < K; k++) {
+        float a_ik       = a_data[i * K + k];
+        const float* b_k = b_data + k * N;
+        int64_t j        = 0;
+#ifdef __AVX__
+        __m256 va = _mm256_set1_ps(a_ik);
+        for (; j + kLanes <= N; j += kLanes) {
+          _mm256_storeu_ps(c + j, MulAdd(va, _mm256_loadu_ps(b_k + j), _mm256_loadu_ps(c + j)));
+        }
+#endif
+        for (; j < N; j++) c[j] += a_ik * b_k[j];
+      }
+    }
+  });
+  return out;
+}
+
+float RowSum(const float* x, int64_t n) {
+  int64_t i = 0;
+  float sum = 0.f;
+#ifdef __AVX__
+  __m256 acc = _mm256_setzero_ps();
+  for (; i + kLanes <= n; i += kLanes) acc = _mm256_add_ps(acc, _mm256_loadu_ps(x + i));
+  sum = HorizontalSum(acc);
+#endif
+  for (; i < n; i++) sum += x[i];
+  return sum;
+}
+
+float RowMax(const float* x, int64_t n) {
+  int64_t i = 0;
+  float max = -std::numeric_limits<float>::infinity();
+#ifdef __AVX__
+  __m256 acc = _mm256_set1_ps(max);
+  for (; i + kLanes <= n; i += kLanes) acc = _mm256_max_ps(acc, _mm256_loadu_ps(x + i));
+  max = HorizontalMax(acc);
+#endif
+  for (; i < n; i++) max = std::max(max, x[i]);
+  return max;
+}
+
+/**
+ * Reduce x over the dimension axis, viewed as [outer, reduce, inner].
+ * With inner being 1 a row is reduced horizontally, otherwise the inner vectors are combined elementwise.
+ */
+template <typename Op>
+DenseHostTensor Reduce(const DenseHostTensor& x, int axis, float init, float (*row_reduce)(const float*, int64_t)) {
+  const float* x_data = FloatData(x);
+  auto dims           = GetDims(x.shape());
+  int rank            = dims.size();
+  if (axis < 0) axis += rank;
+  CHECK(axis >= 0 && axis < rank) << "Invalid reduce axis " << axis << " of shape " << ShapeToString(x.shape());
+
+  int64_t outer = 1, inner = 1, reduce = dims[axis];
+  for (int i = 0; i < axis; i++) outer *= dims[i];
+  for (int i = axis + 1; i < rank; i++) inner *= dims[i];
+  dims.erase(dims.begin() + axis);
+  auto out        = CreateFloatTensor(dims);
+  float* out_data = MutableFloatData(&out);
+
+  if (inner == 1) {
+    ParallelFor(outer, reduce, [&](int64_t begin, int64_t end) {
+      for (int64_t o = begin; o < end; o++) out_data[o] = row_reduce(x_data + o * reduce, reduce);
+    });
+  } else {
+    ParallelFor(outer, reduce * inner, [&](int64_t begin, int64_t end) {
+      for (int64_t o = begin; o < end; o++) {
+        float* acc = out_data + o * inner;
+        std::fill(acc, acc + inner, init);
+        for (int64_t r = 0; r < reduce; r++) {
+          BinaryLoop<Op>(acc, false, x_data + (o * reduce + r) * inner, false, acc, inner);
+        }
+      }
+    });
+  }
+  return out;
+}
+
+DenseHostTensor ReduceSum(const DenseHostTensor& x, Attribute<int32_t> axis) {
+  return Reduce<AddOp>(x, axis.get(), 0.f, RowSum);
+}
+
+DenseHostTensor ReduceMax(const DenseHostTensor& x, Attribute<int32_t> axis) {
+  return Reduce<MaxOp>(x, axis.get(), -std::numeric_limits<float>::infinity(), RowMax);
+}
+
+DenseHostTensor ReduceMean(const DenseHostTensor& x, Attribute<int32_t> axis) {
+  int rank      = x.shape().GetRank();
+  int real_axis = axis.get() < 0 ? axis.get() + rank : axis.get();
+  CHECK(real_axis >= 0 && real_axis < rank)
+      << "Invalid reduce axis " << axis.get() << " of shape " << ShapeToString(x.shape());
+  int64_t size = x.shape().GetDim(real_axis);
+  auto out     = Reduce<AddOp>(x, real_axis, 0.f, RowSum);
+  float scale  = 1.f / size;
+  float* data  = MutableFloatData(&out);
+  BinaryLoop<MulOp>(data, false, &scale, true, data, out.shape().GetNumElements());
+  return out;
+}
+
+//! Apply fn(in_row, out_row, row_size) to every row of the last dimension of x.
+template <typename Fn>
+DenseHostTensor RowWise(const DenseHostTensor& x, int64_t cost_per_element, Fn&& fn) {
+  const float* x_data = FloatData(x);
+  CHECK_GE(x.shape().GetRank(), 1) << "A row-wise op needs a tensor of rank >= 1";
+  int64_t row_size = x.shape().GetDim(x.shape().GetRank() - 1);
+  int64_t rows     = x.shape().GetNumElements() / std::max<int64_t>(row_size, 1);
+  auto out         = CreateFloatTensor(GetDims(x.shape()));
+  float* out_data  = MutableFloatData(&out);
+  ParallelFor(rows, row_size * cost_per_element, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; r++) fn(x_data + r * row_size, out_data + r * row_size, row_size);
+  });
+  return out;
+}
+
+//! Softmax over the last dimension.
+DenseHostTensor Softmax(const DenseHostTensor& x) {
+  return RowWise(x, 10, [](const float* in, float* out, int64_t n) {
+    float max = RowMax(in, n);
+    float sum = 0.f;
+    for (int64_t i = 0; i < n; i++) {
+      out[i] = std::exp(in[i] - max);
+      sum += out[i];
+    }
+    float scale = 1.f / sum;
+    BinaryLoop<MulOp>(out, false, &scale, true, out, n);
+  });
+}
+
+//! Layer normalization over the last dimension, followed by the elementwise affine transform with scale and bias.
+DenseHostTensor LayerNorm(const DenseHostTensor& x,
+                          const DenseHostTensor& scale,
+                          const DenseHostTensor& bias,
+                          Attribute<float> epsilon) {
+  const float* scale_data = FloatData(scale);
+  const float* bias_data  = FloatData(bias);
+  int64_t row_size        = x.shape().GetDim(x.shape().GetRank() - 1);
+  CHECK_EQ(scale.shape().GetNumElements(), row_size) << "The scale of dt.layer_norm should match the last dimension";
+  CHECK_EQ(bias.shape().GetNumElements(), row_size) << "The bias of dt.layer_norm should match the last dimension";
+  float eps = epsilon.get();
+
+  return RowWise(x, 4, [&](const float* in, float* out, int64_t n) {
+    float neg_mean = -RowSum(in, n) / n;
+    BinaryLoop<AddOp>(in, false, &neg_mean, true, out, n);
+    float var = 0.f;
+    for (int64_t i = 0; i < n; i++) var += out[i] * out[i];
+    float rstd = 1.f / std::sqrt(var / n + eps);
+    BinaryLoop<MulOp>(out, false, &rstd, true, out, n);
+    BinaryLoop<MulOp>(out, false, scale_data, false, out, n);
+    BinaryLoop<AddOp>(out, false, bias_data, false, out, n);
+  });
+}
+
+}  // namespace
+
+void RegisterTensorMathKernels(host_context::KernelRegistry* registry) {
+  registry->AddKernel("dt.add.f32", CINN_KERNEL(Add));
+  registry->AddKernel("dt.sub.f32", CINN_KERNEL(Sub));
+  registry->AddKernel("dt.mul.f32", CINN_KERNEL(Mul));
+  registry->AddKernel("dt.div.f32", CINN_KERNEL(Div));
+  registry->AddKernel("dt.maximum.f32", CINN_KERNEL(Maximum));
+
+  registry->AddKernel("dt.relu.f32", CINN_KERNEL(Relu));
+  registry->AddKernel("dt.exp.f32", CINN_KERNEL(Exp));
+  registry->AddKernel("dt.tanh.f32", CINN_KERNEL(Tanh));
+  registry->AddKernel("dt.sigmoid.f32", CINN_KERNEL(Sigmoid));
+
+  registry->AddKernel("dt.matmul.f32", CINN_KERNEL(Matmul));
+
+  registry->AddKernel("dt.reduce_sum.f32", CINN_KERNEL(ReduceSum));
+  registry->AddKernelAttrNameList("dt.reduce_sum.f32", {"axis"});
+  registry->AddKernel("dt.reduce_max.f32", CINN_KERNEL(ReduceMax));
+  registry->AddKernelAttrNameList("dt.reduce_max.f32", {"axis"});
+  registry->AddKernel("dt.reduce_mean.f32", CINN_KERNEL(ReduceMean));
+  registry->AddKernelAttrNameList("dt.reduce_mean.f32", {"axis"});
+
+  registry->AddKernel("dt.softmax.f32", CINN_KERNEL(Softmax));
+  registry->AddKernel("dt.layer_norm.f32", CINN_KERNEL(LayerNorm));
+  registry->AddKernelAttrNameList("dt.layer_norm.f32", {"epsilon"});
+}
+
+}  // namespace infrt::kernel
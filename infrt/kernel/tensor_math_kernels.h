@@ -0,0 +1,15 @@
+#pragma once
+
+namespace infrt::host_context {
+struct KernelRegistry;
+}  // namespace infrt::host_context
+
+namespace infrt::kernel {
+
+/**
+ * Register the compute kernels over float32 DenseHostTensors: the elementwise ops with broadcasting, matmul,
+ * reductions, softmax and layer_norm. They are vectorized with AVX and split the work over an intra-op thread pool.
+ */
+void RegisterTensorMathKernels(host_context::KernelRegistry* registry);
+
+}  // namespace infrt::kernel
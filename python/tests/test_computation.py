@@ -92,6 +92,28 @@ class TestCinnBuilder(unittest.TestCase):
 
         self.assertTrue(np.allclose(edata_cinn, edata_paddle, atol=1e-5))
 
+    def test_bind_tensor_data(self):
+        if enable_gpu == "ON":
+            return
+        builder = CinnBuilder("test_bind_tensor_data")
+        a = builder.create_input(Float(32), (32, 24), "A")
+        b = builder.create_input(Float(32), (32, 24), "B")
+        c = builder.add(a, b)
+
+        computation = Computation.build_and_compile(self.target, builder)
+
+        A_data = np.random.random([32, 24]).astype("float32")
+        B_data = np.random.random([32, 24]).astype("float32")
+        computation.bind_tensor_data("A", A_data)
+        computation.get_tensor("B").share_numpy(B_data, self.target)
+
+        # the arrays are bound without copy, so the updates are seen by the next execution.
+        for step in range(2):
+            A_data[0][0] = step
+            computation.execute()
+            c_view = np.asarray(computation.get_tensor(str(c)))
+            self.assertTrue(np.allclose(c_view, A_data + B_data, atol=1e-5))
+
 
 class TestCompilePaddleModel(unittest.TestCase):
     def setUp(self):
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <absl/container/flat_hash_map.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 #include <string>
@@ -23,6 +24,8 @@
 #include "cinn/runtime/cpu/use_extern_funcs.h"
 #include "tests/benchmark/test_utils.h"
 
+DECLARE_bool(cinn_cpu_two_step_reduce);
+
 namespace cinn {
 namespace tests {
 
@@ -249,6 +252,79 @@ TEST_DEFAULT(softmax, softmax, type, type1)
 std::vector<std::vector<int>> shapes_softmax1 = {{3, 1000}};
 TEST_DEFAULT(softmax, softmax1, type, type1)
 
+// reduce the rows of layer_norm and softmax, with the one step and the two step CPU reductions.
+std::vector<std::vector<int>> shapes_reduce_rows = {{4096, 768}, {1024, 2048}, {4, 65536}};
+TEST(op_defualt, reduce_rows) {
+  hlir::framework::NodeAttr attrs;
+  attrs.attr_store["dim"] = std::vector<int>{1};
+  for (std::string op_name : {"reduce_sum", "reduce_max"}) {
+    for (auto& shape : shapes_reduce_rows) {
+      for (bool two_step : {false, true}) {
+        FLAGS_cinn_cpu_two_step_reduce = two_step;
+        OpBenchmarkTester tester(op_name, {shape});
+        auto input_tensors = tester.CreateInputTensors<float>();
+        // the two step reduction outputs the partial results too.
+        tester.TestOp(common::UniqName(op_name + (two_step ? "_two_step" : "_one_step")),
+                      input_tensors,
+                      attrs,
+                      type,
+                      two_step ? type1 : type);
+      }
+    }
+  }
+  // the sum of the exps of softmax.
+  hlir::framework::NodeAttr softmax_attrs;
+  for (auto& shape : shapes_reduce_rows) {
+    for (bool two_step : {false, true}) {
+      FLAGS_cinn_cpu_two_step_reduce = two_step;
+      OpBenchmarkTester tester("softmax", {shape});
+      auto input_tensors = tester.CreateInputTensors<float>();
+      tester.TestOp(common::UniqName(std::string("softmax") + (two_step ? "_two_step" : "_one_step")),
+                    input_tensors,
+                    softmax_attrs,
+                    type,
+                    two_step ? type8 : type1);
+    }
+  }
+  FLAGS_cinn_cpu_two_step_reduce = false;
+}
+
+// fused attention of 12 heads of dim 64, over the sequence lengths of transformer inference,
+// against the unfused matmul, softmax and matmul it replaces.
+TEST(op_defualt, fused_attention) {
+  hlir::framework::NodeAttr attrs;
+  attrs.attr_store["scale"] = 0.125f;
+  hlir::framework::NodeAttr qk_attrs;
+  qk_attrs.attr_store["trans_b"] = true;
+  qk_attrs.attr_store["alpha"]   = 0.125f;
+  hlir::framework::NodeAttr default_attrs;
+  for (int seq_len : {128, 512, 1024, 4096}) {
+    std::string suffix = "_" + std::to_string(seq_len);
+    std::vector<int> shape{12, seq_len, 64};
+    std::vector<int> scores_shape{12, seq_len, seq_len};
+
+    OpBenchmarkTester fused_tester("fused_attention", {shape, shape, shape});
+    auto fused_inputs = fused_tester.CreateInputTensors<float>();
+    double fused_time =
+        fused_tester.TestOp(common::UniqName("fused_attention" + suffix), fused_inputs, attrs, type8, type1);
+
+    double unfused_time = 0;
+    OpBenchmarkTester qk_tester("matmul", {shape, shape});
+    auto qk_inputs = qk_tester.CreateInputTensors<float>();
+    unfused_time += qk_tester.TestOp(common::UniqName("attention_qk" + suffix), qk_inputs, qk_attrs, type1, type1);
+    OpBenchmarkTester softmax_tester("softmax", {scores_shape});
+    auto softmax_inputs = softmax_tester.CreateInputTensors<float>();
+    unfused_time += softmax_tester.TestOp(
+        common::UniqName("attention_softmax" + suffix), softmax_inputs, default_attrs, type, type1);
+    OpBenchmarkTester pv_tester("matmul", {scores_shape, shape});
+    auto pv_inputs = pv_tester.CreateInputTensors<float>();
+    unfused_time += pv_tester.TestOp(common::UniqName("attention_pv" + suffix), pv_inputs, default_attrs, type1, type1);
+
+    LOG(INFO) << "attention of seq_len " << seq_len << ", fused: " << fused_time << " ms, unfused: " << unfused_time
+              << " ms";
+  }
+}
+
 // sigmoid
 std::vector<std::vector<int>> shapes_sigmoid = {{2, 672, 1, 1}};
 TEST_DEFAULT(sigmoid, sigmoid, type, type)
@@ -14,6 +14,8 @@
 
 #include "tests/benchmark/test_elementwise.h"
 
+#include <cstdlib>
+
 #include "cinn/cinn.h"
 #include "cinn/hlir/framework/node.h"
 
@@ -47,5 +49,27 @@ TEST(test_elementwise_add, default_int32) {
   add_tester.Compare<int>();
 }
 
+TEST(test_elementwise_add, optimize_options) {
+  std::vector<std::vector<int>> input_shapes{{1024, 1024}, {1024, 1024}};
+  std::vector<Type> input_types{Float(32), Float(32)};
+  std::vector<Type> output_types{Float(32)};
+  hlir::framework::NodeAttr attrs;
+  std::vector<float> expected;
+  for (auto& item : ExecutionOptionsToCompare()) {
+    ElementwiseAddTester add_tester("elementwise_add", input_shapes);
+    add_tester.SetExecutionOptions(item.second);
+    auto input_tensors = add_tester.CreateInputTensors<float>();
+    // the kernels of all the options run on the same random inputs.
+    srand(0);
+    add_tester.TestOp("elementwise_add_" + item.first, input_tensors, attrs, input_types, output_types);
+    auto result = add_tester.GetOutput<float>();
+    if (expected.empty()) {
+      expected = result;
+    } else {
+      ExpectNearOutput(item.first, result, expected);
+    }
+  }
+}
+
 }  // namespace tests
 }  // namespace cinn
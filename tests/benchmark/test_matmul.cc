@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+
 namespace cinn {
 namespace tests {
 
@@ -301,5 +303,27 @@ TEST(test_matmul, array_packing) {
   matmul_tester.TestOp("matmul_array_packing", input_tensors, attrs, input_types, output_types, false);
 }
 
+TEST(test_matmul, optimize_options) {
+  std::vector<std::vector<int>> input_shapes{{512, 512}, {512, 512}};
+  std::vector<Type> input_types{Float(32), Float(32)};
+  std::vector<Type> output_types{Float(32)};
+  hlir::framework::NodeAttr attrs;
+  std::vector<float> expected;
+  for (auto &item : ExecutionOptionsToCompare()) {
+    MatmulTileTester matmul_tester("matmul", input_shapes);
+    matmul_tester.SetExecutionOptions(item.second);
+    auto input_tensors = matmul_tester.CreateInputTensors<float>();
+    // the kernels of all the options run on the same random inputs.
+    srand(0);
+    matmul_tester.TestOp("matmul_tile_" + item.first, input_tensors, attrs, input_types, output_types, false);
+    auto result = matmul_tester.GetOutput<float>();
+    if (expected.empty()) {
+      expected = result;
+    } else {
+      ExpectNearOutput(item.first, result, expected);
+    }
+  }
+}
+
 }  // namespace tests
 }  // namespace cinn
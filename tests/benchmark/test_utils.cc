@@ -14,6 +14,11 @@
 
 #include "tests/benchmark/test_utils.h"
 
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+
 #include "cinn/backends/llvm/codegen_x86.h"
 #include "cinn/common/cas.h"
 #include "cinn/common/test_helper.h"
@@ -25,25 +30,28 @@ namespace cinn {
 namespace tests {
 using ir::Tensor;
 std::unique_ptr<backends::ExecutionEngine> OpBenchmarkTester::CreateExecutionEngine(const cinn::ir::Module& module) {
-  auto engine = backends::ExecutionEngine::Create({});
+  auto engine = backends::ExecutionEngine::Create(execution_options_);
   engine->Link<backends::CodeGenX86>(module);
   return engine;
 }
 
-void OpBenchmarkTester::TestOp(const std::string& test_name,
-                               const std::vector<Tensor>& input_tensors,
-                               const hlir::framework::NodeAttr& attrs,
-                               const std::vector<Type>& input_types,
-                               const std::vector<Type>& out_types,
-                               bool use_default_stragegy) {
-  auto module        = CreateCinnModule(input_tensors, attrs, out_types, use_default_stragegy);
-  auto engine        = CreateExecutionEngine(module);
-  auto test_func_ptr = reinterpret_cast<void (*)(void**, int32_t)>(engine->Lookup(op_name_));
-  input_types_       = input_types;
-  out_types_         = out_types;
+double OpBenchmarkTester::TestOp(const std::string& test_name,
+                                 const std::vector<Tensor>& input_tensors,
+                                 const hlir::framework::NodeAttr& attrs,
+                                 const std::vector<Type>& input_types,
+                                 const std::vector<Type>& out_types,
+                                 bool use_default_stragegy) {
+  auto module = CreateCinnModule(input_tensors, attrs, out_types, use_default_stragegy);
+  cinn::utils::Timer timer;
+  timer.Start();
+  auto engine         = CreateExecutionEngine(module);
+  auto test_func_ptr  = reinterpret_cast<void (*)(void**, int32_t)>(engine->Lookup(op_name_));
+  double compile_time = timer.Stop();
+  input_types_        = input_types;
+  out_types_          = out_types;
   CreateBuffer();
   LOG(INFO) << "Testing " << test_name;
-  cinn::utils::Timer timer;
+  LOG(INFO) << "kernel compile time: " << compile_time << " ms";
   // ignore first execution for lazy jit component
   timer.Start();
   test_func_ptr(reinterpret_cast<void**>(all_args_.data()), all_args_.size());
@@ -55,6 +63,7 @@ void OpBenchmarkTester::TestOp(const std::string& test_name,
   }
   test_op_time = timer.Stop() / repeat_;
   LOG(INFO) << "repeat times: " << repeat_ << ", kernel run time: " << test_op_time << " ms";
+  return test_op_time;
 }
 
 Module OpBenchmarkTester::CreateCinnModule(const std::vector<Tensor>& input_tensors,
@@ -139,5 +148,36 @@ void OpBenchmarkTester::CreateBuffer() {
   }
 }
 
+std::vector<std::pair<std::string, backends::ExecutionOptions>> ExecutionOptionsToCompare() {
+  std::vector<std::pair<std::string, backends::ExecutionOptions>> result;
+  backends::ExecutionOptions options;
+  result.emplace_back("O3", options);
+
+  backends::ExecutionOptions o1_options;
+  o1_options.opt_level = 1;
+  result.emplace_back("O1", o1_options);
+
+  backends::ExecutionOptions tuned_options;
+  tuned_options.optimize_options.tune_per_function = true;
+  result.emplace_back("O3_tuned", tuned_options);
+
+  backends::ExecutionOptions new_pm_options;
+  new_pm_options.optimize_options.use_new_pass_manager = true;
+  result.emplace_back("O3_new_pass_manager", new_pm_options);
+
+  backends::ExecutionOptions fast_math_options;
+  fast_math_options.optimize_options.fast_math_flags.setFast();
+  result.emplace_back("O3_fast_math", fast_math_options);
+  return result;
+}
+
+void ExpectNearOutput(const std::string& name, const std::vector<float>& result, const std::vector<float>& expected) {
+  ASSERT_EQ(result.size(), expected.size()) << "The output of " << name << " has a different size";
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_NEAR(result[i], expected[i], 1e-4 * std::max(1.f, std::abs(expected[i])))
+        << "The output of " << name << " differs from the default options at " << i;
+  }
+}
+
 }  // namespace tests
 }  // namespace cinn
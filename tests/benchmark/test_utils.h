@@ -16,6 +16,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "cinn/backends/llvm/execution_engine.h"
@@ -38,12 +39,13 @@ class OpBenchmarkTester {
 
   virtual ~OpBenchmarkTester() = default;
 
-  void TestOp(const std::string &test_name,
-              const std::vector<ir::Tensor> &input_tensors,
-              const hlir::framework::NodeAttr &attrs,
-              const std::vector<Type> &input_types,
-              const std::vector<Type> &out_types,
-              bool use_default_stragegy = true);
+  //! Returns the average kernel run time in ms.
+  double TestOp(const std::string &test_name,
+                const std::vector<ir::Tensor> &input_tensors,
+                const hlir::framework::NodeAttr &attrs,
+                const std::vector<Type> &input_types,
+                const std::vector<Type> &out_types,
+                bool use_default_stragegy = true);
 
   virtual Module CreateCinnModule(const std::vector<ir::Tensor> &input_tensors,
                                   const hlir::framework::NodeAttr &attrs,
@@ -58,9 +60,20 @@ class OpBenchmarkTester {
 
   virtual std::unique_ptr<backends::ExecutionEngine> CreateExecutionEngine(const cinn::ir::Module &module);
 
+  //! Set the options to compile the kernel with, to compare the compile time and the kernel time of them.
+  void SetExecutionOptions(const backends::ExecutionOptions &options) { execution_options_ = options; }
+
   std::vector<cinn_pod_value_t> &GetAllArgs() { return all_args_; }
   int GetOutDims() { return out_dims_; }
 
+  //! Get the data of the last output after TestOp.
+  template <typename T = float>
+  std::vector<T> GetOutput() {
+    CHECK(!all_args_.empty()) << "TestOp should be called before getting the output";
+    auto *data = reinterpret_cast<T *>(cinn_pod_value_to_buffer_p(&all_args_.back())->memory);
+    return std::vector<T>(data, data + out_dims_);
+  }
+
   template <typename T = float>
   std::vector<ir::Tensor> CreateInputTensors() {
     std::vector<ir::Tensor> inputs;
@@ -90,7 +103,20 @@ class OpBenchmarkTester {
   std::vector<Type> out_types_;
   std::vector<cinn_pod_value_t> all_args_;
   int out_dims_;
+  backends::ExecutionOptions execution_options_;
 };
 
+/**
+ * The execution options to compare the compile time and the kernel time of, with their names: the default O3
+ * pipeline first, then O1, O3 with the per-function tuning, the new pass manager, and fast-math.
+ */
+std::vector<std::pair<std::string, backends::ExecutionOptions>> ExecutionOptionsToCompare();
+
+/**
+ * Check the output of the kernel compiled with the execution options \p name is close to the \p expected one compiled
+ * with the default options, the tolerance is relative since fast-math may reassociate the floating-point operations.
+ */
+void ExpectNearOutput(const std::string &name, const std::vector<float> &result, const std::vector<float> &expected);
+
 }  // namespace tests
 }  // namespace cinn